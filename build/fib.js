@@ -0,0 +1,40 @@
+"use strict";
+
+(function(){
+const buffers = [];
+const stdin = buffers.push(null)-1, stdout=buffers.push('')-1, stderr=buffers.push('')-1, stdwarn=buffers.push('')-1;
+const print = (...args) => {
+  for (const arg of args) {
+    if (arg === '\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }
+    if (typeof arg === 'string' && arg.includes('\n')) {
+      const idx = arg.lastIndexOf('\n');
+      const content = buffers[stdout] + arg.substring(0, idx);
+      console.log(content);
+      buffers[stdout] = arg.substring(idx+1);
+      continue;
+    }
+    
+    buffers[stdout] += `${arg}`;
+  }
+};
+const $write = (text) => { buffers[stdout] += text; };
+const $writeLines = (lines, rest) => { console.log(buffers[stdout] + lines); buffers[stdout] = rest; };
+const flush = () => {
+  if (buffers[stdout]) console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+globalThis.print = print;
+globalThis.$write = $write;
+globalThis.$writeLines = $writeLines;
+globalThis.flush = flush;
+})();
+
+function main() {
+  const n = 100;
+  let f = 354224848179261997056;
+  $write("100th fib number is: ");
+  print(f);
+  $writeLines("", "");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,66 @@
+"use strict";
+
+(function(){
+const utf8Decoder = new TextDecoder();
+const utf8Encoder = new TextEncoder();
+const buffers = [];
+const stdin = buffers.push(null)-1, stdout=buffers.push('')-1, stderr=buffers.push('')-1, stdwarn=buffers.push('')-1;
+globalThis.stdin=stdin;globalThis.stdout=stdout;globalThis.stderr=stderr;globalThis.stdwarn=stdwarn;
+const print = (...args) => {
+  for (const arg of args) {
+    if (arg == '\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }
+    if (typeof arg === 'string' && arg.includes('\n')) {
+      const idx = arg.lastIndexOf('\n');
+      const content = buffers[stdout] + arg.substring(0, idx);
+      console.log(content);
+      buffers[stdout] = arg.substring(idx+1);
+      continue;
+    }
+    
+    buffers[stdout] += `${arg}`;
+  }
+};globalThis.print = print;
+const println = (...args) => {
+  for (const arg of args) {
+    if (arg == '\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }
+    if (typeof arg === 'string' && arg.includes('\n')) {
+      const idx = arg.lastIndexOf('\n');
+      const content = buffers[stdout] + arg.substring(0, idx);
+      console.log(content);
+      buffers[stdout] = arg.substring(idx+1);
+      continue;
+    }
+    
+    buffers[stdout] += `${arg}`;
+  }
+  console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};globalThis.println = println;
+const putchar = (...chars) => {
+  if (chars.length == 0) { return; };
+  if (chars.length == 1 && chars[0] === 10) { console.log(buffers[stdout]); buffers[stdout] = ''; return; }
+  if (chars.length == 1) { buffers[stdout] += utf8Decoder.decode(new Uint8Array(chars)); return; }
+  const subbuf = [];
+  for (const ch of chars) {
+    if (ch == 10) { console.log(buffers[stdout] + (subbuf.length == 0 ? '' : utf8Decoder.decode(new Uint8Array(subbuf)))); buffers[stdout] = ''; subbuf.length = 0; continue;  }
+    subbuf.push(ch);
+  }
+  if (subbuf.length == 0) return;
+  buffers[stdout] += utf8Decoder.decode(new Uint8Array(subbuf));
+};globalThis.putchar = putchar;
+const flush = () => {
+  if (buffers[stdout]) console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};globalThis.flush = flush;
+})();
+
+const answer = 42;
+function used_helper() {
+  println(answer);
+}
+function main() {
+  used_helper();
+  println(answer+1);
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,48 @@
+"use strict";
+
+(function(){
+const buffers = [];
+const stdin = buffers.push(null)-1, stdout=buffers.push('')-1, stderr=buffers.push('')-1, stdwarn=buffers.push('')-1;
+const println = (...args) => {
+  for (const arg of args) {
+    if (arg == '\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }
+    if (typeof arg === 'string' && arg.includes('\n')) {
+      const idx = arg.lastIndexOf('\n');
+      const content = buffers[stdout] + arg.substring(0, idx);
+      console.log(content);
+      buffers[stdout] = arg.substring(idx+1);
+      continue;
+    }
+    
+    buffers[stdout] += `${arg}`;
+  }
+  console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+const flush = () => {
+  if (buffers[stdout]) console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+function main() {
+  let x = 3;
+  {
+    let a$1 = x;
+    let b$1 = x-1;
+    println(a$1);
+    let c$1 = b$1-a$1;
+    println(c$1);
+  }
+  {
+    let a$2 = 7;
+    let b$2 = x;
+    println(a$2);
+    let c$2 = b$2-a$2;
+    println(c$2);
+  }
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
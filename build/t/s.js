@@ -0,0 +1,56 @@
+"use strict";
+
+(function(){
+const buffers = [];
+const stdin = buffers.push(null)-1, stdout=buffers.push('')-1, stderr=buffers.push('')-1, stdwarn=buffers.push('')-1;
+const println = (...args) => {
+  for (const arg of args) {
+    if (arg === '\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }
+    if (typeof arg === 'string' && arg.includes('\n')) {
+      const idx = arg.lastIndexOf('\n');
+      const content = buffers[stdout] + arg.substring(0, idx);
+      console.log(content);
+      buffers[stdout] = arg.substring(idx+1);
+      continue;
+    }
+    
+    buffers[stdout] += `${arg}`;
+  }
+  console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+const flush = () => {
+  if (buffers[stdout]) console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+function f(n, acc) {
+  tail: while (true) {
+    if (n === 0) {
+      return acc;
+    }
+    let k = n - 1;
+    {
+      let n = k;
+      { acc = acc + 1; continue tail; }
+    }
+    return;
+  }
+}
+function main() {
+  println(f(5, 0));
+  {
+    let n$1 = 10;
+    {
+      let k$1 = n$1 - 1;
+      let n$1 = k$1;
+      println(n$1);
+    }
+  }
+  return 0;
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,76 @@
+"use strict";
+
+(function(){
+const buffers = [];
+const stdin = buffers.push(null)-1, stdout=buffers.push('')-1, stderr=buffers.push('')-1, stdwarn=buffers.push('')-1;
+const println = (...args) => {
+  for (const arg of args) {
+    if (arg === '\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }
+    if (typeof arg === 'string' && arg.includes('\n')) {
+      const idx = arg.lastIndexOf('\n');
+      const content = buffers[stdout] + arg.substring(0, idx);
+      console.log(content);
+      buffers[stdout] = arg.substring(idx+1);
+      continue;
+    }
+    
+    buffers[stdout] += `${arg}`;
+  }
+  console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+const flush = () => {
+  if (buffers[stdout]) console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+function sum_to(n, acc) {
+  tail: while (true) {
+    if (n === 0) {
+      return acc;
+    }
+    { const n$ = n - 1, acc$ = acc + n; n = n$; acc = acc$; continue tail; }
+  }
+}
+function is_even$is_odd$tail($fn, $0) {
+  tail: while (true) {
+    switch ($fn) {
+    case 0: {
+      let n = $0;
+      if (n === 0) {
+        return 1;
+      }
+      { $0 = n - 1; $fn = 1; continue tail; }
+    }
+    case 1: {
+      let n = $0;
+      if (n === 0) {
+        return 0;
+      }
+      { $0 = n - 1; $fn = 0; continue tail; }
+    }
+    }
+  }
+}
+function is_even(n) { return is_even$is_odd$tail(0, n); }
+function is_odd(n) { return is_even$is_odd$tail(1, n); }
+function swap_down(a, b) {
+  tail: while (true) {
+    if (a <= 0) {
+      return b;
+    }
+    { const a$ = b - 1, b$ = a; a = a$; b = b$; continue tail; }
+  }
+}
+function main() {
+  println(sum_to(5000, 0));
+  println(is_even(3001));
+  println(is_odd(3001));
+  println(swap_down(10, 3));
+  return 0;
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
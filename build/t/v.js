@@ -0,0 +1,67 @@
+"use strict";
+
+(function(){
+const buffers = [];
+const stdin = buffers.push(null)-1, stdout=buffers.push('')-1, stderr=buffers.push('')-1, stdwarn=buffers.push('')-1;
+const println = (...args) => {
+  for (const arg of args) {
+    if (arg === '\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }
+    if (typeof arg === 'string' && arg.includes('\n')) {
+      const idx = arg.lastIndexOf('\n');
+      const content = buffers[stdout] + arg.substring(0, idx);
+      console.log(content);
+      buffers[stdout] = arg.substring(idx+1);
+      continue;
+    }
+    
+    buffers[stdout] += `${arg}`;
+  }
+  console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+const flush = () => {
+  if (buffers[stdout]) console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+let counter = 0;
+function sq(x) {
+  return x * x;
+}
+function add(x, y) {
+  return x + y;
+}
+function bump() {
+  counter = counter + 1;
+  return counter;
+}
+function twice_then(x, y) {
+  return y - x;
+}
+function sum_squares(n) {
+  if (n === 0) {
+    return 0;
+  }
+  return sq(n) + sum_squares(n - 1);
+}
+function main() {
+  println(sum_squares(9));
+  const y = 5;
+  println(add(y, 1));
+  println(add(1, y));
+  println(sq(sq(3)));
+  let i = 9;
+  println(sq(i + 1));
+  println(sq(bump()));
+  println(counter);
+  println(twice_then(bump(), bump()));
+  println(counter);
+  const t = 3 > 2 && sq(y + 2) === 49;
+  println(t);
+  return 0;
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,82 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+function add(a, b) {
+  return a + b;
+}
+function sum(xs) {
+  {
+    let $v1 = 0;
+    for (let $i = 0; $i < xs.length; $i++) {
+      const $it = xs[$i];
+      $v1 = add($v1, $it);
+    }
+    return $v1;
+  }
+}
+const g = Int32Array.of(10, 20, 30);
+function main() {
+  const a = Int32Array.of(3, 1, 4, 1, 5, 9, 2, 6);
+  println(a);
+  println(sum(a));
+  println(sum(g));
+  const words = ["a", "b", "c"];
+  println(words);
+  let k = 2;
+  const mixed = [k, k * 3, Int32Array.of(1, 2)];
+  println(mixed);
+  println([]);
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
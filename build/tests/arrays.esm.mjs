@@ -0,0 +1,36 @@
+import { print, $write, flush } from "./dwoc_runtime.mjs";
+
+function add(a, b) {
+  return a + b;
+}
+function sum(xs) {
+  {
+    let $v1 = 0;
+    for (let $i = 0; $i < xs.length; $i++) {
+      const $it = xs[$i];
+      $v1 = add($v1, $it);
+    }
+    return $v1;
+  }
+}
+const g = Int32Array.of(10, 20, 30);
+function main() {
+  const a = Int32Array.of(3, 1, 4, 1, 5, 9, 2, 6);
+  print(a);
+  $write("\n");
+  print((() => { let $v1 = 0; for (let $i = 0; $i < a.length; $i++) { const $it = a[$i]; $v1 = add($v1, $it); } return $v1; })());
+  $write("\n");
+  print(sum(g));
+  $write("\n");
+  const words = ["a", "b", "c"];
+  print(words);
+  $write("\n");
+  let k = 2;
+  const mixed = [k, k * 3, Int32Array.of(1, 2)];
+  print(mixed);
+  $write("\n");
+  print([]);
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,90 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const $write = outText;
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.$write = $write;
+globalThis.flush = flush;
+})();
+
+function add(a, b) {
+  return a + b;
+}
+function sum(xs) {
+  {
+    let $v1 = 0;
+    for (let $i = 0; $i < xs.length; $i++) {
+      const $it = xs[$i];
+      $v1 = add($v1, $it);
+    }
+    return $v1;
+  }
+}
+const g = Int32Array.of(10, 20, 30);
+function main() {
+  const a = Int32Array.of(3, 1, 4, 1, 5, 9, 2, 6);
+  print(a);
+  $write("\n");
+  print((() => { let $v1 = 0; for (let $i = 0; $i < a.length; $i++) { const $it = a[$i]; $v1 = add($v1, $it); } return $v1; })());
+  $write("\n");
+  print(sum(g));
+  $write("\n");
+  const words = ["a", "b", "c"];
+  print(words);
+  $write("\n");
+  let k = 2;
+  const mixed = [k, k * 3, Int32Array.of(1, 2)];
+  print(mixed);
+  $write("\n");
+  print([]);
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
+//# sourceMappingURL=arrays.map.js.map
@@ -0,0 +1 @@
+"use strict";(function(){const j=require('node:fs');const q=new TextEncoder();const b=new Uint8Array(65536);let a=0;let k=10;const f=()=>{let g=0;while(g<a){try{g+=j.writeSync(1,b,g,a-g);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)k=b[a-1];a=0;};process.on('exit',f);const s=(byte)=>{if(a===b.length)f();b[a++]=byte;};const l=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=q.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);f();}};const m=(...t)=>{for(const h of t)l(typeof h==='string'?h:`${h}`);};const o=l;const p=()=>{if((a>0?b[a-1]:k)!==10)s(10);f();};globalThis.print=m;globalThis.$write=o;globalThis.flush=p;})();function add(a,b){return a+b;}function sum(a){{let $v1=0;for(let $i=0;$i<a.length;$i++){const $it=a[$i];$v1=add($v1,$it);}return $v1;}}const g=Int32Array.of(10,20,30);function main(){const a=Int32Array.of(3,1,4,1,5,9,2,6);print(a);$write("\n");print((()=>{let $v1=0;for(let $i=0;$i<a.length;$i++){const $it=a[$i];$v1=add($v1,$it);}return $v1;})());$write("\n");print(sum(g));$write("\n");const c=["a","b","c"];print(c);$write("\n");let b=2;const d=[b,b*3,Int32Array.of(1,2)];print(d);$write("\n");print([]);$write("\n");}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1,149 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+(function(){
+const fs = require('node:fs');
+const fs_buffer = (size) => new Uint8Array(size);
+const fs_open = (path, flags = 'r') => {
+  try { return fs.openSync(path, flags); } catch { return -1; }
+};
+const fs_close = (fd) => { fs.closeSync(fd); };
+const ioPending = new Map();
+const ioBusy = new Set();
+let ioScheduled = false;
+const ioSchedule = () => {
+  if (ioScheduled) return;
+  ioScheduled = true;
+  setImmediate(ioFlush);
+};
+const ioFlush = () => {
+  ioScheduled = false;
+  for (const [fd, writes] of ioPending) {
+    if (ioBusy.has(fd)) continue;
+    ioPending.delete(fd);
+    ioBusy.add(fd);
+    ioWritev(fd, writes);
+  }
+};
+const ioWritev = (fd, writes) => {
+  const chunks = writes.map((write) => write.bytes);
+  const next = (err, written) => {
+    if (err && err.code === 'EAGAIN') return fs.writev(fd, chunks, next);
+    if (!err) {
+      while (written > 0 && chunks.length > 0) {
+        if (written < chunks[0].byteLength) { chunks[0] = chunks[0].subarray(written); break; }
+        written -= chunks[0].byteLength;
+        chunks.shift();
+      }
+      if (chunks.length > 0) return fs.writev(fd, chunks, next);
+    }
+    for (const write of writes) {
+      if (err) write.fail(err); else write.done(write.bytes.byteLength);
+    }
+    ioBusy.delete(fd);
+    if (ioPending.has(fd)) ioSchedule();
+  };
+  fs.writev(fd, chunks, next);
+};
+const fs_write_async = (fd, data, count) => new Promise((resolve, reject) => {
+  if (typeof data === 'string') data = Buffer.from(data);
+  else data = new Uint8Array(data.buffer, data.byteOffset, count === undefined ? data.byteLength : count);
+  const queue = ioPending.get(fd);
+  const write = { bytes: data, done: resolve, fail: reject };
+  if (queue === undefined) ioPending.set(fd, [write]); else queue.push(write);
+  ioSchedule();
+});
+const fs_read_async = (fd, buf) => new Promise((resolve, reject) => {
+  fs.read(fd, buf, 0, buf.byteLength, null, (err, n) => err ? reject(err) : resolve(n));
+});
+const fs_read_file_async = (path) => fs.promises.readFile(path);
+const fs_write_file_async = (path, data) => fs.promises.writeFile(path, data).then(() => typeof data === 'string' ? Buffer.byteLength(data) : data.byteLength);
+globalThis.fs_buffer = fs_buffer;
+globalThis.fs_open = fs_open;
+globalThis.fs_close = fs_close;
+globalThis.fs_write_async = fs_write_async;
+globalThis.fs_read_async = fs_read_async;
+globalThis.fs_read_file_async = fs_read_file_async;
+globalThis.fs_write_file_async = fs_write_file_async;
+})();
+
+async function twice(x) {
+  return x * 2;
+}
+async function main() {
+  const a = (await twice(21));
+  println(a);
+  const fd = fs_open("as_out.txt", "w");
+  const w1 = fs_write_async(fd, "one\n");
+  const w2 = fs_write_async(fd, "two\n");
+  const n = (await w1);
+  const m = (await w2);
+  (await fs_write_async(fd, "three\n"));
+  fs_close(fd);
+  println(n + m);
+  const data = (await fs_read_file_async("as_out.txt"));
+  print(data);
+  const k = (await fs_write_file_async("as_out2.txt", "hey"));
+  println(k);
+  const fd2 = fs_open("as_out2.txt");
+  const buf = fs_buffer(16);
+  println((await fs_read_async(fd2, buf)));
+  return 0;
+}
+
+main().then((r) => { flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } });
@@ -0,0 +1 @@
+"use strict";(function(){const l=require('node:fs');const u=new TextEncoder();const b=new Uint8Array(65536);let a=0;let m=10;const g=()=>{let h=0;while(h<a){try{h+=l.writeSync(1,b,h,a-h);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)m=b[a-1];a=0;};process.on('exit',g);const o=(byte)=>{if(a===b.length)g();b[a++]=byte;};const j=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=u.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);g();}};const p=(...k)=>{for(const f of k)j(typeof f==='string'?f:`${f}`);};const q=(...k)=>{for(const f of k)j(typeof f==='string'?f:`${f}`);o(10);};const s=j;const t=()=>{if((a>0?b[a-1]:m)!==10)o(10);g();};globalThis.print=p;globalThis.println=q;globalThis.$write=s;globalThis.flush=t;})();(function(){const d=require('node:fs');const j=(w)=>new Uint8Array(w);const k=(e,x='r')=>{try{return d.openSync(e,x);}catch{return-1;}};const l=(a)=>{d.closeSync(a);};const f=new Map();const h=new Set();let i=false;const m=()=>{if(i)return;i=true;setImmediate(y);};const y=()=>{i=false;for(const[a,g]of f){if(h.has(a))continue;f.delete(a);h.add(a);z(a,g);}};const z=(a,g)=>{const c=g.map((write)=>write.bytes);const next=(err,written)=>{if(err&&err.code==='EAGAIN')return d.writev(a,c,next);if(!err){while(written>0&&c.length>0){if(written<c[0].byteLength){c[0]=c[0].subarray(written);break;}written-=c[0].byteLength;c.shift();}if(c.length>0)return d.writev(a,c,next);}for(const write of g){if(err)write.fail(err);else write.done(write.bytes.byteLength);}h.delete(a);if(f.has(a))m();};d.writev(a,c,next);};const o=(a,b,p)=>new Promise((resolve,reject)=>{if(typeof b==='string')b=Buffer.from(b);else b=new Uint8Array(b.buffer,b.byteOffset,p===undefined?b.byteLength:p);const q=f.get(a);const write={bytes:b,done:resolve,fail:reject};if(q===undefined)f.set(a,[write]);else q.push(write);m();});const s=(a,t)=>new Promise((resolve,reject)=>{d.read(a,t,0,t.byteLength,null,(err,n)=>err?reject(err):resolve(n));});const u=(e)=>d.promises.readFile(e);const v=(e,b)=>d.promises.writeFile(e,b).then(()=>typeof b==='string'?Buffer.byteLength(b):b.byteLength);globalThis.fs_buffer=j;globalThis.fs_open=k;globalThis.fs_close=l;globalThis.fs_write_async=o;globalThis.fs_read_async=s;globalThis.fs_read_file_async=u;globalThis.fs_write_file_async=v;})();async function twice(a){return a*2;}async function main(){const b=(await twice(21));print(b);$write("\n");const a=fs_open("as_out.txt","w");const c=fs_write_async(a,"one\n");const d=fs_write_async(a,"two\n");const e=(await c);const f=(await d);(await fs_write_async(a,"three\n"));fs_close(a);print(e+f);$write("\n");const g=(await fs_read_file_async("as_out.txt"));print(g);const h=(await fs_write_file_async("as_out2.txt","hey"));print(h);$write("\n");const i=fs_open("as_out2.txt");const j=fs_buffer(16);println((await fs_read_async(i,j)));return 0;}main().then((r)=>{flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}});
\ No newline at end of file
@@ -0,0 +1,32 @@
+import { print, println, $write, flush } from "./dwoc_runtime.mjs";
+
+import { fs_buffer, fs_open, fs_close, fs_write_async, fs_read_async, fs_read_file_async, fs_write_file_async } from "./dwoc_runtime.mjs";
+
+async function twice(x) {
+  return x * 2;
+}
+async function main() {
+  const a = (await twice(21));
+  print(a);
+  $write("\n");
+  const fd = fs_open("as_out.txt", "w");
+  const w1 = fs_write_async(fd, "one\n");
+  const w2 = fs_write_async(fd, "two\n");
+  const n = (await w1);
+  const m = (await w2);
+  (await fs_write_async(fd, "three\n"));
+  fs_close(fd);
+  print(n + m);
+  $write("\n");
+  const data = (await fs_read_file_async("as_out.txt"));
+  print(data);
+  const k = (await fs_write_file_async("as_out2.txt", "hey"));
+  print(k);
+  $write("\n");
+  const fd2 = fs_open("as_out2.txt");
+  const buf = fs_buffer(16);
+  println((await fs_read_async(fd2, buf)));
+  return 0;
+}
+
+main().then((r) => { flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } });
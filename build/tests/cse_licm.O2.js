@@ -0,0 +1,99 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const $write = outText;
+const $writeNumber = (n) => {
+  if ((n | 0) !== n) { outText(`${n}`); return; }
+  if (outLength + 11 > outBytes.length) outDrain();
+  if (n < 0) { outBytes[outLength++] = 45; n = -n; }
+  let end = outLength + 1;
+  for (let rest = n; rest >= 10; rest = (rest / 10) | 0) end += 1;
+  outLength = end;
+  do { outBytes[--end] = 48 + n % 10; n = (n / 10) | 0; } while (n > 0);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.$write = $write;
+globalThis.$writeNumber = $writeNumber;
+globalThis.flush = flush;
+})();
+
+function main() {
+  let a = 7;
+  let b = 3;
+  const $cse2 = a * b;
+  const $cse1 = $cse2 + a;
+  let x = $cse1 * 2;
+  let y = $cse1 * 3;
+  $writeNumber(x + y);
+  $write("\n");
+  let i = 0;
+  let total = 0;
+  const $licm1 = $cse2 * 4;
+  while (i < 10) {
+    total = total + $licm1;
+    i = i + 1;
+  }
+  print(total);
+  $write("\n");
+  let j = 0;
+  let acc = 0;
+  while (j < 5) {
+    acc = acc + j * b;
+    j = j + 1;
+  }
+  $writeNumber(acc);
+  $write("\n");
+  let c = $cse2;
+  a = a + 1;
+  let d = a * b;
+  $writeNumber(c + d);
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
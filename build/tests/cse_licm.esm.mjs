@@ -0,0 +1,36 @@
+import { print, $write, $writeNumber, flush } from "./dwoc_runtime.mjs";
+
+function main() {
+  let a = 7;
+  let b = 3;
+  const $cse2 = a * b;
+  const $cse1 = $cse2 + a;
+  let x = $cse1 * 2;
+  let y = $cse1 * 3;
+  $writeNumber(x + y);
+  $write("\n");
+  let i = 0;
+  let total = 0;
+  const $licm1 = $cse2 * 4;
+  while (i < 10) {
+    total = total + $licm1;
+    i = i + 1;
+  }
+  print(total);
+  $write("\n");
+  let j = 0;
+  let acc = 0;
+  while (j < 5) {
+    acc = acc + j * b;
+    j = j + 1;
+  }
+  $writeNumber(acc);
+  $write("\n");
+  let c = $cse2;
+  a = a + 1;
+  let d = a * b;
+  $writeNumber(c + d);
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,9 @@
+import { $write, flush } from "./dwoc_runtime.mjs";
+
+function main() {
+  $write("2880067194370816000\n123456789000000000000\n123456789000000000000\n");
+  const f = 102334154;
+  $write("102334154\n9007199254740991\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
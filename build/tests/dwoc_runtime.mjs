@@ -0,0 +1,348 @@
+// Generated by dwoc, shared by the programs compiled with --esm next to it
+import * as fs from 'node:fs';
+const utf8Encoder = new TextEncoder();
+const stdin = 0, stdout = 1, stderr = 2, stdwarn = 3;
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+let inBytes = Buffer.allocUnsafe(65536);
+let inStart = 0, inEnd = 0, inEof = false;
+let inMissed = false;
+const inFill = () => {
+  if (inEof) return false;
+  if (inStart > 0) { inBytes.copyWithin(0, inStart, inEnd); inEnd -= inStart; inStart = 0; }
+  if (inEnd === inBytes.length) {
+    const grown = Buffer.allocUnsafe(inBytes.length * 2);
+    inBytes.copy(grown, 0, 0, inEnd);
+    inBytes = grown;
+  }
+  for (;;) {
+    try {
+      const n = fs.readSync(0, inBytes, inEnd, inBytes.length - inEnd, null);
+      if (n === 0) break;
+      inEnd += n;
+      return true;
+    } catch (e) {
+      if (e.code === 'EOF') break;
+      if (e.code !== 'EAGAIN') throw e;
+    }
+  }
+  inEof = true;
+  return false;
+};
+const read_byte = () => {
+  inMissed = inStart === inEnd && !inFill();
+  return inMissed ? -1 : inBytes[inStart++];
+};
+const read_line = () => {
+  let scan = inStart;
+  for (;;) {
+    const nl = inBytes.indexOf(10, scan);
+    if (nl !== -1 && nl < inEnd) {
+      const end = nl > inStart && inBytes[nl - 1] === 13 ? nl - 1 : nl;
+      const line = inBytes.toString('utf8', inStart, end);
+      inStart = nl + 1;
+      inMissed = false;
+      return line;
+    }
+    scan = inEnd - inStart;
+    if (!inFill()) break;
+  }
+  inMissed = inStart === inEnd;
+  if (inMissed) return -1;
+  const line = inBytes.toString('utf8', inStart, inEnd);
+  inStart = inEnd;
+  return line;
+};
+const read_int = () => {
+  let b = read_byte();
+  while (b === 32 || (b >= 9 && b <= 13)) b = read_byte();
+  if (b === -1) return 0;
+  let sign = 1;
+  if (b === 45 || b === 43) { if (b === 45) sign = -1; b = read_byte(); }
+  let n = 0;
+  while (b >= 48 && b <= 57) { n = n * 10 + (b - 48); b = read_byte(); }
+  if (b !== -1) inStart -= 1;
+  inMissed = false;
+  return sign * n;
+};
+const read_all = () => {
+  while (inFill()) {}
+  const all = inBytes.toString('utf8', inStart, inEnd);
+  inStart = inEnd;
+  inMissed = all.length === 0;
+  return all;
+};
+const eof = () => inMissed ? 1 : 0;
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const putchar = (...chars) => {
+  for (const ch of chars) outByte(ch);
+};
+const putchars = (...chars) => {
+  putchar(...chars);
+  return chars.length;
+};
+const $write = outText;
+const $writeNumber = (n) => {
+  if ((n | 0) !== n) { outText(`${n}`); return; }
+  if (outLength + 11 > outBytes.length) outDrain();
+  if (n < 0) { outBytes[outLength++] = 45; n = -n; }
+  let end = outLength + 1;
+  for (let rest = n; rest >= 10; rest = (rest / 10) | 0) end += 1;
+  outLength = end;
+  do { outBytes[--end] = 48 + n % 10; n = (n / 10) | 0; } while (n > 0);
+};
+const $drain = () => outDrain();
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+const fs_buffer = (size) => new Uint8Array(size);
+const fs_open = (path, flags = 'r') => {
+  try { return fs.openSync(path, flags); } catch { return -1; }
+};
+const fs_close = (fd) => { fs.closeSync(fd); };
+const fs_size = (fd) => fs.fstatSync(fd).size;
+const fs_read = (fd, buf, count = buf.byteLength) => {
+  for (;;) {
+    try { return fs.readSync(fd, buf, 0, count, null); }
+    catch (e) { if (e.code === 'EOF') return 0; if (e.code !== 'EAGAIN') throw e; }
+  }
+};
+const fs_write = (fd, data, count) => {
+  if (typeof data === 'string') data = Buffer.from(data);
+  if (count === undefined) count = data.byteLength;
+  let offset = 0;
+  while (offset < count) {
+    try { offset += fs.writeSync(fd, data, offset, count - offset); }
+    catch (e) { if (e.code !== 'EAGAIN') throw e; }
+  }
+  return count;
+};
+const fs_chunks = (fd, buf) => {
+  const step = { value: 0, done: false };
+  return {
+    next() { step.value = fs_read(fd, buf); step.done = step.value === 0; return step; },
+    [Symbol.iterator]() { return this; },
+  };
+};
+const fs_read_file = (path) => fs.readFileSync(path);
+const ioPending = new Map();
+const ioBusy = new Set();
+let ioScheduled = false;
+const ioSchedule = () => {
+  if (ioScheduled) return;
+  ioScheduled = true;
+  setImmediate(ioFlush);
+};
+const ioFlush = () => {
+  ioScheduled = false;
+  for (const [fd, writes] of ioPending) {
+    if (ioBusy.has(fd)) continue;
+    ioPending.delete(fd);
+    ioBusy.add(fd);
+    ioWritev(fd, writes);
+  }
+};
+const ioWritev = (fd, writes) => {
+  const chunks = writes.map((write) => write.bytes);
+  const next = (err, written) => {
+    if (err && err.code === 'EAGAIN') return fs.writev(fd, chunks, next);
+    if (!err) {
+      while (written > 0 && chunks.length > 0) {
+        if (written < chunks[0].byteLength) { chunks[0] = chunks[0].subarray(written); break; }
+        written -= chunks[0].byteLength;
+        chunks.shift();
+      }
+      if (chunks.length > 0) return fs.writev(fd, chunks, next);
+    }
+    for (const write of writes) {
+      if (err) write.fail(err); else write.done(write.bytes.byteLength);
+    }
+    ioBusy.delete(fd);
+    if (ioPending.has(fd)) ioSchedule();
+  };
+  fs.writev(fd, chunks, next);
+};
+const fs_write_async = (fd, data, count) => new Promise((resolve, reject) => {
+  if (typeof data === 'string') data = Buffer.from(data);
+  else data = new Uint8Array(data.buffer, data.byteOffset, count === undefined ? data.byteLength : count);
+  const queue = ioPending.get(fd);
+  const write = { bytes: data, done: resolve, fail: reject };
+  if (queue === undefined) ioPending.set(fd, [write]); else queue.push(write);
+  ioSchedule();
+});
+const fs_read_async = (fd, buf) => new Promise((resolve, reject) => {
+  fs.read(fd, buf, 0, buf.byteLength, null, (err, n) => err ? reject(err) : resolve(n));
+});
+const fs_read_file_async = (path) => fs.promises.readFile(path);
+const fs_write_file_async = (path, data) => fs.promises.writeFile(path, data).then(() => typeof data === 'string' ? Buffer.byteLength(data) : data.byteLength);
+import * as os from 'node:os';
+import * as worker_threads from 'node:worker_threads';
+const par = { entry: null, fns: [], drain: null, globals: null, pool: null };
+const parWork = (job) => {
+  const fn = par.fns[job.task];
+  for (;;) {
+    const start = Atomics.load(job.ctl, 0);
+    if (start >= job.n) return;
+    const end = Math.min(job.n, start + Math.ceil((job.n - start) / (2 * job.threads)));
+    if (Atomics.compareExchange(job.ctl, 0, start, end) !== start) continue;
+    if (job.output === null) {
+      for (let i = start; i < end; ++i) fn(i);
+      continue;
+    }
+    for (let i = start; i < end; ++i) {
+      const value = fn(job.input[i]);
+      if (typeof value !== 'number') throw new Error(`par_map: ${fn.name} has to return numbers, got ${value}`);
+      job.output[i] = value;
+    }
+  }
+};
+const parPool = () => {
+  if (par.pool !== null) return par.pool;
+  const env = Number(process.env.DWOC_PAR_THREADS);
+  const threads = env > 0 ? env : os.availableParallelism ? os.availableParallelism() : os.cpus().length;
+  par.pool = [];
+  const globals = par.globals();
+  for (let i = 1; i < threads; ++i) {
+    const worker = new worker_threads.Worker(par.entry, { workerData: { dwocPar: true, globals: globals } });
+    worker.unref();
+    par.pool.push(worker);
+  }
+  return par.pool;
+};
+const parShare = (items) => {
+  if (ArrayBuffer.isView(items) && items.buffer instanceof SharedArrayBuffer) return items;
+  let shared = null;
+  if (ArrayBuffer.isView(items)) {
+    shared = new (items instanceof Buffer ? Uint8Array : items.constructor)(new SharedArrayBuffer(items.byteLength));
+  } else {
+    for (const item of items) if (typeof item !== 'number') return items;
+    shared = new Float64Array(new SharedArrayBuffer(items.length * 8));
+  }
+  shared.set(items);
+  return shared;
+};
+const parRun = (fn, n, input, output) => {
+  const task = par.fns.indexOf(fn);
+  if (task === -1) throw new Error(`core:par: ${fn.name} was not compiled as a worker entry point`);
+  const pool = parPool();
+  const job = { task: task, n: n, input: input, output: output, threads: pool.length + 1, ctl: new Int32Array(new SharedArrayBuffer(12)) };
+  for (const worker of pool) worker.postMessage(job);
+  let failure = null;
+  try { parWork(job); } catch (e) { failure = e; Atomics.store(job.ctl, 0, n); }
+  for (;;) {
+    const done = Atomics.load(job.ctl, 1);
+    if (done === pool.length) break;
+    Atomics.wait(job.ctl, 1, done);
+  }
+  if (failure !== null) throw failure;
+  if (Atomics.load(job.ctl, 2) !== 0) throw new Error('core:par: a worker failed');
+};
+const $parGlobal = (index, init) => {
+  if (worker_threads.isMainThread || !worker_threads.workerData || !worker_threads.workerData.dwocPar) return init();
+  return worker_threads.workerData.globals[index];
+};
+const $parEntry = (file, table, drain, globals) => {
+  par.entry = file;
+  par.fns = table;
+  par.drain = drain;
+  par.globals = globals;
+  if (worker_threads.isMainThread || !worker_threads.workerData || !worker_threads.workerData.dwocPar) return false;
+  worker_threads.parentPort.on('message', (job) => {
+    try { parWork(job); }
+    catch (e) {
+      Atomics.store(job.ctl, 2, 1);
+      Atomics.store(job.ctl, 0, job.n);
+      fs.writeSync(2, `${e && e.stack || e}\n`);
+    } finally {
+      if (par.drain !== null) par.drain();
+      Atomics.add(job.ctl, 1, 1);
+      Atomics.notify(job.ctl, 1);
+    }
+  });
+  return true;
+};
+const par_map = (fn, items) => {
+  if (!ArrayBuffer.isView(items) && !Array.isArray(items)) items = Array.from(items);
+  const workers = parPool().length;
+  const results = new Float64Array(workers > 0 ? new SharedArrayBuffer(items.length * 8) : items.length);
+  parRun(fn, items.length, workers > 0 ? parShare(items) : items, results);
+  return results;
+};
+const par_for = (count, fn) => { parRun(fn, count, null, null); };
+export {
+  stdin,
+  stdout,
+  stderr,
+  stdwarn,
+  read_byte,
+  read_line,
+  read_int,
+  read_all,
+  eof,
+  print,
+  println,
+  putchar,
+  putchars,
+  $write,
+  $writeNumber,
+  $drain,
+  flush,
+  fs_buffer,
+  fs_open,
+  fs_close,
+  fs_size,
+  fs_read,
+  fs_write,
+  fs_chunks,
+  fs_read_file,
+  fs_write_async,
+  fs_read_async,
+  fs_read_file_async,
+  fs_write_file_async,
+  $parGlobal,
+  $parEntry,
+  par_map,
+  par_for,
+};
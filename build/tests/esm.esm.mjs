@@ -0,0 +1,14 @@
+import { $write, flush } from "./dwoc_runtime.mjs";
+
+function main() {
+  let who = "modules";
+  {
+    let name$1 = who;
+    $write("hello ");
+    $write(name$1);
+    $write("\n");
+  }
+  $write("42\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1 @@
+"use strict";(function(){const o=require('node:fs');const x=new TextEncoder();const d=new Uint8Array(65536);let a=0;let p=10;const h=()=>{let k=0;while(k<a){try{k+=o.writeSync(1,d,k,a-k);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)p=d[a-1];a=0;};process.on('exit',h);const q=(byte)=>{if(a===d.length)h();d[a++]=byte;};const j=(f)=>{const b=f.length;if(b<=d.length-a){let i=0;for(;i<b;++i){const c=f.charCodeAt(i);if(c>=128)break;d[a++]=c;}if(i===b)return;f=f.substring(i);}for(;;){const r=x.encodeInto(f,d.subarray(a));a+=r.written;if(r.read===f.length)return;f=f.substring(r.read);h();}};const s=(...l)=>{for(const g of l)j(typeof g==='string'?g:`${g}`);};const t=(...l)=>{for(const g of l)j(typeof g==='string'?g:`${g}`);q(10);};const u=j;const v=(b)=>{if((b|0)!==b){j(`${b}`);return;}if(a+11>d.length)h();if(b<0){d[a++]=45;b=-b;}let n=a+1;for(let m=b;m>=10;m=(m/10)|0)n+=1;a=n;do{d[--n]=48+b%10;b=(b/10)|0;}while(b>0);};const w=()=>{if((a>0?d[a-1]:p)!==10)q(10);h();};globalThis.print=s;globalThis.println=t;globalThis.$write=u;globalThis.$writeNumber=v;globalThis.flush=w;})();(function(){const b=require('node:fs');const k=(l)=>new Uint8Array(l);const m=(i,t='r')=>{try{return b.openSync(i,t);}catch{return-1;}};const n=(a)=>{b.closeSync(a);};const o=(a)=>b.fstatSync(a).size;const j=(a,f,c=f.byteLength)=>{for(;;){try{return b.readSync(a,f,0,c,null);}catch(e){if(e.code==='EOF')return 0;if(e.code!=='EAGAIN')throw e;}}};const p=(a,d,c)=>{if(typeof d==='string')d=Buffer.from(d);if(c===undefined)c=d.byteLength;let g=0;while(g<c){try{g+=b.writeSync(a,d,g,c-g);}catch(e){if(e.code!=='EAGAIN')throw e;}}return c;};const q=(a,f)=>{const h={value:0,done:false};return{next(){h.value=j(a,f);h.done=h.value===0;return h;},[Symbol.iterator](){return this;},};};const s=(i)=>b.readFileSync(i);globalThis.fs_buffer=k;globalThis.fs_open=m;globalThis.fs_close=n;globalThis.fs_size=o;globalThis.fs_read=j;globalThis.fs_write=p;globalThis.fs_chunks=q;globalThis.fs_read_file=s;})();function main(){const out=fs_open("fs_out.txt","w");fs_write(out,"héllo\nworld\n");const a=fs_buffer(4);fs_write(out,"AB");fs_close(out);const e=fs_open("fs_out.txt");println("size ",fs_size(e));let f=0;let g=0;for(const b of fs_chunks(e,a)){g=g+1;let c=0;while(c<b){if(a[c]===10){f=f+1;}c=c+1;}}fs_close(e);$write("chunks ");$writeNumber(g);$write(" newlines ");$writeNumber(f);$write("\n");const h=fs_read_file("fs_out.txt");let i=0;for(const l of h){i=i+1;}$write("bytes ");$writeNumber(i);$write(" first ");print(h[0]);$write(" slice ");print(h.slice(1,3));$write("\n");const d=fs_open("fs_out.txt");let k=fs_read(d,a);let j=0;let b=fs_read(d,a);while(b>0){j=j+b;b=fs_read(d,a);}fs_close(d);$write("read ");print(k);$write(" then ");print(j);$write("\n");println("missing ",fs_open("nope/nope.txt"));}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
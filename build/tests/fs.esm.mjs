@@ -0,0 +1,60 @@
+import { print, println, $write, $writeNumber, flush } from "./dwoc_runtime.mjs";
+
+import { fs_buffer, fs_open, fs_close, fs_size, fs_read, fs_write, fs_chunks, fs_read_file } from "./dwoc_runtime.mjs";
+
+function main() {
+  const out = fs_open("fs_out.txt", "w");
+  fs_write(out, "héllo\nworld\n");
+  const buf = fs_buffer(4);
+  fs_write(out, "AB");
+  fs_close(out);
+  const fd = fs_open("fs_out.txt");
+  println("size ", fs_size(fd));
+  let newlines = 0;
+  let chunks = 0;
+  for (const n of fs_chunks(fd, buf)) {
+    chunks = chunks + 1;
+    let i = 0;
+    while (i < n) {
+      if (buf[i] === 10) {
+        newlines = newlines + 1;
+      }
+      i = i + 1;
+    }
+  }
+  fs_close(fd);
+  $write("chunks ");
+  $writeNumber(chunks);
+  $write(" newlines ");
+  $writeNumber(newlines);
+  $write("\n");
+  const all = fs_read_file("fs_out.txt");
+  let count = 0;
+  for (const b of all) {
+    count = count + 1;
+  }
+  $write("bytes ");
+  $writeNumber(count);
+  $write(" first ");
+  print(all[0]);
+  $write(" slice ");
+  print(all.slice(1, 3));
+  $write("\n");
+  const again = fs_open("fs_out.txt");
+  let first = fs_read(again, buf);
+  let rest = 0;
+  let n = fs_read(again, buf);
+  while (n > 0) {
+    rest = rest + n;
+    n = fs_read(again, buf);
+  }
+  fs_close(again);
+  $write("read ");
+  print(first);
+  $write(" then ");
+  print(rest);
+  $write("\n");
+  println("missing ", fs_open("nope/nope.txt"));
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,169 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const $write = outText;
+const $writeNumber = (n) => {
+  if ((n | 0) !== n) { outText(`${n}`); return; }
+  if (outLength + 11 > outBytes.length) outDrain();
+  if (n < 0) { outBytes[outLength++] = 45; n = -n; }
+  let end = outLength + 1;
+  for (let rest = n; rest >= 10; rest = (rest / 10) | 0) end += 1;
+  outLength = end;
+  do { outBytes[--end] = 48 + n % 10; n = (n / 10) | 0; } while (n > 0);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.println = println;
+globalThis.$write = $write;
+globalThis.$writeNumber = $writeNumber;
+globalThis.flush = flush;
+})();
+
+(function(){
+const fs = require('node:fs');
+const fs_buffer = (size) => new Uint8Array(size);
+const fs_open = (path, flags = 'r') => {
+  try { return fs.openSync(path, flags); } catch { return -1; }
+};
+const fs_close = (fd) => { fs.closeSync(fd); };
+const fs_size = (fd) => fs.fstatSync(fd).size;
+const fs_read = (fd, buf, count = buf.byteLength) => {
+  for (;;) {
+    try { return fs.readSync(fd, buf, 0, count, null); }
+    catch (e) { if (e.code === 'EOF') return 0; if (e.code !== 'EAGAIN') throw e; }
+  }
+};
+const fs_write = (fd, data, count) => {
+  if (typeof data === 'string') data = Buffer.from(data);
+  if (count === undefined) count = data.byteLength;
+  let offset = 0;
+  while (offset < count) {
+    try { offset += fs.writeSync(fd, data, offset, count - offset); }
+    catch (e) { if (e.code !== 'EAGAIN') throw e; }
+  }
+  return count;
+};
+const fs_chunks = (fd, buf) => {
+  const step = { value: 0, done: false };
+  return {
+    next() { step.value = fs_read(fd, buf); step.done = step.value === 0; return step; },
+    [Symbol.iterator]() { return this; },
+  };
+};
+const fs_read_file = (path) => fs.readFileSync(path);
+globalThis.fs_buffer = fs_buffer;
+globalThis.fs_open = fs_open;
+globalThis.fs_close = fs_close;
+globalThis.fs_size = fs_size;
+globalThis.fs_read = fs_read;
+globalThis.fs_write = fs_write;
+globalThis.fs_chunks = fs_chunks;
+globalThis.fs_read_file = fs_read_file;
+})();
+
+function main() {
+  const out = fs_open("fs_out.txt", "w");
+  fs_write(out, "héllo\nworld\n");
+  const buf = fs_buffer(4);
+  fs_write(out, "AB");
+  fs_close(out);
+  const fd = fs_open("fs_out.txt");
+  println("size ", fs_size(fd));
+  let newlines = 0;
+  let chunks = 0;
+  for (const n of fs_chunks(fd, buf)) {
+    chunks = chunks + 1;
+    let i = 0;
+    while (i < n) {
+      if (buf[i] === 10) {
+        newlines = newlines + 1;
+      }
+      i = i + 1;
+    }
+  }
+  fs_close(fd);
+  $write("chunks ");
+  $writeNumber(chunks);
+  $write(" newlines ");
+  $writeNumber(newlines);
+  $write("\n");
+  const all = fs_read_file("fs_out.txt");
+  let count = 0;
+  for (const b of all) {
+    count = count + 1;
+  }
+  $write("bytes ");
+  $writeNumber(count);
+  $write(" first ");
+  print(all[0]);
+  $write(" slice ");
+  print(all.slice(1, 3));
+  $write("\n");
+  const again = fs_open("fs_out.txt");
+  let first = fs_read(again, buf);
+  let rest = 0;
+  let n = fs_read(again, buf);
+  while (n > 0) {
+    rest = rest + n;
+    n = fs_read(again, buf);
+  }
+  fs_close(again);
+  $write("read ");
+  print(first);
+  $write(" then ");
+  print(rest);
+  $write("\n");
+  println("missing ", fs_open("nope/nope.txt"));
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
+//# sourceMappingURL=fs.map.js.map
@@ -0,0 +1 @@
+"use strict";(function(){const j=require('node:fs');const q=new TextEncoder();const b=new Uint8Array(65536);let a=0;let k=10;const f=()=>{let g=0;while(g<a){try{g+=j.writeSync(1,b,g,a-g);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)k=b[a-1];a=0;};process.on('exit',f);const s=(byte)=>{if(a===b.length)f();b[a++]=byte;};const l=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=q.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);f();}};const m=(...t)=>{for(const h of t)l(typeof h==='string'?h:`${h}`);};const o=l;const p=()=>{if((a>0?b[a-1]:k)!==10)s(10);f();};globalThis.print=m;globalThis.$write=o;globalThis.flush=p;})();function*range(b,c){let a=b;while(a<c){yield a;a=a+1;}}function*evens_until(b){let a=0;while(1){if(a>b){return;}if(a%2===0){yield a;}else{const c=a;}a=a+1;}}function*pairs(a){for(const b of range(0,a)){for(const c of range(b,a)){yield b*10+c;}}}function main(){let a=0;for(const b of range(1,5)){a=a+b;print(b);$write(",");}print(a);$write("\n");for(const c of evens_until(9)){print(c);$write(" ");}$write("\n");for(const d of pairs(3)){print(d);$write(" ");}$write("\n");for(const e of Int32Array.of(7,8,9)){print(e);}$write("\n");}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1,122 @@
+import { print, $write, flush } from "./dwoc_runtime.mjs";
+
+function range(lo, hi) {
+  let $state = 0;
+  let i;
+  const $step = { value: undefined, done: false };
+  return {
+    next() {
+      for (;;) {
+        switch ($state) {
+          case 0:
+            i = lo;
+          case 1:
+            if (!(i < hi)) { $state = 2; continue; }
+            $step.value = i;
+            $state = 3; return $step;
+          case 3:
+            i = i + 1;
+            $state = 1; continue;
+          case 2:
+            $state = -1;
+          default:
+            $step.value = undefined; $step.done = true; return $step;
+        }
+      }
+    },
+    [Symbol.iterator]() { return this; },
+  };
+}
+function evens_until(limit) {
+  let $state = 0;
+  let n, skipped;
+  const $step = { value: undefined, done: false };
+  return {
+    next() {
+      for (;;) {
+        switch ($state) {
+          case 0:
+            n = 0;
+          case 1:
+            if (!(1)) { $state = 2; continue; }
+            if (!(n > limit)) { $state = 3; continue; }
+            $step.value = undefined;
+            $step.done = true; $state = -1; return $step;
+          case 3:
+            if (!(n % 2 === 0)) { $state = 4; continue; }
+            $step.value = n;
+            $state = 6; return $step;
+          case 6:
+            $state = 5; continue;
+          case 4:
+            skipped = n;
+          case 5:
+            n = n + 1;
+            $state = 1; continue;
+          case 2:
+            $state = -1;
+          default:
+            $step.value = undefined; $step.done = true; return $step;
+        }
+      }
+    },
+    [Symbol.iterator]() { return this; },
+  };
+}
+function pairs(k) {
+  let $state = 0;
+  let $iter1, a, $iter2, b;
+  const $step = { value: undefined, done: false };
+  return {
+    next() {
+      for (;;) {
+        switch ($state) {
+          case 0:
+            $iter1 = (range(0, k))[Symbol.iterator]();
+          case 1:
+            { const $next = $iter1.next(); if ($next.done) { $state = 2; continue; } a = $next.value; }
+            $iter2 = (range(a, k))[Symbol.iterator]();
+          case 3:
+            { const $next = $iter2.next(); if ($next.done) { $state = 4; continue; } b = $next.value; }
+            $step.value = a * 10 + b;
+            $state = 5; return $step;
+          case 5:
+            $state = 3; continue;
+          case 4:
+            $state = 1; continue;
+          case 2:
+            $state = -1;
+          default:
+            $step.value = undefined; $step.done = true; return $step;
+        }
+      }
+    },
+    [Symbol.iterator]() { return this; },
+  };
+}
+function main() {
+  let total = 0;
+  for (const x of range(1, 5)) {
+    total = total + x;
+    print(x);
+    $write(",");
+  }
+  print(total);
+  $write("\n");
+  for (const e of evens_until(9)) {
+    print(e);
+    $write(" ");
+  }
+  $write("\n");
+  for (const p of pairs(3)) {
+    print(p);
+    $write(" ");
+  }
+  $write("\n");
+  for (const v of Int32Array.of(7, 8, 9)) {
+    print(v);
+  }
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,174 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+function range(lo, hi) {
+  let $state = 0;
+  let i;
+  const $step = { value: undefined, done: false };
+  return {
+    next() {
+      for (;;) {
+        switch ($state) {
+          case 0:
+            i = lo;
+          case 1:
+            if (!(i < hi)) { $state = 2; continue; }
+            $step.value = i;
+            $state = 3; return $step;
+          case 3:
+            i = i + 1;
+            $state = 1; continue;
+          case 2:
+            $state = -1;
+          default:
+            $step.value = undefined; $step.done = true; return $step;
+        }
+      }
+    },
+    [Symbol.iterator]() { return this; },
+  };
+}
+function evens_until(limit) {
+  let $state = 0;
+  let n, skipped;
+  const $step = { value: undefined, done: false };
+  return {
+    next() {
+      for (;;) {
+        switch ($state) {
+          case 0:
+            n = 0;
+          case 1:
+            if (!(1)) { $state = 2; continue; }
+            if (!(n > limit)) { $state = 3; continue; }
+            $step.value = undefined;
+            $step.done = true; $state = -1; return $step;
+          case 3:
+            if (!(n % 2 === 0)) { $state = 4; continue; }
+            $step.value = n;
+            $state = 6; return $step;
+          case 6:
+            $state = 5; continue;
+          case 4:
+            skipped = n;
+          case 5:
+            n = n + 1;
+            $state = 1; continue;
+          case 2:
+            $state = -1;
+          default:
+            $step.value = undefined; $step.done = true; return $step;
+        }
+      }
+    },
+    [Symbol.iterator]() { return this; },
+  };
+}
+function pairs(k) {
+  let $state = 0;
+  let $iter1, a, $iter2, b;
+  const $step = { value: undefined, done: false };
+  return {
+    next() {
+      for (;;) {
+        switch ($state) {
+          case 0:
+            $iter1 = (range(0, k))[Symbol.iterator]();
+          case 1:
+            { const $next = $iter1.next(); if ($next.done) { $state = 2; continue; } a = $next.value; }
+            $iter2 = (range(a, k))[Symbol.iterator]();
+          case 3:
+            { const $next = $iter2.next(); if ($next.done) { $state = 4; continue; } b = $next.value; }
+            $step.value = a * 10 + b;
+            $state = 5; return $step;
+          case 5:
+            $state = 3; continue;
+          case 4:
+            $state = 1; continue;
+          case 2:
+            $state = -1;
+          default:
+            $step.value = undefined; $step.done = true; return $step;
+        }
+      }
+    },
+    [Symbol.iterator]() { return this; },
+  };
+}
+function main() {
+  let total = 0;
+  for (const x of range(1, 5)) {
+    total = total + x;
+    print(x, ",");
+  }
+  println(total);
+  for (const e of evens_until(9)) {
+    print(e, " ");
+  }
+  println("");
+  for (const p of pairs(3)) {
+    print(p, " ");
+  }
+  println("");
+  for (const v of Int32Array.of(7, 8, 9)) {
+    print(v);
+  }
+  println("");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
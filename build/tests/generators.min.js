@@ -0,0 +1 @@
+"use strict";(function(){const j=require('node:fs');const q=new TextEncoder();const b=new Uint8Array(65536);let a=0;let k=10;const f=()=>{let g=0;while(g<a){try{g+=j.writeSync(1,b,g,a-g);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)k=b[a-1];a=0;};process.on('exit',f);const s=(byte)=>{if(a===b.length)f();b[a++]=byte;};const l=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=q.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);f();}};const m=(...t)=>{for(const h of t)l(typeof h==='string'?h:`${h}`);};const o=l;const p=()=>{if((a>0?b[a-1]:k)!==10)s(10);f();};globalThis.print=m;globalThis.$write=o;globalThis.flush=p;})();function range(b,c){let $state=0;let a;const $step={value:undefined,done:false};return{next(){for(;;){switch($state){case 0:a=b;case 1:if(!(a<c)){$state=2;continue;}$step.value=a;$state=3;return $step;case 3:a=a+1;$state=1;continue;case 2:$state=-1;default:$step.value=undefined;$step.done=true;return $step;}}},[Symbol.iterator](){return this;},};}function evens_until(b){let $state=0;let a,c;const $step={value:undefined,done:false};return{next(){for(;;){switch($state){case 0:a=0;case 1:if(!(1)){$state=2;continue;}if(!(a>b)){$state=3;continue;}$step.value=undefined;$step.done=true;$state=-1;return $step;case 3:if(!(a%2===0)){$state=4;continue;}$step.value=a;$state=6;return $step;case 6:$state=5;continue;case 4:c=a;case 5:a=a+1;$state=1;continue;case 2:$state=-1;default:$step.value=undefined;$step.done=true;return $step;}}},[Symbol.iterator](){return this;},};}function pairs(a){let $state=0;let $iter1,b,$iter2,c;const $step={value:undefined,done:false};return{next(){for(;;){switch($state){case 0:$iter1=(range(0,a))[Symbol.iterator]();case 1:{const $next=$iter1.next();if($next.done){$state=2;continue;}b=$next.value;}$iter2=(range(b,a))[Symbol.iterator]();case 3:{const $next=$iter2.next();if($next.done){$state=4;continue;}c=$next.value;}$step.value=b*10+c;$state=5;return $step;case 5:$state=3;continue;case 4:$state=1;continue;case 2:$state=-1;default:$step.value=undefined;$step.done=true;return $step;}}},[Symbol.iterator](){return this;},};}function main(){let a=0;for(const b of range(1,5)){a=a+b;print(b);$write(",");}print(a);$write("\n");for(const c of evens_until(9)){print(c);$write(" ");}$write("\n");for(const d of pairs(3)){print(d);$write(" ");}$write("\n");for(const e of Int32Array.of(7,8,9)){print(e);}$write("\n");}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
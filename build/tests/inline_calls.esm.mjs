@@ -0,0 +1,25 @@
+import { $write, $writeNumber, flush } from "./dwoc_runtime.mjs";
+
+function main() {
+  let x = 3;
+  {
+    let a$1 = x;
+    let b$1 = x - 1;
+    $writeNumber(a$1);
+    $write("\n");
+    let c$1 = b$1 - a$1;
+    $writeNumber(c$1);
+    $write("\n");
+  }
+  {
+    let a$2 = 7;
+    let b$2 = x;
+    $writeNumber(a$2);
+    $write("\n");
+    let c$2 = b$2 - a$2;
+    $writeNumber(c$2);
+    $write("\n");
+  }
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
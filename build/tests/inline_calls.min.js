@@ -0,0 +1 @@
+"use strict";(function(){const l=require('node:fs');const s=new TextEncoder();const d=new Uint8Array(65536);let a=0;let m=10;const g=()=>{let h=0;while(h<a){try{h+=l.writeSync(1,d,h,a-h);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)m=d[a-1];a=0;};process.on('exit',g);const t=(byte)=>{if(a===d.length)g();d[a++]=byte;};const n=(f)=>{const b=f.length;if(b<=d.length-a){let i=0;for(;i<b;++i){const c=f.charCodeAt(i);if(c>=128)break;d[a++]=c;}if(i===b)return;f=f.substring(i);}for(;;){const r=s.encodeInto(f,d.subarray(a));a+=r.written;if(r.read===f.length)return;f=f.substring(r.read);g();}};const o=n;const p=(b)=>{if((b|0)!==b){n(`${b}`);return;}if(a+11>d.length)g();if(b<0){d[a++]=45;b=-b;}let k=a+1;for(let j=b;j>=10;j=(j/10)|0)k+=1;a=k;do{d[--k]=48+b%10;b=(b/10)|0;}while(b>0);};const q=()=>{if((a>0?d[a-1]:m)!==10)t(10);g();};globalThis.$write=o;globalThis.$writeNumber=p;globalThis.flush=q;})();function main(){let a=3;{let b=a;let d=a-1;$writeNumber(b);$write("\n");let e=d-b;$writeNumber(e);$write("\n");}{let c=7;let f=a;$writeNumber(c);$write("\n");let g=f-c;$writeNumber(g);$write("\n");}}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1 @@
+"use strict";(function(){const l=require('node:fs');const u=new TextEncoder();const b=new Uint8Array(65536);let a=0;let m=10;const g=()=>{let h=0;while(h<a){try{h+=l.writeSync(1,b,h,a-h);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)m=b[a-1];a=0;};process.on('exit',g);const o=(byte)=>{if(a===b.length)g();b[a++]=byte;};const j=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=u.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);g();}};const p=(...k)=>{for(const f of k)j(typeof f==='string'?f:`${f}`);};const q=(...k)=>{for(const f of k)j(typeof f==='string'?f:`${f}`);o(10);};const s=j;const t=()=>{if((a>0?b[a-1]:m)!==10)o(10);g();};globalThis.print=p;globalThis.println=q;globalThis.$write=s;globalThis.flush=t;})();function swap_sub(a,b){return b-a;}function main$scale(a,b){return a*b;}function main(){let a=1;const c=3;function b(){a=a+10;return a;}println(swap_sub(a,b()));print(main$scale(a,3));$write("\n");return 0;}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
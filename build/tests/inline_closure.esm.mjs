@@ -0,0 +1,19 @@
+import { println, $write, $writeNumber, flush } from "./dwoc_runtime.mjs";
+
+function swap_sub(x, y) {
+  return y - x;
+}
+function main() {
+  let i = 1;
+  const k = 3;
+  function inc() {
+    i = i + 10;
+    return i;
+  }
+  println(swap_sub(i, inc()));
+  $writeNumber(i * 3);
+  $write("\n");
+  return 0;
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1 @@
+"use strict";(function(){const n=require('node:fs');const v=new TextEncoder();const d=new Uint8Array(65536);let a=0;let o=10;const g=()=>{let h=0;while(h<a){try{h+=n.writeSync(1,d,h,a-h);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)o=d[a-1];a=0;};process.on('exit',g);const p=(byte)=>{if(a===d.length)g();d[a++]=byte;};const j=(f)=>{const b=f.length;if(b<=d.length-a){let i=0;for(;i<b;++i){const c=f.charCodeAt(i);if(c>=128)break;d[a++]=c;}if(i===b)return;f=f.substring(i);}for(;;){const r=v.encodeInto(f,d.subarray(a));a+=r.written;if(r.read===f.length)return;f=f.substring(r.read);g();}};const q=(...w)=>{for(const k of w)j(typeof k==='string'?k:`${k}`);p(10);};const s=j;const t=(b)=>{if((b|0)!==b){j(`${b}`);return;}if(a+11>d.length)g();if(b<0){d[a++]=45;b=-b;}let m=a+1;for(let l=b;l>=10;l=(l/10)|0)m+=1;a=m;do{d[--m]=48+b%10;b=(b/10)|0;}while(b>0);};const u=()=>{if((a>0?d[a-1]:o)!==10)p(10);g();};globalThis.println=q;globalThis.$write=s;globalThis.$writeNumber=t;globalThis.flush=u;})();function swap_sub(a,b){return b-a;}function main(){let a=1;const c=3;function b(){a=a+10;return a;}println(swap_sub(a,b()));$writeNumber(a*3);$write("\n");return 0;}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1,48 @@
+import { print, println, $write, $writeNumber, flush } from "./dwoc_runtime.mjs";
+
+let counter = 0;
+function sq(x) {
+  return x * x;
+}
+function bump() {
+  counter = counter + 1;
+  return counter;
+}
+function twice_then(x, y) {
+  return y - x;
+}
+function sum_squares(n) {
+  if (n === 0) {
+    return 0;
+  }
+  return n * n + sum_squares(n - 1);
+}
+function main() {
+  let nine = 9;
+  print(sum_squares(nine));
+  $write("\n");
+  const y = 5;
+  $write("6\n6\n81\n");
+  let i = 9;
+  const x$2 = i + 1;
+  $writeNumber(x$2 * x$2);
+  $write("\n");
+  println(sq(bump()));
+  print(counter);
+  $write("\n");
+  println(twice_then(bump(), bump()));
+  print(counter);
+  $write("\n");
+  const t = 3 > 2 && 49 === 49;
+  print(t);
+  $write("\n");
+  let k = 0;
+  while (k * k < 50) {
+    k = k + 1;
+  }
+  $writeNumber(k);
+  $write("\n");
+  return 0;
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
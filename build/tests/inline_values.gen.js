@@ -0,0 +1,90 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+let counter = 0;
+function sq(x) {
+  return x * x;
+}
+function add(x, y) {
+  return x + y;
+}
+function bump() {
+  counter = counter + 1;
+  return counter;
+}
+function twice_then(x, y) {
+  return y - x;
+}
+function main() {
+  let s = 0;
+  let i = 0;
+  while (i < 10) {
+    s = s + sq(i);
+    i = i + 1;
+  }
+  println(s);
+  const y = 5;
+  println(add(y, 1), " ", add(1, y), " ", sq(sq(3)));
+  println(sq(i + 1), " ", sq(bump()), " ", counter);
+  println(twice_then(bump(), bump()), " ", counter);
+  const t = 3 > 2 && sq(y + 2) === 49;
+  println(t);
+  while (sq(i) < 200) {
+    i = i + 1;
+  }
+  println(i);
+  return 0;
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1 @@
+"use strict";(function(){const o=require('node:fs');const x=new TextEncoder();const d=new Uint8Array(65536);let a=0;let p=10;const h=()=>{let k=0;while(k<a){try{k+=o.writeSync(1,d,k,a-k);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)p=d[a-1];a=0;};process.on('exit',h);const q=(byte)=>{if(a===d.length)h();d[a++]=byte;};const j=(f)=>{const b=f.length;if(b<=d.length-a){let i=0;for(;i<b;++i){const c=f.charCodeAt(i);if(c>=128)break;d[a++]=c;}if(i===b)return;f=f.substring(i);}for(;;){const r=x.encodeInto(f,d.subarray(a));a+=r.written;if(r.read===f.length)return;f=f.substring(r.read);h();}};const s=(...l)=>{for(const g of l)j(typeof g==='string'?g:`${g}`);};const t=(...l)=>{for(const g of l)j(typeof g==='string'?g:`${g}`);q(10);};const u=j;const v=(b)=>{if((b|0)!==b){j(`${b}`);return;}if(a+11>d.length)h();if(b<0){d[a++]=45;b=-b;}let n=a+1;for(let m=b;m>=10;m=(m/10)|0)n+=1;a=n;do{d[--n]=48+b%10;b=(b/10)|0;}while(b>0);};const w=()=>{if((a>0?d[a-1]:p)!==10)q(10);h();};globalThis.print=s;globalThis.println=t;globalThis.$write=u;globalThis.$writeNumber=v;globalThis.flush=w;})();let counter=0;function sq(a){return a*a;}function bump(){counter=counter+1;return counter;}function twice_then(a,b){return b-a;}function sum_squares(a){if(a===0){return 0;}return a*a+sum_squares(a-1);}function main(){let c=9;print(sum_squares(c));$write("\n");const f=5;$write("6\n6\n81\n");let d=9;const b=d+1;$writeNumber(b*b);$write("\n");println(sq(bump()));print(counter);$write("\n");println(twice_then(bump(),bump()));print(counter);$write("\n");const e=3>2&&49===49;print(e);$write("\n");let a=0;while(a*a<50){a=a+1;}$writeNumber(a);$write("\n");return 0;}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1,15 @@
+import { putchar, $write, $writeNumber, flush } from "./dwoc_runtime.mjs";
+
+function main() {
+  $write("big 123456789000000000000\n9007199254740992 0\n");
+  $writeNumber(1000000000 * 1000000000000);
+  $write("\na1\nA\ntab\x09here\n");
+  let c = 66;
+  let n = 7;
+  putchar(c);
+  $writeNumber(n);
+  $writeNumber(c);
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,9 @@
+import { $write, $writeNumber, flush } from "./dwoc_runtime.mjs";
+
+function main() {
+  let x = 6;
+  $writeNumber(x - 1);
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
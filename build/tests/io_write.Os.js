@@ -0,0 +1 @@
+"use strict";(function(){const q=require('node:fs');const y=new TextEncoder();const d=new Uint8Array(65536);let a=0;let s=10;const g=()=>{let h=0;while(h<a){try{h+=q.writeSync(1,d,h,a-h);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)s=d[a-1];a=0;};process.on('exit',g);const k=(byte)=>{if(a===d.length)g();d[a++]=byte;};const l=(f)=>{const b=f.length;if(b<=d.length-a){let i=0;for(;i<b;++i){const c=f.charCodeAt(i);if(c>=128)break;d[a++]=c;}if(i===b)return;f=f.substring(i);}for(;;){const r=y.encodeInto(f,d.subarray(a));a+=r.written;if(r.read===f.length)return;f=f.substring(r.read);g();}};const t=(...z)=>{for(const m of z)l(typeof m==='string'?m:`${m}`);k(10);};const n=(...j)=>{for(const A of j)k(A);};const u=(...j)=>{n(...j);return j.length;};const v=l;const w=(b)=>{if((b|0)!==b){l(`${b}`);return;}if(a+11>d.length)g();if(b<0){d[a++]=45;b=-b;}let p=a+1;for(let o=b;o>=10;o=(o/10)|0)p+=1;a=p;do{d[--p]=48+b%10;b=(b/10)|0;}while(b>0);};const x=()=>{if((a>0?d[a-1]:s)!==10)k(10);g();};globalThis.println=t;globalThis.putchar=n;globalThis.putchars=u;globalThis.$write=v;globalThis.$writeNumber=w;globalThis.flush=x;})();const H=72;const e=101;const l=108;const o=111;function shout(){$write("!");return 3;}function main(){const c=20;let a=6765;let b=0;b=b+putchars(H,e,l,l,o);$write(", Hello!\n20th fib number is: ");$writeNumber(a);$write("\nmulti\nline \"quoted\" \\ text\x09");$writeNumber(a);$writeNumber(a+1);$write("end\n");println(b,shout());putchar(a%7+48);$write("\n");putchar(226,130,172);$write("\nno newline");}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1,29 @@
+import { println, putchar, putchars, $write, $writeNumber, flush } from "./dwoc_runtime.mjs";
+
+const H = 72;
+const e = 101;
+const l = 108;
+const o = 111;
+function shout() {
+  $write("!");
+  return 3;
+}
+function main() {
+  const n = 20;
+  let f = 6765;
+  let count = 0;
+  count = count + putchars(H, e, l, l, o);
+  $write(", Hello!\n20th fib number is: ");
+  $writeNumber(f);
+  $write("\nmulti\nline \"quoted\" \\ text\x09");
+  $writeNumber(f);
+  $writeNumber(f + 1);
+  $write("end\n");
+  println(count, shout());
+  putchar(f % 7 + 48);
+  $write("\n");
+  putchar(226, 130, 172);
+  $write("\nno newline");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
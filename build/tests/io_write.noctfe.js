@@ -0,0 +1,138 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const putchar = (...chars) => {
+  for (const ch of chars) outByte(ch);
+};
+const putchars = (...chars) => {
+  putchar(...chars);
+  return chars.length;
+};
+const $write = outText;
+const $writeNumber = (n) => {
+  if ((n | 0) !== n) { outText(`${n}`); return; }
+  if (outLength + 11 > outBytes.length) outDrain();
+  if (n < 0) { outBytes[outLength++] = 45; n = -n; }
+  let end = outLength + 1;
+  for (let rest = n; rest >= 10; rest = (rest / 10) | 0) end += 1;
+  outLength = end;
+  do { outBytes[--end] = 48 + n % 10; n = (n / 10) | 0; } while (n > 0);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.println = println;
+globalThis.putchar = putchar;
+globalThis.putchars = putchars;
+globalThis.$write = $write;
+globalThis.$writeNumber = $writeNumber;
+globalThis.flush = flush;
+})();
+
+const H = 72;
+const e = 101;
+const l = 108;
+const o = 111;
+function fib$impl(n) {
+  if (n <= 0) {
+    return 0;
+  }
+  if (n === 1) {
+    return n;
+  }
+  return fib(n - 1) + fib(n - 2);
+}
+let fib$table = new Float64Array(64).fill(NaN);
+const fib$cache = new Map();
+function fib(n) {
+  if (n >= 0 && n < 65536) {
+    if (n >= fib$table.length) {
+      const $grown = new Float64Array(Math.max(n + 1, fib$table.length * 2)).fill(NaN);
+      $grown.set(fib$table);
+      fib$table = $grown;
+    }
+    const $hit = fib$table[n];
+    if ($hit === $hit) return $hit;
+    const $r = fib$impl(n);
+    if (typeof $r === 'number') fib$table[n] = $r;
+    return $r;
+  }
+  const $key = n;
+  if (fib$cache.has($key)) return fib$cache.get($key);
+  const $r = fib$impl(n);
+  fib$cache.set($key, $r);
+  return $r;
+}
+function shout() {
+  $write("!");
+  return 3;
+}
+function main() {
+  const n = 20;
+  let f = fib(n);
+  let count = 0;
+  count = count + putchars(H, e, l, l, o);
+  $write(", Hello!");
+  putchar(6 + 6 - 2);
+  $writeNumber(n);
+  $write("th fib number is: ");
+  print(f);
+  $write("\nmulti\nline \"quoted\" \\ text\x09");
+  print(f, f + 1);
+  $write("end\n");
+  println(count, shout());
+  putchar(f % 7 + 48);
+  $write("\n");
+  putchar(226, 130, 172);
+  $write("\nno newline");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
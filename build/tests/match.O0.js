@@ -0,0 +1,117 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+function days(month) {
+  return (month < 6 ? (month == 2 ? 28 : month == 4 ? 30 : 31) : (month == 6 || month == 9 || month == 11 ? 30 : 31));
+}
+function weight(n) {
+  return (($subject) => $subject < 2 ? ($subject === 0 ? 10 : $subject === 1 ? 20 : undefined) : ($subject === 2 ? 30 : $subject === 3 ? 40 : undefined))(n % 4);
+}
+function sparse(code) {
+  if (code === 1) {
+    return 1;
+  }
+  if (code === 10) {
+    return 2;
+  }
+  if (code === 100) {
+    return 3;
+  }
+  if (code === 1000) {
+    return 4;
+  }
+  if (code === 10000) {
+    return 5;
+  }
+  return 0;
+}
+function kind(n) {
+  if (n === 0) {
+    return 100;
+  } else if (n === 1) {
+    return 200;
+  } else if (n === 2) {
+    return 300;
+  } else {
+    return n;
+  }
+}
+function main() {
+  let m = 1;
+  while (m <= 12) {
+    print(days(m), " ");
+    m = m + 1;
+  }
+  println("");
+  let i = 0;
+  while (i < 6) {
+    print(weight(i), " ", kind(i), " ");
+    i = i + 1;
+  }
+  println("");
+  let c = 1;
+  while (c <= 100000) {
+    print(sparse(c), " ");
+    c = c * 10;
+  }
+  println(sparse(7));
+  let x = 5;
+  println((x == 1 ? 2 : x * 3));
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,125 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const $write = outText;
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.$write = $write;
+globalThis.flush = flush;
+})();
+
+const $table1 = [28, 31, 30, 31, 30, 31, 31, 30, 31, 30];
+const $table2 = [10, 20, 30, 40];
+
+function sparse(code) {
+  if (code < 100) {
+    if (code === 1) {
+      return 1;
+    }
+    if (code === 10) {
+      return 2;
+    }
+  } else {
+    if (code === 100) {
+      return 3;
+    }
+    if (code === 1000) {
+      return 4;
+    }
+    if (code === 10000) {
+      return 5;
+    }
+  }
+  return 0;
+}
+function kind(n) {
+  switch (n) {
+    case 0: {
+      return 100;
+    }
+    case 1: {
+      return 200;
+    }
+    case 2: {
+      return 300;
+    }
+    default: {
+      return n;
+    }
+  }
+}
+function main() {
+  let m = 1;
+  while (m <= 12) {
+    print(($table1[m - 2] ?? 31));
+    $write(" ");
+    m = m + 1;
+  }
+  $write("\n");
+  let i = 0;
+  while (i < 6) {
+    print($table2[i % 4]);
+    $write(" ");
+    print(kind(i));
+    $write(" ");
+    i = i + 1;
+  }
+  $write("\n");
+  let c = 1;
+  while (c <= 100000) {
+    print(sparse(c));
+    $write(" ");
+    c = c * 10;
+  }
+  $write("0\n");
+  let x = 5;
+  print((x == 1 ? 2 : x * 3));
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1 @@
+"use strict";(function(){const j=require('node:fs');const q=new TextEncoder();const b=new Uint8Array(65536);let a=0;let k=10;const f=()=>{let g=0;while(g<a){try{g+=j.writeSync(1,b,g,a-g);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)k=b[a-1];a=0;};process.on('exit',f);const s=(byte)=>{if(a===b.length)f();b[a++]=byte;};const l=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=q.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);f();}};const m=(...t)=>{for(const h of t)l(typeof h==='string'?h:`${h}`);};const o=l;const p=()=>{if((a>0?b[a-1]:k)!==10)s(10);f();};globalThis.print=m;globalThis.$write=o;globalThis.flush=p;})();const $table1=[28,31,30,31,30,31,31,30,31,30];const $table2=[10,20,30,40];function days(a){return($table1[a-2]??31);}function weight(a){return $table2[a%4];}function sparse(a){if(a<100){if(a===1){return 1;}if(a===10){return 2;}}else{if(a===100){return 3;}if(a===1000){return 4;}if(a===10000){return 5;}}return 0;}function kind(a){switch(a){case 0:{return 100;}case 1:{return 200;}case 2:{return 300;}default:{return a;}}}function main(){let b=1;while(b<=12){print(days(b));$write(" ");b=b+1;}$write("\n");let a=0;while(a<6){print(weight(a));$write(" ");print(kind(a));$write(" ");a=a+1;}$write("\n");let c=1;while(c<=100000){print(sparse(c));$write(" ");c=c*10;}$write("0\n");let d=5;print((d==1?2:d*3));$write("\n");}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
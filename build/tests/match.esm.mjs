@@ -0,0 +1,72 @@
+import { print, $write, flush } from "./dwoc_runtime.mjs";
+
+const $table1 = [28, 31, 30, 31, 30, 31, 31, 30, 31, 30];
+const $table2 = [10, 20, 30, 40];
+
+function sparse(code) {
+  if (code < 100) {
+    if (code === 1) {
+      return 1;
+    }
+    if (code === 10) {
+      return 2;
+    }
+  } else {
+    if (code === 100) {
+      return 3;
+    }
+    if (code === 1000) {
+      return 4;
+    }
+    if (code === 10000) {
+      return 5;
+    }
+  }
+  return 0;
+}
+function kind(n) {
+  switch (n) {
+    case 0: {
+      return 100;
+    }
+    case 1: {
+      return 200;
+    }
+    case 2: {
+      return 300;
+    }
+    default: {
+      return n;
+    }
+  }
+}
+function main() {
+  let m = 1;
+  while (m <= 12) {
+    print(($table1[m - 2] ?? 31));
+    $write(" ");
+    m = m + 1;
+  }
+  $write("\n");
+  let i = 0;
+  while (i < 6) {
+    print($table2[i % 4]);
+    $write(" ");
+    print(kind(i));
+    $write(" ");
+    i = i + 1;
+  }
+  $write("\n");
+  let c = 1;
+  while (c <= 100000) {
+    print(sparse(c));
+    $write(" ");
+    c = c * 10;
+  }
+  $write("0\n");
+  let x = 5;
+  print((x == 1 ? 2 : x * 3));
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
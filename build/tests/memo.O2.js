@@ -0,0 +1,162 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const $write = outText;
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.$write = $write;
+globalThis.flush = flush;
+})();
+
+class Point {
+  constructor(x, y) {
+    this.x = x;
+    this.y = y;
+  }
+}
+
+let calls = 0;
+function fib$impl(n) {
+  if (n < 2) {
+    return n;
+  }
+  return fib(n - 1) + fib(n - 2);
+}
+let fib$table = new Float64Array(64).fill(NaN);
+const fib$cache = new Map();
+function fib(n) {
+  if (n >= 0 && n < 65536) {
+    if (n >= fib$table.length) {
+      const $grown = new Float64Array(Math.max(n + 1, fib$table.length * 2)).fill(NaN);
+      $grown.set(fib$table);
+      fib$table = $grown;
+    }
+    const $hit = fib$table[n];
+    if ($hit === $hit) return $hit;
+    const $r = fib$impl(n);
+    if (typeof $r === 'number') fib$table[n] = $r;
+    return $r;
+  }
+  const $key = n;
+  if (fib$cache.has($key)) return fib$cache.get($key);
+  const $r = fib$impl(n);
+  fib$cache.set($key, $r);
+  return $r;
+}
+function ways$impl(n) {
+  if (n < 0) {
+    return 0;
+  }
+  if (n === 0) {
+    return 1;
+  }
+  return ways(n - 1) + ways(n - 2) + ways(n - 3);
+}
+let ways$table = new Float64Array(64).fill(NaN);
+const ways$cache = new Map();
+function ways(n) {
+  if (n >= 0 && n < 65536) {
+    if (n >= ways$table.length) {
+      const $grown = new Float64Array(Math.max(n + 1, ways$table.length * 2)).fill(NaN);
+      $grown.set(ways$table);
+      ways$table = $grown;
+    }
+    const $hit = ways$table[n];
+    if ($hit === $hit) return $hit;
+    const $r = ways$impl(n);
+    if (typeof $r === 'number') ways$table[n] = $r;
+    return $r;
+  }
+  const $key = n;
+  if (ways$cache.has($key)) return ways$cache.get($key);
+  const $r = ways$impl(n);
+  ways$cache.set($key, $r);
+  return $r;
+}
+function pick(b) {
+  if (b) {
+    return 1;
+  }
+  return 2;
+}
+function count(n) {
+  if (n < 1) {
+    return 0;
+  }
+  return count(n - 1) + count(n - 2) + 1;
+}
+function total(ps, lo, hi) {
+  if (lo >= hi) {
+    return 0;
+  }
+  return ps[lo].x + total(ps, lo + 1, hi);
+}
+function main() {
+  let n = 70;
+  print(fib(n));
+  $write("\n");
+  let k = 10;
+  k = k * 2;
+  print(ways(k));
+  $write("\n");
+  print(pick(1 < 2));
+  $write("\n");
+  print(pick(2 < 1));
+  $write("\n");
+  calls = 15;
+  print(count(calls));
+  $write("\n");
+  const small = [new Point(1, 0), new Point(2, 0)];
+  const large = [new Point(10, 0), new Point(20, 0)];
+  print(total(small, 0, 2));
+  $write("\n");
+  print(total(large, 0, 2));
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
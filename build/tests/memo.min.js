@@ -0,0 +1 @@
+"use strict";(function(){const j=require('node:fs');const q=new TextEncoder();const b=new Uint8Array(65536);let a=0;let k=10;const f=()=>{let g=0;while(g<a){try{g+=j.writeSync(1,b,g,a-g);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)k=b[a-1];a=0;};process.on('exit',f);const s=(byte)=>{if(a===b.length)f();b[a++]=byte;};const l=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=q.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);f();}};const m=(...t)=>{for(const h of t)l(typeof h==='string'?h:`${h}`);};const o=l;const p=()=>{if((a>0?b[a-1]:k)!==10)s(10);f();};globalThis.print=m;globalThis.$write=o;globalThis.flush=p;})();class Point{constructor(x,y){this.x=x;this.y=y;}}let calls=0;function fib$impl(a){if(a<2){return a;}return fib(a-1)+fib(a-2);}let fib$table=new Float64Array(64).fill(NaN);const fib$cache=new Map();function fib(a){if(a>=0&&a<65536){if(a>=fib$table.length){const $grown=new Float64Array(Math.max(a+1,fib$table.length*2)).fill(NaN);$grown.set(fib$table);fib$table=$grown;}const $hit=fib$table[a];if($hit===$hit)return $hit;const $r=fib$impl(a);if(typeof $r==='number')fib$table[a]=$r;return $r;}const $key=a;if(fib$cache.has($key))return fib$cache.get($key);const $r=fib$impl(a);fib$cache.set($key,$r);return $r;}function ways$impl(a){if(a<0){return 0;}if(a===0){return 1;}return ways(a-1)+ways(a-2)+ways(a-3);}let ways$table=new Float64Array(64).fill(NaN);const ways$cache=new Map();function ways(a){if(a>=0&&a<65536){if(a>=ways$table.length){const $grown=new Float64Array(Math.max(a+1,ways$table.length*2)).fill(NaN);$grown.set(ways$table);ways$table=$grown;}const $hit=ways$table[a];if($hit===$hit)return $hit;const $r=ways$impl(a);if(typeof $r==='number')ways$table[a]=$r;return $r;}const $key=a;if(ways$cache.has($key))return ways$cache.get($key);const $r=ways$impl(a);ways$cache.set($key,$r);return $r;}function pick(a){if(a){return 1;}return 2;}function count(a){if(a<1){return 0;}return count(a-1)+count(a-2)+1;}function total(b,a,c){if(a>=c){return 0;}return b[a].x+total(b,a+1,c);}function main(){let b=70;print(fib(b));$write("\n");let a=10;a=a*2;print(ways(a));$write("\n");print(pick(1<2));$write("\n");print(pick(2<1));$write("\n");calls=15;print(count(calls));$write("\n");const c=[new Point(1,0),new Point(2,0)];const d=[new Point(10,0),new Point(20,0)];print(total(c,0,2));$write("\n");print(total(d,0,2));$write("\n");}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
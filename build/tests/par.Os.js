@@ -0,0 +1 @@
+"use strict";(function(){const l=require('node:fs');const v=new TextEncoder();const b=new Uint8Array(65536);let a=0;let m=10;const g=()=>{let h=0;while(h<a){try{h+=l.writeSync(1,b,h,a-h);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)m=b[a-1];a=0;};process.on('exit',g);const o=(byte)=>{if(a===b.length)g();b[a++]=byte;};const j=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=v.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);g();}};const p=(...k)=>{for(const f of k)j(typeof f==='string'?f:`${f}`);};const q=(...k)=>{for(const f of k)j(typeof f==='string'?f:`${f}`);o(10);};const s=j;const t=()=>g();const u=()=>{if((a>0?b[a-1]:m)!==10)o(10);g();};globalThis.print=p;globalThis.println=q;globalThis.$write=s;globalThis.$drain=t;globalThis.flush=u;})();(function(){const m=require('node:fs');const h=require('node:os');const d=require('node:worker_threads');const c={entry:null,fns:[],drain:null,globals:null,pool:null};const o=(job)=>{const f=c.fns[job.task];for(;;){const g=Atomics.load(job.ctl,0);if(g>=job.n)return;const j=Math.min(job.n,g+Math.ceil((job.n-g)/(2*job.threads)));if(Atomics.compareExchange(job.ctl,0,g,j)!==g)continue;if(job.output===null){for(let i=g;i<j;++i)f(i);continue;}for(let i=g;i<j;++i){const value=f(job.input[i]);if(typeof value!=='number')throw new Error(`par_map: ${f.name} has to return numbers, got ${value}`);job.output[i]=value;}}};const p=()=>{if(c.pool!==null)return c.pool;const env=Number(process.env.DWOC_PAR_THREADS);const threads=env>0?env:h.availableParallelism?h.availableParallelism():h.cpus().length;c.pool=[];const globals=c.globals();for(let i=1;i<threads;++i){const worker=new d.Worker(c.entry,{workerData:{dwocPar:true,globals:globals}});worker.unref();c.pool.push(worker);}return c.pool;};const w=(b)=>{if(ArrayBuffer.isView(b)&&b.buffer instanceof SharedArrayBuffer)return b;let shared=null;if(ArrayBuffer.isView(b)){shared=new(b instanceof Buffer?Uint8Array:b.constructor)(new SharedArrayBuffer(b.byteLength));}else{for(const item of b)if(typeof item!=='number')return b;shared=new Float64Array(new SharedArrayBuffer(b.length*8));}shared.set(b);return shared;};const q=(f,n,input,output)=>{const task=c.fns.indexOf(f);if(task===-1)throw new Error(`core:par: ${f.name} was not compiled as a worker entry point`);const pool=p();const job={task:task,n:n,input:input,output:output,threads:pool.length+1,ctl:new Int32Array(new SharedArrayBuffer(12))};for(const worker of pool)worker.postMessage(job);let k=null;try{o(job);}catch(e){k=e;Atomics.store(job.ctl,0,n);}for(;;){const done=Atomics.load(job.ctl,1);if(done===pool.length)break;Atomics.wait(job.ctl,1,done);}if(k!==null)throw k;if(Atomics.load(job.ctl,2)!==0)throw new Error('core:par: a worker failed');};const r=(x,y)=>{if(d.isMainThread||!d.workerData||!d.workerData.dwocPar)return y();return d.workerData.globals[x];};const s=(z,A,drain,globals)=>{c.entry=z;c.fns=A;c.drain=drain;c.globals=globals;if(d.isMainThread||!d.workerData||!d.workerData.dwocPar)return false;d.parentPort.on('message',(job)=>{try{o(job);}catch(e){Atomics.store(job.ctl,2,1);Atomics.store(job.ctl,0,job.n);m.writeSync(2,`${e&&e.stack||e}\n`);}finally{if(c.drain!==null)c.drain();Atomics.add(job.ctl,1,1);Atomics.notify(job.ctl,1);}});return true;};const l=(f,b)=>{if(!ArrayBuffer.isView(b)&&!Array.isArray(b))b=Array.from(b);const t=p().length;const u=new Float64Array(t>0?new SharedArrayBuffer(b.length*8):b.length);q(f,b.length,t>0?w(b):b,u);return u;};const v=(B,f)=>{q(f,B,null,null);};globalThis.$parGlobal=r;globalThis.$parEntry=s;globalThis.par_map=l;globalThis.par_for=v;})();function collatz(c){let b=0;let a=c;while(a!==1){if(a%2===0){a=Math.trunc(a/2);}else{a=3*a+1;}b=b+1;}return b;}function square(a){return a*a;}function shout(a){if(a===3){$write("three\n");}}function*range(b,c){let a=b;while(a<c){yield a;a=a+1;}}function main(){println(par_map(square,Int32Array.of(1,2,3,4,5)));let b=0;let c=0;for(const a of par_map(collatz,Int32Array.of(27,97,871,6171,77031,837799))){b=b+a;if(a>c){c=a;}}print(b);$write(" ");print(c);$write("\n");par_for(5,shout);let d=0;for(const a of par_map(collatz,range(1,20000))){d=d+a;}print(d);$write("\n");}if(!$parEntry(__filename,[square,collatz,shout],$drain,()=>[])){const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1,76 @@
+import { print, println, $write, $drain, flush } from "./dwoc_runtime.mjs";
+
+import { $parGlobal, $parEntry, par_map, par_for } from "./dwoc_runtime.mjs";
+
+function collatz(n) {
+  let steps = 0;
+  let x = n;
+  while (x !== 1) {
+    if (x % 2 === 0) {
+      x = Math.trunc(x / 2);
+    } else {
+      x = 3 * x + 1;
+    }
+    steps = steps + 1;
+  }
+  return steps;
+}
+function square(x) {
+  return x * x;
+}
+function shout(i) {
+  if (i === 3) {
+    $write("three\n");
+  }
+}
+function range(lo, hi) {
+  let $state = 0;
+  let i;
+  const $step = { value: undefined, done: false };
+  return {
+    next() {
+      for (;;) {
+        switch ($state) {
+          case 0:
+            i = lo;
+          case 1:
+            if (!(i < hi)) { $state = 2; continue; }
+            $step.value = i;
+            $state = 3; return $step;
+          case 3:
+            i = i + 1;
+            $state = 1; continue;
+          case 2:
+            $state = -1;
+          default:
+            $step.value = undefined; $step.done = true; return $step;
+        }
+      }
+    },
+    [Symbol.iterator]() { return this; },
+  };
+}
+function main() {
+  println(par_map(square, Int32Array.of(1, 2, 3, 4, 5)));
+  let total = 0;
+  let longest = 0;
+  for (const s of par_map(collatz, Int32Array.of(27, 97, 871, 6171, 77031, 837799))) {
+    total = total + s;
+    if (s > longest) {
+      longest = s;
+    }
+  }
+  print(total);
+  $write(" ");
+  print(longest);
+  $write("\n");
+  par_for(5, shout);
+  let big = 0;
+  for (const s of par_map(collatz, range(1, 20000))) {
+    big = big + s;
+  }
+  print(big);
+  $write("\n");
+}
+
+if (!$parEntry(new URL(import.meta.url), [square, collatz, shout], $drain, () => [])) { const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
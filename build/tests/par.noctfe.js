@@ -0,0 +1,236 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const $write = outText;
+const $drain = () => outDrain();
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.println = println;
+globalThis.$write = $write;
+globalThis.$drain = $drain;
+globalThis.flush = flush;
+})();
+
+(function(){
+const fs = require('node:fs');
+const os = require('node:os');
+const worker_threads = require('node:worker_threads');
+const par = { entry: null, fns: [], drain: null, globals: null, pool: null };
+const parWork = (job) => {
+  const fn = par.fns[job.task];
+  for (;;) {
+    const start = Atomics.load(job.ctl, 0);
+    if (start >= job.n) return;
+    const end = Math.min(job.n, start + Math.ceil((job.n - start) / (2 * job.threads)));
+    if (Atomics.compareExchange(job.ctl, 0, start, end) !== start) continue;
+    if (job.output === null) {
+      for (let i = start; i < end; ++i) fn(i);
+      continue;
+    }
+    for (let i = start; i < end; ++i) {
+      const value = fn(job.input[i]);
+      if (typeof value !== 'number') throw new Error(`par_map: ${fn.name} has to return numbers, got ${value}`);
+      job.output[i] = value;
+    }
+  }
+};
+const parPool = () => {
+  if (par.pool !== null) return par.pool;
+  const env = Number(process.env.DWOC_PAR_THREADS);
+  const threads = env > 0 ? env : os.availableParallelism ? os.availableParallelism() : os.cpus().length;
+  par.pool = [];
+  const globals = par.globals();
+  for (let i = 1; i < threads; ++i) {
+    const worker = new worker_threads.Worker(par.entry, { workerData: { dwocPar: true, globals: globals } });
+    worker.unref();
+    par.pool.push(worker);
+  }
+  return par.pool;
+};
+const parShare = (items) => {
+  if (ArrayBuffer.isView(items) && items.buffer instanceof SharedArrayBuffer) return items;
+  let shared = null;
+  if (ArrayBuffer.isView(items)) {
+    shared = new (items instanceof Buffer ? Uint8Array : items.constructor)(new SharedArrayBuffer(items.byteLength));
+  } else {
+    for (const item of items) if (typeof item !== 'number') return items;
+    shared = new Float64Array(new SharedArrayBuffer(items.length * 8));
+  }
+  shared.set(items);
+  return shared;
+};
+const parRun = (fn, n, input, output) => {
+  const task = par.fns.indexOf(fn);
+  if (task === -1) throw new Error(`core:par: ${fn.name} was not compiled as a worker entry point`);
+  const pool = parPool();
+  const job = { task: task, n: n, input: input, output: output, threads: pool.length + 1, ctl: new Int32Array(new SharedArrayBuffer(12)) };
+  for (const worker of pool) worker.postMessage(job);
+  let failure = null;
+  try { parWork(job); } catch (e) { failure = e; Atomics.store(job.ctl, 0, n); }
+  for (;;) {
+    const done = Atomics.load(job.ctl, 1);
+    if (done === pool.length) break;
+    Atomics.wait(job.ctl, 1, done);
+  }
+  if (failure !== null) throw failure;
+  if (Atomics.load(job.ctl, 2) !== 0) throw new Error('core:par: a worker failed');
+};
+const $parGlobal = (index, init) => {
+  if (worker_threads.isMainThread || !worker_threads.workerData || !worker_threads.workerData.dwocPar) return init();
+  return worker_threads.workerData.globals[index];
+};
+const $parEntry = (file, table, drain, globals) => {
+  par.entry = file;
+  par.fns = table;
+  par.drain = drain;
+  par.globals = globals;
+  if (worker_threads.isMainThread || !worker_threads.workerData || !worker_threads.workerData.dwocPar) return false;
+  worker_threads.parentPort.on('message', (job) => {
+    try { parWork(job); }
+    catch (e) {
+      Atomics.store(job.ctl, 2, 1);
+      Atomics.store(job.ctl, 0, job.n);
+      fs.writeSync(2, `${e && e.stack || e}\n`);
+    } finally {
+      if (par.drain !== null) par.drain();
+      Atomics.add(job.ctl, 1, 1);
+      Atomics.notify(job.ctl, 1);
+    }
+  });
+  return true;
+};
+const par_map = (fn, items) => {
+  if (!ArrayBuffer.isView(items) && !Array.isArray(items)) items = Array.from(items);
+  const workers = parPool().length;
+  const results = new Float64Array(workers > 0 ? new SharedArrayBuffer(items.length * 8) : items.length);
+  parRun(fn, items.length, workers > 0 ? parShare(items) : items, results);
+  return results;
+};
+const par_for = (count, fn) => { parRun(fn, count, null, null); };
+globalThis.$parGlobal = $parGlobal;
+globalThis.$parEntry = $parEntry;
+globalThis.par_map = par_map;
+globalThis.par_for = par_for;
+})();
+
+function collatz(n) {
+  let steps = 0;
+  let x = n;
+  while (x !== 1) {
+    if (x % 2 === 0) {
+      x = Math.trunc(x / 2);
+    } else {
+      x = 3 * x + 1;
+    }
+    steps = steps + 1;
+  }
+  return steps;
+}
+function square(x) {
+  return x * x;
+}
+function shout(i) {
+  if (i === 3) {
+    $write("three\n");
+  }
+}
+function range(lo, hi) {
+  let $state = 0;
+  let i;
+  const $step = { value: undefined, done: false };
+  return {
+    next() {
+      for (;;) {
+        switch ($state) {
+          case 0:
+            i = lo;
+          case 1:
+            if (!(i < hi)) { $state = 2; continue; }
+            $step.value = i;
+            $state = 3; return $step;
+          case 3:
+            i = i + 1;
+            $state = 1; continue;
+          case 2:
+            $state = -1;
+          default:
+            $step.value = undefined; $step.done = true; return $step;
+        }
+      }
+    },
+    [Symbol.iterator]() { return this; },
+  };
+}
+function main() {
+  println(par_map(square, Int32Array.of(1, 2, 3, 4, 5)));
+  let total = 0;
+  let longest = 0;
+  for (const s of par_map(collatz, Int32Array.of(27, 97, 871, 6171, 77031, 837799))) {
+    total = total + s;
+    if (s > longest) {
+      longest = s;
+    }
+  }
+  print(total);
+  $write(" ");
+  print(longest);
+  $write("\n");
+  par_for(5, shout);
+  let big = 0;
+  for (const s of par_map(collatz, range(1, 20000))) {
+    big = big + s;
+  }
+  print(big);
+  $write("\n");
+}
+
+if (!$parEntry(__filename, [square, collatz, shout], $drain, () => [])) { const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
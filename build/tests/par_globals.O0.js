@@ -0,0 +1,218 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+let inBytes = Buffer.allocUnsafe(65536);
+let inStart = 0, inEnd = 0, inEof = false;
+let inMissed = false;
+const inFill = () => {
+  if (inEof) return false;
+  if (inStart > 0) { inBytes.copyWithin(0, inStart, inEnd); inEnd -= inStart; inStart = 0; }
+  if (inEnd === inBytes.length) {
+    const grown = Buffer.allocUnsafe(inBytes.length * 2);
+    inBytes.copy(grown, 0, 0, inEnd);
+    inBytes = grown;
+  }
+  for (;;) {
+    try {
+      const n = fs.readSync(0, inBytes, inEnd, inBytes.length - inEnd, null);
+      if (n === 0) break;
+      inEnd += n;
+      return true;
+    } catch (e) {
+      if (e.code === 'EOF') break;
+      if (e.code !== 'EAGAIN') throw e;
+    }
+  }
+  inEof = true;
+  return false;
+};
+const read_byte = () => {
+  inMissed = inStart === inEnd && !inFill();
+  return inMissed ? -1 : inBytes[inStart++];
+};
+const read_int = () => {
+  let b = read_byte();
+  while (b === 32 || (b >= 9 && b <= 13)) b = read_byte();
+  if (b === -1) return 0;
+  let sign = 1;
+  if (b === 45 || b === 43) { if (b === 45) sign = -1; b = read_byte(); }
+  let n = 0;
+  while (b >= 48 && b <= 57) { n = n * 10 + (b - 48); b = read_byte(); }
+  if (b !== -1) inStart -= 1;
+  inMissed = false;
+  return sign * n;
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const $drain = () => outDrain();
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.read_byte = read_byte;
+globalThis.read_int = read_int;
+globalThis.println = println;
+globalThis.$drain = $drain;
+globalThis.flush = flush;
+})();
+
+(function(){
+const fs = require('node:fs');
+const os = require('node:os');
+const worker_threads = require('node:worker_threads');
+const par = { entry: null, fns: [], drain: null, globals: null, pool: null };
+const parWork = (job) => {
+  const fn = par.fns[job.task];
+  for (;;) {
+    const start = Atomics.load(job.ctl, 0);
+    if (start >= job.n) return;
+    const end = Math.min(job.n, start + Math.ceil((job.n - start) / (2 * job.threads)));
+    if (Atomics.compareExchange(job.ctl, 0, start, end) !== start) continue;
+    if (job.output === null) {
+      for (let i = start; i < end; ++i) fn(i);
+      continue;
+    }
+    for (let i = start; i < end; ++i) {
+      const value = fn(job.input[i]);
+      if (typeof value !== 'number') throw new Error(`par_map: ${fn.name} has to return numbers, got ${value}`);
+      job.output[i] = value;
+    }
+  }
+};
+const parPool = () => {
+  if (par.pool !== null) return par.pool;
+  const env = Number(process.env.DWOC_PAR_THREADS);
+  const threads = env > 0 ? env : os.availableParallelism ? os.availableParallelism() : os.cpus().length;
+  par.pool = [];
+  const globals = par.globals();
+  for (let i = 1; i < threads; ++i) {
+    const worker = new worker_threads.Worker(par.entry, { workerData: { dwocPar: true, globals: globals } });
+    worker.unref();
+    par.pool.push(worker);
+  }
+  return par.pool;
+};
+const parShare = (items) => {
+  if (ArrayBuffer.isView(items) && items.buffer instanceof SharedArrayBuffer) return items;
+  let shared = null;
+  if (ArrayBuffer.isView(items)) {
+    shared = new (items instanceof Buffer ? Uint8Array : items.constructor)(new SharedArrayBuffer(items.byteLength));
+  } else {
+    for (const item of items) if (typeof item !== 'number') return items;
+    shared = new Float64Array(new SharedArrayBuffer(items.length * 8));
+  }
+  shared.set(items);
+  return shared;
+};
+const parRun = (fn, n, input, output) => {
+  const task = par.fns.indexOf(fn);
+  if (task === -1) throw new Error(`core:par: ${fn.name} was not compiled as a worker entry point`);
+  const pool = parPool();
+  const job = { task: task, n: n, input: input, output: output, threads: pool.length + 1, ctl: new Int32Array(new SharedArrayBuffer(12)) };
+  for (const worker of pool) worker.postMessage(job);
+  let failure = null;
+  try { parWork(job); } catch (e) { failure = e; Atomics.store(job.ctl, 0, n); }
+  for (;;) {
+    const done = Atomics.load(job.ctl, 1);
+    if (done === pool.length) break;
+    Atomics.wait(job.ctl, 1, done);
+  }
+  if (failure !== null) throw failure;
+  if (Atomics.load(job.ctl, 2) !== 0) throw new Error('core:par: a worker failed');
+};
+const $parGlobal = (index, init) => {
+  if (worker_threads.isMainThread || !worker_threads.workerData || !worker_threads.workerData.dwocPar) return init();
+  return worker_threads.workerData.globals[index];
+};
+const $parEntry = (file, table, drain, globals) => {
+  par.entry = file;
+  par.fns = table;
+  par.drain = drain;
+  par.globals = globals;
+  if (worker_threads.isMainThread || !worker_threads.workerData || !worker_threads.workerData.dwocPar) return false;
+  worker_threads.parentPort.on('message', (job) => {
+    try { parWork(job); }
+    catch (e) {
+      Atomics.store(job.ctl, 2, 1);
+      Atomics.store(job.ctl, 0, job.n);
+      fs.writeSync(2, `${e && e.stack || e}\n`);
+    } finally {
+      if (par.drain !== null) par.drain();
+      Atomics.add(job.ctl, 1, 1);
+      Atomics.notify(job.ctl, 1);
+    }
+  });
+  return true;
+};
+const par_map = (fn, items) => {
+  if (!ArrayBuffer.isView(items) && !Array.isArray(items)) items = Array.from(items);
+  const workers = parPool().length;
+  const results = new Float64Array(workers > 0 ? new SharedArrayBuffer(items.length * 8) : items.length);
+  parRun(fn, items.length, workers > 0 ? parShare(items) : items, results);
+  return results;
+};
+globalThis.$parGlobal = $parGlobal;
+globalThis.$parEntry = $parEntry;
+globalThis.par_map = par_map;
+})();
+
+const N = $parGlobal(0, () => read_int());
+const OFFSET = 1000;
+const BANNER = $parGlobal(1, () => announce());
+function announce() {
+  println("started");
+  return N * 2;
+}
+function shift(x) {
+  return x + N + OFFSET + BANNER;
+}
+function main() {
+  let total = 0;
+  for (const v of par_map(shift, Int32Array.of(1, 2, 3, 4, 5, 6, 7, 8))) {
+    total = total + v;
+  }
+  println(total);
+}
+
+if (!$parEntry(__filename, [shift], $drain, () => [N, BANNER])) { const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
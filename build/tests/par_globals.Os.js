@@ -0,0 +1 @@
+"use strict";(function(){const o=require('node:fs');const C=new TextEncoder();const f=new Uint8Array(65536);let b=0;let s=10;const m=()=>{let n=0;while(n<b){try{n+=o.writeSync(1,f,n,b-n);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(b>0)s=f[b-1];b=0;};process.on('exit',m);const D=(byte)=>{if(b===f.length)m();f[b++]=byte;};const t=(g)=>{const d=g.length;if(d<=f.length-b){let i=0;for(;i<d;++i){const c=g.charCodeAt(i);if(c>=128)break;f[b++]=c;}if(i===d)return;g=g.substring(i);}for(;;){const r=C.encodeInto(g,f.subarray(b));b+=r.written;if(r.read===g.length)return;g=g.substring(r.read);m();}};let h=Buffer.allocUnsafe(65536);let k=0,j=0,u=false;let p=false;const E=()=>{if(u)return false;if(k>0){h.copyWithin(0,k,j);j-=k;k=0;}if(j===h.length){const v=Buffer.allocUnsafe(h.length*2);h.copy(v,0,0,j);h=v;}for(;;){try{const d=o.readSync(0,h,j,h.length-j,null);if(d===0)break;j+=d;return true;}catch(e){if(e.code==='EOF')break;if(e.code!=='EAGAIN')throw e;}}u=true;return false;};const l=()=>{p=k===j&&!E();return p?-1:h[k++];};const w=()=>{let a=l();while(a===32||(a>=9&&a<=13))a=l();if(a===-1)return 0;let x=1;if(a===45||a===43){if(a===45)x=-1;a=l();}let d=0;while(a>=48&&a<=57){d=d*10+(a-48);a=l();}if(a!==-1)k-=1;p=false;return x*d;};const y=(...F)=>{for(const q of F)t(typeof q==='string'?q:`${q}`);};const z=t;const A=()=>m();const B=()=>{if((b>0?f[b-1]:s)!==10)D(10);m();};globalThis.read_byte=l;globalThis.read_int=w;globalThis.print=y;globalThis.$write=z;globalThis.$drain=A;globalThis.flush=B;})();(function(){const m=require('node:fs');const h=require('node:os');const d=require('node:worker_threads');const c={entry:null,fns:[],drain:null,globals:null,pool:null};const o=(job)=>{const f=c.fns[job.task];for(;;){const g=Atomics.load(job.ctl,0);if(g>=job.n)return;const j=Math.min(job.n,g+Math.ceil((job.n-g)/(2*job.threads)));if(Atomics.compareExchange(job.ctl,0,g,j)!==g)continue;if(job.output===null){for(let i=g;i<j;++i)f(i);continue;}for(let i=g;i<j;++i){const value=f(job.input[i]);if(typeof value!=='number')throw new Error(`par_map: ${f.name} has to return numbers, got ${value}`);job.output[i]=value;}}};const p=()=>{if(c.pool!==null)return c.pool;const env=Number(process.env.DWOC_PAR_THREADS);const threads=env>0?env:h.availableParallelism?h.availableParallelism():h.cpus().length;c.pool=[];const globals=c.globals();for(let i=1;i<threads;++i){const worker=new d.Worker(c.entry,{workerData:{dwocPar:true,globals:globals}});worker.unref();c.pool.push(worker);}return c.pool;};const u=(b)=>{if(ArrayBuffer.isView(b)&&b.buffer instanceof SharedArrayBuffer)return b;let shared=null;if(ArrayBuffer.isView(b)){shared=new(b instanceof Buffer?Uint8Array:b.constructor)(new SharedArrayBuffer(b.byteLength));}else{for(const item of b)if(typeof item!=='number')return b;shared=new Float64Array(new SharedArrayBuffer(b.length*8));}shared.set(b);return shared;};const v=(f,n,input,output)=>{const task=c.fns.indexOf(f);if(task===-1)throw new Error(`core:par: ${f.name} was not compiled as a worker entry point`);const pool=p();const job={task:task,n:n,input:input,output:output,threads:pool.length+1,ctl:new Int32Array(new SharedArrayBuffer(12))};for(const worker of pool)worker.postMessage(job);let k=null;try{o(job);}catch(e){k=e;Atomics.store(job.ctl,0,n);}for(;;){const done=Atomics.load(job.ctl,1);if(done===pool.length)break;Atomics.wait(job.ctl,1,done);}if(k!==null)throw k;if(Atomics.load(job.ctl,2)!==0)throw new Error('core:par: a worker failed');};const q=(w,x)=>{if(d.isMainThread||!d.workerData||!d.workerData.dwocPar)return x();return d.workerData.globals[w];};const r=(y,z,drain,globals)=>{c.entry=y;c.fns=z;c.drain=drain;c.globals=globals;if(d.isMainThread||!d.workerData||!d.workerData.dwocPar)return false;d.parentPort.on('message',(job)=>{try{o(job);}catch(e){Atomics.store(job.ctl,2,1);Atomics.store(job.ctl,0,job.n);m.writeSync(2,`${e&&e.stack||e}\n`);}finally{if(c.drain!==null)c.drain();Atomics.add(job.ctl,1,1);Atomics.notify(job.ctl,1);}});return true;};const l=(f,b)=>{if(!ArrayBuffer.isView(b)&&!Array.isArray(b))b=Array.from(b);const s=p().length;const t=new Float64Array(s>0?new SharedArrayBuffer(b.length*8):b.length);v(f,b.length,s>0?u(b):b,t);return t;};globalThis.$parGlobal=q;globalThis.$parEntry=r;globalThis.par_map=l;})();const N=$parGlobal(0,()=>read_int());const OFFSET=1000;const BANNER=$parGlobal(1,()=>announce());function announce(){$write("started\n");return N*2;}function shift(a){return a+N+OFFSET+BANNER;}function main(){let a=0;for(const b of par_map(shift,Int32Array.of(1,2,3,4,5,6,7,8))){a=a+b;}print(a);$write("\n");}if(!$parEntry(__filename,[shift],$drain,()=>[N,BANNER])){const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
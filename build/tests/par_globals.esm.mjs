@@ -0,0 +1,24 @@
+import { read_byte, read_int, print, $write, $drain, flush } from "./dwoc_runtime.mjs";
+
+import { $parGlobal, $parEntry, par_map } from "./dwoc_runtime.mjs";
+
+const N = $parGlobal(0, () => read_int());
+const OFFSET = 1000;
+const BANNER = $parGlobal(1, () => announce());
+function announce() {
+  $write("started\n");
+  return N * 2;
+}
+function shift(x) {
+  return x + N + OFFSET + BANNER;
+}
+function main() {
+  let total = 0;
+  for (const v of par_map(shift, Int32Array.of(1, 2, 3, 4, 5, 6, 7, 8))) {
+    total = total + v;
+  }
+  print(total);
+  $write("\n");
+}
+
+if (!$parEntry(new URL(import.meta.url), [shift], $drain, () => [N, BANNER])) { const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
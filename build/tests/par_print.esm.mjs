@@ -0,0 +1,19 @@
+import { $write, $drain, flush } from "./dwoc_runtime.mjs";
+
+import { $parGlobal, $parEntry, par_for } from "./dwoc_runtime.mjs";
+
+function report(i) {
+  let k = 0;
+  while (k < 2000000) {
+    k = k + 1;
+  }
+  if (i >= 0) {
+    $write("reported\n");
+  }
+}
+function main() {
+  par_for(40, report);
+  $write("done\n");
+}
+
+if (!$parEntry(new URL(import.meta.url), [report], $drain, () => [])) { const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
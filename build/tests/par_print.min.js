@@ -0,0 +1 @@
+"use strict";(function(){const h=require('node:fs');const o=new TextEncoder();const b=new Uint8Array(65536);let a=0;let j=10;const f=()=>{let g=0;while(g<a){try{g+=h.writeSync(1,b,g,a-g);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)j=b[a-1];a=0;};process.on('exit',f);const p=(byte)=>{if(a===b.length)f();b[a++]=byte;};const q=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=o.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);f();}};const k=q;const l=()=>f();const m=()=>{if((a>0?b[a-1]:j)!==10)p(10);f();};globalThis.$write=k;globalThis.$drain=l;globalThis.flush=m;})();(function(){const k=require('node:fs');const g=require('node:os');const c=require('node:worker_threads');const b={entry:null,fns:[],drain:null,globals:null,pool:null};const l=(job)=>{const d=b.fns[job.task];for(;;){const f=Atomics.load(job.ctl,0);if(f>=job.n)return;const h=Math.min(job.n,f+Math.ceil((job.n-f)/(2*job.threads)));if(Atomics.compareExchange(job.ctl,0,f,h)!==f)continue;if(job.output===null){for(let i=f;i<h;++i)d(i);continue;}for(let i=f;i<h;++i){const value=d(job.input[i]);if(typeof value!=='number')throw new Error(`par_map: ${d.name} has to return numbers, got ${value}`);job.output[i]=value;}}};const q=()=>{if(b.pool!==null)return b.pool;const env=Number(process.env.DWOC_PAR_THREADS);const threads=env>0?env:g.availableParallelism?g.availableParallelism():g.cpus().length;b.pool=[];const globals=b.globals();for(let i=1;i<threads;++i){const worker=new c.Worker(b.entry,{workerData:{dwocPar:true,globals:globals}});worker.unref();b.pool.push(worker);}return b.pool;};const x=(items)=>{if(ArrayBuffer.isView(items)&&items.buffer instanceof SharedArrayBuffer)return items;let shared=null;if(ArrayBuffer.isView(items)){shared=new(items instanceof Buffer?Uint8Array:items.constructor)(new SharedArrayBuffer(items.byteLength));}else{for(const item of items)if(typeof item!=='number')return items;shared=new Float64Array(new SharedArrayBuffer(items.length*8));}shared.set(items);return shared;};const r=(d,n,input,output)=>{const task=b.fns.indexOf(d);if(task===-1)throw new Error(`core:par: ${d.name} was not compiled as a worker entry point`);const pool=q();const job={task:task,n:n,input:input,output:output,threads:pool.length+1,ctl:new Int32Array(new SharedArrayBuffer(12))};for(const worker of pool)worker.postMessage(job);let j=null;try{l(job);}catch(e){j=e;Atomics.store(job.ctl,0,n);}for(;;){const done=Atomics.load(job.ctl,1);if(done===pool.length)break;Atomics.wait(job.ctl,1,done);}if(j!==null)throw j;if(Atomics.load(job.ctl,2)!==0)throw new Error('core:par: a worker failed');};const m=(s,t)=>{if(c.isMainThread||!c.workerData||!c.workerData.dwocPar)return t();return c.workerData.globals[s];};const o=(u,v,drain,globals)=>{b.entry=u;b.fns=v;b.drain=drain;b.globals=globals;if(c.isMainThread||!c.workerData||!c.workerData.dwocPar)return false;c.parentPort.on('message',(job)=>{try{l(job);}catch(e){Atomics.store(job.ctl,2,1);Atomics.store(job.ctl,0,job.n);k.writeSync(2,`${e&&e.stack||e}\n`);}finally{if(b.drain!==null)b.drain();Atomics.add(job.ctl,1,1);Atomics.notify(job.ctl,1);}});return true;};const p=(w,d)=>{r(d,w,null,null);};globalThis.$parGlobal=m;globalThis.$parEntry=o;globalThis.par_for=p;})();function report(b){let a=0;while(a<2000000){a=a+1;}if(b>=0){$write("reported\n");}}function main(){par_for(40,report);$write("done\n");}if(!$parEntry(__filename,[report],$drain,()=>[])){const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1 @@
+"use strict";(function(){const l=require('node:fs');const u=new TextEncoder();const b=new Uint8Array(65536);let a=0;let m=10;const g=()=>{let h=0;while(h<a){try{h+=l.writeSync(1,b,h,a-h);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)m=b[a-1];a=0;};process.on('exit',g);const o=(byte)=>{if(a===b.length)g();b[a++]=byte;};const j=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=u.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);g();}};const p=(...k)=>{for(const f of k)j(typeof f==='string'?f:`${f}`);};const q=(...k)=>{for(const f of k)j(typeof f==='string'?f:`${f}`);o(10);};const s=j;const t=()=>{if((a>0?b[a-1]:m)!==10)o(10);g();};globalThis.print=p;globalThis.println=q;globalThis.$write=s;globalThis.flush=t;})();function square(a){return a*a;}function is_odd(a){return a%2===1;}function add(a,b){return a+b;}function scale(a,b){return a*b;}function sum_odd_squares(a){{let $v1=0;for(let $i=0;$i<a.length;$i++){let $it=a[$i];if(!is_odd($it))continue;$it=square($it);$v1=add($v1,$it);}return $v1;}}function scaled_total$by_k(a,b){return a*b;}function scaled_total(a,b){{let $v1=0;for(let $i=0;$i<a.length;$i++){let $it=a[$i];$it=scaled_total$by_k($it,b);$v1=add($v1,$it);}return $v1;}}function main(){{const $src1=Int32Array.of(1,2,3,4,5);const $v1=[];for(let $i=0;$i<$src1.length;$i++){let $it=$src1[$i];$it=square($it);$v1.push($it);}println($v1);}let b;{const $src1=Int32Array.of(1,2,3,4,5,6,7);const $v1=[];for(let $i=0;$i<$src1.length;$i++){const $it=$src1[$i];if(!is_odd($it))continue;$v1.push($it);}b=$v1;}print(b);$write("\n");print(sum_odd_squares(Int32Array.of(1,2,3,4,5)));$write("\n");print(1+(()=>{const $src1=Int32Array.of(1,2,3);let $v1=10;for(let $i=0;$i<$src1.length;$i++){const $it=$src1[$i];$v1=add($v1,$it);}return $v1;})());$write("\n");print(scaled_total(Int32Array.of(1,2,3),4));$write("\n");let a=square(scale(3,2));print(a);$write("\n");{const $src1=Int32Array.of(2,3);let $v1=0;for(let $i=0;$i<$src1.length;$i++){let $it=$src1[$i];$it=square($it);$v1=add($v1,$it);}a=scale($v1,10);}print(a);$write("\n");}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
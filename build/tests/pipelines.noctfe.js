@@ -0,0 +1,146 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const $write = outText;
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.println = println;
+globalThis.$write = $write;
+globalThis.flush = flush;
+})();
+
+function square(x) {
+  return x * x;
+}
+function is_odd(x) {
+  return x % 2 === 1;
+}
+function add(a, b) {
+  return a + b;
+}
+function scale(x, k) {
+  return x * k;
+}
+function sum_odd_squares(xs) {
+  {
+    let $v1 = 0;
+    for (let $i = 0; $i < xs.length; $i++) {
+      let $it = xs[$i];
+      if (!is_odd($it)) continue;
+      $it = square($it);
+      $v1 = add($v1, $it);
+    }
+    return $v1;
+  }
+}
+function scaled_total$by_k(x, k) {
+  return x * k;
+}
+function scaled_total(xs, k) {
+  {
+    let $v1 = 0;
+    for (let $i = 0; $i < xs.length; $i++) {
+      let $it = xs[$i];
+      $it = scaled_total$by_k($it, k);
+      $v1 = add($v1, $it);
+    }
+    return $v1;
+  }
+}
+function main() {
+  {
+    const $src1 = Int32Array.of(1, 2, 3, 4, 5);
+    const $v1 = [];
+    for (let $i = 0; $i < $src1.length; $i++) {
+      let $it = $src1[$i];
+      $it = square($it);
+      $v1.push($it);
+    }
+    println($v1);
+  }
+  let odds;
+  {
+    const $src1 = Int32Array.of(1, 2, 3, 4, 5, 6, 7);
+    const $v1 = [];
+    for (let $i = 0; $i < $src1.length; $i++) {
+      const $it = $src1[$i];
+      if (!is_odd($it)) continue;
+      $v1.push($it);
+    }
+    odds = $v1;
+  }
+  print(odds);
+  $write("\n");
+  print(sum_odd_squares(Int32Array.of(1, 2, 3, 4, 5)));
+  $write("\n");
+  print(1 + (() => { const $src1 = Int32Array.of(1, 2, 3); let $v1 = 10; for (let $i = 0; $i < $src1.length; $i++) { const $it = $src1[$i]; $v1 = add($v1, $it); } return $v1; })());
+  $write("\n");
+  print(scaled_total(Int32Array.of(1, 2, 3), 4));
+  $write("\n");
+  let y = square(scale(3, 2));
+  print(y);
+  $write("\n");
+  {
+    const $src1 = Int32Array.of(2, 3);
+    let $v1 = 0;
+    for (let $i = 0; $i < $src1.length; $i++) {
+      let $it = $src1[$i];
+      $it = square($it);
+      $v1 = add($v1, $it);
+    }
+    y = scale($v1, 10);
+  }
+  print(y);
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,19 @@
+import { print, $write, flush } from "./dwoc_runtime.mjs";
+
+function main() {
+  $write("7\n");
+  const G$s1 = 8;
+  $write("8\n");
+  {
+    const G$s2 = 9;
+    $write("9\n");
+  }
+  $write("8\n");
+  for (const G$s3 of Int32Array.of(1, 2)) {
+    print(G$s3);
+  }
+  $write("\n8\n");
+  return 0;
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
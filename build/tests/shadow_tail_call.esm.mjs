@@ -0,0 +1,32 @@
+import { print, $write, $writeNumber, flush } from "./dwoc_runtime.mjs";
+
+function f(n, acc) {
+  tail: while (true) {
+    if (n === 0) {
+      return acc;
+    }
+    let k = n - 1;
+    {
+      let n$s1 = k;
+      { n = n$s1; acc = acc + 1; continue tail; }
+    }
+    return;
+  }
+}
+function main() {
+  let five = 5;
+  print(f(five, 0));
+  $write("\n");
+  {
+    let n$1 = 10;
+    {
+      let k$1 = n$1 - 1;
+      let n$s2$1 = k$1;
+      $writeNumber(n$s2$1);
+      $write("\n");
+    }
+  }
+  return 0;
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
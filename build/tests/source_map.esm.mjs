@@ -0,0 +1,7 @@
+import { $write, flush } from "./dwoc_runtime.mjs";
+
+function main() {
+  $write("42\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1 @@
+"use strict";(function(){const h=require('node:fs');const m=new TextEncoder();const b=new Uint8Array(65536);let a=0;let j=10;const f=()=>{let g=0;while(g<a){try{g+=h.writeSync(1,b,g,a-g);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)j=b[a-1];a=0;};process.on('exit',f);const o=(byte)=>{if(a===b.length)f();b[a++]=byte;};const p=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=m.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);f();}};const k=p;const l=()=>{if((a>0?b[a-1]:j)!==10)o(10);f();};globalThis.$write=k;globalThis.flush=l;})();function main(){$write("42\n");}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1,106 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+let inBytes = Buffer.allocUnsafe(65536);
+let inStart = 0, inEnd = 0, inEof = false;
+let inMissed = false;
+const inFill = () => {
+  if (inEof) return false;
+  if (inStart > 0) { inBytes.copyWithin(0, inStart, inEnd); inEnd -= inStart; inStart = 0; }
+  if (inEnd === inBytes.length) {
+    const grown = Buffer.allocUnsafe(inBytes.length * 2);
+    inBytes.copy(grown, 0, 0, inEnd);
+    inBytes = grown;
+  }
+  for (;;) {
+    try {
+      const n = fs.readSync(0, inBytes, inEnd, inBytes.length - inEnd, null);
+      if (n === 0) break;
+      inEnd += n;
+      return true;
+    } catch (e) {
+      if (e.code === 'EOF') break;
+      if (e.code !== 'EAGAIN') throw e;
+    }
+  }
+  inEof = true;
+  return false;
+};
+const read_byte = () => {
+  inMissed = inStart === inEnd && !inFill();
+  return inMissed ? -1 : inBytes[inStart++];
+};
+const read_all = () => {
+  while (inFill()) {}
+  const all = inBytes.toString('utf8', inStart, inEnd);
+  inStart = inEnd;
+  inMissed = all.length === 0;
+  return all;
+};
+const eof = () => inMissed ? 1 : 0;
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.read_byte = read_byte;
+globalThis.read_all = read_all;
+globalThis.eof = eof;
+globalThis.print = print;
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+function main() {
+  let c = read_byte();
+  print(c, " ");
+  print(read_all());
+  println("|", eof());
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
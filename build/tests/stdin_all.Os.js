@@ -0,0 +1 @@
+"use strict";(function(){const o=require('node:fs');const F=new TextEncoder();const f=new Uint8Array(65536);let a=0;let s=10;const l=()=>{let m=0;while(m<a){try{m+=o.writeSync(1,f,m,a-m);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)s=f[a-1];a=0;};process.on('exit',l);const t=(byte)=>{if(a===f.length)l();f[a++]=byte;};const p=(g)=>{const k=g.length;if(k<=f.length-a){let i=0;for(;i<k;++i){const c=g.charCodeAt(i);if(c>=128)break;f[a++]=c;}if(i===k)return;g=g.substring(i);}for(;;){const r=F.encodeInto(g,f.subarray(a));a+=r.written;if(r.read===g.length)return;g=g.substring(r.read);l();}};let d=Buffer.allocUnsafe(65536);let h=0,b=0,u=false;let n=false;const v=()=>{if(u)return false;if(h>0){d.copyWithin(0,h,b);b-=h;h=0;}if(b===d.length){const w=Buffer.allocUnsafe(d.length*2);d.copy(w,0,0,b);d=w;}for(;;){try{const k=o.readSync(0,d,b,d.length-b,null);if(k===0)break;b+=k;return true;}catch(e){if(e.code==='EOF')break;if(e.code!=='EAGAIN')throw e;}}u=true;return false;};const x=()=>{n=h===b&&!v();return n?-1:d[h++];};const y=()=>{while(v()){}const z=d.toString('utf8',h,b);h=b;n=z.length===0;return z;};const A=()=>n?1:0;const B=(...q)=>{for(const j of q)p(typeof j==='string'?j:`${j}`);};const C=(...q)=>{for(const j of q)p(typeof j==='string'?j:`${j}`);t(10);};const D=p;const E=()=>{if((a>0?f[a-1]:s)!==10)t(10);l();};globalThis.read_byte=x;globalThis.read_all=y;globalThis.eof=A;globalThis.print=B;globalThis.println=C;globalThis.$write=D;globalThis.flush=E;})();function main(){let a=read_byte();print(a);$write(" ");print(read_all());println("|",eof());}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1,11 @@
+import { read_byte, read_all, eof, print, println, $write, flush } from "./dwoc_runtime.mjs";
+
+function main() {
+  let c = read_byte();
+  print(c);
+  $write(" ");
+  print(read_all());
+  println("|", eof());
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,140 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+let inBytes = Buffer.allocUnsafe(65536);
+let inStart = 0, inEnd = 0, inEof = false;
+let inMissed = false;
+const inFill = () => {
+  if (inEof) return false;
+  if (inStart > 0) { inBytes.copyWithin(0, inStart, inEnd); inEnd -= inStart; inStart = 0; }
+  if (inEnd === inBytes.length) {
+    const grown = Buffer.allocUnsafe(inBytes.length * 2);
+    inBytes.copy(grown, 0, 0, inEnd);
+    inBytes = grown;
+  }
+  for (;;) {
+    try {
+      const n = fs.readSync(0, inBytes, inEnd, inBytes.length - inEnd, null);
+      if (n === 0) break;
+      inEnd += n;
+      return true;
+    } catch (e) {
+      if (e.code === 'EOF') break;
+      if (e.code !== 'EAGAIN') throw e;
+    }
+  }
+  inEof = true;
+  return false;
+};
+const read_byte = () => {
+  inMissed = inStart === inEnd && !inFill();
+  return inMissed ? -1 : inBytes[inStart++];
+};
+const read_line = () => {
+  let scan = inStart;
+  for (;;) {
+    const nl = inBytes.indexOf(10, scan);
+    if (nl !== -1 && nl < inEnd) {
+      const end = nl > inStart && inBytes[nl - 1] === 13 ? nl - 1 : nl;
+      const line = inBytes.toString('utf8', inStart, end);
+      inStart = nl + 1;
+      inMissed = false;
+      return line;
+    }
+    scan = inEnd - inStart;
+    if (!inFill()) break;
+  }
+  inMissed = inStart === inEnd;
+  if (inMissed) return -1;
+  const line = inBytes.toString('utf8', inStart, inEnd);
+  inStart = inEnd;
+  return line;
+};
+const read_int = () => {
+  let b = read_byte();
+  while (b === 32 || (b >= 9 && b <= 13)) b = read_byte();
+  if (b === -1) return 0;
+  let sign = 1;
+  if (b === 45 || b === 43) { if (b === 45) sign = -1; b = read_byte(); }
+  let n = 0;
+  while (b >= 48 && b <= 57) { n = n * 10 + (b - 48); b = read_byte(); }
+  if (b !== -1) inStart -= 1;
+  inMissed = false;
+  return sign * n;
+};
+const eof = () => inMissed ? 1 : 0;
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.read_byte = read_byte;
+globalThis.read_line = read_line;
+globalThis.read_int = read_int;
+globalThis.eof = eof;
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+function main() {
+  let count = read_int();
+  let sum = 0;
+  let i = 0;
+  while (i < count) {
+    sum = sum + read_int();
+    i = i + 1;
+  }
+  println("sum ", sum);
+  let first = read_line();
+  println("rest of line [", first, "]");
+  let line = read_line();
+  while (eof() === 0) {
+    println("line [", line, "]");
+    line = read_line();
+  }
+  println("eof ", line, " ", read_byte(), " ", read_int(), " ", eof());
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
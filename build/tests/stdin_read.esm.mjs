@@ -0,0 +1,28 @@
+import { read_byte, read_line, read_int, eof, print, println, $write, flush } from "./dwoc_runtime.mjs";
+
+function main() {
+  let count = read_int();
+  let sum = 0;
+  let i = 0;
+  while (i < count) {
+    sum = sum + read_int();
+    i = i + 1;
+  }
+  $write("sum ");
+  print(sum);
+  $write("\n");
+  let first = read_line();
+  $write("rest of line [");
+  print(first);
+  $write("]\n");
+  let line = read_line();
+  while (eof() === 0) {
+    $write("line [");
+    print(line);
+    $write("]\n");
+    line = read_line();
+  }
+  println("eof ", line, " ", read_byte(), " ", read_int(), " ", eof());
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1 @@
+"use strict";(function(){const s=require('node:fs');const K=new TextEncoder();const j=new Uint8Array(65536);let d=0;let w=10;const p=()=>{let q=0;while(q<d){try{q+=s.writeSync(1,j,q,d-q);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(d>0)w=j[d-1];d=0;};process.on('exit',p);const x=(byte)=>{if(d===j.length)p();j[d++]=byte;};const t=(k)=>{const h=k.length;if(h<=j.length-d){let i=0;for(;i<h;++i){const c=k.charCodeAt(i);if(c>=128)break;j[d++]=c;}if(i===h)return;k=k.substring(i);}for(;;){const r=K.encodeInto(k,j.subarray(d));d+=r.written;if(r.read===k.length)return;k=k.substring(r.read);p();}};let g=Buffer.allocUnsafe(65536);let a=0,f=0,y=false;let l=false;const z=()=>{if(y)return false;if(a>0){g.copyWithin(0,a,f);f-=a;a=0;}if(f===g.length){const A=Buffer.allocUnsafe(g.length*2);g.copy(A,0,0,f);g=A;}for(;;){try{const h=s.readSync(0,g,f,g.length-f,null);if(h===0)break;f+=h;return true;}catch(e){if(e.code==='EOF')break;if(e.code!=='EAGAIN')throw e;}}y=true;return false;};const o=()=>{l=a===f&&!z();return l?-1:g[a++];};const B=()=>{let C=a;for(;;){const m=g.indexOf(10,C);if(m!==-1&&m<f){const L=m>a&&g[m-1]===13?m-1:m;const u=g.toString('utf8',a,L);a=m+1;l=false;return u;}C=f-a;if(!z())break;}l=a===f;if(l)return-1;const u=g.toString('utf8',a,f);a=f;return u;};const D=()=>{let b=o();while(b===32||(b>=9&&b<=13))b=o();if(b===-1)return 0;let E=1;if(b===45||b===43){if(b===45)E=-1;b=o();}let h=0;while(b>=48&&b<=57){h=h*10+(b-48);b=o();}if(b!==-1)a-=1;l=false;return E*h;};const F=()=>l?1:0;const G=(...v)=>{for(const n of v)t(typeof n==='string'?n:`${n}`);};const H=(...v)=>{for(const n of v)t(typeof n==='string'?n:`${n}`);x(10);};const I=t;const J=()=>{if((d>0?j[d-1]:w)!==10)x(10);p();};globalThis.read_byte=o;globalThis.read_line=B;globalThis.read_int=D;globalThis.eof=F;globalThis.print=G;globalThis.println=H;globalThis.$write=I;globalThis.flush=J;})();function main(){let d=read_int();let a=0;let b=0;while(b<d){a=a+read_int();b=b+1;}$write("sum ");print(a);$write("\n");let e=read_line();$write("rest of line [");print(e);$write("]\n");let c=read_line();while(eof()===0){$write("line [");print(c);$write("]\n");c=read_line();}println("eof ",c," ",read_byte()," ",read_int()," ",eof());}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1 @@
+"use strict";(function(){const j=require('node:fs');const q=new TextEncoder();const b=new Uint8Array(65536);let a=0;let k=10;const f=()=>{let g=0;while(g<a){try{g+=j.writeSync(1,b,g,a-g);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)k=b[a-1];a=0;};process.on('exit',f);const s=(byte)=>{if(a===b.length)f();b[a++]=byte;};const l=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=q.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);f();}};const m=(...t)=>{for(const h of t)l(typeof h==='string'?h:`${h}`);};const o=l;const p=()=>{if((a>0?b[a-1]:k)!==10)s(10);f();};globalThis.print=m;globalThis.$write=o;globalThis.flush=p;})();class Point{constructor(x,y){this.x=x;this.y=y;}}class Particle{constructor(x,v,mass){this.x=x;this.v=v;this.mass=mass;}}class Particle$soa{constructor(length,x,v,mass){this.length=length;this.x=x;this.v=v;this.mass=mass;}at(i){return new Particle(this.x[i],this.v[i],this.mass[i]);}slice(start,end){const x=this.x.subarray(start,end);return new Particle$soa(x.length,x,this.v.subarray(start,end),this.mass.subarray(start,end));}}function add(a,b){return a+b;}function mass_of(a){return a.mass;}function dist2(a){return a.x*a.x+a.y*a.y;}function total_momentum(c,d){let a=0;let b=0;while(a<d){b=b+c.v[a]*c.mass[a];a=a+1;}return b;}function main(){const b=new Point(3,4);print(b.x);$write(" ");print(b.y);$write(" ");print(dist2(b));$write("\n");const a=new Particle$soa(3,Int32Array.of(1,4,7),Int32Array.of(2,5,8),Int32Array.of(3,6,9));print(total_momentum(a,3));$write("\n");print(a.x[1]+a.mass[2]);$write("\n");const e=a.at(1);print(e.v);$write("\n");const c=a.slice(1);print(c.x[0]);$write(" ");print(c.mass[1]);$write("\n");print((()=>{let $v1=0;for(let $i=0;$i<a.length;$i++){let $it=a.at($i);$it=mass_of($it);$v1=add($v1,$it);}return $v1;})());$write("\n");let d=1000;const f=new Particle$soa(d,new Int32Array(d),new Int32Array(d).fill(1),new Int32Array(d).fill(2));print(total_momentum(f,d));$write("\n");const g=[new Point(1,2),new Point(3,4)];print(g[1].y);$write("\n");}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1,79 @@
+import { print, $write, $writeNumber, flush } from "./dwoc_runtime.mjs";
+
+class Point {
+  constructor(x, y) {
+    this.x = x;
+    this.y = y;
+  }
+}
+class Particle {
+  constructor(x, v, mass) {
+    this.x = x;
+    this.v = v;
+    this.mass = mass;
+  }
+}
+class Particle$soa {
+  constructor(length, x, v, mass) {
+    this.length = length;
+    this.x = x;
+    this.v = v;
+    this.mass = mass;
+  }
+  at(i) {
+    return new Particle(this.x[i], this.v[i], this.mass[i]);
+  }
+  slice(start, end) {
+    const x = this.x.subarray(start, end);
+    return new Particle$soa(x.length, x, this.v.subarray(start, end), this.mass.subarray(start, end));
+  }
+}
+
+function add(a, b) {
+  return a + b;
+}
+function mass_of(p) {
+  return p.mass;
+}
+function total_momentum(ps, n) {
+  let i = 0;
+  let total = 0;
+  while (i < n) {
+    total = total + ps.v[i] * ps.mass[i];
+    i = i + 1;
+  }
+  return total;
+}
+function main() {
+  const p = new Point(3, 4);
+  print(p.x);
+  $write(" ");
+  print(p.y);
+  $write(" ");
+  $writeNumber(p.x * p.x + p.y * p.y);
+  $write("\n");
+  const ps = new Particle$soa(3, Int32Array.of(1, 4, 7), Int32Array.of(2, 5, 8), Int32Array.of(3, 6, 9));
+  print(total_momentum(ps, 3));
+  $write("\n");
+  print(ps.x[1] + ps.mass[2]);
+  $write("\n");
+  const q = ps.at(1);
+  print(q.v);
+  $write("\n");
+  const tail = ps.slice(1);
+  print(tail.x[0]);
+  $write(" ");
+  print(tail.mass[1]);
+  $write("\n");
+  print((() => { let $v1 = 0; for (let $i = 0; $i < ps.length; $i++) { let $it = ps.at($i); $it = mass_of($it); $v1 = add($v1, $it); } return $v1; })());
+  $write("\n");
+  let n = 1000;
+  const many = new Particle$soa(n, new Int32Array(n), new Int32Array(n).fill(1), new Int32Array(n).fill(2));
+  print(total_momentum(many, n));
+  $write("\n");
+  const pts = [new Point(1, 2), new Point(3, 4)];
+  print(pts[1].y);
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,120 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+class Point {
+  constructor(x, y) {
+    this.x = x;
+    this.y = y;
+  }
+}
+class Particle {
+  constructor(x, v, mass) {
+    this.x = x;
+    this.v = v;
+    this.mass = mass;
+  }
+}
+class Particle$soa {
+  constructor(length, x, v, mass) {
+    this.length = length;
+    this.x = x;
+    this.v = v;
+    this.mass = mass;
+  }
+  at(i) {
+    return new Particle(this.x[i], this.v[i], this.mass[i]);
+  }
+  slice(start, end) {
+    const x = this.x.subarray(start, end);
+    return new Particle$soa(x.length, x, this.v.subarray(start, end), this.mass.subarray(start, end));
+  }
+}
+
+function add(a, b) {
+  return a + b;
+}
+function mass_of(p) {
+  return p.mass;
+}
+function dist2(p) {
+  return p.x * p.x + p.y * p.y;
+}
+function total_momentum(ps, n) {
+  let i = 0;
+  let total = 0;
+  while (i < n) {
+    total = total + ps.v[i] * ps.mass[i];
+    i = i + 1;
+  }
+  return total;
+}
+function main() {
+  const p = new Point(3, 4);
+  println(p.x, " ", p.y, " ", dist2(p));
+  const ps = new Particle$soa(3, Int32Array.of(1, 4, 7), Int32Array.of(2, 5, 8), Int32Array.of(3, 6, 9));
+  println(total_momentum(ps, 3));
+  println(ps.x[1] + ps.mass[2]);
+  const q = ps.at(1);
+  println(q.v);
+  const tail = ps.slice(1);
+  println(tail.x[0], " ", tail.mass[1]);
+  println((() => { let $v1 = 0; for (let $i = 0; $i < ps.length; $i++) { let $it = ps.at($i); $it = mass_of($it); $v1 = add($v1, $it); } return $v1; })());
+  let n = 1000;
+  const many = new Particle$soa(n, new Int32Array(n), new Int32Array(n).fill(1), new Int32Array(n).fill(2));
+  println(total_momentum(many, n));
+  const pts = [new Point(1, 2), new Point(3, 4)];
+  println(pts[1].y);
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
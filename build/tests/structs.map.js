@@ -0,0 +1,143 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const $write = outText;
+const $writeNumber = (n) => {
+  if ((n | 0) !== n) { outText(`${n}`); return; }
+  if (outLength + 11 > outBytes.length) outDrain();
+  if (n < 0) { outBytes[outLength++] = 45; n = -n; }
+  let end = outLength + 1;
+  for (let rest = n; rest >= 10; rest = (rest / 10) | 0) end += 1;
+  outLength = end;
+  do { outBytes[--end] = 48 + n % 10; n = (n / 10) | 0; } while (n > 0);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.$write = $write;
+globalThis.$writeNumber = $writeNumber;
+globalThis.flush = flush;
+})();
+
+class Point {
+  constructor(x, y) {
+    this.x = x;
+    this.y = y;
+  }
+}
+class Particle {
+  constructor(x, v, mass) {
+    this.x = x;
+    this.v = v;
+    this.mass = mass;
+  }
+}
+class Particle$soa {
+  constructor(length, x, v, mass) {
+    this.length = length;
+    this.x = x;
+    this.v = v;
+    this.mass = mass;
+  }
+  at(i) {
+    return new Particle(this.x[i], this.v[i], this.mass[i]);
+  }
+  slice(start, end) {
+    const x = this.x.subarray(start, end);
+    return new Particle$soa(x.length, x, this.v.subarray(start, end), this.mass.subarray(start, end));
+  }
+}
+
+function add(a, b) {
+  return a + b;
+}
+function mass_of(p) {
+  return p.mass;
+}
+function total_momentum(ps, n) {
+  let i = 0;
+  let total = 0;
+  while (i < n) {
+    total = total + ps.v[i] * ps.mass[i];
+    i = i + 1;
+  }
+  return total;
+}
+function main() {
+  const p = new Point(3, 4);
+  print(p.x);
+  $write(" ");
+  print(p.y);
+  $write(" ");
+  $writeNumber(p.x * p.x + p.y * p.y);
+  $write("\n");
+  const ps = new Particle$soa(3, Int32Array.of(1, 4, 7), Int32Array.of(2, 5, 8), Int32Array.of(3, 6, 9));
+  print(total_momentum(ps, 3));
+  $write("\n");
+  print(ps.x[1] + ps.mass[2]);
+  $write("\n");
+  const q = ps.at(1);
+  print(q.v);
+  $write("\n");
+  const tail = ps.slice(1);
+  print(tail.x[0]);
+  $write(" ");
+  print(tail.mass[1]);
+  $write("\n");
+  print((() => { let $v1 = 0; for (let $i = 0; $i < ps.length; $i++) { let $it = ps.at($i); $it = mass_of($it); $v1 = add($v1, $it); } return $v1; })());
+  $write("\n");
+  let n = 1000;
+  const many = new Particle$soa(n, new Int32Array(n), new Int32Array(n).fill(1), new Int32Array(n).fill(2));
+  print(total_momentum(many, n));
+  $write("\n");
+  const pts = [new Point(1, 2), new Point(3, 4)];
+  print(pts[1].y);
+  $write("\n");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
+//# sourceMappingURL=structs.map.js.map
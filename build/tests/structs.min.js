@@ -0,0 +1 @@
+"use strict";(function(){const n=require('node:fs');const u=new TextEncoder();const d=new Uint8Array(65536);let a=0;let o=10;const g=()=>{let h=0;while(h<a){try{h+=n.writeSync(1,d,h,a-h);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)o=d[a-1];a=0;};process.on('exit',g);const v=(byte)=>{if(a===d.length)g();d[a++]=byte;};const j=(f)=>{const b=f.length;if(b<=d.length-a){let i=0;for(;i<b;++i){const c=f.charCodeAt(i);if(c>=128)break;d[a++]=c;}if(i===b)return;f=f.substring(i);}for(;;){const r=u.encodeInto(f,d.subarray(a));a+=r.written;if(r.read===f.length)return;f=f.substring(r.read);g();}};const p=(...w)=>{for(const k of w)j(typeof k==='string'?k:`${k}`);};const q=j;const s=(b)=>{if((b|0)!==b){j(`${b}`);return;}if(a+11>d.length)g();if(b<0){d[a++]=45;b=-b;}let m=a+1;for(let l=b;l>=10;l=(l/10)|0)m+=1;a=m;do{d[--m]=48+b%10;b=(b/10)|0;}while(b>0);};const t=()=>{if((a>0?d[a-1]:o)!==10)v(10);g();};globalThis.print=p;globalThis.$write=q;globalThis.$writeNumber=s;globalThis.flush=t;})();class Point{constructor(x,y){this.x=x;this.y=y;}}class Particle{constructor(x,v,mass){this.x=x;this.v=v;this.mass=mass;}}class Particle$soa{constructor(length,x,v,mass){this.length=length;this.x=x;this.v=v;this.mass=mass;}at(i){return new Particle(this.x[i],this.v[i],this.mass[i]);}slice(start,end){const x=this.x.subarray(start,end);return new Particle$soa(x.length,x,this.v.subarray(start,end),this.mass.subarray(start,end));}}function add(a,b){return a+b;}function mass_of(a){return a.mass;}function total_momentum(c,d){let a=0;let b=0;while(a<d){b=b+c.v[a]*c.mass[a];a=a+1;}return b;}function main(){const a=new Point(3,4);print(a.x);$write(" ");print(a.y);$write(" ");$writeNumber(a.x*a.x+a.y*a.y);$write("\n");const b=new Particle$soa(3,Int32Array.of(1,4,7),Int32Array.of(2,5,8),Int32Array.of(3,6,9));print(total_momentum(b,3));$write("\n");print(b.x[1]+b.mass[2]);$write("\n");const e=b.at(1);print(e.v);$write("\n");const c=b.slice(1);print(c.x[0]);$write(" ");print(c.mass[1]);$write("\n");print((()=>{let $v1=0;for(let $i=0;$i<b.length;$i++){let $it=b.at($i);$it=mass_of($it);$v1=add($v1,$it);}return $v1;})());$write("\n");let d=1000;const f=new Particle$soa(d,new Int32Array(d),new Int32Array(d).fill(1),new Int32Array(d).fill(2));print(total_momentum(f,d));$write("\n");const g=[new Point(1,2),new Point(3,4)];print(g[1].y);$write("\n");}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
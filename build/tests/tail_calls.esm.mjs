@@ -0,0 +1,43 @@
+import { print, $write, flush } from "./dwoc_runtime.mjs";
+
+function sum_to(n, acc) {
+  tail: while (true) {
+    if (n === 0) {
+      return acc;
+    }
+    { const n$ = n - 1, acc$ = acc + n; n = n$; acc = acc$; continue tail; }
+  }
+}
+function is_even$is_odd$tail($fn, $0) {
+  tail: while (true) {
+    switch ($fn) {
+    case 0: {
+      let n = $0;
+      if (n === 0) {
+        return 1;
+      }
+      { $0 = n - 1; $fn = 1; continue tail; }
+    }
+    case 1: {
+      let n = $0;
+      if (n === 0) {
+        return 0;
+      }
+      { $0 = n - 1; $fn = 0; continue tail; }
+    }
+    }
+  }
+}
+function is_even(n) { return is_even$is_odd$tail(0, n); }
+function is_odd(n) { return is_even$is_odd$tail(1, n); }
+function main() {
+  print(sum_to(5000, 0));
+  $write("\n");
+  print(is_even(3001));
+  $write("\n");
+  print(is_odd(3001));
+  $write("\n8\n");
+  return 0;
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
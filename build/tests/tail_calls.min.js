@@ -0,0 +1 @@
+"use strict";(function(){const j=require('node:fs');const q=new TextEncoder();const b=new Uint8Array(65536);let a=0;let k=10;const f=()=>{let g=0;while(g<a){try{g+=j.writeSync(1,b,g,a-g);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)k=b[a-1];a=0;};process.on('exit',f);const s=(byte)=>{if(a===b.length)f();b[a++]=byte;};const l=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=q.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);f();}};const m=(...t)=>{for(const h of t)l(typeof h==='string'?h:`${h}`);};const o=l;const p=()=>{if((a>0?b[a-1]:k)!==10)s(10);f();};globalThis.print=m;globalThis.$write=o;globalThis.flush=p;})();function sum_to(a,b){tail:while(true){if(a===0){return b;}{const a$=a-1,b$=b+a;a=a$;b=b$;continue tail;}}}function is_even$is_odd$tail($fn,$0){tail:while(true){switch($fn){case 0:{let a=$0;if(a===0){return 1;}{$0=a-1;$fn=1;continue tail;}}case 1:{let a=$0;if(a===0){return 0;}{$0=a-1;$fn=0;continue tail;}}}}}function is_even(a){return is_even$is_odd$tail(0,a);}function is_odd(a){return is_even$is_odd$tail(1,a);}function main(){print(sum_to(5000,0));$write("\n");print(is_even(3001));$write("\n");print(is_odd(3001));$write("\n8\n");return 0;}{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
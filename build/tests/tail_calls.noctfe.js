@@ -0,0 +1,106 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const $write = outText;
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.$write = $write;
+globalThis.flush = flush;
+})();
+
+function sum_to(n, acc) {
+  tail: while (true) {
+    if (n === 0) {
+      return acc;
+    }
+    { const n$ = n - 1, acc$ = acc + n; n = n$; acc = acc$; continue tail; }
+  }
+}
+function is_even$is_odd$tail($fn, $0) {
+  tail: while (true) {
+    switch ($fn) {
+    case 0: {
+      let n = $0;
+      if (n === 0) {
+        return 1;
+      }
+      { $0 = n - 1; $fn = 1; continue tail; }
+    }
+    case 1: {
+      let n = $0;
+      if (n === 0) {
+        return 0;
+      }
+      { $0 = n - 1; $fn = 0; continue tail; }
+    }
+    }
+  }
+}
+function is_even(n) { return is_even$is_odd$tail(0, n); }
+function is_odd(n) { return is_even$is_odd$tail(1, n); }
+function swap_down(a, b) {
+  tail: while (true) {
+    if (a <= 0) {
+      return b;
+    }
+    { const a$ = b - 1, b$ = a; a = a$; b = b$; continue tail; }
+  }
+}
+function main() {
+  print(sum_to(5000, 0));
+  $write("\n");
+  print(is_even(3001));
+  $write("\n");
+  print(is_odd(3001));
+  $write("\n");
+  print(swap_down(10, 3));
+  $write("\n");
+  return 0;
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
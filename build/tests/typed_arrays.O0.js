@@ -0,0 +1,105 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const println = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+  outByte(10);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+function square(x) {
+  return x * x;
+}
+function add(a, b) {
+  return a + b;
+}
+function sum(xs) {
+  {
+    let $v1 = 0;
+    for (let $i = 0; $i < xs.length; $i++) {
+      const $it = xs[$i];
+      $v1 = add($v1, $it);
+    }
+    return $v1;
+  }
+}
+function main() {
+  const a = Int32Array.of(3, 1, 4, 1, 5, 9, 2, 6);
+  println(a);
+  println(a[2] + a[5]);
+  const mid = a.subarray(2, 5);
+  println(mid, " ", mid[0]);
+  println(a.subarray(0, 3), " ", a.subarray(5), " ", a.subarray());
+  const zeros = new Int32Array(4);
+  println(zeros);
+  const sevens = new Int32Array(3).fill(7);
+  println(sum(sevens));
+  const big = Float64Array.of(3000000000, 1);
+  println(big[0] + big[1]);
+  const words = ["a", "b", "c"];
+  println(words.slice(1));
+  let k = 2;
+  const mixed = [k, 1];
+  println(mixed.slice(1));
+  println(Float64Array.of(a[0] * 2, a[1] * 3));
+  println((() => { const $v1 = []; for (let $i = 0; $i < a.length; $i++) { let $it = a[$i]; $it = square($it); $v1.push($it); } return sum($v1); })());
+  const m = [Int32Array.of(1, 2), Int32Array.of(3, 4)];
+  println(m[1][0]);
+  let n = 5;
+  println(new Int32Array(n).fill(1));
+  println(use_global(), " ", shadow(Int32Array.of(1, 2)));
+}
+const g = Int32Array.of(10, 20, 30);
+function use_global() {
+  return g.subarray(1);
+}
+function shadow(g) {
+  return g.subarray(1);
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,69 @@
+import { print, $write, flush } from "./dwoc_runtime.mjs";
+
+function square(x) {
+  return x * x;
+}
+function add(a, b) {
+  return a + b;
+}
+function sum(xs) {
+  {
+    let $v1 = 0;
+    for (let $i = 0; $i < xs.length; $i++) {
+      const $it = xs[$i];
+      $v1 = add($v1, $it);
+    }
+    return $v1;
+  }
+}
+function main() {
+  const a = Int32Array.of(3, 1, 4, 1, 5, 9, 2, 6);
+  print(a);
+  $write("\n");
+  print(a[2] + a[5]);
+  $write("\n");
+  const mid = a.subarray(2, 5);
+  print(mid);
+  $write(" ");
+  print(mid[0]);
+  $write("\n");
+  print(a.subarray(0, 3));
+  $write(" ");
+  print(a.subarray(5));
+  $write(" ");
+  print(a.subarray());
+  $write("\n");
+  const zeros = new Int32Array(4);
+  print(zeros);
+  $write("\n");
+  const sevens = new Int32Array(3).fill(7);
+  print(sum(sevens));
+  $write("\n");
+  const big = Float64Array.of(3000000000, 1);
+  print(big[0] + big[1]);
+  $write("\n");
+  const words = ["a", "b", "c"];
+  print(words.slice(1));
+  $write("\n");
+  let k = 2;
+  const mixed = [k, 1];
+  print(mixed.slice(1));
+  $write("\n");
+  print(Float64Array.of(a[0] * 2, a[1] * 3));
+  $write("\n");
+  print((() => { const $v1 = []; for (let $i = 0; $i < a.length; $i++) { let $it = a[$i]; $it = square($it); $v1.push($it); } return sum($v1); })());
+  $write("\n");
+  const m = [Int32Array.of(1, 2), Int32Array.of(3, 4)];
+  print(m[1][0]);
+  $write("\n");
+  let n = 5;
+  print(new Int32Array(n).fill(1));
+  $write("\n");
+  print(g.slice(1));
+  $write(" ");
+  print(Int32Array.of(1, 2).subarray(1));
+  $write("\n");
+}
+const g = Int32Array.of(10, 20, 30);
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -0,0 +1,123 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const $write = outText;
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.$write = $write;
+globalThis.flush = flush;
+})();
+
+function square(x) {
+  return x * x;
+}
+function add(a, b) {
+  return a + b;
+}
+function sum(xs) {
+  {
+    let $v1 = 0;
+    for (let $i = 0; $i < xs.length; $i++) {
+      const $it = xs[$i];
+      $v1 = add($v1, $it);
+    }
+    return $v1;
+  }
+}
+function main() {
+  const a = Int32Array.of(3, 1, 4, 1, 5, 9, 2, 6);
+  print(a);
+  $write("\n");
+  print(a[2] + a[5]);
+  $write("\n");
+  const mid = a.subarray(2, 5);
+  print(mid);
+  $write(" ");
+  print(mid[0]);
+  $write("\n");
+  print(a.subarray(0, 3));
+  $write(" ");
+  print(a.subarray(5));
+  $write(" ");
+  print(a.subarray());
+  $write("\n");
+  const zeros = new Int32Array(4);
+  print(zeros);
+  $write("\n");
+  const sevens = new Int32Array(3).fill(7);
+  print(sum(sevens));
+  $write("\n");
+  const big = Float64Array.of(3000000000, 1);
+  print(big[0] + big[1]);
+  $write("\n");
+  const words = ["a", "b", "c"];
+  print(words.slice(1));
+  $write("\n");
+  let k = 2;
+  const mixed = [k, 1];
+  print(mixed.slice(1));
+  $write("\n");
+  print(Float64Array.of(a[0] * 2, a[1] * 3));
+  $write("\n");
+  print((() => { const $v1 = []; for (let $i = 0; $i < a.length; $i++) { let $it = a[$i]; $it = square($it); $v1.push($it); } return sum($v1); })());
+  $write("\n");
+  const m = [Int32Array.of(1, 2), Int32Array.of(3, 4)];
+  print(m[1][0]);
+  $write("\n");
+  let n = 5;
+  print(new Int32Array(n).fill(1));
+  $write("\n");
+  print(g.slice(1));
+  $write(" ");
+  print(Int32Array.of(1, 2).subarray(1));
+  $write("\n");
+}
+const g = Int32Array.of(10, 20, 30);
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
+//# sourceMappingURL=typed_arrays.map.js.map
@@ -0,0 +1 @@
+"use strict";(function(){const j=require('node:fs');const q=new TextEncoder();const b=new Uint8Array(65536);let a=0;let k=10;const f=()=>{let g=0;while(g<a){try{g+=j.writeSync(1,b,g,a-g);}catch(e){if(e.code==='EPIPE')break;if(e.code!=='EAGAIN')throw e;}}if(a>0)k=b[a-1];a=0;};process.on('exit',f);const s=(byte)=>{if(a===b.length)f();b[a++]=byte;};const l=(d)=>{const n=d.length;if(n<=b.length-a){let i=0;for(;i<n;++i){const c=d.charCodeAt(i);if(c>=128)break;b[a++]=c;}if(i===n)return;d=d.substring(i);}for(;;){const r=q.encodeInto(d,b.subarray(a));a+=r.written;if(r.read===d.length)return;d=d.substring(r.read);f();}};const m=(...t)=>{for(const h of t)l(typeof h==='string'?h:`${h}`);};const o=l;const p=()=>{if((a>0?b[a-1]:k)!==10)s(10);f();};globalThis.print=m;globalThis.$write=o;globalThis.flush=p;})();function square(a){return a*a;}function add(a,b){return a+b;}function sum(a){{let $v1=0;for(let $i=0;$i<a.length;$i++){const $it=a[$i];$v1=add($v1,$it);}return $v1;}}function main(){const a=Int32Array.of(3,1,4,1,5,9,2,6);print(a);$write("\n");print(a[2]+a[5]);$write("\n");const b=a.subarray(2,5);print(b);$write(" ");print(b[0]);$write("\n");print(a.subarray(0,3));$write(" ");print(a.subarray(5));$write(" ");print(a.subarray());$write("\n");const d=new Int32Array(4);print(d);$write("\n");const e=new Int32Array(3).fill(7);print(sum(e));$write("\n");const c=Float64Array.of(3000000000,1);print(c[0]+c[1]);$write("\n");const f=["a","b","c"];print(f.slice(1));$write("\n");let h=2;const i=[h,1];print(i.slice(1));$write("\n");print(Float64Array.of(a[0]*2,a[1]*3));$write("\n");print((()=>{const $v1=[];for(let $i=0;$i<a.length;$i++){let $it=a[$i];$it=square($it);$v1.push($it);}return sum($v1);})());$write("\n");const j=[Int32Array.of(1,2),Int32Array.of(3,4)];print(j[1][0]);$write("\n");let k=5;print(new Int32Array(k).fill(1));$write("\n");print(g.slice(1));$write(" ");print(Int32Array.of(1,2).subarray(1));$write("\n");}const g=Int32Array.of(10,20,30);{const r=main();flush();if(typeof r==='number')if(r!=0){throw new Error(`Program exited with non-zero exit code: ${r}`);}}
\ No newline at end of file
@@ -0,0 +1,56 @@
+import { print, $write, $writeNumber, flush } from "./dwoc_runtime.mjs";
+
+const S = "glob";
+function main() {
+  let i = 0;
+  let total = 0;
+  while (i < 5) {
+    total = total + i * 3;
+    i = i + 1;
+  }
+  $writeNumber(i);
+  $write(" ");
+  $writeNumber(total);
+  $write(" ");
+  $writeNumber(-total);
+  $write(" 14 ");
+  $write(S);
+  $write("\n");
+  const s = "a" + i;
+  $write(s);
+  $write("|");
+  $write(s + "b");
+  $write("\n");
+  let m = 1;
+  m = "now a string";
+  print(m);
+  $write("\n");
+  const h = 3;
+  $write("3 -2147483648 2147483648 123456789000\n");
+  {
+    let x$1 = 3;
+    $writeNumber(x$1);
+    $write(" ");
+    $writeNumber(x$1 + 1);
+    $write("\n");
+  }
+  {
+    let x$2 = "q";
+    $write(x$2);
+    $write(" ");
+    $write(x$2 + 1);
+    $write("\n");
+  }
+  if (1) {
+    const G$s1 = "shadow";
+    $write(G$s1);
+    $write("\n");
+  }
+  for (const k of Int32Array.of(1, 2)) {
+    print(k);
+  }
+  $write("\n");
+  return 0;
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
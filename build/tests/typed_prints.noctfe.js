@@ -0,0 +1,129 @@
+"use strict";
+
+(function(){
+const fs = require('node:fs');
+const utf8Encoder = new TextEncoder();
+const outBytes = new Uint8Array(65536);
+let outLength = 0;
+let outLast = 10;
+const outDrain = () => {
+  let offset = 0;
+  while (offset < outLength) {
+    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }
+    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }
+  }
+  if (outLength > 0) outLast = outBytes[outLength - 1];
+  outLength = 0;
+};
+process.on('exit', outDrain);
+const outByte = (byte) => {
+  if (outLength === outBytes.length) outDrain();
+  outBytes[outLength++] = byte;
+};
+const outText = (text) => {
+  const n = text.length;
+  if (n <= outBytes.length - outLength) {
+    let i = 0;
+    for (; i < n; ++i) {
+      const c = text.charCodeAt(i);
+      if (c >= 128) break;
+      outBytes[outLength++] = c;
+    }
+    if (i === n) return;
+    text = text.substring(i);
+  }
+  for (;;) {
+    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));
+    outLength += r.written;
+    if (r.read === text.length) return;
+    text = text.substring(r.read);
+    outDrain();
+  }
+};
+const print = (...args) => {
+  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);
+};
+const $write = outText;
+const $writeNumber = (n) => {
+  if ((n | 0) !== n) { outText(`${n}`); return; }
+  if (outLength + 11 > outBytes.length) outDrain();
+  if (n < 0) { outBytes[outLength++] = 45; n = -n; }
+  let end = outLength + 1;
+  for (let rest = n; rest >= 10; rest = (rest / 10) | 0) end += 1;
+  outLength = end;
+  do { outBytes[--end] = 48 + n % 10; n = (n / 10) | 0; } while (n > 0);
+};
+const flush = () => {
+  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);
+  outDrain();
+};
+globalThis.print = print;
+globalThis.$write = $write;
+globalThis.$writeNumber = $writeNumber;
+globalThis.flush = flush;
+})();
+
+const G = 7;
+const S = "glob";
+function main() {
+  let i = 0;
+  let total = 0;
+  while (i < 5) {
+    total = total + i * 3;
+    i = i + 1;
+  }
+  $writeNumber(i);
+  $write(" ");
+  $writeNumber(total);
+  $write(" ");
+  $writeNumber(-total);
+  $write(" ");
+  $writeNumber(G * 2);
+  $write(" ");
+  $write(S);
+  $write("\n");
+  const s = "a" + i;
+  $write(s);
+  $write("|");
+  $write(s + "b");
+  $write("\n");
+  let m = 1;
+  m = "now a string";
+  print(m);
+  $write("\n");
+  const h = Math.trunc(7 / 2);
+  $writeNumber(h);
+  $write(" ");
+  $writeNumber(0 - 2147483648);
+  $write(" ");
+  $writeNumber(2147483647 + 1);
+  $write(" ");
+  $writeNumber(123456789 * 1000);
+  $write("\n");
+  {
+    let x$1 = 3;
+    $writeNumber(x$1);
+    $write(" ");
+    $writeNumber(x$1 + 1);
+    $write("\n");
+  }
+  {
+    let x$2 = "q";
+    $write(x$2);
+    $write(" ");
+    $write(x$2 + 1);
+    $write("\n");
+  }
+  if (1) {
+    const G$s1 = "shadow";
+    $write(G$s1);
+    $write("\n");
+  }
+  for (const k of Int32Array.of(1, 2)) {
+    print(k);
+  }
+  $write("\n");
+  return 0;
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
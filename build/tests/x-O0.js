@@ -0,0 +1,103 @@
+"use strict";
+
+(function(){
+const buffers = [];
+const stdin = buffers.push(null)-1, stdout=buffers.push('')-1, stderr=buffers.push('')-1, stdwarn=buffers.push('')-1;
+const print = (...args) => {
+  for (const arg of args) {
+    if (arg === '\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }
+    if (typeof arg === 'string' && arg.includes('\n')) {
+      const idx = arg.lastIndexOf('\n');
+      const content = buffers[stdout] + arg.substring(0, idx);
+      console.log(content);
+      buffers[stdout] = arg.substring(idx+1);
+      continue;
+    }
+    
+    buffers[stdout] += `${arg}`;
+  }
+};
+const println = (...args) => {
+  for (const arg of args) {
+    if (arg === '\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }
+    if (typeof arg === 'string' && arg.includes('\n')) {
+      const idx = arg.lastIndexOf('\n');
+      const content = buffers[stdout] + arg.substring(0, idx);
+      console.log(content);
+      buffers[stdout] = arg.substring(idx+1);
+      continue;
+    }
+    
+    buffers[stdout] += `${arg}`;
+  }
+  console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+const flush = () => {
+  if (buffers[stdout]) console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+globalThis.print = print;
+globalThis.println = println;
+globalThis.flush = flush;
+})();
+
+function days(month) {
+  return (month < 6 ? (month == 2 ? 28 : month == 4 ? 30 : 31) : (month == 6 || month == 9 || month == 11 ? 30 : 31));
+}
+function weight(n) {
+  return (($subject) => $subject < 2 ? ($subject === 0 ? 10 : $subject === 1 ? 20 : undefined) : ($subject === 2 ? 30 : $subject === 3 ? 40 : undefined))(n % 4);
+}
+function sparse(code) {
+  if (code === 1) {
+    return 1;
+  }
+  if (code === 10) {
+    return 2;
+  }
+  if (code === 100) {
+    return 3;
+  }
+  if (code === 1000) {
+    return 4;
+  }
+  if (code === 10000) {
+    return 5;
+  }
+  return 0;
+}
+function kind(n) {
+  if (n === 0) {
+    return 100;
+  } else if (n === 1) {
+    return 200;
+  } else if (n === 2) {
+    return 300;
+  } else {
+    return n;
+  }
+}
+function main() {
+  let m = 1;
+  while (m <= 12) {
+    print(days(m), " ");
+    m = m + 1;
+  }
+  println("");
+  let i = 0;
+  while (i < 6) {
+    print(weight(i), " ", kind(i), " ");
+    i = i + 1;
+  }
+  println("");
+  let c = 1;
+  while (c <= 100000) {
+    print(sparse(c), " ");
+    c = c * 10;
+  }
+  println(sparse(7));
+  let x = 5;
+  println((x == 1 ? 2 : x * 3));
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
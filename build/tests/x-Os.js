@@ -0,0 +1,107 @@
+"use strict";
+
+(function(){
+const buffers = [];
+const stdin = buffers.push(null)-1, stdout=buffers.push('')-1, stderr=buffers.push('')-1, stdwarn=buffers.push('')-1;
+const print = (...args) => {
+  for (const arg of args) {
+    if (arg === '\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }
+    if (typeof arg === 'string' && arg.includes('\n')) {
+      const idx = arg.lastIndexOf('\n');
+      const content = buffers[stdout] + arg.substring(0, idx);
+      console.log(content);
+      buffers[stdout] = arg.substring(idx+1);
+      continue;
+    }
+    
+    buffers[stdout] += `${arg}`;
+  }
+};
+const $write = (text) => { buffers[stdout] += text; };
+const $writeLines = (lines, rest) => { console.log(buffers[stdout] + lines); buffers[stdout] = rest; };
+const flush = () => {
+  if (buffers[stdout]) console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+globalThis.print = print;
+globalThis.$write = $write;
+globalThis.$writeLines = $writeLines;
+globalThis.flush = flush;
+})();
+
+const $table1 = [28, 31, 30, 31, 30, 31, 31, 30, 31, 30];
+const $table2 = [10, 20, 30, 40];
+
+function days(month) {
+  return ($table1[month - 2] ?? 31);
+}
+function weight(n) {
+  return $table2[n % 4];
+}
+function sparse(code) {
+  if (code < 100) {
+    if (code === 1) {
+      return 1;
+    }
+    if (code === 10) {
+      return 2;
+    }
+  } else {
+    if (code === 100) {
+      return 3;
+    }
+    if (code === 1000) {
+      return 4;
+    }
+    if (code === 10000) {
+      return 5;
+    }
+  }
+  return 0;
+}
+function kind(n) {
+  switch (n) {
+    case 0: {
+      return 100;
+    }
+    case 1: {
+      return 200;
+    }
+    case 2: {
+      return 300;
+    }
+    default: {
+      return n;
+    }
+  }
+}
+function main() {
+  let m = 1;
+  while (m <= 12) {
+    print(days(m));
+    $write(" ");
+    m = m + 1;
+  }
+  $writeLines("", "");
+  let i = 0;
+  while (i < 6) {
+    print(weight(i));
+    $write(" ");
+    print(kind(i));
+    $write(" ");
+    i = i + 1;
+  }
+  $writeLines("", "");
+  let c = 1;
+  while (c <= 100000) {
+    print(sparse(c));
+    $write(" ");
+    c = c * 10;
+  }
+  $writeLines("0", "");
+  let x = 5;
+  print((x == 1 ? 2 : x * 3));
+  $writeLines("", "");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
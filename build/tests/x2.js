@@ -0,0 +1,108 @@
+"use strict";
+
+(function(){
+const buffers = [];
+const stdin = buffers.push(null)-1, stdout=buffers.push('')-1, stderr=buffers.push('')-1, stdwarn=buffers.push('')-1;
+const print = (...args) => {
+  for (const arg of args) {
+    if (arg === '\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }
+    if (typeof arg === 'string' && arg.includes('\n')) {
+      const idx = arg.lastIndexOf('\n');
+      const content = buffers[stdout] + arg.substring(0, idx);
+      console.log(content);
+      buffers[stdout] = arg.substring(idx+1);
+      continue;
+    }
+    
+    buffers[stdout] += `${arg}`;
+  }
+};
+const $write = (text) => { buffers[stdout] += text; };
+const $writeLines = (lines, rest) => { console.log(buffers[stdout] + lines); buffers[stdout] = rest; };
+const flush = () => {
+  if (buffers[stdout]) console.log(buffers[stdout]);
+  buffers[stdout] = '';
+};
+globalThis.print = print;
+globalThis.$write = $write;
+globalThis.$writeLines = $writeLines;
+globalThis.flush = flush;
+})();
+
+class Point {
+  constructor(x, y) {
+    this.x = x;
+    this.y = y;
+  }
+}
+class Particle {
+  constructor(x, v, mass) {
+    this.x = x;
+    this.v = v;
+    this.mass = mass;
+  }
+}
+class Particle$soa {
+  constructor(length, x, v, mass) {
+    this.length = length;
+    this.x = x;
+    this.v = v;
+    this.mass = mass;
+  }
+  at(i) {
+    return new Particle(this.x[i], this.v[i], this.mass[i]);
+  }
+  slice(start, end) {
+    const x = this.x.subarray(start, end);
+    return new Particle$soa(x.length, x, this.v.subarray(start, end), this.mass.subarray(start, end));
+  }
+}
+
+function add(a, b) {
+  return a + b;
+}
+function mass_of(p) {
+  return p.mass;
+}
+function total_momentum(ps, n) {
+  let i = 0;
+  let total = 0;
+  while (i < n) {
+    total = total + ps.v[i] * ps.mass[i];
+    i = i + 1;
+  }
+  return total;
+}
+function main() {
+  const p = new Point(3, 4);
+  print(p.x);
+  $write(" ");
+  print(p.y);
+  $write(" ");
+  print(p.x * p.x + p.y * p.y);
+  $writeLines("", "");
+  const ps = new Particle$soa(3, Int32Array.of(1, 4, 7), Int32Array.of(2, 5, 8), Int32Array.of(3, 6, 9));
+  print(total_momentum(ps, 3));
+  $writeLines("", "");
+  print(ps.x[1] + ps.mass[2]);
+  $writeLines("", "");
+  const q = ps.at(1);
+  print(q.v);
+  $writeLines("", "");
+  const tail = ps.slice(1);
+  print(tail.x[0]);
+  $write(" ");
+  print(tail.mass[1]);
+  $writeLines("", "");
+  print((() => { let $v1 = 0; for (let $i = 0; $i < ps.length; $i++) { let $it = ps.at($i); $it = mass_of($it); $v1 = add($v1, $it); } return $v1; })());
+  $writeLines("", "");
+  let n = 1000;
+  const many = new Particle$soa(n, new Int32Array(n), new Int32Array(n).fill(1), new Int32Array(n).fill(2));
+  print(total_momentum(many, n));
+  $writeLines("", "");
+  const pts = [new Point(1, 2), new Point(3, 4)];
+  print(pts[1].y);
+  $writeLines("", "");
+}
+
+{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }
@@ -10,6 +10,7 @@
 #  define my_cc_release(cmd) nob_cmd_append(cmd, "/O2")
 #  define my_cc_output(cmd, output) nob_cmd_append(cmd, nob_temp_sprintf("/Fe:%s.exe", output))
 #  define my_cc_include(cmd, include) nob_cmd_append(cmd, nob_temp_sprintf("/I%s", include))
+#  define my_cc_libs(cmd)
 #else
 // Default flags are just fine, they feel sane enough
 // #  define nob_cc_flags(cmd) nob_cmd_append(cmd, "-Wall", "-Wextra", "-fsanitize=undefined")
@@ -17,6 +18,8 @@
 #  define my_cc_release(cmd) nob_cmd_append(cmd, "-O2")
 #  define my_cc_output(cmd, output) nob_cmd_append(cmd, "-o", output)
 #  define my_cc_include(cmd, include) nob_cmd_append(cmd, nob_temp_sprintf("-I%s", include))
+// The compile time interpreter needs libm
+#  define my_cc_libs(cmd) nob_cmd_append(cmd, "-lm")
 #endif
 
 #define NOB_IMPLEMENTATION
@@ -31,6 +34,9 @@ const char *source_files[] = {
   "src/utils.h",
   "src/lexer.h",
   "src/ast.h",
+  "src/interpreter.h",
+  "src/optimizer.h",
+  "src/passes.h",
 };
 size_t source_files_count = NOB_ARRAY_LEN(source_files);
 
@@ -51,9 +57,179 @@ bool generate_etags_silent(Cmd *cmd) {
   return result;
 }
 
+typedef struct {
+  // Tells apart the files every configuration writes into build/tests
+  const char *suffix;
+  const char *flags[3];
+  // What the compiler names the output, js when not given
+  const char *extension;
+} Test_Config;
+
+// Every program in tests/ has to print the same thing no matter how it gets compiled
+Test_Config test_configs[] = {
+  { "O0", { "-O0" } },
+  { "O1", { "-O1" } },
+  { "O2", { "-O2" } },
+  { "noctfe", { "-O2", "--ctfe-steps", "0" } },
+  { "Os", { "-Os" } },
+  { "min", { "-O2", "--minify" } },
+  { "map", { "-O1", "--source-map-url" } },
+  { "esm", { "-O2", "--esm" }, "mjs" },
+};
+
+int compare_cstrs(const void *a, const void *b) {
+  return strcmp(*(const char**)a, *(const char**)b);
+}
+
+bool sv_contains(String_View sv, String_View needle) {
+  for (size_t i = 0; i + needle.count <= sv.count; ++i) {
+    if (memcmp(sv.data + i, needle.data, needle.count) == 0) return true;
+  }
+  return false;
+}
+
+// Lines like `// expect O2 lacks function unused` in a test check the JavaScript emitted for a configuration, `*` matches all of them
+// The source map written next to the JavaScript is checked along with it
+bool check_expectations(const char *name, Test_Config config, String_View source, const char *js_path) {
+  String_Builder js = {0};
+  if (!read_entire_file(js_path, &js)) return false;
+  const char *map_path = temp_sprintf("%s.map", js_path);
+  if (file_exists(map_path) == 1 && !read_entire_file(map_path, &js)) return false;
+  bool ok = true;
+  while (source.count > 0) {
+    String_View line = sv_trim(sv_chop_by_delim(&source, '\n'));
+    if (!sv_starts_with(line, sv_from_cstr("// expect "))) continue;
+    sv_chop_left(&line, strlen("// expect "));
+    String_View target = sv_chop_by_delim(&line, ' ');
+    String_View check = sv_chop_by_delim(&line, ' ');
+    String_View text = sv_trim(line);
+    if (!sv_eq(target, sv_from_cstr("*")) && !sv_eq(target, sv_from_cstr(config.suffix))) continue;
+    bool wanted = sv_eq(check, sv_from_cstr("has"));
+    if (!wanted && !sv_eq(check, sv_from_cstr("lacks"))) {
+      nob_log(NOB_ERROR, "%s: unknown expectation `"SV_Fmt"`, only `has` and `lacks` exist", name, SV_Arg(check));
+      ok = false;
+      continue;
+    }
+    if (sv_contains(sb_to_sv(js), text) != wanted) {
+      nob_log(NOB_ERROR, "%s [%s]: %s was expected to %s `"SV_Fmt"`", name, config.suffix, js_path, wanted ? "have" : "lack", SV_Arg(text));
+      ok = false;
+    }
+  }
+  sb_free(js);
+  return ok;
+}
+
+bool run_test(Cmd *cmd, const char *name, Test_Config config, String_View source, String_Builder *expected) {
+  const char *source_path = temp_sprintf("tests/%s.dwoc", name);
+  const char *js_name = temp_sprintf("%s.%s.%s", name, config.suffix, config.extension ? config.extension : "js");
+  const char *js_path = temp_sprintf("build/tests/%s", js_name);
+  const char *log_path = temp_sprintf("build/tests/%s.%s.log", name, config.suffix);
+  const char *out_path = temp_sprintf("build/tests/%s.%s.out", name, config.suffix);
+
+  Fd log_fd = fd_open_for_write(log_path);
+  if (log_fd == NOB_INVALID_FD) return false;
+#if _WIN32
+  cmd_append(cmd, "build\\dwoc.exe");
+#else
+  cmd_append(cmd, "build/dwoc");
+#endif
+  for (size_t i = 0; i < NOB_ARRAY_LEN(config.flags) && config.flags[i] != NULL; ++i) {
+    cmd_append(cmd, config.flags[i]);
+  }
+  cmd_append(cmd, "-o", js_path, source_path);
+  bool compiled = cmd_run_sync_redirect(*cmd, (Cmd_Redirect) { .fdout = &log_fd, .fderr = &log_fd });
+  fd_close(log_fd);
+  cmd->count = 0;
+  if (!compiled) {
+    nob_log(NOB_ERROR, "%s [%s]: failed to compile, see %s", name, config.suffix, log_path);
+    return false;
+  }
+  if (!check_expectations(name, config, source, js_path)) return false;
+
+  const char *in_path = temp_sprintf("tests/%s.in", name);
+  Fd in_fd = NOB_INVALID_FD;
+  if (file_exists(in_path) == 1) {
+    in_fd = fd_open_for_read(in_path);
+    if (in_fd == NOB_INVALID_FD) return false;
+  }
+  Fd out_fd = fd_open_for_write(out_path);
+  if (out_fd == NOB_INVALID_FD) return false;
+  // Programs run inside build/tests, the files they write end up next to everything else the tests leave behind
+  const char *root = get_current_dir_temp();
+  if (root == NULL || !set_current_dir("build/tests")) return false;
+  cmd_append(cmd, "node", js_name);
+  bool ran = cmd_run_sync_redirect_and_reset(cmd, (Cmd_Redirect) {
+      .fdin = in_fd == NOB_INVALID_FD ? NULL : &in_fd,
+      .fdout = &out_fd,
+    });
+  if (!set_current_dir(root)) return false;
+  if (!ran) {
+    nob_log(NOB_ERROR, "%s [%s]: %s exited with an error", name, config.suffix, js_path);
+    return false;
+  }
+
+  String_Builder actual = {0};
+  if (!read_entire_file(out_path, &actual)) return false;
+  bool same = actual.count == expected->count && memcmp(actual.items, expected->items, actual.count) == 0;
+  sb_free(actual);
+  if (!same) {
+    nob_log(NOB_ERROR, "%s [%s]: output differs from tests/%s.out, see %s", name, config.suffix, name, out_path);
+  }
+  return same;
+}
+
+// Compiles every tests/<name>.dwoc with each of the test_configs and compares what it prints with tests/<name>.out,
+// tests/<name>.in is fed to it as stdin when there is one
+bool run_tests(Cmd *cmd) {
+  File_Paths entries = {0};
+  if (!read_entire_dir("tests", &entries)) return false;
+  qsort(entries.items, entries.count, sizeof(*entries.items), compare_cstrs);
+  minimal_log_level = NOB_WARNING;
+  if (!mkdir_if_not_exists("build/tests")) return false;
+  minimal_log_level = NOB_INFO;
+  // core:par gets workers even on a machine with a single CPU
+#if _WIN32
+  _putenv("DWOC_PAR_THREADS=4");
+#else
+  setenv("DWOC_PAR_THREADS", "4", 1);
+#endif
+
+  size_t passed = 0, failed = 0;
+  for (size_t i = 0; i < entries.count; ++i) {
+    String_View entry = sv_from_cstr(entries.items[i]);
+    if (!sv_end_with(entry, ".dwoc")) continue;
+    const char *name = temp_sprintf(SV_Fmt, (int)(entry.count - strlen(".dwoc")), entry.data);
+
+    String_Builder source = {0};
+    String_Builder expected = {0};
+    if (!read_entire_file(temp_sprintf("tests/%s.dwoc", name), &source) || !read_entire_file(temp_sprintf("tests/%s.out", name), &expected)) {
+      failed += NOB_ARRAY_LEN(test_configs);
+      sb_free(source);
+      sb_free(expected);
+      continue;
+    }
+    for (size_t j = 0; j < NOB_ARRAY_LEN(test_configs); ++j) {
+      // Don't need to know about every command that gets run, only about what broke
+      minimal_log_level = NOB_WARNING;
+      bool ok = run_test(cmd, name, test_configs[j], sb_to_sv(source), &expected);
+      minimal_log_level = NOB_INFO;
+      cmd->count = 0;
+      if (ok) passed += 1;
+      else failed += 1;
+    }
+    sb_free(source);
+    sb_free(expected);
+  }
+  da_free(entries);
+
+  nob_log(failed == 0 ? NOB_INFO : NOB_ERROR, "Tests: %zu passed, %zu failed", passed, failed);
+  return failed == 0;
+}
+
 void usage(const char *program) {
   printf("Usage: %s [FLAGS]\n", program);
   printf("    -run <(ir|js)>   -----  Run example `dwoc hello.dwoc`\n");
+  printf("    -test            -----  Compile and run every program in tests/, comparing what it prints with its .out file\n");
   printf("    -etags           -----  Generate TAGS file with etags for project\n");
   printf("    -release         -----  Build without debug information, forces rebuild\n");
   printf("    -f               -----  Force rebuild of dowc\n");
@@ -67,7 +243,7 @@ int main(int argc, char** argv) {
 
   nob_log(NOB_INFO, "Project has %zu source files registered (nob files aren't counted)", source_files_count);
 
-  bool should_run = false, force_rebuild = false, create_etags_on_rebuild = false, release = false;
+  bool should_run = false, should_test = false, force_rebuild = false, create_etags_on_rebuild = false, release = false;
   char *target = "ir";
   while(argc > 0) {
     const char *flag = shift(argv, argc);
@@ -90,6 +266,8 @@ int main(int argc, char** argv) {
         nob_log(NOB_ERROR, "Invalid run target for run flag");
         usage(program);
       }
+    } else if (cstr_eq(flag, "-test")) {
+      should_test = true;
     } else if (cstr_eq(flag, "-f")) {
       force_rebuild = true;
     } else if (cstr_eq(flag, "-etags")) {
@@ -129,6 +307,7 @@ int main(int argc, char** argv) {
       Nob_String_View ssv = nob_sv_from_cstr(source_files[i]);
       if (sv_end_with(ssv, ".c")) cmd_append(&cmd, source_files[i]);
     }
+    my_cc_libs(&cmd);
     if (!cmd_run_sync_and_reset(&cmd)) return 1;
 
     if (create_etags_on_rebuild) generate_etags_silent(&cmd);
@@ -144,5 +323,7 @@ int main(int argc, char** argv) {
     cmd_run_sync_and_reset(&cmd);
   }
 
+  if (should_test && !run_tests(&cmd)) return 1;
+
   return 0;
 }
@@ -4,17 +4,25 @@
 
 #include "lexer.h"
 
-typedef struct {
-  const char *source_path;
-  bool main_is_defined;
-  Lexer lex;
-  Vars vars;
-  Fns fns;
-} Context;
-
 const char *KEYWORD_FN = "fn";
 const char *KEYWORD_LET = "let";
 const char *KEYWORD_IMPORT = "use";
+const char *KEYWORD_RETURN = "return";
+const char *KEYWORD_IF = "if";
+const char *KEYWORD_ELSE = "else";
+const char *KEYWORD_WHILE = "while";
+const char *KEYWORD_MATCH = "match";
+const char *KEYWORD_STRUCT = "struct";
+const char *KEYWORD_YIELD = "yield";
+const char *KEYWORD_FOR = "for";
+const char *KEYWORD_IN = "in";
+const char *KEYWORD_ASYNC = "async";
+const char *KEYWORD_AWAIT = "await";
+
+const char *ATTRIBUTE_MEMO = "memo";
+const char *FN_ATTRIBUTES[] = { "memo" };
+const char *ATTRIBUTE_SOA = "soa";
+const char *STRUCT_ATTRIBUTES[] = { "soa" };
 
 typedef enum {
   AST_NK_EOF,
@@ -26,6 +34,8 @@ typedef enum {
   AST_NK_UNOP,
   AST_NK_BINOP,
   AST_NK_FN_PARAMS_DECL,
+  AST_NK_MATCH_ARM, // Integer patterns (none for `_`) and the value they select
+  AST_NK_PIPE_STAGE, // Step of a pipeline, a call with the piped value as its first argument
 
   // Compounds
   AST_NK_EXPR,
@@ -33,6 +43,19 @@ typedef enum {
   AST_NK_ASSIGNMENT,
   AST_NK_FN_DECL,
   AST_NK_FN_CALL,
+  AST_NK_BLOCK, // Scoped list of statements
+  AST_NK_IF,
+  AST_NK_WHILE,
+  AST_NK_RETURN,
+  AST_NK_MATCH,
+  AST_NK_ARRAY,
+  AST_NK_PIPELINE, // `source |> stage |> ...`
+  AST_NK_INDEX, // `array[i]` or the `array[start..end]` slice
+  AST_NK_STRUCT_DECL,
+  AST_NK_FIELD, // `value.name`
+  AST_NK_YIELD,
+  AST_NK_FOR, // `for (name in iterable) body`
+  AST_NK_AWAIT, // `await value` inside of an `async fn`
 } AST_Node_Kind;
 
 typedef struct AST_VarDeclAttr AST_VarDeclAttr;
@@ -67,13 +90,127 @@ typedef struct {
   Nob_String_View name;
   AST_NodeList params;
   AST_NodeList body;
+  // Names given with `@name` before the `fn` keyword
+  StringViews attrs;
+  // Has a `yield` of its own, calling it gives an iterator over what it yields instead of running the body
+  bool generator;
+  // Declared with `async fn`, calling it gives a promise of what it returns
+  bool async;
 } AST_FnDeclAttr;
 
 typedef struct {
   Nob_String_View name;
   AST_NodeList params;
+  // Builds an instance of the struct with this name, set once the whole module is parsed
+  bool constructs;
 } AST_FnCall;
 
+typedef struct {
+  Nob_String_View name;
+  // In declaration order, the constructor takes them in the same order
+  StringViews fields;
+  StringViews attrs;
+} AST_StructDecl;
+
+typedef struct {
+  AST_NodeList target;
+  Nob_String_View name;
+} AST_Field;
+
+typedef struct {
+  Token op;
+  // Single operand for unary operations, left and right hand side for binary ones
+  AST_NodeList operands;
+} AST_Operation;
+
+typedef struct {
+  AST_NodeList cond;
+  AST_NodeList then_body;
+  AST_NodeList else_body;
+} AST_If;
+
+typedef struct {
+  AST_NodeList cond;
+  AST_NodeList body;
+} AST_While;
+
+typedef struct {
+  Nob_String_View name;
+  // Array or iterator the loop takes the values of
+  AST_NodeList iter;
+  AST_NodeList body;
+} AST_For;
+
+typedef struct {
+  AST_NodeList subject;
+  AST_NodeList arms;
+  // Id of the lookup table the backend emitted for this match, 0 when it has none
+  size_t table;
+} AST_Match;
+
+typedef struct {
+  // Integer literals, optionally negated, the arm is the default one when empty
+  AST_NodeList patterns;
+  AST_NodeList value;
+} AST_MatchArm;
+
+// What every element of an array is known to be, decides how the backend stores it
+typedef enum {
+  AST_ELEM_ANY,
+  AST_ELEM_I32,
+  AST_ELEM_F64,
+  // Instances of a `@soa` struct stored as one array per field
+  AST_ELEM_SOA,
+} AST_Elem_Kind;
+
+typedef struct {
+  AST_NodeList items;
+  // `[value; length]` has its single value in items and the amount of copies here
+  AST_NodeList length;
+  AST_Elem_Kind elem;
+  // Struct of the elements when they are AST_ELEM_SOA
+  Nob_String_View soa;
+} AST_Array;
+
+typedef struct {
+  AST_NodeList target;
+  // Either bound can be missing in a slice, they default to the start and end of the array
+  AST_NodeList start;
+  AST_NodeList end;
+  bool slice;
+  // Element kind of target
+  AST_Elem_Kind elem;
+  Nob_String_View soa;
+} AST_Index;
+
+// Names the stages of a pipeline use for the value flowing through it, `$` keeps them apart from the user's
+#define AST_PIPE_ITEM "$it"
+#define AST_PIPE_ACC "$acc"
+
+typedef enum {
+  // `|> f(args)` is `f(value, args)`
+  AST_PIPE_CALL,
+  // `|> Array.map(f)`, `|> Array.filter(f)` and `|> Array.reduce(f, init)` work element by element
+  AST_PIPE_MAP,
+  AST_PIPE_FILTER,
+  AST_PIPE_REDUCE,
+} AST_Pipe_Stage_Kind;
+
+typedef struct {
+  AST_Pipe_Stage_Kind kind;
+  // Single call reading AST_PIPE_ITEM, reduce also passes AST_PIPE_ACC before it
+  AST_NodeList call;
+  // Starting value of reduce
+  AST_NodeList init;
+} AST_PipeStage;
+
+typedef struct {
+  AST_NodeList source;
+  AST_NodeList stages;
+  // Struct of the elements when the source is stored as struct of arrays
+  Nob_String_View soa;
+} AST_Pipeline;
+
 typedef union {
   Nob_String_View sv;
   int integer;
@@ -81,8 +218,24 @@ typedef union {
   AST_VarAssign var_assign;
   AST_FnDeclAttr fn_decl;
   AST_FnCall fn_call;
+  AST_StructDecl struct_decl;
+  AST_Field field;
   AST_Import import;
   AST_NodeList expr;
+  AST_NodeList block;
+  AST_NodeList ret;
+  AST_NodeList yield;
+  AST_NodeList awaited;
+  AST_Operation op;
+  AST_If if_stmt;
+  AST_While while_loop;
+  AST_For for_loop;
+  AST_Match match;
+  AST_MatchArm match_arm;
+  AST_Array array;
+  AST_Index index;
+  AST_PipeStage pipe_stage;
+  AST_Pipeline pipeline;
   Token token;
 } AST_Node_As;
 
@@ -92,15 +245,43 @@ struct AST_Node {
   AST_Node_As as;
 };
 
+typedef struct {
+  const char *source_path;
+  bool main_is_defined;
+  Lexer lex;
+  Vars vars;
+  Fns fns;
+  AST_NodeList module;
+  Options opts;
+} Context;
+
 char *ast_node_kind_name(AST_Node_Kind kind);
 
+// Binding power of a binary operator, 0 when the symbol isn't a binary operator
+int ast_binop_precedence(Nob_String_View op);
+
 // Advances lexer consuming tokens till it produces a node or hits EOF
 // On error returns false
 bool ast_chomp(Lexer *l, AST_Node *node);
 
+// Chomps nodes till EOF storing every top level node of the module
+// On error returns false
+bool ast_chomp_module(Lexer *l, AST_NodeList *module);
+
 // Walks through all the sub-nodes of this node recursively and frees them
 void ast_node_children_free(AST_Node *node);
 
+// Store pointers to every list of sub-nodes the node owns, returns how many lists were stored
+#define AST_MAX_CHILD_LISTS 3
+size_t ast_node_child_lists(AST_Node *node, AST_NodeList *lists[AST_MAX_CHILD_LISTS]);
+
+// Value of a match pattern, an integer literal or the negation of one
+double ast_int_literal_value(AST_Node *node);
+
+// Deep copy of a node, the copy owns all of its sub-nodes
+AST_Node ast_node_clone(AST_Node node);
+AST_NodeList ast_node_list_clone(AST_NodeList list);
+
 void ast_dump_node_at_depth(Nob_String_Builder *sb, AST_Node node, int depth);
 #define ast_dump_node(sb, node) ast_dump_node_at_depth(sb, node, 0)
 
@@ -125,6 +306,10 @@ char *ast_node_kind_name(AST_Node_Kind kind) {
     return "Binary_Operation";
   case AST_NK_FN_PARAMS_DECL:
     return "Function_Parameters_Declaration";
+  case AST_NK_MATCH_ARM:
+    return "Match_Arm";
+  case AST_NK_PIPE_STAGE:
+    return "Pipe_Stage";
 
     // Compounds
   case AST_NK_EXPR:
@@ -137,6 +322,32 @@ char *ast_node_kind_name(AST_Node_Kind kind) {
     return "Function_Declaration";
   case AST_NK_FN_CALL:
     return "Function_Call";
+  case AST_NK_BLOCK:
+    return "Block";
+  case AST_NK_IF:
+    return "If";
+  case AST_NK_WHILE:
+    return "While";
+  case AST_NK_RETURN:
+    return "Return";
+  case AST_NK_MATCH:
+    return "Match";
+  case AST_NK_ARRAY:
+    return "Array";
+  case AST_NK_PIPELINE:
+    return "Pipeline";
+  case AST_NK_INDEX:
+    return "Index";
+  case AST_NK_STRUCT_DECL:
+    return "Struct_Declaration";
+  case AST_NK_FIELD:
+    return "Field";
+  case AST_NK_YIELD:
+    return "Yield";
+  case AST_NK_FOR:
+    return "For";
+  case AST_NK_AWAIT:
+    return "Await";
 
   default:// If this is ever hit then we added a node kind that's missing
     TODOf("ast_node_kind_name: Implement missing AST Node kind (%d)", kind);
@@ -155,6 +366,7 @@ void ast_node_children_free(AST_Node *node) {
   switch (node->kind) {
   case AST_NK_EOF:
   case AST_NK_TOKEN:
+  case AST_NK_IMPORT:
     return;
 
   case AST_NK_EXPR:
@@ -175,6 +387,70 @@ void ast_node_children_free(AST_Node *node) {
   case AST_NK_FN_DECL:
     ast_node_list_free(&node->as.fn_decl.params);
     ast_node_list_free(&node->as.fn_decl.body);
+    safe_da_free(node->as.fn_decl.attrs);
+    return;
+  case AST_NK_STRUCT_DECL:
+    safe_da_free(node->as.struct_decl.fields);
+    safe_da_free(node->as.struct_decl.attrs);
+    return;
+  case AST_NK_FIELD:
+    ast_node_list_free(&node->as.field.target);
+    return;
+
+  case AST_NK_BLOCK:
+    ast_node_list_free(&node->as.block);
+    return;
+
+  case AST_NK_UNOP:
+  case AST_NK_BINOP:
+    ast_node_list_free(&node->as.op.operands);
+    return;
+  case AST_NK_IF:
+    ast_node_list_free(&node->as.if_stmt.cond);
+    ast_node_list_free(&node->as.if_stmt.then_body);
+    ast_node_list_free(&node->as.if_stmt.else_body);
+    return;
+  case AST_NK_WHILE:
+    ast_node_list_free(&node->as.while_loop.cond);
+    ast_node_list_free(&node->as.while_loop.body);
+    return;
+  case AST_NK_RETURN:
+    ast_node_list_free(&node->as.ret);
+    return;
+  case AST_NK_YIELD:
+    ast_node_list_free(&node->as.yield);
+    return;
+  case AST_NK_AWAIT:
+    ast_node_list_free(&node->as.awaited);
+    return;
+  case AST_NK_FOR:
+    ast_node_list_free(&node->as.for_loop.iter);
+    ast_node_list_free(&node->as.for_loop.body);
+    return;
+  case AST_NK_MATCH:
+    ast_node_list_free(&node->as.match.subject);
+    ast_node_list_free(&node->as.match.arms);
+    return;
+  case AST_NK_MATCH_ARM:
+    ast_node_list_free(&node->as.match_arm.patterns);
+    ast_node_list_free(&node->as.match_arm.value);
+    return;
+  case AST_NK_ARRAY:
+    ast_node_list_free(&node->as.array.items);
+    ast_node_list_free(&node->as.array.length);
+    return;
+  case AST_NK_INDEX:
+    ast_node_list_free(&node->as.index.target);
+    ast_node_list_free(&node->as.index.start);
+    ast_node_list_free(&node->as.index.end);
+    return;
+  case AST_NK_PIPELINE:
+    ast_node_list_free(&node->as.pipeline.source);
+    ast_node_list_free(&node->as.pipeline.stages);
+    return;
+  case AST_NK_PIPE_STAGE:
+    ast_node_list_free(&node->as.pipe_stage.call);
+    ast_node_list_free(&node->as.pipe_stage.init);
     return;
 
   default:
@@ -182,6 +458,195 @@ void ast_node_children_free(AST_Node *node) {
   }
 }
 
+size_t ast_node_child_lists(AST_Node *node, AST_NodeList *lists[AST_MAX_CHILD_LISTS]) {
+  switch (node->kind) {
+  case AST_NK_EOF:
+  case AST_NK_TOKEN:
+  case AST_NK_IMPORT:
+  case AST_NK_FN_PARAMS_DECL:
+    return 0;
+  case AST_NK_UNOP:
+  case AST_NK_BINOP:
+    lists[0] = &node->as.op.operands;
+    return 1;
+  case AST_NK_EXPR:
+    lists[0] = &node->as.expr;
+    return 1;
+  case AST_NK_VAR_DECL:
+    lists[0] = &node->as.var_decl.expr;
+    return 1;
+  case AST_NK_ASSIGNMENT:
+    lists[0] = &node->as.var_assign.expr;
+    return 1;
+  case AST_NK_FN_DECL:
+    lists[0] = &node->as.fn_decl.params;
+    lists[1] = &node->as.fn_decl.body;
+    return 2;
+  case AST_NK_FN_CALL:
+    lists[0] = &node->as.fn_call.params;
+    return 1;
+  case AST_NK_STRUCT_DECL:
+    return 0;
+  case AST_NK_FIELD:
+    lists[0] = &node->as.field.target;
+    return 1;
+  case AST_NK_BLOCK:
+    lists[0] = &node->as.block;
+    return 1;
+  case AST_NK_IF:
+    lists[0] = &node->as.if_stmt.cond;
+    lists[1] = &node->as.if_stmt.then_body;
+    lists[2] = &node->as.if_stmt.else_body;
+    return 3;
+  case AST_NK_WHILE:
+    lists[0] = &node->as.while_loop.cond;
+    lists[1] = &node->as.while_loop.body;
+    return 2;
+  case AST_NK_RETURN:
+    lists[0] = &node->as.ret;
+    return 1;
+  case AST_NK_YIELD:
+    lists[0] = &node->as.yield;
+    return 1;
+  case AST_NK_AWAIT:
+    lists[0] = &node->as.awaited;
+    return 1;
+  case AST_NK_FOR:
+    lists[0] = &node->as.for_loop.iter;
+    lists[1] = &node->as.for_loop.body;
+    return 2;
+  case AST_NK_MATCH:
+    lists[0] = &node->as.match.subject;
+    lists[1] = &node->as.match.arms;
+    return 2;
+  case AST_NK_MATCH_ARM:
+    lists[0] = &node->as.match_arm.patterns;
+    lists[1] = &node->as.match_arm.value;
+    return 2;
+  case AST_NK_ARRAY:
+    lists[0] = &node->as.array.items;
+    lists[1] = &node->as.array.length;
+    return 2;
+  case AST_NK_INDEX:
+    lists[0] = &node->as.index.target;
+    lists[1] = &node->as.index.start;
+    lists[2] = &node->as.index.end;
+    return 3;
+  case AST_NK_PIPELINE:
+    lists[0] = &node->as.pipeline.source;
+    lists[1] = &node->as.pipeline.stages;
+    return 2;
+  case AST_NK_PIPE_STAGE:
+    lists[0] = &node->as.pipe_stage.call;
+    lists[1] = &node->as.pipe_stage.init;
+    return 2;
+  }
+  TODOf("ast_node_child_lists: Implement missing AST Node kind (%d)", node->kind);
+}
+
+AST_NodeList ast_node_list_clone(AST_NodeList list) {
+  AST_NodeList copy = {0};
+  nob_da_foreach(AST_Node, node, &list) {
+    nob_da_append(&copy, ast_node_clone(*node));
+  }
+  return copy;
+}
+
+AST_Node ast_node_clone(AST_Node node) {
+  AST_Node copy = node;
+  switch (node.kind) {
+  case AST_NK_EOF:
+  case AST_NK_TOKEN:
+  case AST_NK_IMPORT:
+    return copy;
+
+  case AST_NK_EXPR:
+    copy.as.expr = ast_node_list_clone(node.as.expr);
+    return copy;
+  case AST_NK_VAR_DECL:
+    copy.as.var_decl.expr = ast_node_list_clone(node.as.var_decl.expr);
+    return copy;
+  case AST_NK_ASSIGNMENT:
+    copy.as.var_assign.expr = ast_node_list_clone(node.as.var_assign.expr);
+    return copy;
+  case AST_NK_FN_CALL:
+    copy.as.fn_call.params = ast_node_list_clone(node.as.fn_call.params);
+    return copy;
+  case AST_NK_FN_DECL:
+    copy.as.fn_decl.params = ast_node_list_clone(node.as.fn_decl.params);
+    copy.as.fn_decl.body = ast_node_list_clone(node.as.fn_decl.body);
+    copy.as.fn_decl.attrs = (StringViews) {0};
+    nob_da_append_many(&copy.as.fn_decl.attrs, node.as.fn_decl.attrs.items, node.as.fn_decl.attrs.count);
+    return copy;
+  case AST_NK_STRUCT_DECL:
+    copy.as.struct_decl.fields = (StringViews) {0};
+    copy.as.struct_decl.attrs = (StringViews) {0};
+    nob_da_append_many(&copy.as.struct_decl.fields, node.as.struct_decl.fields.items, node.as.struct_decl.fields.count);
+    nob_da_append_many(&copy.as.struct_decl.attrs, node.as.struct_decl.attrs.items, node.as.struct_decl.attrs.count);
+    return copy;
+  case AST_NK_FIELD:
+    copy.as.field.target = ast_node_list_clone(node.as.field.target);
+    return copy;
+  case AST_NK_BLOCK:
+    copy.as.block = ast_node_list_clone(node.as.block);
+    return copy;
+  case AST_NK_UNOP:
+  case AST_NK_BINOP:
+    copy.as.op.operands = ast_node_list_clone(node.as.op.operands);
+    return copy;
+  case AST_NK_IF:
+    copy.as.if_stmt.cond = ast_node_list_clone(node.as.if_stmt.cond);
+    copy.as.if_stmt.then_body = ast_node_list_clone(node.as.if_stmt.then_body);
+    copy.as.if_stmt.else_body = ast_node_list_clone(node.as.if_stmt.else_body);
+    return copy;
+  case AST_NK_WHILE:
+    copy.as.while_loop.cond = ast_node_list_clone(node.as.while_loop.cond);
+    copy.as.while_loop.body = ast_node_list_clone(node.as.while_loop.body);
+    return copy;
+  case AST_NK_RETURN:
+    copy.as.ret = ast_node_list_clone(node.as.ret);
+    return copy;
+  case AST_NK_YIELD:
+    copy.as.yield = ast_node_list_clone(node.as.yield);
+    return copy;
+  case AST_NK_AWAIT:
+    copy.as.awaited = ast_node_list_clone(node.as.awaited);
+    return copy;
+  case AST_NK_FOR:
+    copy.as.for_loop.iter = ast_node_list_clone(node.as.for_loop.iter);
+    copy.as.for_loop.body = ast_node_list_clone(node.as.for_loop.body);
+    return copy;
+  case AST_NK_MATCH:
+    copy.as.match.subject = ast_node_list_clone(node.as.match.subject);
+    copy.as.match.arms = ast_node_list_clone(node.as.match.arms);
+    return copy;
+  case AST_NK_MATCH_ARM:
+    copy.as.match_arm.patterns = ast_node_list_clone(node.as.match_arm.patterns);
+    copy.as.match_arm.value = ast_node_list_clone(node.as.match_arm.value);
+    return copy;
+  case AST_NK_ARRAY:
+    copy.as.array.items = ast_node_list_clone(node.as.array.items);
+    copy.as.array.length = ast_node_list_clone(node.as.array.length);
+    return copy;
+  case AST_NK_INDEX:
+    copy.as.index.target = ast_node_list_clone(node.as.index.target);
+    copy.as.index.start = ast_node_list_clone(node.as.index.start);
+    copy.as.index.end = ast_node_list_clone(node.as.index.end);
+    return copy;
+  case AST_NK_PIPELINE:
+    copy.as.pipeline.source = ast_node_list_clone(node.as.pipeline.source);
+    copy.as.pipeline.stages = ast_node_list_clone(node.as.pipeline.stages);
+    return copy;
+  case AST_NK_PIPE_STAGE:
+    copy.as.pipe_stage.call = ast_node_list_clone(node.as.pipe_stage.call);
+    copy.as.pipe_stage.init = ast_node_list_clone(node.as.pipe_stage.init);
+    return copy;
+
+  default:
+    TODOf("ast_node_clone: Clone node %s", ast_node_kind_name(node.kind));
+  }
+}
+
 void ast_dump_node_list(Nob_String_Builder *sb, AST_NodeList *nodes) {
   nob_da_foreach(AST_Node, n, nodes) {
     size_t index = n - nodes->items;
@@ -190,6 +655,13 @@ void ast_dump_node_list(Nob_String_Builder *sb, AST_NodeList *nodes) {
   }
 }
 
+void ast_dump_statement_list_at_depth(Nob_String_Builder *sb, AST_NodeList *nodes, int depth) {
+  nob_da_foreach(AST_Node, n, nodes) {
+    ast_dump_node_at_depth(sb, *n, depth);
+    nob_sb_append_cstr(sb, ";\n");
+  }
+}
+
 void ast_dump_node_at_depth(Nob_String_Builder *sb, AST_Node node, int depth) {
   sb_add_indentation_level(sb, i, depth);
   switch (node.kind) {
@@ -208,10 +680,14 @@ void ast_dump_node_at_depth(Nob_String_Builder *sb, AST_Node node, int depth) {
 
   // Molecules
   case AST_NK_UNOP:
-    TODO("Dumping of AST_Node AST_NK_UNOP");
+    nob_sb_appendf(sb, "Node::UnOp("SV_Fmt", ", SV_Arg(node.as.op.op.sv));
+    ast_dump_node_list(sb, &node.as.op.operands);
+    nob_sb_append_cstr(sb, ")");
     return;
   case AST_NK_BINOP:
-    TODO("Dumping of AST_Node AST_NK_BINOP");
+    nob_sb_appendf(sb, "Node::BinOp("SV_Fmt", ", SV_Arg(node.as.op.op.sv));
+    ast_dump_node_list(sb, &node.as.op.operands);
+    nob_sb_append_cstr(sb, ")");
     return;
   case AST_NK_FN_PARAMS_DECL:
     TODO("Dumping of AST_Node AST_NK_FN_PARAMS_DECL");
@@ -247,7 +723,13 @@ void ast_dump_node_at_depth(Nob_String_Builder *sb, AST_Node node, int depth) {
     return;
 
   case AST_NK_FN_DECL:
-    nob_sb_appendf(sb, "Node::FnDecl(Token::Ident('"SV_Fmt"'), []) {\n", SV_Arg(node.as.fn_decl.name));
+    nob_sb_append_cstr(sb, node.as.fn_decl.async ? "Node::AsyncFnDecl" : "Node::FnDecl");
+    nob_da_foreach(Nob_String_View, attr, &node.as.fn_decl.attrs) {
+      nob_sb_appendf(sb, "<@"SV_Fmt">", SV_Arg(*attr));
+    }
+    nob_sb_appendf(sb, "(Token::Ident('"SV_Fmt"'), [", SV_Arg(node.as.fn_decl.name));
+    ast_dump_node_list(sb, &node.as.fn_decl.params);
+    nob_sb_append_cstr(sb, "]) {\n");
     nob_da_foreach(AST_Node, n, &node.as.fn_decl.body) {
       size_t index = n - node.as.fn_decl.body.items;
       if (index > 0) nob_sb_append_cstr(sb, ";\n");
@@ -258,6 +740,141 @@ void ast_dump_node_at_depth(Nob_String_Builder *sb, AST_Node node, int depth) {
     nob_sb_append_cstr(sb, "}");
     return;
 
+  case AST_NK_BLOCK:
+    nob_sb_append_cstr(sb, "Node::Block {\n");
+    nob_da_foreach(AST_Node, n, &node.as.block) {
+      size_t index = n - node.as.block.items;
+      if (index > 0) nob_sb_append_cstr(sb, ";\n");
+      ast_dump_node_at_depth(sb, *n, depth+1);
+    }
+    nob_sb_append_cstr(sb, "\n");
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}");
+    return;
+
+  case AST_NK_IF:
+    nob_sb_append_cstr(sb, "Node::If(");
+    ast_dump_node_list(sb, &node.as.if_stmt.cond);
+    nob_sb_append_cstr(sb, ") {\n");
+    ast_dump_statement_list_at_depth(sb, &node.as.if_stmt.then_body, depth + 1);
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}");
+    if (node.as.if_stmt.else_body.count > 0) {
+      nob_sb_append_cstr(sb, " else {\n");
+      ast_dump_statement_list_at_depth(sb, &node.as.if_stmt.else_body, depth + 1);
+      sb_add_indentation_level(sb, i, depth);
+      nob_sb_append_cstr(sb, "}");
+    }
+    return;
+
+  case AST_NK_WHILE:
+    nob_sb_append_cstr(sb, "Node::While(");
+    ast_dump_node_list(sb, &node.as.while_loop.cond);
+    nob_sb_append_cstr(sb, ") {\n");
+    ast_dump_statement_list_at_depth(sb, &node.as.while_loop.body, depth + 1);
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}");
+    return;
+
+  case AST_NK_RETURN:
+    nob_sb_append_cstr(sb, "Node::Return(");
+    ast_dump_node_list(sb, &node.as.ret);
+    nob_sb_append_cstr(sb, ")");
+    return;
+  case AST_NK_YIELD:
+    nob_sb_append_cstr(sb, "Node::Yield(");
+    ast_dump_node_list(sb, &node.as.yield);
+    nob_sb_append_cstr(sb, ")");
+    return;
+  case AST_NK_AWAIT:
+    nob_sb_append_cstr(sb, "Node::Await(");
+    ast_dump_node_list(sb, &node.as.awaited);
+    nob_sb_append_cstr(sb, ")");
+    return;
+  case AST_NK_FOR:
+    nob_sb_appendf(sb, "Node::For(Token::Ident('"SV_Fmt"'), ", SV_Arg(node.as.for_loop.name));
+    ast_dump_node_list(sb, &node.as.for_loop.iter);
+    nob_sb_append_cstr(sb, ") {\n");
+    ast_dump_statement_list_at_depth(sb, &node.as.for_loop.body, depth + 1);
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}");
+    return;
+
+  case AST_NK_MATCH:
+    nob_sb_append_cstr(sb, "Node::Match(");
+    ast_dump_node_list(sb, &node.as.match.subject);
+    nob_sb_append_cstr(sb, ") {\n");
+    nob_da_foreach(AST_Node, arm, &node.as.match.arms) {
+      ast_dump_node_at_depth(sb, *arm, depth + 1);
+      nob_sb_append_cstr(sb, ",\n");
+    }
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}");
+    return;
+  case AST_NK_MATCH_ARM:
+    nob_sb_append_cstr(sb, "Node::MatchArm([");
+    ast_dump_node_list(sb, &node.as.match_arm.patterns);
+    nob_sb_append_cstr(sb, "], ");
+    ast_dump_node_list(sb, &node.as.match_arm.value);
+    nob_sb_append_cstr(sb, ")");
+    return;
+
+  case AST_NK_ARRAY:
+    nob_sb_append_cstr(sb, "Node::Array([");
+    ast_dump_node_list(sb, &node.as.array.items);
+    if (node.as.array.length.count > 0) {
+      nob_sb_append_cstr(sb, "; ");
+      ast_dump_node_list(sb, &node.as.array.length);
+    }
+    nob_sb_append_cstr(sb, "])");
+    return;
+  case AST_NK_INDEX:
+    nob_sb_append_cstr(sb, "Node::Index(");
+    ast_dump_node_list(sb, &node.as.index.target);
+    nob_sb_append_cstr(sb, "[");
+    ast_dump_node_list(sb, &node.as.index.start);
+    if (node.as.index.slice) {
+      nob_sb_append_cstr(sb, "..");
+      ast_dump_node_list(sb, &node.as.index.end);
+    }
+    nob_sb_append_cstr(sb, "])");
+    return;
+  case AST_NK_PIPELINE:
+    nob_sb_append_cstr(sb, "Node::Pipeline(");
+    ast_dump_node_list(sb, &node.as.pipeline.source);
+    nob_sb_append_cstr(sb, ", [");
+    ast_dump_node_list(sb, &node.as.pipeline.stages);
+    nob_sb_append_cstr(sb, "])");
+    return;
+  case AST_NK_PIPE_STAGE: {
+    static const char *stage_names[] = { "Call", "Map", "Filter", "Reduce" };
+    nob_sb_appendf(sb, "Node::PipeStage(%s, ", stage_names[node.as.pipe_stage.kind]);
+    ast_dump_node_list(sb, &node.as.pipe_stage.call);
+    if (node.as.pipe_stage.init.count > 0) {
+      nob_sb_append_cstr(sb, ", ");
+      ast_dump_node_list(sb, &node.as.pipe_stage.init);
+    }
+    nob_sb_append_cstr(sb, ")");
+  } return;
+
+  case AST_NK_STRUCT_DECL:
+    nob_sb_append_cstr(sb, "Node::StructDecl");
+    nob_da_foreach(Nob_String_View, attr, &node.as.struct_decl.attrs) {
+      nob_sb_appendf(sb, "<@"SV_Fmt">", SV_Arg(*attr));
+    }
+    nob_sb_appendf(sb, "(Token::Ident('"SV_Fmt"'), [", SV_Arg(node.as.struct_decl.name));
+    nob_da_foreach(Nob_String_View, field, &node.as.struct_decl.fields) {
+      if (field != node.as.struct_decl.fields.items) nob_sb_append_cstr(sb, ", ");
+      dump_token(sb, (Token) { .kind = TOK_IDENT, .sv = *field });
+    }
+    nob_sb_append_cstr(sb, "])");
+    return;
+  case AST_NK_FIELD:
+    nob_sb_append_cstr(sb, "Node::Field(");
+    ast_dump_node_list(sb, &node.as.field.target);
+    nob_sb_appendf(sb, ", '"SV_Fmt"')", SV_Arg(node.as.field.name));
+    return;
+
   case AST_NK_FN_CALL:
     nob_sb_append_cstr(sb, "Node::FnCall(");
     dump_token(sb, (Token) { .kind = TOK_IDENT, .sv = node.as.fn_call.name });
@@ -272,91 +889,485 @@ void ast_dump_node_at_depth(Nob_String_Builder *sb, AST_Node node, int depth) {
   HERE("ast_dump_node_at_depth: Unsupported node kind");
 }
 
-bool ast_create_expr(Lexer *l, AST_NodeList *expr) {
-  Token tok;
-  static TokenKind allowed_expr_tokens[] = { TOK_IDENT, TOK_INT };
-  static size_t allowed_expr_count = NOB_ARRAY_LEN(allowed_expr_tokens);
-  
-  for (;;) {
-    AST_Node value = {0};
-    if (!expect_next_token_kind_from_sized_arr(l, &tok, allowed_expr_tokens, allowed_expr_count)) {
-      if (tok.kind == TOK_EOF) {
-        comp_error(l->loc, "Unexpected end of file: Missing rvalue for variable initialization");
-      } else {
-        comp_errorf(l->loc, "Invalid token %s(`"SV_Fmt"`) found in expression", token_kind_name(tok.kind), SV_Arg(tok.sv));
-      }
+int ast_binop_precedence(Nob_String_View op) {
+  if (sv_eq_str(op, "||")) return 1;
+  if (sv_eq_str(op, "&&")) return 2;
+  if (sv_eq_str(op, "==") || sv_eq_str(op, "!=")) return 3;
+  if (sv_eq_str(op, "<") || sv_eq_str(op, "<=") || sv_eq_str(op, ">") || sv_eq_str(op, ">=")) return 4;
+  if (sv_eq_str(op, "+") || sv_eq_str(op, "-")) return 5;
+  if (sv_eq_str(op, "*") || sv_eq_str(op, "/") || sv_eq_str(op, "%")) return 6;
+  return 0;
+}
+
+bool ast_create_fn_call_args(Lexer *l, AST_NodeList *params);
+bool ast_create_binop_rhs(Lexer *l, int min_precedence, AST_Node *lhs);
+bool ast_create_expr(Lexer *l, AST_NodeList *expr);
+
+double ast_int_literal_value(AST_Node *node) {
+  if (node->kind == AST_NK_UNOP) return -ast_int_literal_value(&node->as.op.operands.items[0]);
+  double value = 0;
+  for (size_t i = 0; i < node->as.token.sv.count; ++i) {
+    value = value*10 + (node->as.token.sv.data[i] - '0');
+  }
+  return value;
+}
+
+// Parses an integer pattern of a match arm, `-` followed by a literal is accepted for negative numbers
+bool ast_create_match_pattern(Lexer *l, AST_Node *pattern) {
+  Token tok = {0};
+  next_token(l, &tok);
+  pattern->loc = l->loc;
+  if (tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "-")) {
+    pattern->kind = AST_NK_UNOP;
+    pattern->as.op.op = tok;
+    AST_Node literal = {0};
+    if (!ast_create_match_pattern(l, &literal)) return false;
+    if (literal.kind != AST_NK_TOKEN) {
+      comp_error(literal.loc, "Only a single `-` is allowed in a match pattern");
+      ast_node_children_free(&literal);
+      return false;
+    }
+    nob_da_append(&pattern->as.op.operands, literal);
+    return true;
+  }
+  if (tok.kind != TOK_INT) {
+    comp_errorf(l->loc, "Match patterns must be integer literals or `_` but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  pattern->kind = AST_NK_TOKEN;
+  pattern->as.token = tok;
+  return true;
+}
+
+// Parses the parenthesized subject and the arms of a match after its already consumed keyword
+bool ast_create_match(Lexer *l, AST_Node *node) {
+  Token tok = {0};
+  Loc match_loc = node->loc;
+  node->kind = AST_NK_MATCH;
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "(")) {
+    comp_errorf(l->loc, "Expected `(` after `match` but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  if (!ast_create_expr(l, &node->as.match.subject)) {
+    comp_note(match_loc, "Invalid subject for match");
+    return false;
+  }
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, ")")) {
+    comp_errorf(l->loc, "Expected `)` to close the match subject but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "{")) {
+    comp_errorf(l->loc, "Expected `{` to open the match arms but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  Loc open_loc = l->loc;
+  bool has_fallback = false;
+  Loc fallback_loc = {0};
+  while (true) {
+    if (!peek_token(*l, &tok) || tok.kind == TOK_EOF) {
+      comp_error(l->loc, "Expected '}' to close the match but found end of file instead");
+      comp_note(open_loc, "Match opened here");
       return false;
     }
-    value.loc = l->loc;
-    if (tok.kind == TOK_INT || tok.kind == TOK_IDENT) {
-      value.kind = AST_NK_TOKEN;
-      value.as.token = tok;
+    if (tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "}")) {
+      lexer_next_token(l);
+      break;
+    }
+    AST_Node arm = { .loc = l->loc, .kind = AST_NK_MATCH_ARM };
+    if (tok.kind == TOK_IDENT && sv_eq_str(tok.sv, "_")) {
+      lexer_next_token(l);
+      arm.loc = l->loc;
+      if (has_fallback) {
+        comp_error(arm.loc, "Match has more than one `_` arm");
+        comp_note(fallback_loc, "First `_` arm is here");
+        return false;
+      }
+      has_fallback = true;
+      fallback_loc = arm.loc;
     } else {
-      comp_errorf(l->loc, "Unsupported token %s(`"SV_Fmt"`) found in expression", token_kind_name(tok.kind), SV_Arg(tok.sv));
-      TODO("Add missing allowed expression tokens");
-      // return false;
+      while (true) {
+        AST_Node pattern = {0};
+        if (!ast_create_match_pattern(l, &pattern)) return false;
+        double value = ast_int_literal_value(&pattern);
+        nob_da_foreach(AST_Node, other, &node->as.match.arms) {
+          nob_da_foreach(AST_Node, seen, &other->as.match_arm.patterns) {
+            if (ast_int_literal_value(seen) != value) continue;
+            comp_errorf(pattern.loc, "Pattern %.0f is already handled by an earlier arm", value);
+            comp_note(seen->loc, "Handled here");
+            return false;
+          }
+        }
+        nob_da_append(&arm.as.match_arm.patterns, pattern);
+        if (!(peek_token(*l, &tok) && tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "|"))) break;
+        lexer_next_token(l);
+      }
     }
-    nob_da_append(expr, value);
-
-    Lexer peeker = *l;
-    if (!peek_token(peeker, &tok)) {
-      comp_error(peeker.loc, "Unexpected end of file: Missing semicolon?");
+    if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "=>")) {
+      comp_errorf(l->loc, "Expected `=>` after match pattern but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
       return false;
     }
-    if (tok.kind != TOK_SYMBOL) {
-      comp_errorf(peeker.loc,
-                  "Unexpected %s(`"SV_Fmt"`): Expected math operand or a expression finisher was expected",
-                  token_kind_name(tok.kind), SV_Arg(tok.sv));
+    if (!ast_create_expr(l, &arm.as.match_arm.value)) {
+      comp_note(arm.loc, "Invalid value for match arm");
       return false;
     }
-    if (sv_eq_str(tok.sv, "+") || sv_eq_str(tok.sv, "-")) {
+    nob_da_append(&node->as.match.arms, arm);
+    if (peek_token(*l, &tok) && tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, ",")) {
       lexer_next_token(l);
-      AST_Node operand = {
-        .loc = l->loc,
-        .kind = AST_NK_TOKEN,
-      };
-      operand.as.token = tok;
-      nob_da_append(expr, operand);
       continue;
     }
-    break;
+    if (!(tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "}"))) {
+      comp_errorf(l->loc, "Expected `,` or `}` after match arm but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+      return false;
+    }
   }
-
   return true;
 }
 
-bool ast_create_var_decl(Lexer *l, AST_Node *decl) {
-  Token tok;
-  decl->kind = AST_NK_VAR_DECL;
-  if (!expect_next_token_eq_str(l, &tok, TOK_IDENT, "let")) {
-    comp_error(l->loc, "Unexpected EOF: expected keyword `let` accompanied by a variable name");
-    return false;
-  }
-  Loc decl_start_loc = l->loc;
-  
-  if (!expect_next_token_kind(l, &tok, TOK_IDENT)) {
-    comp_errorf(l->loc, "Expected name for variable but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
-    comp_note(decl_start_loc, "Variable declaration starts here");
-    return false;
+// Parses the elements of an array literal after its already consumed `[` up to and including the `]`
+bool ast_create_array(Lexer *l, AST_Node *node) {
+  Token tok = {0};
+  Loc open_loc = node->loc;
+  node->kind = AST_NK_ARRAY;
+  if (peek_token(*l, &tok) && tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "]")) {
+    lexer_next_token(l);
+    return true;
   }
-
-  decl->loc = l->loc;
-  decl->as.var_decl.name = tok.sv;
-
-  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, ":")) {
-    if (tok.kind == TOK_EOF) {
-      comp_error(l->loc, "Unexpected end of file: expected mutable variable initialization with ':=' or immutable with '::'");
-    } else {
-      comp_errorf(l->loc,
-                  "Unexpected %s token `"SV_Fmt"`: expected variable initialization with ':=' or immutable with '::'",
-                  token_kind_name(tok.kind),
-                  SV_Arg(tok.sv));
+  while (true) {
+    if (!ast_create_expr(l, &node->as.array.items)) {
+      comp_note(open_loc, "Array starts here");
+      return false;
     }
-    comp_note(decl_start_loc, "Variable declaration starts here");
-    return false;
+    if (!expect_next_token_kind(l, &tok, TOK_SYMBOL) || (!sv_eq_str(tok.sv, ",") && !sv_eq_str(tok.sv, "]") && !sv_eq_str(tok.sv, ";"))) {
+      comp_errorf(l->loc, "Expected `,` or `]` after array element but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+      comp_note(open_loc, "Array starts here");
+      return false;
+    }
+    if (sv_eq_str(tok.sv, "]")) return true;
+    if (!sv_eq_str(tok.sv, ";")) continue;
+    // `[value; length]`
+    if (node->as.array.items.count != 1) {
+      comp_error(l->loc, "Only a single value can be repeated with `[value; length]`");
+      comp_note(open_loc, "Array starts here");
+      return false;
+    }
+    if (!ast_create_expr(l, &node->as.array.length)) return false;
+    if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "]")) {
+      comp_error(l->loc, "Expected `]` after the length of the array");
+      comp_note(open_loc, "Array starts here");
+      return false;
+    }
+    return true;
   }
+}
 
-  if (!expect_next_token_kind(l, &tok, TOK_SYMBOL) || (!sv_eq_str(tok.sv, "=") && !sv_eq_str(tok.sv, ":"))) {
+// Parses `[i]`, `[start..end]` or `.field` after target, they get chained so `m[i][j].x` works
+bool ast_create_index(Lexer *l, AST_Node *target) {
+  Token tok = {0};
+  while (peek_token(*l, &tok) && tok.kind == TOK_SYMBOL && (sv_eq_str(tok.sv, "[") || sv_eq_str(tok.sv, "."))) {
+    lexer_next_token(l);
+    if (sv_eq_str(tok.sv, ".")) {
+      AST_Node field = {
+        .loc = l->loc,
+        .kind = AST_NK_FIELD,
+      };
+      if (!expect_next_token_kind(l, &tok, TOK_IDENT)) {
+        comp_errorf(l->loc, "Expected field name after `.` but found %s", token_kind_name(tok.kind));
+        return false;
+      }
+      field.as.field.name = tok.sv;
+      nob_da_append(&field.as.field.target, *target);
+      *target = field;
+      continue;
+    }
+    Loc open_loc = l->loc;
+    AST_Node index = {
+      .loc = open_loc,
+      .kind = AST_NK_INDEX,
+    };
+    nob_da_append(&index.as.index.target, *target);
+    *target = index;
+    AST_Index *it = &target->as.index;
+    if (!(peek_token(*l, &tok) && tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, ".."))) {
+      if (!ast_create_expr(l, &it->start)) return false;
+    }
+    if (peek_token(*l, &tok) && tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "..")) {
+      lexer_next_token(l);
+      it->slice = true;
+      if (!(peek_token(*l, &tok) && tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "]"))) {
+        if (!ast_create_expr(l, &it->end)) return false;
+      }
+    }
+    if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "]")) {
+      comp_error(l->loc, "Expected `]` to close the index");
+      comp_note(open_loc, "Index starts here");
+      return false;
+    }
+  }
+  return true;
+}
+
+AST_Node ast_pipe_placeholder(Loc loc, const char *name) {
+  AST_Node node = {
+    .loc = loc,
+    .kind = AST_NK_TOKEN,
+  };
+  node.as.token.kind = TOK_IDENT;
+  node.as.token.sv = SV(name);
+  return node;
+}
+
+// `Array.map(f)`, `Array.filter(f)`, `Array.reduce(f, init)` or any call `f(args)` and bare function name `f`
+bool ast_create_pipe_stage(Lexer *l, AST_Node *stage) {
+  Token tok = {0};
+  if (!expect_next_token_kind(l, &tok, TOK_IDENT)) {
+    comp_errorf(l->loc, "Expected a function to pipe into after `|>` but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  stage->loc = l->loc;
+  stage->kind = AST_NK_PIPE_STAGE;
+  AST_Node call = { .loc = l->loc, .kind = AST_NK_FN_CALL };
+  call.as.fn_call.name = tok.sv;
+  AST_NodeList args = {0};
+
+  if (sv_eq_str(tok.sv, "Array")) {
+    Token method = {0};
+    if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, ".") || !expect_next_token_kind(l, &method, TOK_IDENT)) {
+      comp_error(l->loc, "Expected `Array.map`, `Array.filter` or `Array.reduce`");
+      return false;
+    }
+    size_t arity = 1;
+    if (sv_eq_str(method.sv, "map")) {
+      stage->as.pipe_stage.kind = AST_PIPE_MAP;
+    } else if (sv_eq_str(method.sv, "filter")) {
+      stage->as.pipe_stage.kind = AST_PIPE_FILTER;
+    } else if (sv_eq_str(method.sv, "reduce")) {
+      stage->as.pipe_stage.kind = AST_PIPE_REDUCE;
+      arity = 2;
+    } else {
+      comp_errorf(l->loc, "Unknown array stage `Array."SV_Fmt"`, expected map, filter or reduce", SV_Arg(method.sv));
+      return false;
+    }
+    if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "(")) {
+      comp_errorf(l->loc, "Expected `(` after `Array."SV_Fmt"`", SV_Arg(method.sv));
+      return false;
+    }
+    if (!ast_create_fn_call_args(l, &args)) return false;
+    if (args.count != arity || args.items[0].kind != AST_NK_TOKEN || args.items[0].as.token.kind != TOK_IDENT) {
+      comp_errorf(stage->loc, "`Array."SV_Fmt"` takes the name of a function%s", SV_Arg(method.sv), arity == 2 ? " and the starting value" : "");
+      ast_node_list_free(&args);
+      return false;
+    }
+    // The function gets called with the element, reduce passes what it has accumulated first
+    call.loc = args.items[0].loc;
+    call.as.fn_call.name = args.items[0].as.token.sv;
+    if (stage->as.pipe_stage.kind == AST_PIPE_REDUCE) {
+      nob_da_append(&call.as.fn_call.params, ast_pipe_placeholder(call.loc, AST_PIPE_ACC));
+      nob_da_append(&stage->as.pipe_stage.init, args.items[1]);
+    }
+    nob_da_append(&call.as.fn_call.params, ast_pipe_placeholder(call.loc, AST_PIPE_ITEM));
+    safe_da_free(args);
+    nob_da_append(&stage->as.pipe_stage.call, call);
+    return true;
+  }
+
+  stage->as.pipe_stage.kind = AST_PIPE_CALL;
+  nob_da_append(&call.as.fn_call.params, ast_pipe_placeholder(call.loc, AST_PIPE_ITEM));
+  if (peek_token(*l, &tok) && tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "(")) {
+    lexer_next_token(l);
+    if (!ast_create_fn_call_args(l, &call.as.fn_call.params)) return false;
+  }
+  nob_da_append(&stage->as.pipe_stage.call, call);
+  return true;
+}
+
+// Turns lhs into a pipeline when `|>` follows it, `|>` binds looser than every other operator
+bool ast_create_pipeline(Lexer *l, AST_Node *lhs) {
+  Token tok = {0};
+  if (!(peek_token(*l, &tok) && tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "|>"))) return true;
+  AST_Node pipeline = {
+    .loc = lhs->loc,
+    .kind = AST_NK_PIPELINE,
+  };
+  nob_da_append(&pipeline.as.pipeline.source, *lhs);
+  while (peek_token(*l, &tok) && tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "|>")) {
+    lexer_next_token(l);
+    AST_Node stage = {0};
+    if (!ast_create_pipe_stage(l, &stage)) {
+      *lhs = pipeline;
+      return false;
+    }
+    nob_da_append(&pipeline.as.pipeline.stages, stage);
+  }
+  *lhs = pipeline;
+  return true;
+}
+
+bool ast_create_atom(Lexer *l, AST_Node *node);
+
+// Parses a single value of an expression: literals, variables, calls, unary operations or a parenthesized expression
+bool ast_create_operand(Lexer *l, AST_Node *node) {
+  if (!ast_create_atom(l, node)) return false;
+  // The operand of a unary operation or an await already took the index
+  if (node->kind == AST_NK_UNOP || node->kind == AST_NK_AWAIT) return true;
+  return ast_create_index(l, node);
+}
+
+bool ast_create_atom(Lexer *l, AST_Node *node) {
+  Token tok;
+  if (!next_token(l, &tok)) {
+    comp_error(l->loc, "Unexpected end of file: Missing value in expression");
+    return false;
+  }
+  node->loc = l->loc;
+  if (tok.kind == TOK_INT || tok.kind == TOK_STR) {
+    node->kind = AST_NK_TOKEN;
+    node->as.token = tok;
+    return true;
+  }
+  if (tok.kind == TOK_IDENT && sv_eq_str(tok.sv, KEYWORD_MATCH)) {
+    return ast_create_match(l, node);
+  }
+  if (tok.kind == TOK_IDENT && sv_eq_str(tok.sv, KEYWORD_AWAIT)) {
+    // Binds like a unary operation, `await f() + 1` adds to what f() resolved to
+    node->kind = AST_NK_AWAIT;
+    AST_Node operand = {0};
+    if (!ast_create_operand(l, &operand)) return false;
+    nob_da_append(&node->as.awaited, operand);
+    return true;
+  }
+  if (tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "[")) {
+    return ast_create_array(l, node);
+  }
+  if (tok.kind == TOK_IDENT) {
+    Token peeked = {0};
+    if (peek_token(*l, &peeked) && peeked.kind == TOK_SYMBOL && sv_eq_str(peeked.sv, "(")) {
+      lexer_next_token(l);
+      node->kind = AST_NK_FN_CALL;
+      node->as.fn_call.name = tok.sv;
+      return ast_create_fn_call_args(l, &node->as.fn_call.params);
+    }
+    node->kind = AST_NK_TOKEN;
+    node->as.token = tok;
+    return true;
+  }
+  if (tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "(")) {
+    Loc open_loc = l->loc;
+    if (!ast_create_operand(l, node)) return false;
+    if (!ast_create_binop_rhs(l, 1, node)) return false;
+    if (!ast_create_pipeline(l, node)) return false;
+    if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, ")")) {
+      comp_error(l->loc, "Expected `)` to close parenthesized expression");
+      comp_note(open_loc, "Parenthesis opened here");
+      return false;
+    }
+    return true;
+  }
+  if (tok.kind == TOK_SYMBOL && (sv_eq_str(tok.sv, "-") || sv_eq_str(tok.sv, "!"))) {
+    node->kind = AST_NK_UNOP;
+    node->as.op.op = tok;
+    AST_Node operand = {0};
+    if (!ast_create_operand(l, &operand)) return false;
+    nob_da_append(&node->as.op.operands, operand);
+    return true;
+  }
+  if (tok.kind == TOK_EOF) {
+    comp_error(l->loc, "Unexpected end of file: Missing rvalue for variable initialization");
+  } else {
+    comp_errorf(l->loc, "Invalid token %s(`"SV_Fmt"`) found in expression", token_kind_name(tok.kind), SV_Arg(tok.sv));
+  }
+  return false;
+}
+
+// Keeps folding binary operations onto lhs while their operator binds at least as tight as min_precedence
+bool ast_create_binop_rhs(Lexer *l, int min_precedence, AST_Node *lhs) {
+  while (true) {
+    Token op = {0};
+    if (!peek_token(*l, &op) || op.kind != TOK_SYMBOL) return true;
+    int precedence = ast_binop_precedence(op.sv);
+    if (precedence == 0 || precedence < min_precedence) return true;
+    lexer_next_token(l);
+    Loc loc = l->loc;
+
+    AST_Node rhs = {0};
+    if (!ast_create_operand(l, &rhs)) return false;
+    Token next = {0};
+    while (peek_token(*l, &next) && next.kind == TOK_SYMBOL && ast_binop_precedence(next.sv) > precedence) {
+      if (!ast_create_binop_rhs(l, precedence + 1, &rhs)) return false;
+    }
+
+    AST_Node binop = {
+      .loc = loc,
+      .kind = AST_NK_BINOP,
+    };
+    binop.as.op.op = op;
+    nob_da_append(&binop.as.op.operands, *lhs);
+    nob_da_append(&binop.as.op.operands, rhs);
+    *lhs = binop;
+  }
+}
+
+// Parses an expression into a tree and appends its root to expr
+bool ast_create_expr(Lexer *l, AST_NodeList *expr) {
+  AST_Node root = {0};
+  if (!ast_create_operand(l, &root)) return false;
+  if (!ast_create_binop_rhs(l, 1, &root)) return false;
+  if (!ast_create_pipeline(l, &root)) return false;
+  nob_da_append(expr, root);
+
+  Token tok = {0};
+  Lexer peeker = *l;
+  if (!peek_token(peeker, &tok)) {
+    comp_error(peeker.loc, "Unexpected end of file: Missing semicolon?");
+    return false;
+  }
+  if (tok.kind != TOK_SYMBOL) {
+    comp_errorf(peeker.loc,
+                "Unexpected %s(`"SV_Fmt"`): Expected math operand or a expression finisher was expected",
+                token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  return true;
+}
+
+bool ast_create_var_binding(Lexer *l, AST_Node *decl, Loc decl_start_loc);
+
+bool ast_create_var_decl(Lexer *l, AST_Node *decl) {
+  Token tok;
+  decl->kind = AST_NK_VAR_DECL;
+  if (!expect_next_token_eq_str(l, &tok, TOK_IDENT, "let")) {
+    comp_error(l->loc, "Unexpected EOF: expected keyword `let` accompanied by a variable name");
+    return false;
+  }
+  return ast_create_var_binding(l, decl, l->loc);
+}
+
+// Everything in a variable declaration after `let`, statements can also start with it directly as in `n :: 100;`
+bool ast_create_var_binding(Lexer *l, AST_Node *decl, Loc decl_start_loc) {
+  Token tok;
+  decl->kind = AST_NK_VAR_DECL;
+  if (!expect_next_token_kind(l, &tok, TOK_IDENT)) {
+    comp_errorf(l->loc, "Expected name for variable but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    comp_note(decl_start_loc, "Variable declaration starts here");
+    return false;
+  }
+
+  decl->loc = l->loc;
+  decl->as.var_decl.name = tok.sv;
+
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, ":")) {
+    if (tok.kind == TOK_EOF) {
+      comp_error(l->loc, "Unexpected end of file: expected mutable variable initialization with ':=' or immutable with '::'");
+    } else {
+      comp_errorf(l->loc,
+                  "Unexpected %s token `"SV_Fmt"`: expected variable initialization with ':=' or immutable with '::'",
+                  token_kind_name(tok.kind),
+                  SV_Arg(tok.sv));
+    }
+    comp_note(decl_start_loc, "Variable declaration starts here");
+    return false;
+  }
+
+  if (!expect_next_token_kind(l, &tok, TOK_SYMBOL) || (!sv_eq_str(tok.sv, "=") && !sv_eq_str(tok.sv, ":"))) {
     if (tok.kind == TOK_EOF) {
       comp_error(l->loc, "Unexpected end of file: expected mutable variable initialization with ':=' or immutable with '::'");
     } else {
@@ -370,10 +1381,7 @@ bool ast_create_var_decl(Lexer *l, AST_Node *decl) {
   }
   decl->as.var_decl.mutable = sv_eq_str(tok.sv, "=");
 
-  AST_NodeList expr = {
-    .items = nob_temp_alloc(sizeof(AST_Node)),
-    .capacity = 1,
-  };
+  AST_NodeList expr = {0};
   if (!ast_create_expr(l, &expr)) {
     comp_note(decl_start_loc, "Variable declaration starts here");
     return false;
@@ -418,191 +1426,570 @@ bool ast_create_assignment(Lexer *l, AST_Node *node, Nob_String_View name) {
   return true;
 }
 
-bool ast_create_fn_body(Lexer *l, AST_Node *fn_node) {
-  Token tok;
-  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "{")) {
-    comp_errorf(l->loc, "Expected '{' for declaring function body but found %s", token_kind_name(tok.kind));
+// Parses the arguments of a function call up to and including the closing parenthesis
+bool ast_create_fn_call_args(Lexer *l, AST_NodeList *params) {
+  Token tok = {0};
+  if (!peek_token(*l, &tok)) {
+    comp_error(l->loc, "Unexpected End of File unfinished function call");
     return false;
   }
+  if (tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, ")")) {
+    lexer_next_token(l);
+    return true;
+  }
+  while (true) {
+    Loc arg_loc = l->loc;
+    AST_NodeList p_expr = {0};
+    if (!ast_create_expr(l, &p_expr)) {
+      comp_error(l->loc, "Failed to parse function call argument");
+      return false;
+    }
+    AST_Node p_node = {0};
+    if (p_expr.count == 1) {
+      p_node = p_expr.items[0];
+      safe_da_free(p_expr);
+    } else {
+      p_node.kind = AST_NK_EXPR;
+      p_node.loc = arg_loc;
+      p_node.as.expr = p_expr;
+    }
+    nob_da_append(params, p_node);
 
-  AST_NodeList *body = &fn_node->as.fn_decl.body;
-  while (peek_token(*l, &tok) && !sv_eq_str(tok.sv, "}")) {
-    if (sv_eq_str(tok.sv, KEYWORD_LET)) {
-      AST_Node node = { .loc = l->loc };
-      if (!ast_create_var_decl(l, &node)) {
-        return false;
+    if (!expect_next_token_kind(l, &tok, TOK_SYMBOL) || (!sv_eq_str(tok.sv, ",") && !sv_eq_str(tok.sv, ")"))) {
+      if (tok.kind == TOK_EOF) {
+        comp_error(l->loc, "Unexpected End of File unfinished function call");
+      } else {
+        comp_errorf(l->loc, "Unexpected token expected closing parenthesis `)` or `,` but got %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
       }
-      nob_da_append(body, node);
-      continue;
+      return false;
     }
-    if (tok.kind == TOK_IDENT) {
-      next_token(l, &tok);
-      AST_Node node = {
-        .loc = l->loc,
-        .kind = AST_NK_EOF,
-      };
-      Nob_String_View name = tok.sv;
-      if (!expect_next_token_kind(l, &tok, TOK_SYMBOL)) {
-        if (tok.kind == TOK_EOF) {
-          comp_error(l->loc, "Unexpected End of File created hanging statement");
-        } else {
-          comp_errorf(l->loc, "Unexpected token expected ';' or '()' but got %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
-        }
-        return false;
-      }
-      if (sv_eq_str(tok.sv, EQSIGN)) {
-        if (!ast_create_assignment(l, &node, name)) {
-          return false;
-        }
-        nob_da_append(body, node);
-        continue;
+    if (sv_eq_str(tok.sv, ")")) return true;
+  }
+}
+
+// Parses the parameter names of a function declaration up to and including the closing parenthesis
+bool ast_create_fn_params_decl(Lexer *l, AST_NodeList *params) {
+  Token tok = {0};
+  if (!peek_token(*l, &tok)) {
+    comp_error(l->loc, "Unexpected end of file: Was expecting the closing of the function parameters declaration but got EOF");
+    return false;
+  }
+  if (tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, ")")) {
+    lexer_next_token(l);
+    return true;
+  }
+  while (true) {
+    if (!expect_next_token_kind(l, &tok, TOK_IDENT)) {
+      if (tok.kind == TOK_EOF) {
+        comp_error(l->loc, "Unexpected end of file: Was expecting a parameter name");
+      } else {
+        comp_errorf(l->loc, "Expected parameter name but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
       }
-      node.kind = AST_NK_FN_CALL;
-      node.as.fn_call.name = name;
-      if (!sv_eq_str(tok.sv, "(")) {
-        comp_errorf(l->loc, "Unexpected token expected ';' or '()' but got `"SV_Fmt"`", SV_Arg(tok.sv));
+      return false;
+    }
+    nob_da_foreach(AST_Node, p, params) {
+      if (nob_sv_eq(p->as.token.sv, tok.sv)) {
+        comp_errorf(l->loc, "Parameter `"SV_Fmt"` is declared more than once", SV_Arg(tok.sv));
+        comp_note(p->loc, "Previously declared here");
         return false;
       }
-      Lexer peeker = *l;
-      if (!expect_next_token_kind_from_arr(&peeker, &tok, ((TokenKind[]){TOK_SYMBOL, TOK_IDENT, TOK_INT}))) {
-        if (tok.kind == TOK_EOF) {
-          comp_error(l->loc, "Unexpected End of File unfinished function call");
-        } else {
-          comp_errorf(l->loc, "Unexpected token expected closing parenthesis `)` or an function argument but got %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
-        }
-        return false;
+    }
+    AST_Node param = {
+      .loc = l->loc,
+      .kind = AST_NK_TOKEN,
+    };
+    param.as.token = tok;
+    nob_da_append(params, param);
+
+    if (!expect_next_token_kind(l, &tok, TOK_SYMBOL) || (!sv_eq_str(tok.sv, ",") && !sv_eq_str(tok.sv, ")"))) {
+      if (tok.kind == TOK_EOF) {
+        comp_error(l->loc, "Unexpected end of file: Was expecting the closing of the function parameters declaration but got EOF");
+      } else {
+        comp_errorf(l->loc, "Expected `,` or `)` after parameter name but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
       }
-      if (tok.kind == TOK_SYMBOL) {
-        lexer_next_token(l);
-        if (!sv_eq_str(tok.sv, ")")) {
-          comp_errorf(l->loc, "Unexpected token expected closing parenthesis `)` but got %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
-          return false;
-        }
-      } else if (tok.kind == TOK_IDENT || tok.kind == TOK_INT) {
-        AST_NodeList params = {0};
-        AST_NodeList p_expr = {0};
-        AST_Node p_node = {
-          .loc = l->loc,
-          .kind = AST_NK_TOKEN,
-        };
-        p_node.as.token = tok;
-        if (!ast_create_expr(l, &p_expr)) {
-          comp_error(l->loc, "Failed to parse function call argument");
-          return false;
-        }
-        if (p_expr.count == 1) {
-          p_node = p_expr.items[0];
-        } else {
-          p_node.kind = AST_NK_EXPR;
-          p_node.loc = peeker.loc;
-          p_node.as.expr = p_expr;
-        }
-        nob_da_append(&params, p_node);
+      return false;
+    }
+    if (sv_eq_str(tok.sv, ")")) return true;
+  }
+}
 
-        Token peeked = {0};
-        if (!next_token(&peeker, &peeked)) {
-          comp_error(peeker.loc, "Unexpected End of File unfinished function call");
-          comp_note(l->loc, "After first parameter expected closing parenthesis `)` or more arguments");
-          return false;
-        }
-        if (peeked.kind == TOK_SYMBOL && sv_eq_str(peeked.sv, ",")) {
-          lexer_next_token(l);
-          while (true) {
-            p_expr.count = 0;
-            lexer_next_token(&peeker);
-            if (!ast_create_expr(l, &p_expr)) {
-              comp_error(l->loc, "Failed to parse function call argument");
-              return false;
-            }
-            if (p_expr.count == 1) {
-              p_node = p_expr.items[0];
-            } else {
-              p_node.kind = AST_NK_EXPR;
-              p_node.loc = peeker.loc;
-              p_node.as.expr = p_expr;
-            }
-            nob_da_append(&params, p_node);
-            peeker = *l;
-            if (!next_token(&peeker, &peeked)) {
-              comp_error(l->loc, "Unexpected End of File unfinished function call");
-              return false;
-            }
-            if (!sv_eq_str(peeked.sv, ",")) {
-              break;
-            }
-            lexer_next_token(l);
-          }
-        }
-        node.as.fn_call.params = params;
+bool ast_expect_end_of_statement(Lexer *l) {
+  Token tok = {0};
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, SEMICOLON)) {
+    if (tok.kind == TOK_EOF) {
+      comp_errorf(l->loc, "Expected semicolon for end of statement but found %s", token_kind_name(tok.kind));
+    } else {
+      comp_errorf(l->loc, "Expected semicolon for end of statement but found %s "SV_Fmt, token_kind_name(tok.kind), SV_Arg(tok.sv));
+    }
+    return false;
+  }
+  return true;
+}
 
-        if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, ")")) {
-          if (tok.kind == TOK_EOF) {
-            comp_error(l->loc, "Unexpected End of File unfinished function call");
-          } else {
-            comp_errorf(l->loc, "Unexpected token expected closing parenthesis `)` but got %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
-          }
-          return false;
-        }
-      }
-      if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, SEMICOLON)) {
-        if (tok.kind == TOK_EOF) {
-          comp_errorf(l->loc, "Expected semicolon for end of statement but found %s", token_kind_name(tok.kind));
-        } else {
-          comp_errorf(l->loc, "Expected semicolon for end of statement but found %s "SV_Fmt, token_kind_name(tok.kind), SV_Arg(tok.sv));
-        }
+bool ast_create_statement(Lexer *l, AST_NodeList *body);
+bool ast_create_fn_decl(Lexer *l, AST_Node *node, StringViews attrs, bool async);
+
+// Whether the expressions of the statement wait on something for the function they are in
+bool ast_awaits(AST_Node *node) {
+  if (node->kind == AST_NK_AWAIT) return true;
+  if (node->kind == AST_NK_FN_DECL) return false;
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (ast_awaits(it)) return true;
+    }
+  }
+  return false;
+}
+
+// Consumes the `fn` that has to follow an already consumed `async`
+bool ast_expect_fn_after_async(Lexer *l) {
+  Token tok = {0};
+  if (!expect_next_token_eq_str(l, &tok, TOK_IDENT, KEYWORD_FN)) {
+    comp_errorf(l->loc, "Expected `fn` after `async` but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  return true;
+}
+
+// Whether the statement yields for the function it is in, the ones of nested functions belong to them
+bool ast_yields(AST_Node *node) {
+  if (node->kind == AST_NK_YIELD) return true;
+  if (node->kind == AST_NK_FN_DECL) return false;
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (ast_yields(it)) return true;
+    }
+  }
+  return false;
+}
+
+// Parses statements after an already consumed `{` up to and including the matching `}`
+bool ast_create_statement_list(Lexer *l, AST_NodeList *body, Loc open_loc) {
+  Token tok = {0};
+  while (peek_token(*l, &tok) && !(tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "}"))) {
+    if (!ast_create_statement(l, body)) return false;
+  }
+  if (!sv_eq_str(tok.sv, "}")) {
+    comp_error(l->loc, "Expected '}' to close the block but found end of file instead");
+    comp_note(open_loc, "Block opened here");
+    return false;
+  }
+  lexer_next_token(l);
+  return true;
+}
+
+// Body of an if or else, either a single statement or a list of them between braces
+bool ast_create_branch(Lexer *l, AST_NodeList *body) {
+  Token tok = {0};
+  if (peek_token(*l, &tok) && tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "{")) {
+    lexer_next_token(l);
+    return ast_create_statement_list(l, body, l->loc);
+  }
+  return ast_create_statement(l, body);
+}
+
+bool ast_create_if(Lexer *l, AST_Node *node) {
+  Token tok = {0};
+  next_token(l, &tok);
+  node->loc = l->loc;
+  node->kind = AST_NK_IF;
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "(")) {
+    comp_errorf(l->loc, "Expected `(` after `if` but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  if (!ast_create_expr(l, &node->as.if_stmt.cond)) {
+    comp_note(node->loc, "Invalid condition for if statement");
+    return false;
+  }
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, ")")) {
+    comp_errorf(l->loc, "Expected `)` to close the if condition but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  if (!ast_create_branch(l, &node->as.if_stmt.then_body)) return false;
+  if (peek_token(*l, &tok) && tok.kind == TOK_IDENT && sv_eq_str(tok.sv, KEYWORD_ELSE)) {
+    lexer_next_token(l);
+    if (!ast_create_branch(l, &node->as.if_stmt.else_body)) return false;
+  }
+  return true;
+}
+
+bool ast_create_while(Lexer *l, AST_Node *node) {
+  Token tok = {0};
+  next_token(l, &tok);
+  node->loc = l->loc;
+  node->kind = AST_NK_WHILE;
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "(")) {
+    comp_errorf(l->loc, "Expected `(` after `while` but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  if (!ast_create_expr(l, &node->as.while_loop.cond)) {
+    comp_note(node->loc, "Invalid condition for while loop");
+    return false;
+  }
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, ")")) {
+    comp_errorf(l->loc, "Expected `)` to close the while condition but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  return ast_create_branch(l, &node->as.while_loop.body);
+}
+
+bool ast_create_for(Lexer *l, AST_Node *node) {
+  Token tok = {0};
+  next_token(l, &tok);
+  node->loc = l->loc;
+  node->kind = AST_NK_FOR;
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "(")) {
+    comp_errorf(l->loc, "Expected `(` after `for` but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  if (!expect_next_token_kind(l, &tok, TOK_IDENT)) {
+    comp_errorf(l->loc, "Expected name for the loop variable but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  node->as.for_loop.name = tok.sv;
+  if (!expect_next_token_eq_str(l, &tok, TOK_IDENT, KEYWORD_IN)) {
+    comp_errorf(l->loc, "Expected `in` after the loop variable but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  if (!ast_create_expr(l, &node->as.for_loop.iter)) {
+    comp_note(node->loc, "Invalid value to iterate over in for loop");
+    return false;
+  }
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, ")")) {
+    comp_errorf(l->loc, "Expected `)` to close the for loop header but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  return ast_create_branch(l, &node->as.for_loop.body);
+}
+
+bool ast_create_statement(Lexer *l, AST_NodeList *body) {
+  Token tok = {0};
+  if (!peek_token(*l, &tok)) {
+    comp_error(l->loc, "Unexpected End of File created hanging statement");
+    return false;
+  }
+  AST_Node node = { .loc = l->loc };
+
+  if (sv_eq_str(tok.sv, KEYWORD_LET)) {
+    if (!ast_create_var_decl(l, &node)) {
+      return false;
+    }
+    nob_da_append(body, node);
+    return true;
+  }
+  if (sv_eq_str(tok.sv, KEYWORD_IF)) {
+    if (!ast_create_if(l, &node)) return false;
+    nob_da_append(body, node);
+    return true;
+  }
+  if (sv_eq_str(tok.sv, KEYWORD_WHILE)) {
+    if (!ast_create_while(l, &node)) return false;
+    nob_da_append(body, node);
+    return true;
+  }
+  if (sv_eq_str(tok.sv, KEYWORD_FOR)) {
+    if (!ast_create_for(l, &node)) return false;
+    nob_da_append(body, node);
+    return true;
+  }
+  if (sv_eq_str(tok.sv, KEYWORD_YIELD)) {
+    next_token(l, &tok);
+    node.loc = l->loc;
+    node.kind = AST_NK_YIELD;
+    if (!ast_create_expr(l, &node.as.yield)) {
+      comp_note(node.loc, "Invalid value for yield statement");
+      return false;
+    }
+    if (!ast_expect_end_of_statement(l)) return false;
+    nob_da_append(body, node);
+    return true;
+  }
+  // Expressions like `[1, 2] |> f;`, `match (x) { ... };` and `await f();` only make sense as statements for what they call
+  if (sv_eq_str(tok.sv, KEYWORD_MATCH) || sv_eq_str(tok.sv, KEYWORD_AWAIT) || (tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "["))) {
+    node.kind = AST_NK_EXPR;
+    if (!ast_create_expr(l, &node.as.expr)) return false;
+    if (!ast_expect_end_of_statement(l)) return false;
+    nob_da_append(body, node);
+    return true;
+  }
+  if (sv_eq_str(tok.sv, KEYWORD_FN) || sv_eq_str(tok.sv, KEYWORD_ASYNC)) {
+    // Nested function, it can use the variables of the functions around it
+    next_token(l, &tok);
+    node.loc = l->loc;
+    bool async = sv_eq_str(tok.sv, KEYWORD_ASYNC);
+    if (async && !ast_expect_fn_after_async(l)) return false;
+    if (!ast_create_fn_decl(l, &node, (StringViews) {0}, async)) return false;
+    nob_da_append(body, node);
+    return true;
+  }
+  if (sv_eq_str(tok.sv, KEYWORD_RETURN)) {
+    next_token(l, &tok);
+    node.loc = l->loc;
+    node.kind = AST_NK_RETURN;
+    if (!peek_token(*l, &tok) || !(tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, SEMICOLON))) {
+      if (!ast_create_expr(l, &node.as.ret)) {
+        comp_note(node.loc, "Invalid value for return statement");
         return false;
       }
-      nob_da_append(body, node);
-      continue;
     }
+    if (!ast_expect_end_of_statement(l)) return false;
+    nob_da_append(body, node);
+    return true;
+  }
+  if (tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, OPEN_BRACE)) {
+    next_token(l, &tok);
+    node.loc = l->loc;
+    node.kind = AST_NK_BLOCK;
+    if (!ast_create_statement_list(l, &node.as.block, node.loc)) return false;
+    nob_da_append(body, node);
+    return true;
+  }
+  if (tok.kind != TOK_IDENT) {
     next_token(l, &tok);
+    comp_errorf(l->loc, "Unexpected %s `"SV_Fmt"` expected a statement", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
   }
-  if (!sv_eq_str(tok.sv, "}")) {
-    comp_error(l->loc, "Expected '}' to close the function body but found end of file instead");
+
+  Token after_name = {0};
+  if (peek_token_ahead_by(*l, &after_name, 2) && after_name.kind == TOK_SYMBOL && sv_eq_str(after_name.sv, ":")) {
+    if (!ast_create_var_binding(l, &node, l->loc)) return false;
+    nob_da_append(body, node);
+    return true;
+  }
+  if (after_name.kind == TOK_SYMBOL && sv_eq_str(after_name.sv, "|>")) {
+    node.kind = AST_NK_EXPR;
+    if (!ast_create_expr(l, &node.as.expr)) return false;
+    if (!ast_expect_end_of_statement(l)) return false;
+    nob_da_append(body, node);
+    return true;
+  }
+
+  next_token(l, &tok);
+  node.loc = l->loc;
+  Nob_String_View name = tok.sv;
+  if (!expect_next_token_kind(l, &tok, TOK_SYMBOL)) {
+    if (tok.kind == TOK_EOF) {
+      comp_error(l->loc, "Unexpected End of File created hanging statement");
+    } else {
+      comp_errorf(l->loc, "Unexpected token expected ';' or '()' but got %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    }
     return false;
   }
-  lexer_next_token(l);
+  if (sv_eq_str(tok.sv, EQSIGN)) {
+    if (!ast_create_assignment(l, &node, name)) {
+      return false;
+    }
+    nob_da_append(body, node);
+    return true;
+  }
+  node.kind = AST_NK_FN_CALL;
+  node.as.fn_call.name = name;
+  if (!sv_eq_str(tok.sv, "(")) {
+    comp_errorf(l->loc, "Unexpected token expected ';' or '()' but got `"SV_Fmt"`", SV_Arg(tok.sv));
+    return false;
+  }
+  if (!ast_create_fn_call_args(l, &node.as.fn_call.params)) {
+    return false;
+  }
+  if (peek_token(*l, &tok) && tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "|>")) {
+    AST_Node source = node;
+    if (!ast_create_pipeline(l, &source)) return false;
+    node = (AST_Node) { .loc = source.loc, .kind = AST_NK_EXPR };
+    nob_da_append(&node.as.expr, source);
+  }
+  if (!ast_expect_end_of_statement(l)) return false;
+  nob_da_append(body, node);
+  return true;
+}
+
+bool ast_create_fn_body(Lexer *l, AST_Node *fn_node) {
+  Token tok;
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "{")) {
+    comp_errorf(l->loc, "Expected '{' for declaring function body but found %s", token_kind_name(tok.kind));
+    return false;
+  }
+  if (!ast_create_statement_list(l, &fn_node->as.fn_decl.body, l->loc)) return false;
   da_compact(&fn_node->as.fn_decl.body);
   return true;
 }
 
-bool ast_chomp(Lexer *l, AST_Node *node) {
+// Name, parameters and body of a function whose `fn` keyword was already consumed
+bool ast_create_fn_decl(Lexer *l, AST_Node *node, StringViews attrs, bool async) {
   Token tok;
-  // EOF when not expecting anything isn't an error
-  if (!next_token(l, &tok)) {
+  if (!expect_next_token_kind(l, &tok, TOK_IDENT)) {
     node->kind = AST_NK_EOF;
-    return true;
+    comp_errorf(l->loc, "Expected identifier for function name but found %s", token_kind_name(tok.kind));
+    return false;
   }
-  if (sv_eq_str(tok.sv, KEYWORD_FN)) {
-    node->loc = l->loc;
-    if (!expect_next_token_kind(l, &tok, TOK_IDENT)) {
-      node->kind = AST_NK_EOF;
-      comp_errorf(l->loc, "Expected identifier for function name but found %s", token_kind_name(tok.kind));
+  node->loc = l->loc;
+  node->kind = AST_NK_FN_DECL;
+  node->as.fn_decl.name = tok.sv;
+  node->as.fn_decl.attrs = attrs;
+  node->as.fn_decl.async = async;
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "(")) {
+    comp_error(l->loc, "Unexpected end of file: Was expecting the continuation to a function declaration but got EOF");
+    return false;
+  }
+  AST_NodeList params = {0};
+  if (!ast_create_fn_params_decl(l, &params)) {
+    return false;
+  }
+  node->as.fn_decl.params = params;
+
+  AST_NodeList body = {0};
+  node->as.fn_decl.body = body;
+  if (!ast_create_fn_body(l, node)) {
+    return false;
+  }
+  nob_da_foreach(AST_Node, it, &node->as.fn_decl.body) {
+    if (ast_yields(it)) node->as.fn_decl.generator = true;
+  }
+  if (node->as.fn_decl.generator && sv_eq_str(node->as.fn_decl.name, "main")) {
+    comp_error(node->loc, "`main` can't `yield`, nothing would run it");
+    return false;
+  }
+  if (node->as.fn_decl.generator && async) {
+    comp_errorf(node->loc, "`async fn "SV_Fmt"` can't `yield`", SV_Arg(node->as.fn_decl.name));
+    return false;
+  }
+  nob_da_foreach(AST_Node, it, &node->as.fn_decl.body) {
+    if (async || !ast_awaits(it)) continue;
+    comp_errorf(it->loc, "`await` can only be used inside of an `async fn`, `"SV_Fmt"` isn't one", SV_Arg(node->as.fn_decl.name));
+    return false;
+  }
+  return true;
+}
+
+// Parse the name of an attribute after its `@`, what it's applied to gets checked once the declaration is found
+bool ast_create_attribute(Lexer *l, StringViews *attrs) {
+  Token tok;
+  if (!expect_next_token_kind(l, &tok, TOK_IDENT)) {
+    comp_errorf(l->loc, "Expected attribute name after `@` but found %s", token_kind_name(tok.kind));
+    return false;
+  }
+  bool known = false;
+  carray_foreach(const char*, attr, FN_ATTRIBUTES) {
+    if (sv_eq_str(tok.sv, *attr)) known = true;
+  }
+  carray_foreach(const char*, attr, STRUCT_ATTRIBUTES) {
+    if (sv_eq_str(tok.sv, *attr)) known = true;
+  }
+  if (!known) {
+    comp_errorf(l->loc, "Unknown attribute `@"SV_Fmt"`", SV_Arg(tok.sv));
+    return false;
+  }
+  nob_da_append(attrs, tok.sv);
+  return true;
+}
+
+#define ast_attrs_are_within(attrs, allowed, bad) ast_attrs_are_within_(attrs, allowed, NOB_ARRAY_LEN(allowed), bad)
+bool ast_attrs_are_within_(StringViews *attrs, const char **allowed, size_t allowed_count, Nob_String_View *bad) {
+  nob_da_foreach(Nob_String_View, attr, attrs) {
+    bool found = false;
+    for (size_t i = 0; i < allowed_count; ++i) {
+      if (sv_eq_str(*attr, allowed[i])) found = true;
+    }
+    if (found) continue;
+    *bad = *attr;
+    return false;
+  }
+  return true;
+}
+
+// Parses `struct Name { a, b }` after its already consumed `struct` keyword
+bool ast_create_struct_decl(Lexer *l, AST_Node *node, StringViews attrs) {
+  Token tok = {0};
+  node->kind = AST_NK_STRUCT_DECL;
+  node->as.struct_decl.attrs = attrs;
+  if (!expect_next_token_kind(l, &tok, TOK_IDENT)) {
+    comp_errorf(l->loc, "Expected identifier for struct name but found %s", token_kind_name(tok.kind));
+    return false;
+  }
+  node->loc = l->loc;
+  node->as.struct_decl.name = tok.sv;
+  if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "{")) {
+    comp_errorf(l->loc, "Expected `{` to list the fields of the struct but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+    return false;
+  }
+  StringViews *fields = &node->as.struct_decl.fields;
+  while (true) {
+    if (!next_token(l, &tok)) {
+      comp_error(l->loc, "Unexpected end of file: Missing `}` to close struct declaration");
+      comp_note(node->loc, "Struct declared here");
       return false;
     }
-    node->loc = l->loc;
-    node->kind = AST_NK_FN_DECL;
-    node->as.fn_decl.name = tok.sv;
-    if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, "(")) {
-      comp_error(l->loc, "Unexpected end of file: Was expecting the continuation to a function declaration but got EOF");
+    if (tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "}")) return true;
+    if (tok.kind != TOK_IDENT) {
+      comp_errorf(l->loc, "Expected field name but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
       return false;
     }
-    // TODO: Add function parameters
-    AST_NodeList params = {0};
-    node->as.fn_decl.params = params;
-  
-    if (!expect_next_token_eq_str(l, &tok, TOK_SYMBOL, ")")) {
-      comp_error(l->loc, "Unexpected end of file: Was expecting the closing of the function parameters declaration but got EOF");
+    nob_da_foreach(Nob_String_View, field, fields) {
+      if (!nob_sv_eq(*field, tok.sv)) continue;
+      comp_errorf(l->loc, "Field `"SV_Fmt"` is declared twice", SV_Arg(tok.sv));
       return false;
     }
+    nob_da_append(fields, tok.sv);
+    if (!expect_next_token_kind(l, &tok, TOK_SYMBOL) || (!sv_eq_str(tok.sv, ",") && !sv_eq_str(tok.sv, "}"))) {
+      comp_errorf(l->loc, "Expected `,` or `}` after struct field but found %s `"SV_Fmt"`", token_kind_name(tok.kind), SV_Arg(tok.sv));
+      return false;
+    }
+    if (sv_eq_str(tok.sv, "}")) return true;
+  }
+}
 
-    AST_NodeList body = {0};
-    node->as.fn_decl.body = body;
-    if (!ast_create_fn_body(l, node)) {
+bool ast_chomp(Lexer *l, AST_Node *node) {
+  Token tok;
+  Lexer before = *l;
+  // EOF when not expecting anything isn't an error
+  if (!next_token(l, &tok)) {
+    node->kind = AST_NK_EOF;
+    return true;
+  }
+  StringViews attrs = {0};
+  while (tok.kind == TOK_SYMBOL && sv_eq_str(tok.sv, "@")) {
+    if (!ast_create_attribute(l, &attrs)) return false;
+    if (!next_token(l, &tok)) {
+      comp_error(l->loc, "Unexpected end of file: Attributes must be followed by a function or struct declaration");
+      return false;
+    }
+  }
+  bool async = sv_eq_str(tok.sv, KEYWORD_ASYNC);
+  if (attrs.count > 0 && !async && !sv_eq_str(tok.sv, KEYWORD_FN) && !sv_eq_str(tok.sv, KEYWORD_STRUCT)) {
+    comp_errorf(l->loc, "Attributes can only be applied to function and struct declarations but found `"SV_Fmt"`", SV_Arg(tok.sv));
+    safe_da_free(attrs);
+    return false;
+  }
+  Nob_String_View bad = {0};
+  bool is_struct = sv_eq_str(tok.sv, KEYWORD_STRUCT);
+  if (is_struct ? !ast_attrs_are_within(&attrs, STRUCT_ATTRIBUTES, &bad) : !ast_attrs_are_within(&attrs, FN_ATTRIBUTES, &bad)) {
+    comp_errorf(l->loc, "Attribute `@"SV_Fmt"` can't be applied to a %s declaration", SV_Arg(bad), is_struct ? "struct" : "function");
+    safe_da_free(attrs);
+    return false;
+  }
+  if (is_struct) {
+    node->loc = l->loc;
+    return ast_create_struct_decl(l, node, attrs);
+  }
+  if (sv_eq_str(tok.sv, KEYWORD_LET)) {
+    // Variable declaration parsing expects to consume the keyword by itself
+    *l = before;
+    node->loc = l->loc;
+    if (!ast_create_var_decl(l, node)) return false;
+    if (ast_awaits(node)) {
+      comp_errorf(node->loc, "`await` can only be used inside of an `async fn`, not to initialize the global `"SV_Fmt"`", SV_Arg(node->as.var_decl.name));
       return false;
     }
     return true;
   }
+  if (async && !ast_expect_fn_after_async(l)) return false;
+  if (async || sv_eq_str(tok.sv, KEYWORD_FN)) {
+    node->loc = l->loc;
+    return ast_create_fn_decl(l, node, attrs, async);
+  }
   if (sv_eq_str(tok.sv, KEYWORD_IMPORT)) {
     AST_Import import = {0};
     Loc init_loc = l->loc;
@@ -642,7 +2029,7 @@ bool ast_chomp(Lexer *l, AST_Node *node) {
     }
     Nob_String_View name = nob_sb_to_sv(sb);
     if (nob_sv_end_with(name, ":")) {
-      comp_errorf(last_colon, "Import name cannot end with a ':' did you miss to type something?");
+      comp_error(last_colon, "Import name cannot end with a ':' did you miss to type something?");
       return false;
     }
     import.name = name;
@@ -654,5 +2041,76 @@ bool ast_chomp(Lexer *l, AST_Node *node) {
   return false;
 }
 
+AST_Node *ast_find_struct(AST_NodeList *module, Nob_String_View name) {
+  nob_da_foreach(AST_Node, it, module) {
+    if (it->kind == AST_NK_STRUCT_DECL && nob_sv_eq(it->as.struct_decl.name, name)) return it;
+  }
+  return NULL;
+}
+
+// Calls named after a struct construct it, fields read anywhere must belong to some struct
+bool ast_resolve_struct_uses(AST_NodeList *module, AST_Node *node) {
+  if (node->kind == AST_NK_FN_CALL) {
+    AST_Node *decl = ast_find_struct(module, node->as.fn_call.name);
+    if (decl != NULL) {
+      size_t fields = decl->as.struct_decl.fields.count;
+      if (node->as.fn_call.params.count != fields) {
+        comp_errorf(node->loc, "Struct `"SV_Fmt"` has %zu fields but %zu values were given to build it", SV_Arg(decl->as.struct_decl.name), fields, node->as.fn_call.params.count);
+        comp_note(decl->loc, "Struct declared here");
+        return false;
+      }
+      node->as.fn_call.constructs = true;
+    }
+  }
+  if (node->kind == AST_NK_FIELD) {
+    bool known = false;
+    nob_da_foreach(AST_Node, it, module) {
+      if (it->kind != AST_NK_STRUCT_DECL) continue;
+      nob_da_foreach(Nob_String_View, field, &it->as.struct_decl.fields) {
+        if (nob_sv_eq(*field, node->as.field.name)) known = true;
+      }
+    }
+    if (!known) {
+      comp_errorf(node->loc, "No struct has a field named `"SV_Fmt"`", SV_Arg(node->as.field.name));
+      return false;
+    }
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (!ast_resolve_struct_uses(module, it)) return false;
+    }
+  }
+  return true;
+}
+
+bool ast_chomp_module(Lexer *l, AST_NodeList *module) {
+  while (true) {
+    AST_Node node = {0};
+    if (!ast_chomp(l, &node)) {
+      nob_log(NOB_INFO, "Errored on ast node %s", ast_node_kind_name(node.kind));
+      return false;
+    }
+    if (node.kind == AST_NK_EOF) break;
+    nob_da_append(module, node);
+  }
+  // Structs can be used before their declaration so calls are only told apart from constructors at the end
+  nob_da_foreach(AST_Node, it, module) {
+    if (it->kind != AST_NK_STRUCT_DECL) continue;
+    nob_da_foreach(AST_Node, other, module) {
+      Nob_String_View name = other->kind == AST_NK_STRUCT_DECL ? other->as.struct_decl.name : other->kind == AST_NK_FN_DECL ? other->as.fn_decl.name : SVl(NULL, 0);
+      if (other == it || !nob_sv_eq(name, it->as.struct_decl.name)) continue;
+      comp_errorf(other->loc, "`"SV_Fmt"` is already declared as a struct", SV_Arg(name));
+      comp_note(it->loc, "Struct declared here");
+      return false;
+    }
+  }
+  nob_da_foreach(AST_Node, it, module) {
+    if (!ast_resolve_struct_uses(module, it)) return false;
+  }
+  return true;
+}
+
 #endif // DWOC_AST_IMPLEMENTATION
 
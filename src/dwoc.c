@@ -20,6 +20,18 @@
 #include "ast.h"
 #undef DWOC_AST_IMPLEMENTATION
 
+#define DWOC_INTERPRETER_IMPLEMENTATION
+#include "interpreter.h"
+#undef DWOC_INTERPRETER_IMPLEMENTATION
+
+#define DWOC_OPTIMIZER_IMPLEMENTATION
+#include "optimizer.h"
+#undef DWOC_OPTIMIZER_IMPLEMENTATION
+
+#define DWOC_PASSES_IMPLEMENTATION
+#include "passes.h"
+#undef DWOC_PASSES_IMPLEMENTATION
+
 #define DWOC_JS_IMPLEMENTATION
 #include "javascript.h"
 
@@ -41,6 +53,22 @@ void usage(const char* program) {
   printf("Usage: %s [OPTIONS] <input.dwo>\n", program);
   printf("  -o <output-name>    ----  Specify output file name\n");
   printf("  -t <js|ir>          ----  Specify output target\n");
+  printf("  -O<0|1|2|s>         ----  Optimization level, defaults to -O1, -Os leaves out the passes that grow the output\n");
+  printf("  --inline-budget <n> ----  Max size of a function body to be inlined, overrides the one set by -O\n");
+  printf("  --report-inline     ----  Print a note for every inlined call\n");
+  printf("  --ctfe-steps <n>    ----  Max steps to evaluate a constant expression at compile time, 0 disables it, overrides the one set by -O\n");
+  printf("  --report-hoist      ----  Print a note for every expression reused or hoisted out of a loop at -O2\n");
+  printf("  --pass-stats        ----  Print the time every pass and analysis took and the amount of nodes each pass changed\n");
+  printf("  --native-generators ----  Emit generators as JavaScript generator functions instead of state machines, the default with -Os\n");
+  printf("  --source-map        ----  Write a source map of the JavaScript to <output>.js.map\n");
+  printf("  --source-map-url    ----  Same as --source-map and also end the JavaScript with a `sourceMappingURL` comment\n");
+  printf("  --esm               ----  Emit an ES module, <output>.mjs, importing the runtime from a dwoc_runtime.mjs written next to it\n");
+  printf("  --minify            ----  Emit JavaScript without whitespace and with short names for locals and the runtime, the default with -Os\n");
+  printf("  --disable-pass <n>  ----  Skip a pass or analysis, can be given multiple times. Passes:");
+  for (size_t i = 0; i < javascript_pipeline_count; ++i) {
+    if (!javascript_pipeline[i].required) printf(" %s", javascript_pipeline[i].name);
+  }
+  printf(", analyses: purity tail-calls memoize dispatch\n");
 }
 
 int main(int argc, char **argv) {
@@ -54,6 +82,9 @@ int main(int argc, char **argv) {
   char *input_path = NULL;
   char *output_name = "out";
   OutputTarget output_target = OT_JavaScript;
+  Options opts = { .opt_level = 1 };
+  bool inline_budget_given = false;
+  bool ctfe_steps_given = false;
   while (argc > 0) {
     char *flag = nob_shift(argv, argc);
     if (strcmp(flag, "-o") == 0) {
@@ -83,6 +114,104 @@ int main(int argc, char **argv) {
       }
       continue;
     }
+    if (strcmp(flag, "-O0") == 0 || strcmp(flag, "-O1") == 0 || strcmp(flag, "-O2") == 0) {
+      opts.opt_level = flag[2] - '0';
+      opts.optimize_size = false;
+      continue;
+    }
+    if (strcmp(flag, "-Os") == 0) {
+      opts.opt_level = 2;
+      opts.optimize_size = true;
+      continue;
+    }
+    if (strcmp(flag, "--inline-budget") == 0) {
+      if (argc == 0) {
+        nob_log(NOB_ERROR, "Missing budget for inlining");
+        usage(program);
+        return 1;
+      }
+      char *budget = nob_shift(argv, argc);
+      char *end = NULL;
+      long value = strtol(budget, &end, 10);
+      if (*budget == 0 || *end != 0 || value < 0) {
+        nob_log(NOB_ERROR, "Invalid inline budget %s, expected a non negative integer", budget);
+        usage(program);
+        return 1;
+      }
+      opts.inline_budget = (size_t)value;
+      inline_budget_given = true;
+      continue;
+    }
+    if (strcmp(flag, "--ctfe-steps") == 0) {
+      if (argc == 0) {
+        nob_log(NOB_ERROR, "Missing amount of steps for compile time evaluation");
+        usage(program);
+        return 1;
+      }
+      char *steps = nob_shift(argv, argc);
+      char *end = NULL;
+      long value = strtol(steps, &end, 10);
+      if (*steps == 0 || *end != 0 || value < 0) {
+        nob_log(NOB_ERROR, "Invalid amount of compile time evaluation steps %s, expected a non negative integer", steps);
+        usage(program);
+        return 1;
+      }
+      opts.ctfe_steps = (size_t)value;
+      ctfe_steps_given = true;
+      continue;
+    }
+    if (strcmp(flag, "--report-inline") == 0) {
+      opts.report_inline = true;
+      continue;
+    }
+    if (strcmp(flag, "--report-hoist") == 0) {
+      opts.report_hoist = true;
+      continue;
+    }
+    if (strcmp(flag, "--native-generators") == 0) {
+      opts.native_generators = true;
+      continue;
+    }
+    if (strcmp(flag, "--esm") == 0) {
+      opts.esm = true;
+      continue;
+    }
+    if (strcmp(flag, "--minify") == 0) {
+      opts.minify = true;
+      continue;
+    }
+    if (strcmp(flag, "--source-map") == 0) {
+      opts.source_map = true;
+      continue;
+    }
+    if (strcmp(flag, "--source-map-url") == 0) {
+      opts.source_map = true;
+      opts.source_map_url = true;
+      continue;
+    }
+    if (strcmp(flag, "--pass-stats") == 0) {
+      opts.pass_stats = true;
+      continue;
+    }
+    if (strcmp(flag, "--disable-pass") == 0) {
+      if (argc == 0) {
+        nob_log(NOB_ERROR, "Missing name of the pass to disable");
+        usage(program);
+        return 1;
+      }
+      char *name = nob_shift(argv, argc);
+      if (!pass_manager_knows(javascript_pipeline, javascript_pipeline_count, name)) {
+        nob_log(NOB_ERROR, "Unknown pass %s", name);
+        usage(program);
+        return 1;
+      }
+      if (pass_manager_is_required(javascript_pipeline, javascript_pipeline_count, name)) {
+        nob_log(NOB_ERROR, "Pass %s can't be disabled, the output isn't correct without it", name);
+        return 1;
+      }
+      nob_da_append(&opts.disabled_passes, name);
+      continue;
+    }
     if (flag[0] == '-') {
       nob_log(NOB_ERROR, "Unknown flag %s", flag);
       usage(program);
@@ -90,49 +219,28 @@ int main(int argc, char **argv) {
     }
     input_path = flag;
   }
+  if (!inline_budget_given) opts.inline_budget = optimizer_inline_budget_for_level(opts.opt_level);
+  if (!ctfe_steps_given) opts.ctfe_steps = optimizer_ctfe_steps_for_level(opts.opt_level);
+  if (opts.optimize_size) {
+    opts.native_generators = true;
+    opts.minify = true;
+  }
   Nob_String_Builder output_path_sb = {0};
   nob_sb_append_cstr(&output_path_sb, output_name);
 
-  Nob_String_Builder sb = {0};
-  if (!nob_read_entire_file(input_path, &sb)) return 1;
-  // printf("Read %zu bytes from file %s\n", sb.count, input_path);
-  Nob_String_Builder out = {0};
-
-  Context ctx = {
-    .source_path = input_path,
-    .lex = lexer_from(input_path, sb.items, sb.count),
-  };
-
   if (output_target == OT_IR) {
     if (!nob_sv_end_with(nob_sb_to_sv(output_path_sb), ".ir")) {
       nob_sb_append_cstr(&output_path_sb, ".ir");
     }
-    AST_Node node = {0};
-    while (true) {
-      if (!ast_chomp(&ctx.lex, &node)) return 1;
-      AST_Node_Kind nk = node.kind;
-      if (nk != AST_NK_EOF) ast_dump_node(&out, node);
-      if (nk == AST_NK_FN_DECL && sv_eq_str(node.as.fn_decl.name, "main")) {
-        ctx.main_is_defined = true;
-      }
-      memzero(&node);
-      nob_da_append(&out, '\n');
-      if (nk == AST_NK_EOF) {
-        break;
-      }
+  } else if (output_target == OT_JavaScript && opts.esm) {
+    if (!nob_sv_end_with(nob_sb_to_sv(output_path_sb), ".mjs")) {
+      if (nob_sv_end_with(nob_sb_to_sv(output_path_sb), ".js")) output_path_sb.count -= strlen(".js");
+      nob_sb_append_cstr(&output_path_sb, ".mjs");
     }
   } else if (output_target == OT_JavaScript) {
     if (!nob_sv_end_with(nob_sb_to_sv(output_path_sb), ".js")) {
       nob_sb_append_cstr(&output_path_sb, ".js");
     }
-    javascript_compilation_prologue(&out);
-    if (!javascript_run_compilation(&out, &ctx)) {
-      nob_log(NOB_INFO, "Wrote onto buffer %zu bytes", out.count);
-      // Nob_String_View out_sv = nob_sb_to_sv(out);
-      // nob_log(NOB_INFO, SV_Fmt, SV_Arg(out_sv));
-      return 1;
-    }
-    javascript_compilation_epilogue(&out, &ctx);
   } else {
     nob_log(NOB_ERROR, "Unsupported target");
     return 1;
@@ -190,7 +298,86 @@ int main(int argc, char **argv) {
   const char *output_path = output_path_sb.items;
   // nob_log(NOB_INFO, "Crafted output path: `%s`", output_path);
 
-  if (!nob_write_entire_file(output_path, out.items, out.count)) return 1;
+  Nob_String_Builder sb = {0};
+  if (!nob_read_entire_file(input_path, &sb)) return 1;
+  // printf("Read %zu bytes from file %s\n", sb.count, input_path);
+  // Big enough to not be worth putting on the stack
+  static Output_Sink out = {0};
+  if (!output_sink_open(&out, output_path)) return 1;
+
+  Context ctx = {
+    .source_path = input_path,
+    .lex = lexer_from(input_path, sb.items, sb.count),
+    .opts = opts,
+  };
+
+  if (output_target == OT_IR) {
+    Nob_String_Builder dump = {0};
+    AST_Node node = {0};
+    while (true) {
+      if (!ast_chomp(&ctx.lex, &node)) {
+        output_sink_discard(&out);
+        return 1;
+      }
+      AST_Node_Kind nk = node.kind;
+      if (nk != AST_NK_EOF) ast_dump_node(&dump, node);
+      if (nk == AST_NK_FN_DECL && sv_eq_str(node.as.fn_decl.name, "main")) {
+        ctx.main_is_defined = true;
+      }
+      memzero(&node);
+      nob_da_append(&dump, '\n');
+      if (!output_sink_drain(&out, &dump)) {
+        output_sink_discard(&out);
+        return 1;
+      }
+      if (nk == AST_NK_EOF) {
+        break;
+      }
+    }
+    safe_da_free(dump);
+  } else {
+    if (!ast_chomp_module(&ctx.lex, &ctx.module)) {
+      output_sink_discard(&out);
+      return 1;
+    }
+    Pass_Manager pm = {0};
+    pass_manager_init(&pm, &ctx.module, &ctx.opts);
+    pass_manager_run(&pm, javascript_pipeline, javascript_pipeline_count);
+    static Output_Sink map_out = {0};
+    if (ctx.opts.source_map) {
+      const char *map_path = nob_temp_sprintf("%s.map", output_path);
+      if (!output_sink_open(&map_out, map_path) || !javascript_source_map_open(&map_out, output_path, input_path)) {
+        output_sink_discard(&map_out);
+        output_sink_discard(&out);
+        return 1;
+      }
+    }
+    javascript_compilation_prologue(&out, &ctx);
+    bool compiled = javascript_run_compilation(&out, &ctx, &pm);
+    if (ctx.opts.pass_stats) pass_manager_print_stats(&pm);
+    pass_manager_free(&pm);
+    if (!compiled) {
+      nob_log(NOB_INFO, "Wrote %zu bytes before failing", out.written + out.count);
+      output_sink_discard(&map_out);
+      output_sink_discard(&out);
+      return 1;
+    }
+    javascript_compilation_epilogue(&out, &ctx);
+    if (ctx.opts.esm && !javascript_write_esm_runtime(&ctx, output_path)) {
+      output_sink_discard(&out);
+      return 1;
+    }
+    if (ctx.opts.source_map && (!javascript_source_map_close(&out, &ctx, ctx.opts.source_map_url) || !output_sink_close(&map_out))) {
+      output_sink_discard(&map_out);
+      output_sink_discard(&out);
+      return 1;
+    }
+  }
+
+  if (!output_sink_close(&out)) {
+    output_sink_discard(&out);
+    return 1;
+  }
   nob_log(NOB_INFO, "Succesfully compiled: %s", output_path);
 
   return 0;
@@ -0,0 +1,500 @@
+#ifndef __DWOC_INTERPRETER_H
+#define __DWOC_INTERPRETER_H
+
+#include <math.h>
+#include <stdint.h>
+
+#include "utils.h"
+#include "ast.h"
+
+#ifndef NOB_IMPLEMENTATION
+#  include "nob.h"
+#endif
+
+// Values follow the JavaScript semantics of the emitted code so a folded result prints the same as a computed one
+typedef enum {
+  INTERPRETER_VK_UNDEFINED,
+  INTERPRETER_VK_NUMBER,
+  INTERPRETER_VK_BOOL,
+} Interpreter_Value_Kind;
+
+typedef struct {
+  Interpreter_Value_Kind kind;
+  double number;
+  bool boolean;
+} Interpreter_Value;
+
+typedef struct {
+  // Evaluated nodes before giving up
+  size_t max_steps;
+  // Nested calls before giving up, also keeps the compiler's own stack in check
+  size_t max_depth;
+  // Live variables before giving up, cached call results are dropped once they reach it as well
+  size_t max_slots;
+} Interpreter_Limits;
+
+typedef struct {
+  Nob_String_View name;
+  Interpreter_Value value;
+} Interpreter_Binding;
+
+typedef struct {
+  Interpreter_Binding *items;
+  size_t count;
+  size_t capacity;
+} Interpreter_Bindings;
+
+typedef struct {
+  AST_Node *fn;
+  // Arguments live in Interpreter.memo_args starting at this offset
+  size_t args_at;
+  Interpreter_Value result;
+} Interpreter_MemoEntry;
+
+typedef struct {
+  Interpreter_MemoEntry *items;
+  size_t count;
+  size_t capacity;
+} Interpreter_MemoEntries;
+
+typedef struct {
+  Interpreter_Value *items;
+  size_t count;
+  size_t capacity;
+} Interpreter_Values;
+
+// Sandbox for evaluating dwoc code inside of the compiler
+// It only runs code that can't be told apart from running it later: no I/O, no library calls, no mutable globals
+typedef struct {
+  AST_NodeList *module;
+  Interpreter_Limits limits;
+  size_t steps;
+  size_t depth;
+  // Variables of every active call, each call only sees the ones from its frame start onwards
+  Interpreter_Bindings env;
+  size_t frame;
+  // Immutable globals that were already evaluated
+  Interpreter_Bindings globals;
+  StringViews evaluating_globals;
+  // Results of previous calls, whatever ran in the sandbox only depends on its arguments
+  Interpreter_MemoEntries memo;
+  Interpreter_Values memo_args;
+  size_t *memo_buckets;
+  size_t memo_buckets_count;
+  // Set when a `return` is unwinding the current call
+  bool returning;
+  Interpreter_Value returned;
+  // Why the last evaluation failed
+  const char *error;
+  Loc error_loc;
+} Interpreter;
+
+// Evaluate an expression where only top level declarations are in scope
+// Returns false when the expression can't be evaluated at compile time or it went over the limits, leaving the reason in `error`
+bool interpreter_eval(Interpreter *in, AST_Node *expr, Interpreter_Value *out);
+
+void interpreter_free(Interpreter *in);
+
+#endif // __DWOC_INTERPRETER_H
+
+#ifdef DWOC_INTERPRETER_IMPLEMENTATION
+
+bool interpreter_fail(Interpreter *in, Loc loc, const char *error) {
+  in->error = error;
+  in->error_loc = loc;
+  return false;
+}
+
+bool interpreter_step(Interpreter *in, AST_Node *node) {
+  in->steps++;
+  if (in->steps > in->limits.max_steps) return interpreter_fail(in, node->loc, "step limit reached");
+  return true;
+}
+
+bool interpreter_check_slots(Interpreter *in, Loc loc) {
+  if (in->env.count > in->limits.max_slots) return interpreter_fail(in, loc, "memory limit reached");
+  return true;
+}
+
+Interpreter_Value interpreter_number(double number) {
+  return (Interpreter_Value) { .kind = INTERPRETER_VK_NUMBER, .number = number };
+}
+
+Interpreter_Value interpreter_bool(bool boolean) {
+  return (Interpreter_Value) { .kind = INTERPRETER_VK_BOOL, .boolean = boolean };
+}
+
+double interpreter_to_number(Interpreter_Value value) {
+  switch (value.kind) {
+  case INTERPRETER_VK_NUMBER: return value.number;
+  case INTERPRETER_VK_BOOL: return value.boolean ? 1 : 0;
+  case INTERPRETER_VK_UNDEFINED: return NAN;
+  }
+  NEVER("interpreter_to_number: Unknown value kind");
+}
+
+bool interpreter_truthy(Interpreter_Value value) {
+  switch (value.kind) {
+  case INTERPRETER_VK_NUMBER: return value.number != 0 && !isnan(value.number);
+  case INTERPRETER_VK_BOOL: return value.boolean;
+  case INTERPRETER_VK_UNDEFINED: return false;
+  }
+  NEVER("interpreter_truthy: Unknown value kind");
+}
+
+bool interpreter_strict_equals(Interpreter_Value a, Interpreter_Value b) {
+  if (a.kind != b.kind) return false;
+  switch (a.kind) {
+  case INTERPRETER_VK_NUMBER: return a.number == b.number;
+  case INTERPRETER_VK_BOOL: return a.boolean == b.boolean;
+  case INTERPRETER_VK_UNDEFINED: return true;
+  }
+  NEVER("interpreter_strict_equals: Unknown value kind");
+}
+
+bool interpreter_eval_node(Interpreter *in, AST_Node *node, Interpreter_Value *out);
+
+bool interpreter_eval_list(Interpreter *in, AST_NodeList *expr, Interpreter_Value *out) {
+  if (expr->count != 1) return interpreter_fail(in, in->error_loc, "unsupported expression shape");
+  return interpreter_eval_node(in, &expr->items[0], out);
+}
+
+Interpreter_Binding *interpreter_find_local(Interpreter *in, Nob_String_View name) {
+  // Newest first so inner blocks shadow outer ones
+  for (size_t i = in->env.count; i > in->frame; --i) {
+    if (nob_sv_eq(in->env.items[i - 1].name, name)) return &in->env.items[i - 1];
+  }
+  return NULL;
+}
+
+bool interpreter_eval_global(Interpreter *in, AST_Node *at, Nob_String_View name, Interpreter_Value *out) {
+  nob_da_foreach(Interpreter_Binding, it, &in->globals) {
+    if (!nob_sv_eq(it->name, name)) continue;
+    *out = it->value;
+    return true;
+  }
+  AST_Node *decl = NULL;
+  nob_da_foreach(AST_Node, it, in->module) {
+    if (it->kind == AST_NK_VAR_DECL && nob_sv_eq(it->as.var_decl.name, name)) decl = it;
+  }
+  if (decl == NULL) return interpreter_fail(in, at->loc, "unknown variable");
+  if (decl->as.var_decl.mutable) return interpreter_fail(in, at->loc, "reads a mutable global");
+  nob_da_foreach(Nob_String_View, it, &in->evaluating_globals) {
+    if (nob_sv_eq(*it, name)) return interpreter_fail(in, at->loc, "global depends on itself");
+  }
+
+  // Globals are evaluated with no caller's variables in sight
+  size_t frame = in->frame;
+  in->frame = in->env.count;
+  nob_da_append(&in->evaluating_globals, name);
+  bool ok = interpreter_eval_list(in, &decl->as.var_decl.expr, out);
+  in->evaluating_globals.count--;
+  in->frame = frame;
+  if (!ok) return false;
+
+  Interpreter_Binding binding = { .name = name, .value = *out };
+  nob_da_append(&in->globals, binding);
+  return true;
+}
+
+uint64_t interpreter_hash_call(AST_Node *fn, Interpreter_Value *args, size_t count) {
+  // FNV-1a over the callee and the bytes of every argument
+  uint64_t hash = 14695981039346656037ULL;
+  uintptr_t fn_bits = (uintptr_t)fn;
+  for (size_t i = 0; i < sizeof(fn_bits); ++i) {
+    hash = (hash ^ ((fn_bits >> (i * 8)) & 0xff)) * 1099511628211ULL;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t bits = 0;
+    double number = args[i].kind == INTERPRETER_VK_BOOL ? (args[i].boolean ? 1 : 0) : args[i].number;
+    memcpy(&bits, &number, sizeof(bits));
+    bits ^= (uint64_t)args[i].kind << 60;
+    for (size_t j = 0; j < sizeof(bits); ++j) {
+      hash = (hash ^ ((bits >> (j * 8)) & 0xff)) * 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+bool interpreter_memo_matches(Interpreter *in, Interpreter_MemoEntry *entry, AST_Node *fn, Interpreter_Value *args, size_t count) {
+  if (entry->fn != fn) return false;
+  for (size_t i = 0; i < count; ++i) {
+    if (!interpreter_strict_equals(in->memo_args.items[entry->args_at + i], args[i])) return false;
+  }
+  return true;
+}
+
+// Buckets hold entry index + 1 with 0 marking a free bucket, they are kept at most half full
+Interpreter_MemoEntry *interpreter_memo_find(Interpreter *in, AST_Node *fn, Interpreter_Value *args, size_t count) {
+  if (in->memo_buckets_count == 0) return NULL;
+  size_t mask = in->memo_buckets_count - 1;
+  for (size_t i = interpreter_hash_call(fn, args, count) & mask; in->memo_buckets[i] != 0; i = (i + 1) & mask) {
+    Interpreter_MemoEntry *entry = &in->memo.items[in->memo_buckets[i] - 1];
+    if (interpreter_memo_matches(in, entry, fn, args, count)) return entry;
+  }
+  return NULL;
+}
+
+void interpreter_memo_place(Interpreter *in, size_t index) {
+  Interpreter_MemoEntry *entry = &in->memo.items[index];
+  size_t count = entry->fn->as.fn_decl.params.count;
+  size_t mask = in->memo_buckets_count - 1;
+  size_t i = interpreter_hash_call(entry->fn, in->memo_args.items + entry->args_at, count) & mask;
+  while (in->memo_buckets[i] != 0) i = (i + 1) & mask;
+  in->memo_buckets[i] = index + 1;
+}
+
+void interpreter_memo_insert(Interpreter *in, AST_Node *fn, Interpreter_Value *args, size_t count, Interpreter_Value result) {
+  if (in->memo.count >= in->limits.max_slots) {
+    in->memo.count = 0;
+    in->memo_args.count = 0;
+    memset(in->memo_buckets, 0, in->memo_buckets_count * sizeof(size_t));
+  }
+  Interpreter_MemoEntry entry = {
+    .fn = fn,
+    .args_at = in->memo_args.count,
+    .result = result,
+  };
+  nob_da_append_many(&in->memo_args, args, count);
+  nob_da_append(&in->memo, entry);
+  if (in->memo.count * 2 <= in->memo_buckets_count) {
+    interpreter_memo_place(in, in->memo.count - 1);
+    return;
+  }
+  NOB_FREE(in->memo_buckets);
+  in->memo_buckets_count = in->memo_buckets_count == 0 ? 64 : in->memo_buckets_count * 2;
+  in->memo_buckets = NOB_REALLOC(NULL, in->memo_buckets_count * sizeof(size_t));
+  NOB_ASSERT(in->memo_buckets != NULL && "Buy more RAM lol");
+  memset(in->memo_buckets, 0, in->memo_buckets_count * sizeof(size_t));
+  for (size_t i = 0; i < in->memo.count; ++i) interpreter_memo_place(in, i);
+}
+
+bool interpreter_exec_list(Interpreter *in, AST_NodeList *body);
+
+bool interpreter_eval_call(Interpreter *in, AST_Node *node, Interpreter_Value *out) {
+  AST_Node *fn = NULL;
+  nob_da_foreach(AST_Node, it, in->module) {
+    if (it->kind == AST_NK_FN_DECL && nob_sv_eq(it->as.fn_decl.name, node->as.fn_call.name)) fn = it;
+  }
+  // Anything not declared in the module comes from a library and talks to the outside world
+  if (fn == NULL) return interpreter_fail(in, node->loc, "calls a library function");
+  if (fn->as.fn_decl.generator) return interpreter_fail(in, node->loc, "calls a generator");
+  if (fn->as.fn_decl.async) return interpreter_fail(in, node->loc, "calls an async function");
+  AST_NodeList *params = &fn->as.fn_decl.params;
+  AST_NodeList *args = &node->as.fn_call.params;
+  if (params->count != args->count) return interpreter_fail(in, node->loc, "wrong amount of arguments");
+  if (in->depth >= in->limits.max_depth) return interpreter_fail(in, node->loc, "call depth limit reached");
+
+  Interpreter_Value *arg_values = NOB_REALLOC(NULL, (args->count + 1) * sizeof(Interpreter_Value));
+  NOB_ASSERT(arg_values != NULL && "Buy more RAM lol");
+  nob_da_foreach(AST_Node, arg, args) {
+    if (interpreter_eval_node(in, arg, &arg_values[arg - args->items])) continue;
+    NOB_FREE(arg_values);
+    return false;
+  }
+  Interpreter_MemoEntry *hit = interpreter_memo_find(in, fn, arg_values, args->count);
+  if (hit != NULL) {
+    *out = hit->result;
+    NOB_FREE(arg_values);
+    return true;
+  }
+
+  size_t frame = in->env.count;
+  for (size_t i = 0; i < args->count; ++i) {
+    Interpreter_Binding binding = { .name = params->items[i].as.token.sv, .value = arg_values[i] };
+    nob_da_append(&in->env, binding);
+  }
+  if (!interpreter_check_slots(in, node->loc)) {
+    NOB_FREE(arg_values);
+    return false;
+  }
+
+  size_t caller_frame = in->frame;
+  in->frame = frame;
+  in->depth++;
+  bool ok = interpreter_exec_list(in, &fn->as.fn_decl.body);
+  in->depth--;
+  in->frame = caller_frame;
+  in->env.count = frame;
+  if (ok) {
+    *out = in->returning ? in->returned : (Interpreter_Value) { .kind = INTERPRETER_VK_UNDEFINED };
+    in->returning = false;
+    interpreter_memo_insert(in, fn, arg_values, args->count, *out);
+  }
+  NOB_FREE(arg_values);
+  return ok;
+}
+
+bool interpreter_eval_binop(Interpreter *in, AST_Node *node, Interpreter_Value *out) {
+  Nob_String_View op = node->as.op.op.sv;
+  Interpreter_Value lhs = {0};
+  Interpreter_Value rhs = {0};
+  if (!interpreter_eval_node(in, &node->as.op.operands.items[0], &lhs)) return false;
+  // Logical operators short circuit and give back one of their operands like JavaScript's do
+  if (sv_eq_str(op, "&&") || sv_eq_str(op, "||")) {
+    bool take_lhs = interpreter_truthy(lhs) == sv_eq_str(op, "||");
+    if (take_lhs) {
+      *out = lhs;
+      return true;
+    }
+    return interpreter_eval_node(in, &node->as.op.operands.items[1], out);
+  }
+  if (!interpreter_eval_node(in, &node->as.op.operands.items[1], &rhs)) return false;
+
+  if (sv_eq_str(op, "==")) {
+    *out = interpreter_bool(interpreter_strict_equals(lhs, rhs));
+    return true;
+  }
+  if (sv_eq_str(op, "!=")) {
+    *out = interpreter_bool(!interpreter_strict_equals(lhs, rhs));
+    return true;
+  }
+  double a = interpreter_to_number(lhs);
+  double b = interpreter_to_number(rhs);
+  if (sv_eq_str(op, "+")) *out = interpreter_number(a + b);
+  else if (sv_eq_str(op, "-")) *out = interpreter_number(a - b);
+  else if (sv_eq_str(op, "*")) *out = interpreter_number(a * b);
+  else if (sv_eq_str(op, "/")) *out = interpreter_number(trunc(a / b));
+  else if (sv_eq_str(op, "%")) *out = interpreter_number(fmod(a, b));
+  else if (sv_eq_str(op, "<")) *out = interpreter_bool(a < b);
+  else if (sv_eq_str(op, "<=")) *out = interpreter_bool(a <= b);
+  else if (sv_eq_str(op, ">")) *out = interpreter_bool(a > b);
+  else if (sv_eq_str(op, ">=")) *out = interpreter_bool(a >= b);
+  else return interpreter_fail(in, node->loc, "unsupported operator");
+  return true;
+}
+
+// Strict equality against the patterns like the `switch` it compiles to, `_` is only taken when no pattern matched
+bool interpreter_eval_match(Interpreter *in, AST_Node *node, Interpreter_Value *out) {
+  Interpreter_Value subject = {0};
+  if (!interpreter_eval_list(in, &node->as.match.subject, &subject)) return false;
+  AST_Node *fallback = NULL;
+  nob_da_foreach(AST_Node, arm, &node->as.match.arms) {
+    if (arm->as.match_arm.patterns.count == 0) fallback = arm;
+    nob_da_foreach(AST_Node, pattern, &arm->as.match_arm.patterns) {
+      if (subject.kind == INTERPRETER_VK_NUMBER && subject.number == ast_int_literal_value(pattern)) {
+        return interpreter_eval_list(in, &arm->as.match_arm.value, out);
+      }
+    }
+  }
+  if (fallback != NULL) return interpreter_eval_list(in, &fallback->as.match_arm.value, out);
+  out->kind = INTERPRETER_VK_UNDEFINED;
+  return true;
+}
+
+bool interpreter_eval_node(Interpreter *in, AST_Node *node, Interpreter_Value *out) {
+  if (!interpreter_step(in, node)) return false;
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    if (node->as.token.kind == TOK_INT) {
+      *out = interpreter_number(strtod(nob_temp_sv_to_cstr(node->as.token.sv), NULL));
+      return true;
+    }
+    if (node->as.token.kind == TOK_IDENT) {
+      Interpreter_Binding *local = interpreter_find_local(in, node->as.token.sv);
+      if (local != NULL) {
+        *out = local->value;
+        return true;
+      }
+      return interpreter_eval_global(in, node, node->as.token.sv, out);
+    }
+    return interpreter_fail(in, node->loc, "unsupported literal");
+  case AST_NK_EXPR:
+    return interpreter_eval_list(in, &node->as.expr, out);
+  case AST_NK_UNOP: {
+    Interpreter_Value operand = {0};
+    if (!interpreter_eval_node(in, &node->as.op.operands.items[0], &operand)) return false;
+    if (sv_eq_str(node->as.op.op.sv, "-")) {
+      *out = interpreter_number(-interpreter_to_number(operand));
+    } else {
+      *out = interpreter_bool(!interpreter_truthy(operand));
+    }
+    return true;
+  }
+  case AST_NK_BINOP:
+    return interpreter_eval_binop(in, node, out);
+  case AST_NK_FN_CALL:
+    return interpreter_eval_call(in, node, out);
+  case AST_NK_MATCH:
+    return interpreter_eval_match(in, node, out);
+  default:
+    return interpreter_fail(in, node->loc, "unsupported expression");
+  }
+}
+
+bool interpreter_exec(Interpreter *in, AST_Node *node) {
+  if (!interpreter_step(in, node)) return false;
+  Interpreter_Value value = {0};
+  switch (node->kind) {
+  case AST_NK_VAR_DECL: {
+    Interpreter_Binding binding = { .name = node->as.var_decl.name };
+    if (!interpreter_eval_list(in, &node->as.var_decl.expr, &binding.value)) return false;
+    nob_da_append(&in->env, binding);
+    return interpreter_check_slots(in, node->loc);
+  }
+  case AST_NK_ASSIGNMENT: {
+    if (interpreter_find_local(in, node->as.var_assign.name) == NULL) return interpreter_fail(in, node->loc, "assigns to a global");
+    // Calls in the value can grow the env so the binding is only looked up again after evaluating it
+    if (!interpreter_eval_list(in, &node->as.var_assign.expr, &value)) return false;
+    interpreter_find_local(in, node->as.var_assign.name)->value = value;
+    return true;
+  }
+  case AST_NK_FN_CALL:
+  case AST_NK_EXPR:
+    return interpreter_eval_node(in, node, &value);
+  case AST_NK_BLOCK:
+    return interpreter_exec_list(in, &node->as.block);
+  case AST_NK_IF:
+    if (!interpreter_eval_list(in, &node->as.if_stmt.cond, &value)) return false;
+    return interpreter_exec_list(in, interpreter_truthy(value) ? &node->as.if_stmt.then_body : &node->as.if_stmt.else_body);
+  case AST_NK_WHILE:
+    while (true) {
+      if (!interpreter_eval_list(in, &node->as.while_loop.cond, &value)) return false;
+      if (!interpreter_truthy(value)) return true;
+      if (!interpreter_exec_list(in, &node->as.while_loop.body)) return false;
+      if (in->returning) return true;
+      if (!interpreter_step(in, node)) return false;
+    }
+  case AST_NK_RETURN:
+    value.kind = INTERPRETER_VK_UNDEFINED;
+    if (node->as.ret.count > 0 && !interpreter_eval_list(in, &node->as.ret, &value)) return false;
+    in->returned = value;
+    in->returning = true;
+    return true;
+  default:
+    return interpreter_fail(in, node->loc, "unsupported statement");
+  }
+}
+
+bool interpreter_exec_list(Interpreter *in, AST_NodeList *body) {
+  // Variables declared in the list go out of scope with it
+  size_t scope = in->env.count;
+  nob_da_foreach(AST_Node, it, body) {
+    if (!interpreter_exec(in, it)) return false;
+    if (in->returning) break;
+  }
+  in->env.count = scope;
+  return true;
+}
+
+bool interpreter_eval(Interpreter *in, AST_Node *expr, Interpreter_Value *out) {
+  in->steps = 0;
+  in->depth = 0;
+  in->env.count = 0;
+  in->frame = 0;
+  in->evaluating_globals.count = 0;
+  in->returning = false;
+  in->error = NULL;
+  return interpreter_eval_node(in, expr, out);
+}
+
+void interpreter_free(Interpreter *in) {
+  safe_da_free(in->env);
+  safe_da_free(in->globals);
+  safe_da_free(in->evaluating_globals);
+  safe_da_free(in->memo);
+  safe_da_free(in->memo_args);
+  if (in->memo_buckets != NULL) NOB_FREE(in->memo_buckets);
+}
+
+#endif // DWOC_INTERPRETER_IMPLEMENTATION
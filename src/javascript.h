@@ -4,279 +4,4308 @@
 
 #include "utils.h"
 #include "ast.h"
+#include "optimizer.h"
+#include "passes.h"
 
 #ifndef NOB_IMPLEMENTATION
 #  include "nob.h"
 #endif
 
-void javascript_compilation_prologue(Nob_String_Builder *sb);
+void javascript_compilation_prologue(Output_Sink *out, Context *ctx);
 
-bool javascript_run_compilation(Nob_String_Builder *sb, Context *ctx);
+// Passes to run over the parsed module before handing it to javascript_run_compilation
+extern const Pass javascript_pipeline[];
+extern const size_t javascript_pipeline_count;
 
-void javascript_compilation_epilogue(Nob_String_Builder *sb, Context *ctx);
+// Emit the module, analyses like tail calls and memoization come from the pass manager that optimized it
+// Every top level item goes into the sink before the next one gets built
+bool javascript_run_compilation(Output_Sink *out, Context *ctx, Pass_Manager *pm);
+
+void javascript_compilation_epilogue(Output_Sink *out, Context *ctx);
+
+// Runtime module the programs compiled with --esm import from, written next to them
+#define JS_ESM_RUNTIME "dwoc_runtime.mjs"
+
+// Writes the runtime module next to output_path when the program imports from it and it isn't already there
+bool javascript_write_esm_runtime(Context *ctx, const char *output_path);
+
+// Write a version 3 source map of the compilation into map_out, every emitted statement, function and call points back at its node
+// Starts recording, call before the prologue
+bool javascript_source_map_open(Output_Sink *map_out, const char *js_path, const char *source_path);
+// Finishes the map, with url set the JavaScript gets a `sourceMappingURL` comment pointing at it
+bool javascript_source_map_close(Output_Sink *out, Context *ctx, bool url);
 
 #endif // __DWOC_JavaScript_H
 
 #ifdef DWOC_JS_IMPLEMENTATION
 
-void javascript_compilation_prologue(Nob_String_Builder *sb) {
+// Where the emitted text of a node starts in the builder it went into
+typedef struct {
+  Nob_String_Builder *sb;
+  size_t offset;
+  Loc loc;
+} JS_SourceMark;
+
+typedef struct {
+  JS_SourceMark *items;
+  size_t count;
+  size_t capacity;
+} JS_SourceMarks;
+
+typedef struct {
+  Output_Sink *out;
+  const char *js_path;
+  // Marks of the item being built, turned into segments when it is drained
+  JS_SourceMarks marks;
+  // Position in the output where the next drained item starts
+  size_t line;
+  size_t col;
+  // Fields of the last segment written, the next one is encoded relative to them
+  size_t segment_line;
+  size_t segment_col;
+  size_t source_row;
+  size_t source_col;
+  bool line_has_segment;
+} JS_SourceMap;
+
+// Only set while a source map is being written, a NULL check is all recording costs otherwise
+static JS_SourceMap *javascript_source_map = NULL;
+
+#define javascript_map(sb, node)                                           \
+  do {                                                                     \
+    if (javascript_source_map != NULL) {                                   \
+      JS_SourceMark mark = { .sb = (sb), .offset = (sb)->count, .loc = (node)->loc }; \
+      nob_da_append(&javascript_source_map->marks, mark);                  \
+    }                                                                      \
+  } while (0)
+
+// Text built in a builder of its own got appended to another one at base
+void javascript_map_moved(Nob_String_Builder *from, Nob_String_Builder *to, size_t base) {
+  if (javascript_source_map == NULL) return;
+  nob_da_foreach(JS_SourceMark, it, &javascript_source_map->marks) {
+    if (it->sb != from) continue;
+    it->sb = to;
+    it->offset += base;
+  }
+}
+
+// Keeps the marks of sb in order of offset, the ones left in other builders never made it into the output
+void javascript_map_prune(Nob_String_Builder *sb) {
+  JS_SourceMarks *marks = &javascript_source_map->marks;
+  size_t kept = 0;
+  nob_da_foreach(JS_SourceMark, it, marks) {
+    if (it->sb == sb) marks->items[kept++] = *it;
+  }
+  marks->count = kept;
+  for (size_t i = 1; i < marks->count; ++i) {
+    for (size_t j = i; j > 0 && marks->items[j - 1].offset > marks->items[j].offset; --j) {
+      JS_SourceMark mark = marks->items[j];
+      marks->items[j] = marks->items[j - 1];
+      marks->items[j - 1] = mark;
+    }
+  }
+}
+
+void javascript_map_vlq(Nob_String_Builder *sb, long value) {
+  static const char base64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  // Sign goes in the lowest bit, then groups of 5 bits with the 6th set while more follow
+  unsigned long bits = value < 0 ? ((unsigned long)(-value) << 1) | 1 : (unsigned long)value << 1;
+  do {
+    unsigned long digit = bits & 31;
+    bits >>= 5;
+    if (bits > 0) digit |= 32;
+    nob_da_append(sb, base64[digit]);
+  } while (bits > 0);
+}
+
+void javascript_map_segment(JS_SourceMap *map, Nob_String_Builder *segments, size_t line, size_t col, Loc loc) {
+  if (map->line_has_segment && line == map->segment_line && col == map->segment_col) return;
+  while (map->segment_line < line) {
+    nob_da_append(segments, ';');
+    map->segment_line += 1;
+    map->segment_col = 0;
+    map->line_has_segment = false;
+  }
+  if (map->line_has_segment) nob_da_append(segments, ',');
+  // Lexer rows start at 1, source maps count lines from 0
+  size_t row = loc.row > 0 ? loc.row - 1 : 0;
+  javascript_map_vlq(segments, (long)col - (long)map->segment_col);
+  javascript_map_vlq(segments, 0);
+  javascript_map_vlq(segments, (long)row - (long)map->source_row);
+  javascript_map_vlq(segments, (long)loc.col - (long)map->source_col);
+  map->segment_col = col;
+  map->source_row = row;
+  map->source_col = loc.col;
+  map->line_has_segment = true;
+}
+
+// Turns the marks of the item about to be drained into segments, indentation is skipped so they point at the code itself
+bool javascript_map_item(JS_SourceMap *map, Nob_String_Builder *sb) {
+  javascript_map_prune(sb);
+  Nob_String_Builder segments = {0};
+  size_t at = 0;
+  nob_da_foreach(JS_SourceMark, mark, &map->marks) {
+    size_t offset = mark->offset;
+    while (offset < sb->count && sb->items[offset] == ' ') offset += 1;
+    for (; at < offset; ++at) {
+      if (sb->items[at] == '\n') {
+        map->line += 1;
+        map->col = 0;
+      } else {
+        map->col += 1;
+      }
+    }
+    if (offset < sb->count) javascript_map_segment(map, &segments, map->line, map->col, mark->loc);
+  }
+  for (; at < sb->count; ++at) {
+    if (sb->items[at] == '\n') {
+      map->line += 1;
+      map->col = 0;
+    } else {
+      map->col += 1;
+    }
+  }
+  map->marks.count = 0;
+  bool ok = output_sink_drain(map->out, &segments);
+  nob_sb_free(segments);
+  return ok;
+}
+
+void javascript_map_append_json_string(Nob_String_Builder *sb, const char *text) {
+  nob_da_append(sb, '"');
+  for (const char *c = text; *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') nob_da_append(sb, '\\');
+    nob_da_append(sb, *c);
+  }
+  nob_da_append(sb, '"');
+}
+
+// Directories leading to the path from the root, with `.` and `..` resolved, relative paths start where the compiler runs
+void javascript_path_components(const char *path, StringViews *parts) {
+  bool absolute = path[0] == '/' || path[0] == '\\' || (path[0] != '\0' && path[1] == ':');
+  Nob_String_View rest = nob_sv_from_cstr(absolute ? path : nob_temp_sprintf("%s/%s", nob_get_current_dir_temp(), path));
+  while (rest.count > 0) {
+    size_t i = 0;
+    while (i < rest.count && rest.data[i] != '/' && rest.data[i] != '\\') ++i;
+    Nob_String_View part = nob_sv_from_parts(rest.data, i);
+    rest = nob_sv_from_parts(rest.data + i, rest.count - i);
+    if (rest.count > 0) rest = nob_sv_from_parts(rest.data + 1, rest.count - 1);
+    if (part.count == 0 || sv_eq_str(part, ".")) continue;
+    if (sv_eq_str(part, "..")) {
+      if (parts->count > 0) parts->count--;
+      continue;
+    }
+    nob_da_append(parts, part);
+  }
+}
+
+// Sources of a map are resolved from the directory the map is in, so the path is written relative to it
+// Only a source on another drive than the map keeps its absolute path
+void javascript_map_source_path(Nob_String_Builder *sb, const char *map_path, const char *source_path) {
+  StringViews from = {0};
+  StringViews to = {0};
+  javascript_path_components(map_path, &from);
+  javascript_path_components(source_path, &to);
+  // The map's own name isn't a directory to leave
+  if (from.count > 0) from.count--;
+  size_t common = 0;
+  while (common < from.count && common + 1 < to.count && nob_sv_eq(from.items[common], to.items[common])) common++;
+  bool other_drive = common == 0 && to.count > 0 && to.items[0].count > 0 && to.items[0].data[to.items[0].count - 1] == ':';
+  if (other_drive) {
+    common = 0;
+    from.count = 0;
+  } else if (source_path[0] == '/' && common == 0) {
+    // Nothing shared but the root, walking up to it reads the same as the absolute path
+    nob_da_append(sb, '/');
+    from.count = 0;
+  }
+  for (size_t i = common; i < from.count; ++i) nob_sb_append_cstr(sb, "../");
+  for (size_t i = common; i < to.count; ++i) {
+    if (i > common) nob_da_append(sb, '/');
+    sb_append_sv(sb, to.items[i]);
+  }
+  safe_da_free(from);
+  safe_da_free(to);
+}
+
+bool javascript_source_map_open(Output_Sink *map_out, const char *js_path, const char *source_path) {
+  static JS_SourceMap map = {0};
+  map = (JS_SourceMap) {
+    .out = map_out,
+    .js_path = js_path,
+  };
+  Nob_String_Builder source = {0};
+  javascript_map_source_path(&source, js_path, source_path);
+  nob_sb_append_null(&source);
+
+  Nob_String_Builder header = {0};
+  nob_sb_append_cstr(&header, "{\"version\":3,\"file\":");
+  javascript_map_append_json_string(&header, nob_path_name(js_path));
+  nob_sb_append_cstr(&header, ",\"sources\":[");
+  javascript_map_append_json_string(&header, source.items);
+  nob_sb_append_cstr(&header, "],\"names\":[],\"mappings\":\"");
+  bool ok = output_sink_drain(map_out, &header);
+  nob_sb_free(header);
+  nob_sb_free(source);
+  javascript_source_map = &map;
+  return ok;
+}
+
+bool javascript_source_map_close(Output_Sink *out, Context *ctx, bool url) {
+  JS_SourceMap *map = javascript_source_map;
+  javascript_source_map = NULL;
+  bool ok = output_sink_write_cstr(map->out, "\"}\n");
+  safe_da_free(map->marks);
+  if (!url) return ok;
+  Nob_String_Builder comment = {0};
+  nob_sb_appendf(&comment, "%s//# sourceMappingURL=%s.map\n", ctx->opts.minify ? "\n" : "", nob_path_name(map->js_path));
+  ok = output_sink_drain(out, &comment) && ok;
+  nob_sb_free(comment);
+  return ok;
+}
+
+bool javascript_drain(Output_Sink *out, Nob_String_Builder *sb, Context *ctx);
+
+void javascript_compilation_prologue(Output_Sink *out, Context *ctx) {
   // TODO: Embed some runtime stuff
   // possibly also needs options passed in to know what runtime things need to be added.
-  nob_sb_append_cstr(sb, "\"use strict\";\n\n");
+  // Modules are always strict
+  if (ctx->opts.esm) return;
+  Nob_String_Builder sb = {0};
+  nob_sb_append_cstr(&sb, "\"use strict\";\n\n");
+  javascript_drain(out, &sb, ctx);
+  nob_sb_free(sb);
+}
+
+// Function currently being compiled
+typedef struct {
+  AST_Node *node;
+  AST_NodeList *module;
+  // Group of functions whose tail calls become jumps in the current function, NULL if it has none
+  Optimizer_TailGroup *tail_group;
+  // Whether the body is emitted as `name$impl` behind a wrapper that caches its results
+  bool memoized;
+  Pass_Manager *pm;
+} JS_Function;
+
+// Arguments in [0, limit) are cached in a typed array that grows on demand, the rest go into a Map
+#define JS_MEMO_TABLE_LIMIT 65536
+#define JS_MEMO_TABLE_INITIAL 64
+
+// Name of the function that holds the merged bodies of a group of mutually tail recursive functions
+void javascript_append_tail_group_name(Nob_String_Builder *sb, AST_NodeList *module, Optimizer_TailGroup *group) {
+  nob_da_foreach(size_t, index, &group->fns) {
+    sb_append_sv(sb, module->items[*index].as.fn_decl.name);
+    nob_sb_append_cstr(sb, "$");
+  }
+  nob_sb_append_cstr(sb, "tail");
+}
+
+bool javascript_compile_expr_node(Nob_String_Builder *sb, AST_Node *node);
+bool javascript_compile_expr_at_depth(Nob_String_Builder *sb, AST_NodeList *expr, int depth);
+
+bool javascript_compile_fn_call(Nob_String_Builder *sb, AST_Node *node) {
+  javascript_map(sb, node);
+  if (node->as.fn_call.constructs) nob_sb_append_cstr(sb, "new ");
+  sb_append_sv(sb, node->as.fn_call.name);
+  nob_sb_append_cstr(sb, "(");
+  AST_NodeList *fn_params = &node->as.fn_call.params;
+  nob_da_foreach(AST_Node, param, fn_params) {
+    size_t index = param - fn_params->items;
+    if (index > 0) nob_sb_append_cstr(sb, ", ");
+    if (!javascript_compile_expr_node(sb, param)) return false;
+  }
+  nob_sb_append_cstr(sb, ")");
+  return true;
+}
+
+// Operand of a binary operation, wrapped in parenthesis when it binds looser than the operation
+bool javascript_compile_operand(Nob_String_Builder *sb, AST_Node *operand, int precedence, bool is_rhs) {
+  bool wrap = false;
+  if (operand->kind == AST_NK_BINOP) {
+    int operand_precedence = ast_binop_precedence(operand->as.op.op.sv);
+    wrap = operand_precedence < precedence || (is_rhs && operand_precedence == precedence);
+  }
+  if (wrap) nob_sb_append_cstr(sb, "(");
+  if (!javascript_compile_expr_node(sb, operand)) return false;
+  if (wrap) nob_sb_append_cstr(sb, ")");
+  return true;
+}
+
+// JavaScript string literal for a dwoc one, escapes are resolved first as both languages disagree on some of them
+void javascript_append_string_literal(Nob_String_Builder *sb, Nob_String_View literal) {
+  Nob_String_Builder text = {0};
+  lexer_unescape_string(&text, literal);
+  nob_da_append(sb, '"');
+  for (size_t i = 0; i < text.count; ++i) {
+    unsigned char c = text.items[i];
+    if (c == '"' || c == '\\') {
+      nob_da_append(sb, '\\');
+      nob_da_append(sb, c);
+    } else if (c == '\n') {
+      nob_sb_append_cstr(sb, "\\n");
+    } else if (c < 0x20) {
+      nob_sb_appendf(sb, "\\x%02x", c);
+    } else if (c == 0xe2 && i + 2 < text.count && (unsigned char)text.items[i + 1] == 0x80 && ((unsigned char)text.items[i + 2] & 0xfe) == 0xa8) {
+      // U+2028 and U+2029 end lines inside of JavaScript strings
+      nob_sb_appendf(sb, "\\u%04x", 0x2000 | (unsigned char)text.items[i + 2]);
+      i += 2;
+    } else {
+      nob_da_append(sb, c);
+    }
+  }
+  nob_da_append(sb, '"');
+  safe_da_free(text);
+}
+
+// Whether the expression always evaluates to a number, anything else gets converted before a match compares it
+bool javascript_is_number(AST_Node *node) {
+  node = optimizer_unwrap_expr(node);
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    return node->as.token.kind == TOK_INT;
+  case AST_NK_UNOP:
+    return sv_eq_str(node->as.op.op.sv, "-");
+  case AST_NK_INDEX:
+    return !node->as.index.slice && (node->as.index.elem == AST_ELEM_I32 || node->as.index.elem == AST_ELEM_F64);
+  case AST_NK_BINOP: {
+    Nob_String_View op = node->as.op.op.sv;
+    // `+` concatenates as soon as one side is a string
+    if (sv_eq_str(op, "+")) return javascript_is_number(&node->as.op.operands.items[0]) && javascript_is_number(&node->as.op.operands.items[1]);
+    return sv_eq_str(op, "-") || sv_eq_str(op, "*") || sv_eq_str(op, "/") || sv_eq_str(op, "%");
+  }
+  default:
+    return false;
+  }
+}
+
+// Values an integer expression can take, dwoc numbers are integers so `x % 4` stays within [-3, 3]
+bool javascript_expr_range(AST_Node *node, double *lo, double *hi) {
+  node = optimizer_unwrap_expr(node);
+  if (node->kind == AST_NK_TOKEN) {
+    if (node->as.token.kind != TOK_INT) return false;
+    *lo = *hi = ast_int_literal_value(node);
+    return true;
+  }
+  if (node->kind == AST_NK_INDEX) {
+    if (node->as.index.slice || node->as.index.elem != AST_ELEM_I32) return false;
+    *lo = INT32_MIN;
+    *hi = INT32_MAX;
+    return true;
+  }
+  if (node->kind == AST_NK_UNOP) {
+    if (!sv_eq_str(node->as.op.op.sv, "-") || !javascript_expr_range(&node->as.op.operands.items[0], lo, hi)) return false;
+    double tmp = *lo;
+    *lo = -*hi;
+    *hi = -tmp;
+    return true;
+  }
+  if (node->kind != AST_NK_BINOP) return false;
+  Nob_String_View op = node->as.op.op.sv;
+  AST_Node *lhs = optimizer_unwrap_expr(&node->as.op.operands.items[0]);
+  AST_Node *rhs = optimizer_unwrap_expr(&node->as.op.operands.items[1]);
+  double lhs_lo, lhs_hi, rhs_lo, rhs_hi;
+  bool lhs_known = javascript_expr_range(lhs, &lhs_lo, &lhs_hi);
+  bool rhs_known = javascript_expr_range(rhs, &rhs_lo, &rhs_hi);
+  if (sv_eq_str(op, "%")) {
+    if (!rhs_known || rhs_lo != rhs_hi || rhs_lo == 0) return false;
+    if (lhs->kind == AST_NK_TOKEN && lhs->as.token.kind == TOK_STR) return false;
+    // The remainder takes the sign of the dividend
+    double limit = fabs(rhs_lo) - 1;
+    *lo = lhs_known && lhs_lo >= 0 ? 0 : -limit;
+    *hi = lhs_known && lhs_hi <= 0 ? 0 : limit;
+    if (lhs_known && lhs_lo >= 0 && lhs_hi < *hi) *hi = lhs_hi;
+    return true;
+  }
+  if (!lhs_known || !rhs_known) return false;
+  if (sv_eq_str(op, "+")) {
+    *lo = lhs_lo + rhs_lo;
+    *hi = lhs_hi + rhs_hi;
+    return true;
+  }
+  if (sv_eq_str(op, "-")) {
+    *lo = lhs_lo - rhs_hi;
+    *hi = lhs_hi - rhs_lo;
+    return true;
+  }
+  return false;
+}
+
+// `+x` for subjects that might not be numbers, matches compare them like arithmetic would
+bool javascript_compile_numeric_subject(Nob_String_Builder *sb, AST_Node *subject) {
+  if (javascript_is_number(subject)) return javascript_compile_expr_node(sb, subject);
+  bool wrap = optimizer_unwrap_expr(subject)->kind != AST_NK_TOKEN && optimizer_unwrap_expr(subject)->kind != AST_NK_FN_CALL;
+  nob_sb_append_cstr(sb, wrap ? "+(" : "+");
+  if (!javascript_compile_expr_node(sb, subject)) return false;
+  if (wrap) nob_sb_append_cstr(sb, ")");
+  return true;
+}
+
+// `$tableN[subject - min]`, the `??` only stays when the subject might land outside of the table
+bool javascript_compile_match_lookup(Nob_String_Builder *sb, AST_Node *node, Optimizer_Cases *cases, AST_NodeList *fallback) {
+  AST_Node *subject = &node->as.match.subject.items[0];
+  double min = cases->items[0].value;
+  double max = cases->items[cases->count - 1].value;
+  double lo, hi;
+  bool in_range = javascript_expr_range(subject, &lo, &hi) && lo >= min && hi <= max;
+  bool has_fallback = fallback != NULL && !in_range;
+  if (has_fallback) nob_sb_append_cstr(sb, "(");
+  nob_sb_appendf(sb, "$table%zu[", node->as.match.table);
+  if (min == 0) {
+    if (!javascript_compile_numeric_subject(sb, subject)) return false;
+  } else {
+    // Subtracting converts the subject to a number already
+    if (!javascript_compile_operand(sb, subject, ast_binop_precedence(SV("-")), false)) return false;
+    nob_sb_appendf(sb, " %c %.0f", min > 0 ? '-' : '+', fabs(min));
+  }
+  nob_sb_append_cstr(sb, "]");
+  if (has_fallback) {
+    nob_sb_append_cstr(sb, " ?? ");
+    if (!javascript_compile_expr_node(sb, &fallback->items[0])) return false;
+    nob_sb_append_cstr(sb, ")");
+  }
+  return true;
+}
+
+// Nested conditionals comparing the subject, a binary search on the values once there are more than a few
+bool javascript_compile_match_tree(Nob_String_Builder *sb, const char *subject, const char *eq, Optimizer_Cases *cases, size_t lo, size_t hi, AST_NodeList *fallback) {
+  if (hi - lo > 3) {
+    size_t mid = lo + (hi - lo)/2;
+    nob_sb_appendf(sb, "%s < %.0f ? (", subject, cases->items[mid].value);
+    if (!javascript_compile_match_tree(sb, subject, eq, cases, lo, mid, fallback)) return false;
+    nob_sb_append_cstr(sb, ") : (");
+    if (!javascript_compile_match_tree(sb, subject, eq, cases, mid, hi, fallback)) return false;
+    nob_sb_append_cstr(sb, ")");
+    return true;
+  }
+  for (size_t i = lo; i < hi; ++i) {
+    nob_sb_appendf(sb, "%s %s %.0f", subject, eq, cases->items[i].value);
+    // Neighbouring values of the same arm share its value
+    while (i + 1 < hi && cases->items[i + 1].body == cases->items[i].body) {
+      nob_sb_appendf(sb, " || %s %s %.0f", subject, eq, cases->items[++i].value);
+    }
+    nob_sb_append_cstr(sb, " ? ");
+    if (!javascript_compile_expr_node(sb, &cases->items[i].body->items[0])) return false;
+    nob_sb_append_cstr(sb, " : ");
+  }
+  if (fallback == NULL) {
+    nob_sb_append_cstr(sb, "undefined");
+    return true;
+  }
+  return javascript_compile_expr_node(sb, &fallback->items[0]);
+}
+
+bool javascript_compile_match(Nob_String_Builder *sb, AST_Node *node) {
+  Optimizer_Cases cases = {0};
+  AST_NodeList *fallback = NULL;
+  optimizer_match_cases(node, &cases, &fallback);
+  AST_Node *subject = optimizer_unwrap_expr(&node->as.match.subject.items[0]);
+  bool ok = true;
+  if (node->as.match.table != 0) {
+    ok = javascript_compile_match_lookup(sb, node, &cases, fallback);
+  } else {
+    // Loose equality converts the subject to a number the same way `+x` would
+    const char *eq = javascript_is_number(subject) ? "===" : "==";
+    Nob_String_Builder name = {0};
+    if (subject->kind == AST_NK_TOKEN) {
+      ok = javascript_compile_expr_node(&name, subject);
+      nob_sb_append_null(&name);
+      nob_sb_append_cstr(sb, "(");
+    } else {
+      nob_sb_append_cstr(&name, "$subject");
+      nob_sb_append_null(&name);
+      nob_sb_append_cstr(sb, "(($subject) => ");
+    }
+    ok = ok && javascript_compile_match_tree(sb, name.items, eq, &cases, 0, cases.count, fallback);
+    nob_sb_append_cstr(sb, ")");
+    if (ok && subject->kind != AST_NK_TOKEN) {
+      nob_sb_append_cstr(sb, "(");
+      ok = javascript_compile_expr_node(sb, subject);
+      nob_sb_append_cstr(sb, ")");
+    }
+    nob_sb_free(name);
+  }
+  safe_da_free(cases);
+  return ok;
+}
+
+const char *javascript_typed_array_name(AST_Elem_Kind elem) {
+  switch (elem) {
+  case AST_ELEM_I32: return "Int32Array";
+  case AST_ELEM_F64: return "Float64Array";
+  case AST_ELEM_ANY: return "Array";
+  case AST_ELEM_SOA: break;
+  }
+  NEVER("Arrays of structs don't have a single array holding them");
+}
+
+AST_Elem_Kind javascript_value_elem(AST_Node *node);
+
+AST_Elem_Kind javascript_elem_join(AST_Elem_Kind a, AST_Elem_Kind b) {
+  if (a == AST_ELEM_ANY || b == AST_ELEM_ANY) return AST_ELEM_ANY;
+  if (a == AST_ELEM_F64 || b == AST_ELEM_F64) return AST_ELEM_F64;
+  return AST_ELEM_I32;
+}
+
+// Kind of the array holding a field for every element of a struct of arrays
+AST_Elem_Kind javascript_soa_column_elem(AST_Array *array, size_t field) {
+  AST_Elem_Kind elem = AST_ELEM_I32;
+  nob_da_foreach(AST_Node, it, &array->items) {
+    elem = javascript_elem_join(elem, javascript_value_elem(&optimizer_unwrap_expr(it)->as.fn_call.params.items[field]));
+  }
+  return elem;
+}
+
+// One typed array per field, the values of an element end up at the same index of every one of them
+bool javascript_compile_soa_array(Nob_String_Builder *sb, AST_Array *array) {
+  size_t fields = optimizer_unwrap_expr(&array->items.items[0])->as.fn_call.params.count;
+  if (array->length.count == 0) {
+    nob_sb_appendf(sb, "new "SV_Fmt"$soa(%zu", SV_Arg(array->soa), array->items.count);
+    for (size_t i = 0; i < fields; ++i) {
+      nob_sb_appendf(sb, ", %s.of(", javascript_typed_array_name(javascript_soa_column_elem(array, i)));
+      nob_da_foreach(AST_Node, it, &array->items) {
+        if (it != array->items.items) nob_sb_append_cstr(sb, ", ");
+        if (!javascript_compile_expr_node(sb, &optimizer_unwrap_expr(it)->as.fn_call.params.items[i])) return false;
+      }
+      nob_sb_append_cstr(sb, ")");
+    }
+    nob_sb_append_cstr(sb, ")");
+    return true;
+  }
+  // The length is needed by every field so anything that isn't a plain value gets evaluated once first
+  AST_Node *length = optimizer_unwrap_expr(&array->length.items[0]);
+  bool is_plain = length->kind == AST_NK_TOKEN;
+  if (!is_plain) nob_sb_append_cstr(sb, "(($n) => ");
+  Nob_String_Builder count = {0};
+  if (is_plain && !javascript_compile_expr_node(&count, length)) return false;
+  if (!is_plain) nob_sb_append_cstr(&count, "$n");
+  nob_sb_append_null(&count);
+  nob_sb_appendf(sb, "new "SV_Fmt"$soa(%s", SV_Arg(array->soa), count.items);
+  AST_Node *value = optimizer_unwrap_expr(&array->items.items[0]);
+  for (size_t i = 0; i < fields; ++i) {
+    AST_Node *param = &value->as.fn_call.params.items[i];
+    nob_sb_appendf(sb, ", new %s(%s)", javascript_typed_array_name(javascript_soa_column_elem(array, i)), count.items);
+    double lo, hi;
+    if (javascript_expr_range(param, &lo, &hi) && lo == 0 && hi == 0) continue;
+    nob_sb_append_cstr(sb, ".fill(");
+    if (!javascript_compile_expr_node(sb, param)) return false;
+    nob_sb_append_cstr(sb, ")");
+  }
+  nob_sb_append_cstr(sb, ")");
+  if (!is_plain) {
+    nob_sb_append_cstr(sb, ")(");
+    if (!javascript_compile_expr_node(sb, length)) return false;
+    nob_sb_append_cstr(sb, ")");
+  }
+  nob_sb_free(count);
+  return true;
+}
+
+// Arrays of numbers are typed so the engine keeps them as unboxed contiguous memory
+bool javascript_compile_array(Nob_String_Builder *sb, AST_Node *node) {
+  AST_Array *array = &node->as.array;
+  if (array->elem == AST_ELEM_SOA) return javascript_compile_soa_array(sb, array);
+  const char *name = javascript_typed_array_name(array->elem);
+  if (array->length.count > 0) {
+    nob_sb_appendf(sb, "new %s(", name);
+    if (!javascript_compile_expr_at_depth(sb, &array->length, 0)) return false;
+    nob_sb_append_cstr(sb, ")");
+    // Typed arrays already start zeroed
+    AST_Node *value = optimizer_unwrap_expr(&array->items.items[0]);
+    double lo, hi;
+    if (array->elem != AST_ELEM_ANY && javascript_expr_range(value, &lo, &hi) && lo == 0 && hi == 0) return true;
+    nob_sb_append_cstr(sb, ".fill(");
+    if (!javascript_compile_expr_node(sb, value)) return false;
+    nob_sb_append_cstr(sb, ")");
+    return true;
+  }
+  // `of` fills the typed array straight from the arguments without a temporary array in between
+  nob_sb_append_cstr(sb, array->elem == AST_ELEM_ANY || array->items.count == 0 ? "[" : nob_temp_sprintf("%s.of(", name));
+  nob_da_foreach(AST_Node, it, &array->items) {
+    if (it != array->items.items) nob_sb_append_cstr(sb, ", ");
+    if (!javascript_compile_expr_node(sb, it)) return false;
+  }
+  nob_sb_append_cstr(sb, array->elem == AST_ELEM_ANY || array->items.count == 0 ? "]" : ")");
+  return true;
+}
+
+// Value something gets looked up in, wrapped when the lookup would bind to only part of it
+bool javascript_compile_lookup_target(Nob_String_Builder *sb, AST_Node *target) {
+  target = optimizer_unwrap_expr(target);
+  bool wrap = target->kind == AST_NK_BINOP || target->kind == AST_NK_UNOP || target->kind == AST_NK_MATCH || target->kind == AST_NK_PIPELINE;
+  if (wrap) nob_sb_append_cstr(sb, "(");
+  if (!javascript_compile_expr_node(sb, target)) return false;
+  if (wrap) nob_sb_append_cstr(sb, ")");
+  return true;
+}
+
+bool javascript_compile_index(Nob_String_Builder *sb, AST_Node *node) {
+  AST_Index *index = &node->as.index;
+  if (!javascript_compile_lookup_target(sb, &index->target.items[0])) return false;
+  if (!index->slice) {
+    // Whole elements of a struct of arrays have to be put back together
+    nob_sb_append_cstr(sb, index->elem == AST_ELEM_SOA ? ".at(" : "[");
+    if (!javascript_compile_expr_at_depth(sb, &index->start, 0)) return false;
+    nob_sb_append_cstr(sb, index->elem == AST_ELEM_SOA ? ")" : "]");
+    return true;
+  }
+  // Arrays never change once built so a typed one can share its memory with the slice instead of copying it
+  // Structs of arrays do the same for every field in their `slice`
+  nob_sb_append_cstr(sb, index->elem == AST_ELEM_ANY || index->elem == AST_ELEM_SOA ? ".slice(" : ".subarray(");
+  if (index->start.count > 0) {
+    if (!javascript_compile_expr_at_depth(sb, &index->start, 0)) return false;
+  } else if (index->end.count > 0) {
+    nob_sb_append_cstr(sb, "0");
+  }
+  if (index->end.count > 0) {
+    nob_sb_append_cstr(sb, ", ");
+    if (!javascript_compile_expr_at_depth(sb, &index->end, 0)) return false;
+  }
+  nob_sb_append_cstr(sb, ")");
+  return true;
+}
+
+bool javascript_compile_field(Nob_String_Builder *sb, AST_Node *node) {
+  AST_Node *target = optimizer_unwrap_expr(&node->as.field.target.items[0]);
+  if (target->kind == AST_NK_INDEX && !target->as.index.slice && target->as.index.elem == AST_ELEM_SOA) {
+    // `a[i].x` reads straight from the array of the field without building the element
+    if (!javascript_compile_lookup_target(sb, &target->as.index.target.items[0])) return false;
+    nob_sb_appendf(sb, "."SV_Fmt"[", SV_Arg(node->as.field.name));
+    if (!javascript_compile_expr_at_depth(sb, &target->as.index.start, 0)) return false;
+    nob_sb_append_cstr(sb, "]");
+    return true;
+  }
+  if (!javascript_compile_lookup_target(sb, target)) return false;
+  nob_sb_appendf(sb, "."SV_Fmt, SV_Arg(node->as.field.name));
+  return true;
+}
+
+bool javascript_pipeline_has_loops(AST_Node *pipeline) {
+  nob_da_foreach(AST_Node, stage, &pipeline->as.pipeline.stages) {
+    if (stage->as.pipe_stage.kind != AST_PIPE_CALL) return true;
+  }
+  return false;
+}
+
+// Call of a stage with its placeholders replaced by the piped value and what reduce accumulated so far
+bool javascript_compile_pipe_call(Nob_String_Builder *sb, AST_Node *stage, const char *value, const char *acc) {
+  AST_Node *call = &stage->as.pipe_stage.call.items[0];
+  sb_append_sv(sb, call->as.fn_call.name);
+  nob_sb_append_cstr(sb, "(");
+  nob_da_foreach(AST_Node, param, &call->as.fn_call.params) {
+    if (param != call->as.fn_call.params.items) nob_sb_append_cstr(sb, ", ");
+    if (param->kind == AST_NK_TOKEN && sv_eq_str(param->as.token.sv, AST_PIPE_ITEM)) {
+      nob_sb_append_cstr(sb, value);
+    } else if (param->kind == AST_NK_TOKEN && sv_eq_str(param->as.token.sv, AST_PIPE_ACC)) {
+      nob_sb_append_cstr(sb, acc);
+    } else if (!javascript_compile_expr_node(sb, param)) {
+      return false;
+    }
+  }
+  nob_sb_append_cstr(sb, ")");
+  return true;
+}
+
+// A negative depth puts all the statements of the pipeline on a single line
+void javascript_pipe_line_start(Nob_String_Builder *sb, int depth) {
+  sb_add_indentation_level(sb, i, depth);
+}
+
+void javascript_pipe_line_end(Nob_String_Builder *sb, int depth) {
+  nob_sb_append_cstr(sb, depth < 0 ? " " : "\n");
+}
+
+// Consecutive map, filter and reduce stages share a single loop over the array so only the end of the run gets materialized
+// Emits the statements computing the pipeline, value ends up holding the expression to read the result from
+bool javascript_compile_pipeline_steps(Nob_String_Builder *sb, AST_Node *pipeline, Nob_String_Builder *value, int depth) {
+  int inner = depth < 0 ? depth : depth + 1;
+  AST_NodeList *stages = &pipeline->as.pipeline.stages;
+  AST_Node *source = optimizer_unwrap_expr(&pipeline->as.pipeline.source.items[0]);
+  if (!javascript_compile_expr_node(value, source)) return false;
+  nob_sb_append_null(value);
+  // A variable can be iterated as it is, anything else gets evaluated once first
+  bool is_name = source->kind == AST_NK_TOKEN && source->as.token.kind == TOK_IDENT;
+  bool is_soa = pipeline->as.pipeline.soa.count > 0;
+  size_t runs = 0;
+  for (size_t i = 0; i < stages->count;) {
+    AST_Node *stage = &stages->items[i];
+    if (stage->as.pipe_stage.kind == AST_PIPE_CALL) {
+      Nob_String_Builder call = {0};
+      if (!javascript_compile_pipe_call(&call, stage, value->items, NULL)) return false;
+      nob_sb_append_null(&call);
+      nob_sb_free(*value);
+      *value = call;
+      is_name = false;
+      is_soa = false;
+      i++;
+      continue;
+    }
+
+    size_t end = i;
+    bool has_map = false;
+    while (end < stages->count && stages->items[end].as.pipe_stage.kind != AST_PIPE_CALL) {
+      has_map = has_map || stages->items[end].as.pipe_stage.kind == AST_PIPE_MAP;
+      if (stages->items[end++].as.pipe_stage.kind == AST_PIPE_REDUCE) break;
+    }
+    AST_Node *last = &stages->items[end - 1];
+    bool reduces = last->as.pipe_stage.kind == AST_PIPE_REDUCE;
+    runs++;
+
+    Nob_String_Builder src = {0};
+    if (is_name) {
+      nob_sb_append_cstr(&src, value->items);
+    } else {
+      nob_sb_appendf(&src, "$src%zu", runs);
+      javascript_pipe_line_start(sb, depth);
+      nob_sb_appendf(sb, "const %s = %s;", src.items, value->items);
+      javascript_pipe_line_end(sb, depth);
+    }
+    nob_sb_append_null(&src);
+    Nob_String_Builder out = {0};
+    nob_sb_appendf(&out, "$v%zu", runs);
+    nob_sb_append_null(&out);
+
+    javascript_pipe_line_start(sb, depth);
+    if (reduces) {
+      nob_sb_appendf(sb, "let %s = ", out.items);
+      if (!javascript_compile_expr_at_depth(sb, &last->as.pipe_stage.init, 0)) return false;
+      nob_sb_append_cstr(sb, ";");
+    } else {
+      nob_sb_appendf(sb, "const %s = [];", out.items);
+    }
+    javascript_pipe_line_end(sb, depth);
+    javascript_pipe_line_start(sb, depth);
+    nob_sb_appendf(sb, "for (let $i = 0; $i < %s.length; $i++) {", src.items);
+    javascript_pipe_line_end(sb, depth);
+    javascript_pipe_line_start(sb, inner);
+    nob_sb_appendf(sb, is_soa ? "%s "AST_PIPE_ITEM" = %s.at($i);" : "%s "AST_PIPE_ITEM" = %s[$i];", has_map ? "let" : "const", src.items);
+    javascript_pipe_line_end(sb, depth);
+    for (size_t j = i; j < end; ++j) {
+      AST_Node *it = &stages->items[j];
+      javascript_pipe_line_start(sb, inner);
+      switch (it->as.pipe_stage.kind) {
+      case AST_PIPE_MAP:
+        nob_sb_append_cstr(sb, AST_PIPE_ITEM" = ");
+        if (!javascript_compile_pipe_call(sb, it, AST_PIPE_ITEM, NULL)) return false;
+        nob_sb_append_cstr(sb, ";");
+        break;
+      case AST_PIPE_FILTER:
+        nob_sb_append_cstr(sb, "if (!");
+        if (!javascript_compile_pipe_call(sb, it, AST_PIPE_ITEM, NULL)) return false;
+        nob_sb_append_cstr(sb, ") continue;");
+        break;
+      case AST_PIPE_REDUCE:
+        nob_sb_appendf(sb, "%s = ", out.items);
+        if (!javascript_compile_pipe_call(sb, it, AST_PIPE_ITEM, out.items)) return false;
+        nob_sb_append_cstr(sb, ";");
+        break;
+      case AST_PIPE_CALL:
+        NEVER("Calls end the run of stages sharing a loop");
+      }
+      javascript_pipe_line_end(sb, depth);
+    }
+    if (!reduces) {
+      javascript_pipe_line_start(sb, inner);
+      nob_sb_appendf(sb, "%s.push("AST_PIPE_ITEM");", out.items);
+      javascript_pipe_line_end(sb, depth);
+    }
+    javascript_pipe_line_start(sb, depth);
+    nob_sb_append_cstr(sb, "}");
+    javascript_pipe_line_end(sb, depth);
+
+    nob_sb_free(src);
+    nob_sb_free(*value);
+    *value = out;
+    is_name = true;
+    is_soa = false;
+    i = end;
+  }
+  return true;
+}
+
+bool javascript_compile_pipeline(Nob_String_Builder *sb, AST_Node *node) {
+  Nob_String_Builder value = {0};
+  bool ok = true;
+  if (javascript_pipeline_has_loops(node)) {
+    // The loops need statements, an arrow this small gets inlined by the engine
+    nob_sb_append_cstr(sb, "(() => { ");
+    ok = javascript_compile_pipeline_steps(sb, node, &value, -1);
+    if (ok) nob_sb_appendf(sb, "return %s; })()", value.items);
+  } else {
+    ok = javascript_compile_pipeline_steps(sb, node, &value, -1);
+    if (ok) nob_sb_append_cstr(sb, value.items);
+  }
+  nob_sb_free(value);
+  return ok;
+}
+
+bool javascript_compile_expr_node(Nob_String_Builder *sb, AST_Node *node) {
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    if (node->as.token.kind == TOK_STR) {
+      javascript_append_string_literal(sb, node->as.token.sv);
+      return true;
+    }
+    sb_append_sv(sb, node->as.token.sv);
+    return true;
+  case AST_NK_FN_CALL:
+    return javascript_compile_fn_call(sb, node);
+  case AST_NK_AWAIT:
+    nob_sb_append_cstr(sb, "(await ");
+    if (!javascript_compile_expr_at_depth(sb, &node->as.awaited, 0)) return false;
+    nob_sb_append_cstr(sb, ")");
+    return true;
+  case AST_NK_EXPR:
+    return javascript_compile_expr_at_depth(sb, &node->as.expr, 0);
+  case AST_NK_UNOP:
+    sb_append_sv(sb, node->as.op.op.sv);
+    // Nested unary operations are wrapped too so `- -x` doesn't come out as a decrement
+    if (node->as.op.operands.items[0].kind == AST_NK_BINOP || node->as.op.operands.items[0].kind == AST_NK_UNOP) {
+      nob_sb_append_cstr(sb, "(");
+      if (!javascript_compile_expr_node(sb, &node->as.op.operands.items[0])) return false;
+      nob_sb_append_cstr(sb, ")");
+      return true;
+    }
+    return javascript_compile_expr_node(sb, &node->as.op.operands.items[0]);
+  case AST_NK_BINOP: {
+    Nob_String_View op = node->as.op.op.sv;
+    int precedence = ast_binop_precedence(op);
+    AST_Node *lhs = &node->as.op.operands.items[0];
+    AST_Node *rhs = &node->as.op.operands.items[1];
+    // dwoc only has integers so division truncates
+    if (sv_eq_str(op, "/")) {
+      nob_sb_append_cstr(sb, "Math.trunc(");
+      if (!javascript_compile_operand(sb, lhs, precedence, false)) return false;
+      nob_sb_append_cstr(sb, " / ");
+      if (!javascript_compile_operand(sb, rhs, precedence, true)) return false;
+      nob_sb_append_cstr(sb, ")");
+      return true;
+    }
+    if (!javascript_compile_operand(sb, lhs, precedence, false)) return false;
+    if (sv_eq_str(op, "==")) {
+      nob_sb_append_cstr(sb, " === ");
+    } else if (sv_eq_str(op, "!=")) {
+      nob_sb_append_cstr(sb, " !== ");
+    } else {
+      nob_sb_appendf(sb, " "SV_Fmt" ", SV_Arg(op));
+    }
+    return javascript_compile_operand(sb, rhs, precedence, true);
+  }
+  case AST_NK_MATCH:
+    return javascript_compile_match(sb, node);
+  case AST_NK_ARRAY:
+    return javascript_compile_array(sb, node);
+  case AST_NK_INDEX:
+    return javascript_compile_index(sb, node);
+  case AST_NK_FIELD:
+    return javascript_compile_field(sb, node);
+  case AST_NK_PIPELINE:
+    return javascript_compile_pipeline(sb, node);
+  default:
+    comp_errorf(node->loc, "Unsupported %s in expression", ast_node_kind_name(node->kind));
+    return false;
+  }
+}
+
+bool javascript_compile_expr_at_depth(Nob_String_Builder *sb, AST_NodeList *expr, int depth) {
+  // nob_log(NOB_INFO, "Compiling expression...");
+  sb_add_indentation_level(sb, i, depth);
+  nob_da_foreach(AST_Node, node, expr) {
+    if (!javascript_compile_expr_node(sb, node)) {
+      comp_note(expr->items[0].loc, "Expression starts here");
+      return false;
+    }
+  }
+  return true;
+}
+
+bool javascript_compile_var_declaration(Nob_String_Builder *sb, AST_Node node, int depth) {
+  // nob_log(NOB_INFO, "Compiling variable declaration...");
+  javascript_map(sb, &node);
+  sb_add_indentation_level(sb, i, depth);
+  AST_VarDeclAttr decl = node.as.var_decl;
+  if (decl.mutable) {
+    nob_sb_append_cstr(sb, "let ");
+  } else {
+    nob_sb_append_cstr(sb, "const ");
+  }
+  sb_append_sv(sb, decl.name);
+  if (decl.expr.count == 0) {
+    if (!decl.mutable) {
+      comp_error(node.loc, "Constant variables require to be set on declaration");
+      return false;
+    }
+    nob_sb_append_cstr(sb, ";");
+    return true;
+  }
+  nob_sb_append_cstr(sb, " = ");
+  if (!javascript_compile_expr_at_depth(sb, &decl.expr, 0)) return false;
+  nob_sb_append_cstr(sb, ";");
+  return true;
+}
+
+// Replace a tail call with the reassignment of the parameters and a jump back to the start of the loop
+bool javascript_compile_tail_jump(Nob_String_Builder *sb, JS_Function *fn, AST_Node *site, int depth) {
+  AST_Node *call = optimizer_tail_site_call(site);
+  AST_Node *target = optimizer_find_fn(fn->module, call->as.fn_call.name);
+  AST_NodeList *params = &target->as.fn_decl.params;
+  AST_NodeList *args = &call->as.fn_call.params;
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_append_cstr(sb, "{ ");
+
+  if (fn->tail_group->fns.count > 1) {
+    // Merged bodies read their parameters from copies so the slots can be overwritten in order
+    nob_da_foreach(AST_Node, arg, args) {
+      nob_sb_appendf(sb, "$%zu = ", (size_t)(arg - args->items));
+      if (!javascript_compile_expr_node(sb, arg)) return false;
+      nob_sb_append_cstr(sb, "; ");
+    }
+    size_t target_index = 0;
+    for (size_t i = 0; i < fn->tail_group->fns.count; ++i) {
+      if (&fn->module->items[fn->tail_group->fns.items[i]] == target) target_index = i;
+    }
+    nob_sb_appendf(sb, "$fn = %zu; continue tail; }", target_index);
+    return true;
+  }
+
+  // Passing a parameter as itself needs no assignment, javascript_unshadow_locals made sure a local can't go by a parameter's name
+  bool *skip = NOB_REALLOC(NULL, (params->count + 1) * sizeof(bool));
+  NOB_ASSERT(skip != NULL && "Buy more RAM lol");
+  for (size_t i = 0; i < params->count; ++i) {
+    AST_Node *arg = &args->items[i];
+    skip[i] = arg->kind == AST_NK_TOKEN && arg->as.token.kind == TOK_IDENT && nob_sv_eq(arg->as.token.sv, params->items[i].as.token.sv);
+  }
+  // Temporaries are only needed when an argument reads a parameter that was already reassigned
+  bool needs_temps = false;
+  StringViews refs = {0};
+  for (size_t k = 0; k < params->count && !needs_temps; ++k) {
+    if (skip[k]) continue;
+    refs.count = 0;
+    optimizer_collect_refs(&args->items[k], &refs);
+    for (size_t i = 0; i < k && !needs_temps; ++i) {
+      if (skip[i]) continue;
+      nob_da_foreach(Nob_String_View, ref, &refs) {
+        if (nob_sv_eq(*ref, params->items[i].as.token.sv)) needs_temps = true;
+      }
+    }
+  }
+  safe_da_free(refs);
+
+  if (needs_temps) {
+    bool first = true;
+    for (size_t i = 0; i < params->count; ++i) {
+      if (skip[i]) continue;
+      nob_sb_append_cstr(sb, first ? "const " : ", ");
+      first = false;
+      nob_sb_appendf(sb, SV_Fmt"$ = ", SV_Arg(params->items[i].as.token.sv));
+      if (!javascript_compile_expr_node(sb, &args->items[i])) {
+        NOB_FREE(skip);
+        return false;
+      }
+    }
+    if (!first) nob_sb_append_cstr(sb, "; ");
+  }
+  for (size_t i = 0; i < params->count; ++i) {
+    if (skip[i]) continue;
+    Nob_String_View name = params->items[i].as.token.sv;
+    if (needs_temps) {
+      nob_sb_appendf(sb, SV_Fmt" = "SV_Fmt"$; ", SV_Arg(name), SV_Arg(name));
+    } else {
+      nob_sb_appendf(sb, SV_Fmt" = ", SV_Arg(name));
+      if (!javascript_compile_expr_node(sb, &args->items[i])) {
+        NOB_FREE(skip);
+        return false;
+      }
+      nob_sb_append_cstr(sb, "; ");
+    }
+  }
+  NOB_FREE(skip);
+  nob_sb_append_cstr(sb, "continue tail; }");
+  return true;
+}
+
+bool javascript_is_tail_site(JS_Function *fn, AST_Node *node) {
+  if (fn == NULL || fn->tail_group == NULL) return false;
+  nob_da_foreach(AST_Node*, site, &fn->tail_group->sites) {
+    if (*site == node) return true;
+  }
+  return false;
+}
+
+bool javascript_compile_statement(Nob_String_Builder *sb, JS_Function *fn, AST_Node *node, int depth);
+bool javascript_compile_fn_declaration(Nob_String_Builder *sb, JS_Function *fn, int depth);
+
+typedef enum {
+  // Bodies are the statements of an `if` chain
+  JS_DISPATCH_STATEMENTS,
+  // Bodies are the values of a match whose result the statement returns, stores or throws away
+  JS_DISPATCH_RETURN,
+  JS_DISPATCH_ASSIGN,
+  JS_DISPATCH_DISCARD,
+} JS_Dispatch_Kind;
+
+// Jump to the body for the value of the subject, from a chain of `if`s or a match that makes up a whole statement
+typedef struct {
+  JS_Function *fn;
+  JS_Dispatch_Kind kind;
+  // Variable JS_DISPATCH_ASSIGN stores the value in
+  Nob_String_View target;
+  // How the comparisons read the subject, either a variable or a `$subject` holding it
+  Nob_String_Builder subject;
+  // What the `switch` is on, `+x` when a match subject might not be a number
+  Nob_String_Builder switch_on;
+  // `===` unless the subject is converted by the comparison itself
+  const char *eq;
+  Optimizer_Cases *cases;
+  AST_NodeList *fallback;
+  // Label a body that doesn't leave the function breaks to so it skips the fallback, empty when there is none
+  Nob_String_Builder label;
+} JS_Dispatch;
+
+bool javascript_compile_statement_list(Nob_String_Builder *sb, JS_Function *fn, AST_NodeList *list, int depth);
+
+// Whether control never reaches what comes after the body
+bool javascript_dispatch_body_exits(JS_Dispatch *d, AST_NodeList *body) {
+  if (d->kind == JS_DISPATCH_RETURN) return true;
+  if (d->kind != JS_DISPATCH_STATEMENTS || body == NULL || body->count == 0) return false;
+  AST_Node *last = &body->items[body->count - 1];
+  return last->kind == AST_NK_RETURN || javascript_is_tail_site(d->fn, last);
+}
+
+// Statements of a case, the body being NULL stands for the undefined value of a match without `_`
+bool javascript_compile_dispatch_body(Nob_String_Builder *sb, JS_Dispatch *d, AST_NodeList *body, int depth) {
+  if (d->kind == JS_DISPATCH_STATEMENTS) {
+    if (body != NULL && !javascript_compile_statement_list(sb, d->fn, body, depth)) return false;
+  } else if (body != NULL || d->kind == JS_DISPATCH_RETURN || d->kind == JS_DISPATCH_ASSIGN) {
+    sb_add_indentation_level(sb, i, depth);
+    if (d->kind == JS_DISPATCH_RETURN) nob_sb_append_cstr(sb, body == NULL ? "return" : "return ");
+    if (d->kind == JS_DISPATCH_ASSIGN) nob_sb_appendf(sb, SV_Fmt" = ", SV_Arg(d->target));
+    if (body == NULL) {
+      if (d->kind == JS_DISPATCH_ASSIGN) nob_sb_append_cstr(sb, "undefined");
+    } else if (!javascript_compile_expr_node(sb, &body->items[0])) {
+      return false;
+    }
+    nob_sb_append_cstr(sb, ";\n");
+  }
+  if (d->label.count > 0 && !javascript_dispatch_body_exits(d, body)) {
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_appendf(sb, "break %s;\n", d->label.items);
+  }
+  return true;
+}
+
+// Dense values become a `switch` the engine can turn into a jump table
+bool javascript_compile_dispatch_switch(Nob_String_Builder *sb, JS_Dispatch *d, int depth) {
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_appendf(sb, "switch (%s) {\n", d->switch_on.items);
+  nob_da_foreach(Optimizer_Case, it, d->cases) {
+    bool seen = false;
+    for (Optimizer_Case *prev = d->cases->items; prev < it; ++prev) {
+      if (prev->body == it->body) seen = true;
+    }
+    if (seen) continue;
+    // Every value of the body gets its label so it is only emitted once
+    for (Optimizer_Case *other = it; other < d->cases->items + d->cases->count; ++other) {
+      if (other->body != it->body) continue;
+      if (other != it) nob_sb_append_cstr(sb, "\n");
+      sb_add_indentation_level(sb, i, depth + 1);
+      nob_sb_appendf(sb, "case %.0f:", other->value);
+    }
+    nob_sb_append_cstr(sb, " {\n");
+    if (!javascript_compile_dispatch_body(sb, d, it->body, depth + 2)) return false;
+    if (!javascript_dispatch_body_exits(d, it->body)) {
+      sb_add_indentation_level(sb, i, depth + 2);
+      nob_sb_append_cstr(sb, "break;\n");
+    }
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_append_cstr(sb, "}\n");
+  }
+  bool needs_default = d->fallback != NULL || d->kind == JS_DISPATCH_RETURN || d->kind == JS_DISPATCH_ASSIGN;
+  if (needs_default) {
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_append_cstr(sb, "default: {\n");
+    if (!javascript_compile_dispatch_body(sb, d, d->fallback, depth + 2)) return false;
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_append_cstr(sb, "}\n");
+  }
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_append_cstr(sb, "}\n");
+  return true;
+}
+
+// Sparse values get a binary search, every comparison halves the cases left
+bool javascript_compile_dispatch_tree(Nob_String_Builder *sb, JS_Dispatch *d, size_t lo, size_t hi, int depth) {
+  Optimizer_Case *cases = d->cases->items;
+  if (hi - lo > 3) {
+    size_t mid = lo + (hi - lo)/2;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_appendf(sb, "if (%s < %.0f) {\n", d->subject.items, cases[mid].value);
+    if (!javascript_compile_dispatch_tree(sb, d, lo, mid, depth + 1)) return false;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "} else {\n");
+    if (!javascript_compile_dispatch_tree(sb, d, mid, hi, depth + 1)) return false;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}\n");
+    return true;
+  }
+  for (size_t i = lo; i < hi; ++i) {
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_appendf(sb, "if (%s %s %.0f", d->subject.items, d->eq, cases[i].value);
+    while (i + 1 < hi && cases[i + 1].body == cases[i].body) {
+      nob_sb_appendf(sb, " || %s %s %.0f", d->subject.items, d->eq, cases[++i].value);
+    }
+    nob_sb_append_cstr(sb, ") {\n");
+    if (!javascript_compile_dispatch_body(sb, d, cases[i].body, depth + 1)) return false;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}\n");
+  }
+  return true;
+}
+
+// subject_expr is the match subject to evaluate once, NULL when the subject already is a variable
+bool javascript_compile_dispatch(Nob_String_Builder *sb, JS_Dispatch *d, AST_Node *subject_expr, int depth) {
+  if (optimizer_cases_are_dense(d->cases)) {
+    if (!javascript_compile_dispatch_switch(sb, d, depth)) return false;
+  } else {
+    bool needs_label = false;
+    if (d->fallback != NULL || d->kind == JS_DISPATCH_RETURN || d->kind == JS_DISPATCH_ASSIGN) {
+      nob_da_foreach(Optimizer_Case, it, d->cases) {
+        if (!javascript_dispatch_body_exits(d, it->body)) needs_label = true;
+      }
+    }
+    int inner = depth;
+    if (needs_label) {
+      // Labels only have to be unique among the ones enclosing it
+      nob_sb_appendf(&d->label, "$dispatch%d", depth);
+      nob_sb_append_null(&d->label);
+      sb_add_indentation_level(sb, i, depth);
+      nob_sb_appendf(sb, "%s: {\n", d->label.items);
+      inner = depth + 1;
+    } else if (subject_expr != NULL) {
+      sb_add_indentation_level(sb, i, depth);
+      nob_sb_append_cstr(sb, "{\n");
+      inner = depth + 1;
+    }
+    if (subject_expr != NULL) {
+      sb_add_indentation_level(sb, i, inner);
+      nob_sb_append_cstr(sb, "const $subject = ");
+      if (!javascript_compile_expr_node(sb, subject_expr)) return false;
+      nob_sb_append_cstr(sb, ";\n");
+    }
+    if (!javascript_compile_dispatch_tree(sb, d, 0, d->cases->count, inner)) return false;
+    if (d->fallback != NULL || d->kind == JS_DISPATCH_RETURN || d->kind == JS_DISPATCH_ASSIGN) {
+      // Nothing is left to skip after the fallback
+      d->label.count = 0;
+      if (!javascript_compile_dispatch_body(sb, d, d->fallback, inner)) return false;
+    }
+    if (inner != depth) {
+      sb_add_indentation_level(sb, i, depth);
+      nob_sb_append_cstr(sb, "}\n");
+    }
+  }
+  // The caller ends the statement with its own newline
+  sb->count--;
+  return true;
+}
+
+void javascript_dispatch_free(JS_Dispatch *d) {
+  nob_sb_free(d->subject);
+  nob_sb_free(d->switch_on);
+  nob_sb_free(d->label);
+}
+
+bool javascript_compile_if_chain(Nob_String_Builder *sb, JS_Function *fn, Optimizer_Dispatch *chain, int depth) {
+  JS_Dispatch d = {
+    .fn = fn,
+    .kind = JS_DISPATCH_STATEMENTS,
+    // Same comparison the `==` of the chain compiles to
+    .eq = "===",
+    .cases = &chain->cases,
+    .fallback = chain->fallback,
+  };
+  sb_append_sv(&d.subject, chain->subject);
+  nob_sb_append_null(&d.subject);
+  sb_append_sv(&d.switch_on, chain->subject);
+  nob_sb_append_null(&d.switch_on);
+  bool ok = javascript_compile_dispatch(sb, &d, NULL, depth);
+  javascript_dispatch_free(&d);
+  return ok;
+}
+
+// Match making up the whole value of the statement, worth a `switch` or a binary search over the ternaries it would be otherwise
+AST_Node *javascript_statement_match(JS_Function *fn, AST_Node *node, Optimizer_Cases *cases, AST_NodeList **fallback) {
+  AST_NodeList *exprs = NULL;
+  switch (node->kind) {
+  case AST_NK_RETURN: exprs = &node->as.ret; break;
+  case AST_NK_VAR_DECL: exprs = &node->as.var_decl.expr; break;
+  case AST_NK_ASSIGNMENT: exprs = &node->as.var_assign.expr; break;
+  case AST_NK_EXPR: exprs = &node->as.expr; break;
+  default: return NULL;
+  }
+  if (fn == NULL || exprs->count != 1) return NULL;
+  AST_Node *match = optimizer_unwrap_expr(&exprs->items[0]);
+  if (match->kind != AST_NK_MATCH || match->as.match.table != 0) return NULL;
+  if (!pass_manager_analysis_enabled(fn->pm, PASS_ANALYSIS_DISPATCH)) return NULL;
+  optimizer_match_cases(match, cases, fallback);
+  if (optimizer_cases_are_worth_dispatch(cases)) return match;
+  safe_da_free((*cases));
+  return NULL;
+}
+
+bool javascript_compile_statement_match(Nob_String_Builder *sb, JS_Function *fn, AST_Node *node, AST_Node *match, Optimizer_Cases *cases, AST_NodeList *fallback, int depth) {
+  JS_Dispatch d = {
+    .fn = fn,
+    .cases = cases,
+    .fallback = fallback,
+  };
+  switch (node->kind) {
+  case AST_NK_RETURN: d.kind = JS_DISPATCH_RETURN; break;
+  case AST_NK_EXPR: d.kind = JS_DISPATCH_DISCARD; break;
+  case AST_NK_ASSIGNMENT:
+    d.kind = JS_DISPATCH_ASSIGN;
+    d.target = node->as.var_assign.name;
+    break;
+  case AST_NK_VAR_DECL:
+    // The declaration can't stay `const` as the cases assign to it
+    d.kind = JS_DISPATCH_ASSIGN;
+    d.target = node->as.var_decl.name;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_appendf(sb, "let "SV_Fmt";\n", SV_Arg(d.target));
+    break;
+  default:
+    NEVER("Only statements holding a single expression can be a match");
+  }
+  AST_Node *subject = optimizer_unwrap_expr(&match->as.match.subject.items[0]);
+  bool is_number = javascript_is_number(subject);
+  d.eq = is_number ? "===" : "==";
+  bool ok = javascript_compile_numeric_subject(&d.switch_on, subject);
+  nob_sb_append_null(&d.switch_on);
+  bool is_variable = subject->kind == AST_NK_TOKEN;
+  if (is_variable) {
+    ok = ok && javascript_compile_expr_node(&d.subject, subject);
+  } else {
+    nob_sb_append_cstr(&d.subject, "$subject");
+  }
+  nob_sb_append_null(&d.subject);
+  ok = ok && javascript_compile_dispatch(sb, &d, is_variable ? NULL : subject, depth);
+  javascript_dispatch_free(&d);
+  return ok;
+}
+
+// Pipeline with loops making up the whole value of the statement, its steps don't need an arrow around them there
+AST_Node *javascript_statement_pipeline(AST_Node *node) {
+  AST_NodeList *exprs = NULL;
+  switch (node->kind) {
+  case AST_NK_RETURN: exprs = &node->as.ret; break;
+  case AST_NK_VAR_DECL: exprs = &node->as.var_decl.expr; break;
+  case AST_NK_ASSIGNMENT: exprs = &node->as.var_assign.expr; break;
+  case AST_NK_EXPR: exprs = &node->as.expr; break;
+  default: return NULL;
+  }
+  if (exprs->count != 1) return NULL;
+  AST_Node *pipeline = optimizer_unwrap_expr(&exprs->items[0]);
+  if (pipeline->kind != AST_NK_PIPELINE || !javascript_pipeline_has_loops(pipeline)) return NULL;
+  return pipeline;
+}
+
+bool javascript_compile_statement_pipeline(Nob_String_Builder *sb, AST_Node *node, AST_Node *pipeline, int depth) {
+  if (node->kind == AST_NK_VAR_DECL) {
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_appendf(sb, "let "SV_Fmt";\n", SV_Arg(node->as.var_decl.name));
+  }
+  // Block of its own so the names of the loops don't clash with the ones of other pipelines
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_append_cstr(sb, "{\n");
+  Nob_String_Builder value = {0};
+  if (!javascript_compile_pipeline_steps(sb, pipeline, &value, depth + 1)) return false;
+  switch (node->kind) {
+  case AST_NK_RETURN:
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_appendf(sb, "return %s;\n", value.items);
+    break;
+  case AST_NK_VAR_DECL:
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_appendf(sb, SV_Fmt" = %s;\n", SV_Arg(node->as.var_decl.name), value.items);
+    break;
+  case AST_NK_ASSIGNMENT:
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_appendf(sb, SV_Fmt" = %s;\n", SV_Arg(node->as.var_assign.name), value.items);
+    break;
+  default:
+    // Nothing left to run when the pipeline ends in a loop
+    if (nob_da_last(&pipeline->as.pipeline.stages).as.pipe_stage.kind != AST_PIPE_CALL) break;
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_appendf(sb, "%s;\n", value.items);
+    break;
+  }
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_append_cstr(sb, "}");
+  nob_sb_free(value);
+  return true;
+}
+
+bool javascript_compile_statement_list(Nob_String_Builder *sb, JS_Function *fn, AST_NodeList *list, int depth) {
+  for (size_t i = 0; i < list->count; ++i) {
+    AST_Node *it = &list->items[i];
+    Optimizer_Dispatch *chain = fn != NULL ? pass_manager_dispatch_at(fn->pm, it) : NULL;
+    if (chain != NULL) {
+      if (!javascript_compile_if_chain(sb, fn, chain, depth)) return false;
+      i += chain->length - 1;
+    } else if (!javascript_compile_statement(sb, fn, it, depth)) {
+      return false;
+    }
+    nob_sb_append_cstr(sb, "\n");
+  }
+  return true;
+}
+
+bool javascript_compile_if(Nob_String_Builder *sb, JS_Function *fn, AST_Node *node, int depth) {
+  nob_sb_append_cstr(sb, "if (");
+  if (!javascript_compile_expr_at_depth(sb, &node->as.if_stmt.cond, 0)) return false;
+  nob_sb_append_cstr(sb, ") {\n");
+  if (!javascript_compile_statement_list(sb, fn, &node->as.if_stmt.then_body, depth + 1)) return false;
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_append_cstr(sb, "}");
+  AST_NodeList *else_body = &node->as.if_stmt.else_body;
+  bool starts_chain = else_body->count == 1 && fn != NULL && pass_manager_dispatch_at(fn->pm, &else_body->items[0]) != NULL;
+  if (else_body->count == 1 && else_body->items[0].kind == AST_NK_IF && !starts_chain) {
+    nob_sb_append_cstr(sb, " else ");
+    return javascript_compile_if(sb, fn, &else_body->items[0], depth);
+  }
+  if (else_body->count > 0) {
+    nob_sb_append_cstr(sb, " else {\n");
+    if (!javascript_compile_statement_list(sb, fn, else_body, depth + 1)) return false;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}");
+  }
+  return true;
+}
+
+bool javascript_compile_statement(Nob_String_Builder *sb, JS_Function *fn, AST_Node *node, int depth) {
+  javascript_map(sb, node);
+  Optimizer_Cases cases = {0};
+  AST_NodeList *fallback = NULL;
+  AST_Node *pipeline = javascript_is_tail_site(fn, node) ? NULL : javascript_statement_pipeline(node);
+  if (pipeline != NULL) return javascript_compile_statement_pipeline(sb, node, pipeline, depth);
+  AST_Node *match = javascript_is_tail_site(fn, node) ? NULL : javascript_statement_match(fn, node, &cases, &fallback);
+  if (match != NULL) {
+    bool ok = javascript_compile_statement_match(sb, fn, node, match, &cases, fallback, depth);
+    safe_da_free(cases);
+    return ok;
+  }
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    comp_warnf(node->loc, "Dangling atom %s with no operation or usage found", token_kind_name(node->as.token.kind));
+    sb_add_indentation_level(sb, i, depth);
+    sb_append_sv(sb, node->as.token.sv);
+    nob_sb_append_cstr(sb, ";");
+    break;
+
+    // Molecules
+  case AST_NK_UNOP:
+  case AST_NK_BINOP:
+    comp_warnf(node->loc, "Result of %s is never used", ast_node_kind_name(node->kind));
+    sb_add_indentation_level(sb, i, depth);
+    if (!javascript_compile_expr_node(sb, node)) return false;
+    nob_sb_append_cstr(sb, ";");
+    break;
+  case AST_NK_FN_PARAMS_DECL:
+    NEVERf("Molecule %s should not be found in function body", ast_node_kind_name(node->kind));
+    break;
+
+    // Compounds
+  case AST_NK_EXPR:
+    if (!javascript_compile_expr_at_depth(sb, &node->as.expr, depth)) return false;
+    nob_sb_append_cstr(sb, ";");
+    break;
+  case AST_NK_VAR_DECL:
+    // TODO: Check if local variable is being re-declared
+    if (!javascript_compile_var_declaration(sb, *node, depth)) return false;
+    break;
+  case AST_NK_FN_DECL: {
+    // Nested functions the lambda-lift pass left behind escape or share variables that change, they stay closures
+    JS_Function closure = {
+      .node = node,
+      .module = fn->module,
+      .pm = fn->pm,
+    };
+    if (!javascript_compile_fn_declaration(sb, &closure, depth)) return false;
+  } break;
+  case AST_NK_ASSIGNMENT:
+    sb_add_indentation_level(sb, i, depth);
+    sb_append_sv(sb, node->as.var_assign.name);
+    nob_sb_append_cstr(sb, " = ");
+    if (!javascript_compile_expr_at_depth(sb, &node->as.var_assign.expr, 0)) return false;
+    nob_sb_append_cstr(sb, ";");
+    break;
+  case AST_NK_FN_CALL:
+    if (javascript_is_tail_site(fn, node)) return javascript_compile_tail_jump(sb, fn, node, depth);
+    sb_add_indentation_level(sb, i, depth);
+    if (!javascript_compile_fn_call(sb, node)) return false;
+    nob_sb_append_cstr(sb, ";");
+    break;
+  case AST_NK_BLOCK:
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "{\n");
+    if (!javascript_compile_statement_list(sb, fn, &node->as.block, depth + 1)) return false;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}");
+    break;
+  case AST_NK_IF:
+    sb_add_indentation_level(sb, i, depth);
+    if (!javascript_compile_if(sb, fn, node, depth)) return false;
+    break;
+  case AST_NK_WHILE:
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "while (");
+    if (!javascript_compile_expr_at_depth(sb, &node->as.while_loop.cond, 0)) return false;
+    nob_sb_append_cstr(sb, ") {\n");
+    if (!javascript_compile_statement_list(sb, fn, &node->as.while_loop.body, depth + 1)) return false;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}");
+    break;
+  case AST_NK_RETURN:
+    if (javascript_is_tail_site(fn, node)) return javascript_compile_tail_jump(sb, fn, node, depth);
+    sb_add_indentation_level(sb, i, depth);
+    if (node->as.ret.count == 0) {
+      nob_sb_append_cstr(sb, "return;");
+      break;
+    }
+    nob_sb_append_cstr(sb, "return ");
+    if (!javascript_compile_expr_at_depth(sb, &node->as.ret, 0)) return false;
+    nob_sb_append_cstr(sb, ";");
+    break;
+  case AST_NK_YIELD:
+    // Only left in the bodies of generators emitted as `function*`, state machines split at every one
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "yield ");
+    if (!javascript_compile_expr_at_depth(sb, &node->as.yield, 0)) return false;
+    nob_sb_append_cstr(sb, ";");
+    break;
+  case AST_NK_FOR:
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_appendf(sb, "for (const "SV_Fmt" of ", SV_Arg(node->as.for_loop.name));
+    if (!javascript_compile_expr_at_depth(sb, &node->as.for_loop.iter, 0)) return false;
+    nob_sb_append_cstr(sb, ") {\n");
+    if (!javascript_compile_statement_list(sb, fn, &node->as.for_loop.body, depth + 1)) return false;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}");
+    break;
+  case AST_NK_EOF:
+    NEVER("End of File should never be part of function body");
+    break;
+
+  default:
+    TODOf("Implement missing AST Node kind ('%s') compilation", ast_node_kind_name(node->kind));
+  }
+  return true;
+}
+
+void javascript_append_fn_params(Nob_String_Builder *sb, AST_FnDeclAttr *decl) {
+  nob_da_foreach(AST_Node, param, &decl->params) {
+    size_t index = param - decl->params.items;
+    if (index > 0) nob_sb_append_cstr(sb, ", ");
+    sb_append_sv(sb, param->as.token.sv);
+  }
+}
+
+// Body of a function running inside of the tail call loop, falling off the end must leave the loop
+bool javascript_compile_tail_body(Nob_String_Builder *sb, JS_Function *fn, AST_FnDeclAttr *decl, int depth) {
+  if (!javascript_compile_statement_list(sb, fn, &decl->body, depth)) return false;
+  AST_Node *last = decl->body.count > 0 ? &nob_da_last(&decl->body) : NULL;
+  if (last == NULL || (last->kind != AST_NK_RETURN && !javascript_is_tail_site(fn, last))) {
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "return;\n");
+  }
+  return true;
+}
+
+// Single function holding the bodies of every function of a mutually tail recursive group
+// Tail calls between them store the arguments in the parameter slots and switch which body runs next
+bool javascript_compile_tail_group(Nob_String_Builder *sb, JS_Function *fn, int depth) {
+  Optimizer_TailGroup *group = fn->tail_group;
+  size_t slots = 0;
+  nob_da_foreach(size_t, index, &group->fns) {
+    size_t count = fn->module->items[*index].as.fn_decl.params.count;
+    if (count > slots) slots = count;
+  }
+
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_append_cstr(sb, "function ");
+  javascript_append_tail_group_name(sb, fn->module, group);
+  nob_sb_append_cstr(sb, "($fn");
+  for (size_t i = 0; i < slots; ++i) nob_sb_appendf(sb, ", $%zu", i);
+  nob_sb_append_cstr(sb, ") {\n");
+  sb_add_indentation_level(sb, i, depth + 1);
+  nob_sb_append_cstr(sb, "tail: while (true) {\n");
+  sb_add_indentation_level(sb, i, depth + 2);
+  nob_sb_append_cstr(sb, "switch ($fn) {\n");
+
+  for (size_t i = 0; i < group->fns.count; ++i) {
+    AST_FnDeclAttr *decl = &fn->module->items[group->fns.items[i]].as.fn_decl;
+    sb_add_indentation_level(sb, i, depth + 2);
+    nob_sb_appendf(sb, "case %zu: {\n", i);
+    nob_da_foreach(AST_Node, param, &decl->params) {
+      sb_add_indentation_level(sb, i, depth + 3);
+      nob_sb_appendf(sb, "let "SV_Fmt" = $%zu;\n", SV_Arg(param->as.token.sv), (size_t)(param - decl->params.items));
+    }
+    if (!javascript_compile_tail_body(sb, fn, decl, depth + 3)) return false;
+    sb_add_indentation_level(sb, i, depth + 2);
+    nob_sb_append_cstr(sb, "}\n");
+  }
+
+  sb_add_indentation_level(sb, i, depth + 2);
+  nob_sb_append_cstr(sb, "}\n");
+  sb_add_indentation_level(sb, i, depth + 1);
+  nob_sb_append_cstr(sb, "}\n");
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_append_cstr(sb, "}\n");
+  return true;
+}
+
+void javascript_append_fn_name(Nob_String_Builder *sb, JS_Function *fn) {
+  sb_append_sv(sb, fn->node->as.fn_decl.name);
+  if (fn->memoized) nob_sb_append_cstr(sb, "$impl");
+}
+
+// Wrapper taking the function's name that only calls into `name$impl` on a cache miss
+// Single parameter functions get a dense Float64Array table for small non-negative arguments, NaN marking the empty slots
+// Everything else is keyed into a Map, the wrapper locals start with `$` so they never shadow a parameter
+void javascript_compile_memo_wrapper(Nob_String_Builder *sb, JS_Function *fn, int depth) {
+  AST_FnDeclAttr *decl = &fn->node->as.fn_decl;
+  Nob_String_View name = decl->name;
+  bool has_table = decl->params.count == 1;
+  Nob_String_View param = has_table ? decl->params.items[0].as.token.sv : SVl(NULL, 0);
+
+  if (has_table) {
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_appendf(sb, "let "SV_Fmt"$table = new Float64Array(%d).fill(NaN);\n", SV_Arg(name), JS_MEMO_TABLE_INITIAL);
+  }
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_appendf(sb, "const "SV_Fmt"$cache = new Map();\n", SV_Arg(name));
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_append_cstr(sb, "function ");
+  sb_append_sv(sb, name);
+  nob_sb_append_cstr(sb, "(");
+  javascript_append_fn_params(sb, decl);
+  nob_sb_append_cstr(sb, ") {\n");
+
+  if (has_table) {
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_appendf(sb, "if ("SV_Fmt" >= 0 && "SV_Fmt" < %d) {\n", SV_Arg(param), SV_Arg(param), JS_MEMO_TABLE_LIMIT);
+    sb_add_indentation_level(sb, i, depth + 2);
+    nob_sb_appendf(sb, "if ("SV_Fmt" >= "SV_Fmt"$table.length) {\n", SV_Arg(param), SV_Arg(name));
+    sb_add_indentation_level(sb, i, depth + 3);
+    nob_sb_appendf(sb, "const $grown = new Float64Array(Math.max("SV_Fmt" + 1, "SV_Fmt"$table.length * 2)).fill(NaN);\n", SV_Arg(param), SV_Arg(name));
+    sb_add_indentation_level(sb, i, depth + 3);
+    nob_sb_appendf(sb, "$grown.set("SV_Fmt"$table);\n", SV_Arg(name));
+    sb_add_indentation_level(sb, i, depth + 3);
+    nob_sb_appendf(sb, SV_Fmt"$table = $grown;\n", SV_Arg(name));
+    sb_add_indentation_level(sb, i, depth + 2);
+    nob_sb_append_cstr(sb, "}\n");
+    sb_add_indentation_level(sb, i, depth + 2);
+    nob_sb_appendf(sb, "const $hit = "SV_Fmt"$table["SV_Fmt"];\n", SV_Arg(name), SV_Arg(param));
+    sb_add_indentation_level(sb, i, depth + 2);
+    nob_sb_append_cstr(sb, "if ($hit === $hit) return $hit;\n");
+    sb_add_indentation_level(sb, i, depth + 2);
+    nob_sb_appendf(sb, "const $r = "SV_Fmt"$impl("SV_Fmt");\n", SV_Arg(name), SV_Arg(param));
+    // Results that aren't numbers would be mangled by the table
+    sb_add_indentation_level(sb, i, depth + 2);
+    nob_sb_appendf(sb, "if (typeof $r === 'number') "SV_Fmt"$table["SV_Fmt"] = $r;\n", SV_Arg(name), SV_Arg(param));
+    sb_add_indentation_level(sb, i, depth + 2);
+    nob_sb_append_cstr(sb, "return $r;\n");
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_append_cstr(sb, "}\n");
+  }
+
+  sb_add_indentation_level(sb, i, depth + 1);
+  nob_sb_append_cstr(sb, "const $key = ");
+  if (decl->params.count == 0) {
+    nob_sb_append_cstr(sb, "0");
+  } else {
+    nob_da_foreach(AST_Node, it, &decl->params) {
+      if (it != decl->params.items) nob_sb_append_cstr(sb, " + ',' + ");
+      sb_append_sv(sb, it->as.token.sv);
+    }
+  }
+  nob_sb_append_cstr(sb, ";\n");
+  sb_add_indentation_level(sb, i, depth + 1);
+  nob_sb_appendf(sb, "if ("SV_Fmt"$cache.has($key)) return "SV_Fmt"$cache.get($key);\n", SV_Arg(name), SV_Arg(name));
+  sb_add_indentation_level(sb, i, depth + 1);
+  nob_sb_append_cstr(sb, "const $r = ");
+  sb_append_sv(sb, name);
+  nob_sb_append_cstr(sb, "$impl(");
+  javascript_append_fn_params(sb, decl);
+  nob_sb_append_cstr(sb, ");\n");
+  sb_add_indentation_level(sb, i, depth + 1);
+  nob_sb_appendf(sb, SV_Fmt"$cache.set($key, $r);\n", SV_Arg(name));
+  sb_add_indentation_level(sb, i, depth + 1);
+  nob_sb_append_cstr(sb, "return $r;\n");
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_append_cstr(sb, "}");
+}
+
+// Generator being compiled into a state machine, `next()` resumes the body at the case of the state it was left in
+typedef struct {
+  JS_Function *fn;
+  // Cases handed out so far, 0 is the start of the body
+  size_t states;
+  size_t iterators;
+  // Variables of the body have to outlive a call to `next()` so they get declared once outside of it
+  StringViews locals;
+  // The ones in scope at the statement being lowered, a declaration hiding one of them would share its variable
+  StringViews scope;
+} JS_Generator;
+
+// Statements holding a `yield` or a `return` get split into cases, any other one compiles as it is
+bool javascript_generator_splits(AST_Node *node) {
+  if (node->kind == AST_NK_YIELD || node->kind == AST_NK_RETURN) return true;
+  if (node->kind == AST_NK_FN_DECL) return false;
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (javascript_generator_splits(it)) return true;
+    }
+  }
+  return false;
+}
+
+bool javascript_generator_declare(JS_Generator *g, Nob_String_View name, Loc loc) {
+  if (optimizer_svs_contain(&g->scope, name)) {
+    comp_errorf(loc, "`"SV_Fmt"` hides a variable of the same name, generators need different names for the variables that live across a `yield`", SV_Arg(name));
+    return false;
+  }
+  nob_da_append(&g->scope, name);
+  if (!optimizer_svs_contain(&g->locals, name)) nob_da_append(&g->locals, name);
+  return true;
+}
+
+// Cases are labels of the switch, the statements of the body are one level deeper
+void javascript_generator_case(Nob_String_Builder *sb, size_t state, int depth) {
+  sb_add_indentation_level(sb, i, depth - 1);
+  nob_sb_appendf(sb, "case %zu:\n", state);
+}
+
+void javascript_generator_jump(Nob_String_Builder *sb, size_t state, int depth) {
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_appendf(sb, "$state = %zu; continue;\n", state);
+}
+
+bool javascript_generator_lower_list(Nob_String_Builder *sb, JS_Generator *g, AST_NodeList *list, int depth);
+
+bool javascript_generator_lower(Nob_String_Builder *sb, JS_Generator *g, AST_Node *node, int depth) {
+  javascript_map(sb, node);
+  switch (node->kind) {
+  case AST_NK_VAR_DECL: {
+    if (!javascript_generator_declare(g, node->as.var_decl.name, node->loc)) return false;
+    AST_Node assign = {
+      .loc = node->loc,
+      .kind = AST_NK_ASSIGNMENT,
+    };
+    assign.as.var_assign.name = node->as.var_decl.name;
+    assign.as.var_assign.expr = node->as.var_decl.expr;
+    if (!javascript_compile_statement(sb, g->fn, &assign, depth)) return false;
+    nob_sb_append_cstr(sb, "\n");
+  } return true;
+  case AST_NK_YIELD: {
+    size_t resume = ++g->states;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "$step.value = ");
+    if (!javascript_compile_expr_at_depth(sb, &node->as.yield, 0)) return false;
+    nob_sb_append_cstr(sb, ";\n");
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_appendf(sb, "$state = %zu; return $step;\n", resume);
+    javascript_generator_case(sb, resume, depth);
+  } return true;
+  case AST_NK_RETURN:
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "$step.value = ");
+    if (node->as.ret.count == 0) {
+      nob_sb_append_cstr(sb, "undefined");
+    } else if (!javascript_compile_expr_at_depth(sb, &node->as.ret, 0)) {
+      return false;
+    }
+    nob_sb_append_cstr(sb, ";\n");
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "$step.done = true; $state = -1; return $step;\n");
+    return true;
+  case AST_NK_BLOCK: {
+    size_t scope = g->scope.count;
+    if (!javascript_generator_lower_list(sb, g, &node->as.block, depth)) return false;
+    g->scope.count = scope;
+  } return true;
+  case AST_NK_IF: {
+    size_t otherwise = ++g->states;
+    size_t end = node->as.if_stmt.else_body.count > 0 ? ++g->states : otherwise;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "if (!(");
+    if (!javascript_compile_expr_at_depth(sb, &node->as.if_stmt.cond, 0)) return false;
+    nob_sb_appendf(sb, ")) { $state = %zu; continue; }\n", otherwise);
+    size_t scope = g->scope.count;
+    if (!javascript_generator_lower_list(sb, g, &node->as.if_stmt.then_body, depth)) return false;
+    g->scope.count = scope;
+    if (end != otherwise) {
+      javascript_generator_jump(sb, end, depth);
+      javascript_generator_case(sb, otherwise, depth);
+      if (!javascript_generator_lower_list(sb, g, &node->as.if_stmt.else_body, depth)) return false;
+      g->scope.count = scope;
+    }
+    javascript_generator_case(sb, end, depth);
+  } return true;
+  case AST_NK_WHILE: {
+    size_t top = ++g->states;
+    size_t end = ++g->states;
+    javascript_generator_case(sb, top, depth);
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "if (!(");
+    if (!javascript_compile_expr_at_depth(sb, &node->as.while_loop.cond, 0)) return false;
+    nob_sb_appendf(sb, ")) { $state = %zu; continue; }\n", end);
+    size_t scope = g->scope.count;
+    if (!javascript_generator_lower_list(sb, g, &node->as.while_loop.body, depth)) return false;
+    g->scope.count = scope;
+    javascript_generator_jump(sb, top, depth);
+    javascript_generator_case(sb, end, depth);
+  } return true;
+  case AST_NK_FOR: {
+    Nob_String_Builder iter = {0};
+    nob_sb_appendf(&iter, "$iter%zu", ++g->iterators);
+    nob_da_append(&g->locals, nob_sb_to_sv(iter));
+    size_t top = ++g->states;
+    size_t end = ++g->states;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_appendf(sb, SV_Fmt" = (", SV_Arg(nob_sb_to_sv(iter)));
+    if (!javascript_compile_expr_at_depth(sb, &node->as.for_loop.iter, 0)) return false;
+    nob_sb_append_cstr(sb, ")[Symbol.iterator]();\n");
+    javascript_generator_case(sb, top, depth);
+    size_t scope = g->scope.count;
+    if (!javascript_generator_declare(g, node->as.for_loop.name, node->loc)) return false;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_appendf(sb, "{ const $next = "SV_Fmt".next(); if ($next.done) { $state = %zu; continue; } "SV_Fmt" = $next.value; }\n",
+                   SV_Arg(nob_sb_to_sv(iter)), end, SV_Arg(node->as.for_loop.name));
+    if (!javascript_generator_lower_list(sb, g, &node->as.for_loop.body, depth)) return false;
+    g->scope.count = scope;
+    javascript_generator_jump(sb, top, depth);
+    javascript_generator_case(sb, end, depth);
+  } return true;
+  default:
+    NEVERf("Statement %s can't hold a `yield` or a `return`", ast_node_kind_name(node->kind));
+  }
+}
+
+bool javascript_generator_lower_list(Nob_String_Builder *sb, JS_Generator *g, AST_NodeList *list, int depth) {
+  for (size_t i = 0; i < list->count; ++i) {
+    AST_Node *it = &list->items[i];
+    if (it->kind == AST_NK_VAR_DECL || javascript_generator_splits(it)) {
+      if (!javascript_generator_lower(sb, g, it, depth)) return false;
+      continue;
+    }
+    Optimizer_Dispatch *chain = pass_manager_dispatch_at(g->fn->pm, it);
+    for (size_t j = 0; chain != NULL && j < chain->length; ++j) {
+      if (javascript_generator_splits(&list->items[i + j])) chain = NULL;
+    }
+    if (chain != NULL) {
+      if (!javascript_compile_if_chain(sb, g->fn, chain, depth)) return false;
+      i += chain->length - 1;
+    } else if (!javascript_compile_statement(sb, g->fn, it, depth)) {
+      return false;
+    }
+    nob_sb_append_cstr(sb, "\n");
+  }
+  return true;
+}
+
+// Calling the generator only binds its arguments, every `next()` runs the body from where the last one stopped up to a `yield`
+// The object `next()` returns is the same every time, which is all `for ... of` needs and spares an allocation per step
+bool javascript_compile_generator(Nob_String_Builder *sb, JS_Function *fn, int depth) {
+  AST_FnDeclAttr *decl = &fn->node->as.fn_decl;
+  sb_add_indentation_level(sb, i, depth);
+  if (fn->pm->opts->native_generators) {
+    nob_sb_append_cstr(sb, "function* ");
+    sb_append_sv(sb, decl->name);
+    nob_sb_append_cstr(sb, "(");
+    javascript_append_fn_params(sb, decl);
+    nob_sb_append_cstr(sb, ") {\n");
+    if (!javascript_compile_statement_list(sb, fn, &decl->body, depth + 1)) return false;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}");
+    return true;
+  }
+
+  JS_Generator g = {
+    .fn = fn,
+  };
+  nob_da_foreach(AST_Node, param, &decl->params) {
+    nob_da_append(&g.scope, param->as.token.sv);
+  }
+  Nob_String_Builder body = {0};
+  bool ok = javascript_generator_lower_list(&body, &g, &decl->body, depth + 6);
+  if (ok) {
+    nob_sb_append_cstr(sb, "function ");
+    sb_append_sv(sb, decl->name);
+    nob_sb_append_cstr(sb, "(");
+    javascript_append_fn_params(sb, decl);
+    nob_sb_append_cstr(sb, ") {\n");
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_append_cstr(sb, "let $state = 0;\n");
+    if (g.locals.count > 0) {
+      sb_add_indentation_level(sb, i, depth + 1);
+      nob_sb_append_cstr(sb, "let ");
+      nob_da_foreach(Nob_String_View, it, &g.locals) {
+        if (it != g.locals.items) nob_sb_append_cstr(sb, ", ");
+        sb_append_sv(sb, (*it));
+      }
+      nob_sb_append_cstr(sb, ";\n");
+    }
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_append_cstr(sb, "const $step = { value: undefined, done: false };\n");
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_append_cstr(sb, "return {\n");
+    sb_add_indentation_level(sb, i, depth + 2);
+    nob_sb_append_cstr(sb, "next() {\n");
+    sb_add_indentation_level(sb, i, depth + 3);
+    nob_sb_append_cstr(sb, "for (;;) {\n");
+    sb_add_indentation_level(sb, i, depth + 4);
+    nob_sb_append_cstr(sb, "switch ($state) {\n");
+    javascript_generator_case(sb, 0, depth + 6);
+    javascript_map_moved(&body, sb, sb->count);
+    nob_da_append_many(sb, body.items, body.count);
+    sb_add_indentation_level(sb, i, depth + 6);
+    nob_sb_append_cstr(sb, "$state = -1;\n");
+    sb_add_indentation_level(sb, i, depth + 5);
+    nob_sb_append_cstr(sb, "default:\n");
+    sb_add_indentation_level(sb, i, depth + 6);
+    nob_sb_append_cstr(sb, "$step.value = undefined; $step.done = true; return $step;\n");
+    sb_add_indentation_level(sb, i, depth + 4);
+    nob_sb_append_cstr(sb, "}\n");
+    sb_add_indentation_level(sb, i, depth + 3);
+    nob_sb_append_cstr(sb, "}\n");
+    sb_add_indentation_level(sb, i, depth + 2);
+    nob_sb_append_cstr(sb, "},\n");
+    sb_add_indentation_level(sb, i, depth + 2);
+    nob_sb_append_cstr(sb, "[Symbol.iterator]() { return this; },\n");
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_append_cstr(sb, "};\n");
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "}");
+  }
+  nob_sb_free(body);
+  safe_da_free(g.locals);
+  safe_da_free(g.scope);
+  return ok;
+}
+
+bool javascript_compile_fn_implementation(Nob_String_Builder *sb, JS_Function *fn, int depth) {
+  // nob_log(NOB_INFO, "Compiling function declaration...");
+  AST_FnDeclAttr *decl = &fn->node->as.fn_decl;
+  Optimizer_TailGroup *group = fn->tail_group;
+  if (decl->generator) return javascript_compile_generator(sb, fn, depth);
+
+  if (group != NULL && group->fns.count > 1) {
+    size_t index = fn->node - fn->module->items;
+    if (group->fns.items[0] == index && !javascript_compile_tail_group(sb, fn, depth)) return false;
+    sb_add_indentation_level(sb, i, depth);
+    nob_sb_append_cstr(sb, "function ");
+    javascript_append_fn_name(sb, fn);
+    nob_sb_append_cstr(sb, "(");
+    javascript_append_fn_params(sb, decl);
+    nob_sb_append_cstr(sb, ") { return ");
+    javascript_append_tail_group_name(sb, fn->module, group);
+    for (size_t i = 0; i < group->fns.count; ++i) {
+      if (group->fns.items[i] == index) nob_sb_appendf(sb, "(%zu", i);
+    }
+    if (decl->params.count > 0) nob_sb_append_cstr(sb, ", ");
+    javascript_append_fn_params(sb, decl);
+    nob_sb_append_cstr(sb, "); }");
+    return true;
+  }
+
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_append_cstr(sb, decl->async ? "async function " : "function ");
+  javascript_append_fn_name(sb, fn);
+  nob_sb_append_cstr(sb, "(");
+  javascript_append_fn_params(sb, decl);
+  nob_sb_append_cstr(sb, ") {\n");
+  if (group != NULL) {
+    // Self tail calls reassign the parameters and jump back to the top instead of growing the stack
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_append_cstr(sb, "tail: while (true) {\n");
+    if (!javascript_compile_tail_body(sb, fn, decl, depth + 2)) return false;
+    sb_add_indentation_level(sb, i, depth + 1);
+    nob_sb_append_cstr(sb, "}\n");
+  } else {
+    if (!javascript_compile_statement_list(sb, fn, &decl->body, depth + 1)) return false;
+  }
+  sb_add_indentation_level(sb, i, depth);
+  nob_sb_append_cstr(sb, "}");
+  return true;
+}
+
+bool javascript_compile_fn_declaration(Nob_String_Builder *sb, JS_Function *fn, int depth) {
+  javascript_map(sb, fn->node);
+  if (!javascript_compile_fn_implementation(sb, fn, depth)) return false;
+  if (fn->memoized) {
+    nob_sb_append_cstr(sb, "\n");
+    javascript_compile_memo_wrapper(sb, fn, depth);
+  }
+  return true;
+}
+
+// Short names that are keywords or builtins the backend emits, never handed out to a mangled name
+static const char *javascript_mangle_reserved[] = {
+  "do", "if", "in", "for", "let", "new", "try", "var", "NaN", "Map", "Set",
+};
+
+// Identifiers in order of length, a letter or `_` first and digits allowed after it
+Nob_String_View javascript_short_name(size_t index) {
+  static const char first[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_";
+  static const char rest[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789";
+  Nob_String_Builder sb = {0};
+  nob_da_append(&sb, first[index % (sizeof(first) - 1)]);
+  index /= sizeof(first) - 1;
+  while (index > 0) {
+    index -= 1;
+    nob_da_append(&sb, rest[index % (sizeof(rest) - 1)]);
+    index /= sizeof(rest) - 1;
+  }
+  return nob_sb_to_sv(sb);
+}
+
+// Shortest name from next on that isn't reserved nor taken
+Nob_String_View javascript_next_short_name(size_t *next, StringViews *taken) {
+  while (true) {
+    Nob_String_View name = javascript_short_name((*next)++);
+    bool reserved = optimizer_svs_contain(taken, name);
+    carray_foreach(const char *, it, javascript_mangle_reserved) {
+      if (sv_eq_str(name, *it)) reserved = true;
+    }
+    if (!reserved) return name;
+  }
+}
+
+// Names sorted by how often they are used, most used first, so they get the shortest names
+void javascript_sort_by_uses(StringViews *names, Optimizer_Indices *uses) {
+  for (size_t i = 1; i < names->count; ++i) {
+    for (size_t j = i; j > 0 && uses->items[j - 1] < uses->items[j]; --j) {
+      Nob_String_View name = names->items[j];
+      names->items[j] = names->items[j - 1];
+      names->items[j - 1] = name;
+      size_t count = uses->items[j];
+      uses->items[j] = uses->items[j - 1];
+      uses->items[j - 1] = count;
+    }
+  }
+}
+
+bool javascript_is_ident_char(char c) {
+  return isalnum((unsigned char)c) || c == '_' || c == '$';
+}
+
+typedef struct {
+  const char *text;
+  size_t count;
+  size_t i;
+  Nob_String_Builder out;
+  // Applied to every identifier that isn't a property, can be NULL
+  Optimizer_Renames *renames;
+  // Source map marks of the builder being minified, moved along with the text they point at
+  JS_SourceMarks *marks;
+  size_t start;
+  size_t mark;
+} JS_Minifier;
+
+// Marks up to the token about to be written now point at where it goes
+void javascript_minify_marks(JS_Minifier *m) {
+  if (m->marks == NULL) return;
+  while (m->mark < m->marks->count && m->marks->items[m->mark].offset <= m->start + m->i) {
+    m->marks->items[m->mark++].offset = m->start + m->out.count;
+  }
+}
+
+void javascript_minify_code(JS_Minifier *m, bool in_template);
+
+// Copies a string literal as is, only the code inside of the `${}` of template literals gets minified
+void javascript_minify_string(JS_Minifier *m) {
+  char quote = m->text[m->i];
+  nob_da_append(&m->out, m->text[m->i++]);
+  while (m->i < m->count) {
+    char c = m->text[m->i];
+    if (c == '\\' && m->i + 1 < m->count) {
+      nob_da_append_many(&m->out, m->text + m->i, 2);
+      m->i += 2;
+      continue;
+    }
+    if (quote == '`' && c == '$' && m->i + 1 < m->count && m->text[m->i + 1] == '{') {
+      nob_da_append_many(&m->out, m->text + m->i, 2);
+      m->i += 2;
+      javascript_minify_code(m, true);
+      if (m->i < m->count) nob_da_append(&m->out, m->text[m->i++]);
+      continue;
+    }
+    nob_da_append(&m->out, c);
+    m->i += 1;
+    if (c == quote) return;
+  }
+}
+
+// Stops at the `}` closing a template substitution when in_template is set
+void javascript_minify_code(JS_Minifier *m, bool in_template) {
+  bool spaced = false;
+  size_t braces = 0;
+  while (m->i < m->count) {
+    char c = m->text[m->i];
+    if (isspace((unsigned char)c)) {
+      spaced = true;
+      m->i += 1;
+      continue;
+    }
+    if (in_template && c == '}' && braces == 0) return;
+    if (c == '{') braces += 1;
+    if (c == '}' && braces > 0) braces -= 1;
+    char last = m->out.count > 0 ? m->out.items[m->out.count - 1] : 0;
+    // `a b` would become one name and `a - -b` a decrement
+    if (spaced && ((javascript_is_ident_char(last) && javascript_is_ident_char(c)) || (last == c && (c == '+' || c == '-')))) {
+      nob_da_append(&m->out, ' ');
+    }
+    spaced = false;
+    javascript_minify_marks(m);
+    if (c == '"' || c == '\'' || c == '`') {
+      javascript_minify_string(m);
+      continue;
+    }
+    if (!javascript_is_ident_char(c)) {
+      nob_da_append(&m->out, c);
+      m->i += 1;
+      continue;
+    }
+    size_t start = m->i;
+    while (m->i < m->count && javascript_is_ident_char(m->text[m->i])) m->i += 1;
+    Nob_String_View word = nob_sv_from_parts(m->text + start, m->i - start);
+    // A single `.` in front reads a property, three spread a value
+    bool property = last == '.' && !(m->out.count > 1 && m->out.items[m->out.count - 2] == '.');
+    if (m->renames != NULL && !property && !isdigit((unsigned char)c)) word = optimizer_rename_lookup(m->renames, word);
+    sb_append_sv(&m->out, word);
+  }
+}
+
+// Rewrites the JavaScript in sb from start on without the whitespace that isn't needed to tell tokens apart
+// Every statement the backend emits ends in `;` or `}`, so line breaks never matter
+void javascript_minify(Nob_String_Builder *sb, size_t start, Optimizer_Renames *renames) {
+  JS_Minifier m = {
+    .text = sb->items + start,
+    .count = sb->count - start,
+    .renames = renames,
+    .start = start,
+  };
+  if (javascript_source_map != NULL) {
+    javascript_map_prune(sb);
+    m.marks = &javascript_source_map->marks;
+    while (m.mark < m.marks->count && m.marks->items[m.mark].offset < start) m.mark += 1;
+  }
+  javascript_minify_code(&m, false);
+  m.i = m.count;
+  javascript_minify_marks(&m);
+  sb->count = start;
+  nob_da_append_many(sb, m.out.items, m.out.count);
+  safe_da_free(m.out);
+}
+
+typedef struct {
+  // Name the fragment defines inside of the runtime scope
+  const char *name;
+  // Fragments that have to be emitted before this one, NULL terminated
+  const char *deps[4];
+  const char *code;
+  // Replaces the code in the shared runtime module, for what a module has to get differently than a script
+  const char *esm_code;
+  // Names the code declares for itself, renamed along with the fragment names when minifying, NULL terminated
+  // Keys of object literals get renamed as well, so none of them can share a name with a local
+  const char *locals[8];
+  // Whether the name is published through globalThis for the program to use
+  bool exported;
+  bool is_fn;
+} JS_RuntimeFragment;
+
+#define JS_IO_CAPACITY "65536"
+
+// Output is UTF-8 encoded into a preallocated buffer and handed to the file descriptor a block at a time,
+// what is written stays the same as with a line at a time through console.log.
+// Input is read the same way a block at a time, lines are found on the bytes and only the line itself gets decoded
+static JS_RuntimeFragment javascript_core_io_fragments[] = {
+  {
+    .name = "fs",
+    .code = "const fs = require('node:fs');\n",
+    .esm_code = "import * as fs from 'node:fs';\n",
+  },
+  {
+    .name = "utf8Encoder",
+    .code = "const utf8Encoder = new TextEncoder();\n",
+  },
+  {
+    .name = "streams",
+    .locals = {"stdin", "stdout", "stderr", "stdwarn"},
+    .code = "const stdin = 0, stdout = 1, stderr = 2, stdwarn = 3;\n",
+  },
+  { .name = "stdin",   .deps = {"streams"}, .exported = true },
+  { .name = "stdout",  .deps = {"streams"}, .exported = true },
+  { .name = "stderr",  .deps = {"streams"}, .exported = true },
+  { .name = "stdwarn", .deps = {"streams"}, .exported = true },
+  {
+    .name = "out",
+    .deps = {"fs", "utf8Encoder"},
+    .locals = {"outBytes", "outLength", "outLast", "outDrain", "outByte", "outText", "offset", "text"},
+    .code =
+    "const outBytes = new Uint8Array("JS_IO_CAPACITY");\n"
+    "let outLength = 0;\n"
+    // Last byte that reached the descriptor, flush() has to know if it left a line open
+    "let outLast = 10;\n"
+    "const outDrain = () => {\n"
+    "  let offset = 0;\n"
+    "  while (offset < outLength) {\n"
+    "    try { offset += fs.writeSync(1, outBytes, offset, outLength - offset); }\n"
+    // Nobody reads a closed pipe anymore, console.log drops the output in that case too
+    "    catch (e) { if (e.code === 'EPIPE') break; if (e.code !== 'EAGAIN') throw e; }\n"
+    "  }\n"
+    "  if (outLength > 0) outLast = outBytes[outLength - 1];\n"
+    "  outLength = 0;\n"
+    "};\n"
+    "process.on('exit', outDrain);\n"
+    "const outByte = (byte) => {\n"
+    "  if (outLength === outBytes.length) outDrain();\n"
+    "  outBytes[outLength++] = byte;\n"
+    "};\n"
+    "const outText = (text) => {\n"
+    "  const n = text.length;\n"
+    "  if (n <= outBytes.length - outLength) {\n"
+    "    let i = 0;\n"
+    "    for (; i < n; ++i) {\n"
+    "      const c = text.charCodeAt(i);\n"
+    "      if (c >= 128) break;\n"
+    "      outBytes[outLength++] = c;\n"
+    "    }\n"
+    "    if (i === n) return;\n"
+    "    text = text.substring(i);\n"
+    "  }\n"
+    "  for (;;) {\n"
+    "    const r = utf8Encoder.encodeInto(text, outBytes.subarray(outLength));\n"
+    "    outLength += r.written;\n"
+    "    if (r.read === text.length) return;\n"
+    "    text = text.substring(r.read);\n"
+    "    outDrain();\n"
+    "  }\n"
+    "};\n",
+  },
+  {
+    .name = "in",
+    .deps = {"fs"},
+    .locals = {"inBytes", "inStart", "inEnd", "inEof", "inMissed", "inFill", "grown", "n"},
+    .code =
+    // Buffer over Uint8Array for indexOf and toString over a range without making a view first
+    "let inBytes = Buffer.allocUnsafe("JS_IO_CAPACITY");\n"
+    "let inStart = 0, inEnd = 0, inEof = false;\n"
+    // Whether the last read found nothing left, for eof()
+    "let inMissed = false;\n"
+    "const inFill = () => {\n"
+    "  if (inEof) return false;\n"
+    "  if (inStart > 0) { inBytes.copyWithin(0, inStart, inEnd); inEnd -= inStart; inStart = 0; }\n"
+    "  if (inEnd === inBytes.length) {\n"
+    "    const grown = Buffer.allocUnsafe(inBytes.length * 2);\n"
+    "    inBytes.copy(grown, 0, 0, inEnd);\n"
+    "    inBytes = grown;\n"
+    "  }\n"
+    "  for (;;) {\n"
+    "    try {\n"
+    "      const n = fs.readSync(0, inBytes, inEnd, inBytes.length - inEnd, null);\n"
+    "      if (n === 0) break;\n"
+    "      inEnd += n;\n"
+    "      return true;\n"
+    "    } catch (e) {\n"
+    "      if (e.code === 'EOF') break;\n"
+    "      if (e.code !== 'EAGAIN') throw e;\n"
+    "    }\n"
+    "  }\n"
+    "  inEof = true;\n"
+    "  return false;\n"
+    "};\n",
+  },
+  {
+    .name = "read_byte",
+    .deps = {"in"},
+    .exported = true,
+    .is_fn = true,
+    .code =
+    "const read_byte = () => {\n"
+    "  inMissed = inStart === inEnd && !inFill();\n"
+    "  return inMissed ? -1 : inBytes[inStart++];\n"
+    "};\n",
+  },
+  {
+    .name = "read_line",
+    .deps = {"in"},
+    .locals = {"scan", "nl", "end", "line"},
+    .exported = true,
+    .is_fn = true,
+    .code =
+    // The line comes without its line break, -1 once there is no input left
+    "const read_line = () => {\n"
+    "  let scan = inStart;\n"
+    "  for (;;) {\n"
+    "    const nl = inBytes.indexOf(10, scan);\n"
+    "    if (nl !== -1 && nl < inEnd) {\n"
+    "      const end = nl > inStart && inBytes[nl - 1] === 13 ? nl - 1 : nl;\n"
+    "      const line = inBytes.toString('utf8', inStart, end);\n"
+    "      inStart = nl + 1;\n"
+    "      inMissed = false;\n"
+    "      return line;\n"
+    "    }\n"
+    "    scan = inEnd - inStart;\n"
+    "    if (!inFill()) break;\n"
+    "  }\n"
+    "  inMissed = inStart === inEnd;\n"
+    "  if (inMissed) return -1;\n"
+    "  const line = inBytes.toString('utf8', inStart, inEnd);\n"
+    "  inStart = inEnd;\n"
+    "  return line;\n"
+    "};\n",
+  },
+  {
+    .name = "read_int",
+    .deps = {"read_byte"},
+    .locals = {"b", "sign", "n"},
+    .exported = true,
+    .is_fn = true,
+    .code =
+    // Skips whitespace like scanf's %d and leaves whatever follows the digits unread, 0 once there is no input left
+    "const read_int = () => {\n"
+    "  let b = read_byte();\n"
+    "  while (b === 32 || (b >= 9 && b <= 13)) b = read_byte();\n"
+    "  if (b === -1) return 0;\n"
+    "  let sign = 1;\n"
+    "  if (b === 45 || b === 43) { if (b === 45) sign = -1; b = read_byte(); }\n"
+    "  let n = 0;\n"
+    "  while (b >= 48 && b <= 57) { n = n * 10 + (b - 48); b = read_byte(); }\n"
+    "  if (b !== -1) inStart -= 1;\n"
+    "  inMissed = false;\n"
+    "  return sign * n;\n"
+    "};\n",
+  },
+  {
+    .name = "read_all",
+    .deps = {"in"},
+    .locals = {"all"},
+    .exported = true,
+    .is_fn = true,
+    .code =
+    "const read_all = () => {\n"
+    "  while (inFill()) {}\n"
+    "  const all = inBytes.toString('utf8', inStart, inEnd);\n"
+    "  inStart = inEnd;\n"
+    "  inMissed = all.length === 0;\n"
+    "  return all;\n"
+    "};\n",
+  },
+  {
+    .name = "eof",
+    .deps = {"in"},
+    .exported = true,
+    .is_fn = true,
+    .code = "const eof = () => inMissed ? 1 : 0;\n",
+  },
+  {
+    .name = "print",
+    .deps = {"out"},
+    .locals = {"args", "arg"},
+    .exported = true,
+    .is_fn = true,
+    .code =
+    "const print = (...args) => {\n"
+    "  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);\n"
+    "};\n",
+  },
+  {
+    .name = "println",
+    .deps = {"out"},
+    .locals = {"args", "arg"},
+    .exported = true,
+    .is_fn = true,
+    .code =
+    "const println = (...args) => {\n"
+    "  for (const arg of args) outText(typeof arg === 'string' ? arg : `${arg}`);\n"
+    "  outByte(10);\n"
+    "};\n",
+  },
+  {
+    .name = "putchar",
+    .deps = {"out"},
+    .locals = {"chars", "ch"},
+    .exported = true,
+    .is_fn = true,
+    .code =
+    "const putchar = (...chars) => {\n"
+    "  for (const ch of chars) outByte(ch);\n"
+    "};\n",
+  },
+  {
+    .name = "putchars",
+    .deps = {"putchar"},
+    .locals = {"chars"},
+    .exported = true,
+    .is_fn = true,
+    .code =
+    "const putchars = (...chars) => {\n"
+    "  putchar(...chars);\n"
+    "  return chars.length;\n"
+    "};\n",
+  },
+  // Writes of values the compiler knows the type of, they skip print's checks and conversions
+  {
+    .name = "$write",
+    .deps = {"out"},
+    .exported = true,
+    .is_fn = true,
+    .code = "const $write = outText;\n",
+  },
+  {
+    .name = "$writeNumber",
+    .deps = {"out"},
+    .locals = {"n", "rest", "end"},
+    .exported = true,
+    .is_fn = true,
+    // Integers go into the buffer a digit at a time without becoming a string first
+    .code =
+    "const $writeNumber = (n) => {\n"
+    "  if ((n | 0) !== n) { outText(`${n}`); return; }\n"
+    "  if (outLength + 11 > outBytes.length) outDrain();\n"
+    "  if (n < 0) { outBytes[outLength++] = 45; n = -n; }\n"
+    "  let end = outLength + 1;\n"
+    "  for (let rest = n; rest >= 10; rest = (rest / 10) | 0) end += 1;\n"
+    "  outLength = end;\n"
+    "  do { outBytes[--end] = 48 + n % 10; n = (n / 10) | 0; } while (n > 0);\n"
+    "};\n",
+  },
+  // What is buffered goes out without ending the line, for threads of core:par that share the descriptor
+  {
+    .name = "$drain",
+    .deps = {"out"},
+    .exported = true,
+    .is_fn = true,
+    .code = "const $drain = () => outDrain();\n",
+  },
+  {
+    .name = "flush",
+    .deps = {"out"},
+    .exported = true,
+    .is_fn = true,
+    .code =
+    "const flush = () => {\n"
+    "  if ((outLength > 0 ? outBytes[outLength - 1] : outLast) !== 10) outByte(10);\n"
+    "  outDrain();\n"
+    "};\n",
+  },
+};
+
+// Reads and writes go through buffers the program allocated once, typed arrays over bytes, so streaming a file allocates nothing
+static JS_RuntimeFragment javascript_core_fs_fragments[] = {
+  {
+    .name = "fs",
+    .code = "const fs = require('node:fs');\n",
+    .esm_code = "import * as fs from 'node:fs';\n",
+  },
+  {
+    .name = "fs_buffer",
+    .locals = {"size"},
+    .exported = true,
+    .is_fn = true,
+    .code = "const fs_buffer = (size) => new Uint8Array(size);\n",
+  },
+  {
+    .name = "fs_open",
+    .deps = {"fs"},
+    .locals = {"path", "flags"},
+    .exported = true,
+    .is_fn = true,
+    // -1 when the file can't be opened, like open(2)
+    .code =
+    "const fs_open = (path, flags = 'r') => {\n"
+    "  try { return fs.openSync(path, flags); } catch { return -1; }\n"
+    "};\n",
+  },
+  {
+    .name = "fs_close",
+    .deps = {"fs"},
+    .locals = {"fd"},
+    .exported = true,
+    .is_fn = true,
+    .code = "const fs_close = (fd) => { fs.closeSync(fd); };\n",
+  },
+  {
+    .name = "fs_size",
+    .deps = {"fs"},
+    .locals = {"fd"},
+    .exported = true,
+    .is_fn = true,
+    .code = "const fs_size = (fd) => fs.fstatSync(fd).size;\n",
+  },
+  {
+    .name = "fs_read",
+    .deps = {"fs"},
+    .locals = {"fd", "buf", "count"},
+    .exported = true,
+    .is_fn = true,
+    // Fills the start of buf from where the last read stopped, 0 once the file ended
+    .code =
+    "const fs_read = (fd, buf, count = buf.byteLength) => {\n"
+    "  for (;;) {\n"
+    "    try { return fs.readSync(fd, buf, 0, count, null); }\n"
+    "    catch (e) { if (e.code === 'EOF') return 0; if (e.code !== 'EAGAIN') throw e; }\n"
+    "  }\n"
+    "};\n",
+  },
+  {
+    .name = "fs_write",
+    .deps = {"fs"},
+    .locals = {"fd", "data", "count", "offset"},
+    .exported = true,
+    .is_fn = true,
+    // Strings go out as UTF-8, buffers up to count bytes, either way all of it before returning
+    .code =
+    "const fs_write = (fd, data, count) => {\n"
+    "  if (typeof data === 'string') data = Buffer.from(data);\n"
+    "  if (count === undefined) count = data.byteLength;\n"
+    "  let offset = 0;\n"
+    "  while (offset < count) {\n"
+    "    try { offset += fs.writeSync(fd, data, offset, count - offset); }\n"
+    "    catch (e) { if (e.code !== 'EAGAIN') throw e; }\n"
+    "  }\n"
+    "  return count;\n"
+    "};\n",
+  },
+  {
+    .name = "fs_chunks",
+    .deps = {"fs_read"},
+    .locals = {"fd", "buf", "step"},
+    .exported = true,
+    .is_fn = true,
+    // `for (n in fs_chunks(fd, buf))` sees the first n bytes of buf refilled every step, one step object for the whole file
+    .code =
+    "const fs_chunks = (fd, buf) => {\n"
+    "  const step = { value: 0, done: false };\n"
+    "  return {\n"
+    "    next() { step.value = fs_read(fd, buf); step.done = step.value === 0; return step; },\n"
+    "    [Symbol.iterator]() { return this; },\n"
+    "  };\n"
+    "};\n",
+  },
+  {
+    .name = "fs_read_file",
+    .deps = {"fs"},
+    .locals = {"path"},
+    .exported = true,
+    .is_fn = true,
+    // The bytes as they are, decoding is up to the program
+    .code = "const fs_read_file = (path) => fs.readFileSync(path);\n",
+  },
+  // Writes asked for during the same turn of the event loop go out together once it ends,
+  // all of the ones to a descriptor in a single writev and in the order they were made
+  {
+    .name = "ioWrites",
+    .deps = {"fs"},
+    .locals = {"ioPending", "ioBusy", "ioScheduled", "ioSchedule", "ioFlush", "ioWritev", "writes", "chunks"},
+    .code =
+    "const ioPending = new Map();\n"
+    // Descriptors with a writev in flight, what gets queued for them meanwhile waits for it to finish
+    "const ioBusy = new Set();\n"
+    "let ioScheduled = false;\n"
+    "const ioSchedule = () => {\n"
+    "  if (ioScheduled) return;\n"
+    "  ioScheduled = true;\n"
+    "  setImmediate(ioFlush);\n"
+    "};\n"
+    "const ioFlush = () => {\n"
+    "  ioScheduled = false;\n"
+    "  for (const [fd, writes] of ioPending) {\n"
+    "    if (ioBusy.has(fd)) continue;\n"
+    "    ioPending.delete(fd);\n"
+    "    ioBusy.add(fd);\n"
+    "    ioWritev(fd, writes);\n"
+    "  }\n"
+    "};\n"
+    "const ioWritev = (fd, writes) => {\n"
+    "  const chunks = writes.map((write) => write.bytes);\n"
+    "  const next = (err, written) => {\n"
+    "    if (err && err.code === 'EAGAIN') return fs.writev(fd, chunks, next);\n"
+    "    if (!err) {\n"
+    "      while (written > 0 && chunks.length > 0) {\n"
+    "        if (written < chunks[0].byteLength) { chunks[0] = chunks[0].subarray(written); break; }\n"
+    "        written -= chunks[0].byteLength;\n"
+    "        chunks.shift();\n"
+    "      }\n"
+    "      if (chunks.length > 0) return fs.writev(fd, chunks, next);\n"
+    "    }\n"
+    "    for (const write of writes) {\n"
+    "      if (err) write.fail(err); else write.done(write.bytes.byteLength);\n"
+    "    }\n"
+    "    ioBusy.delete(fd);\n"
+    "    if (ioPending.has(fd)) ioSchedule();\n"
+    "  };\n"
+    "  fs.writev(fd, chunks, next);\n"
+    "};\n",
+  },
+  {
+    .name = "fs_write_async",
+    .deps = {"ioWrites"},
+    .locals = {"fd", "data", "count", "queue"},
+    .exported = true,
+    .is_fn = true,
+    // Resolves to the amount of bytes written, a buffer has to stay untouched until then
+    .code =
+    "const fs_write_async = (fd, data, count) => new Promise((resolve, reject) => {\n"
+    "  if (typeof data === 'string') data = Buffer.from(data);\n"
+    "  else data = new Uint8Array(data.buffer, data.byteOffset, count === undefined ? data.byteLength : count);\n"
+    "  const queue = ioPending.get(fd);\n"
+    "  const write = { bytes: data, done: resolve, fail: reject };\n"
+    "  if (queue === undefined) ioPending.set(fd, [write]); else queue.push(write);\n"
+    "  ioSchedule();\n"
+    "});\n",
+  },
+  {
+    .name = "fs_read_async",
+    .deps = {"fs"},
+    .locals = {"fd", "buf"},
+    .exported = true,
+    .is_fn = true,
+    // Reads run on the libuv thread pool as soon as they are asked for, the ones of different descriptors overlap
+    .code =
+    "const fs_read_async = (fd, buf) => new Promise((resolve, reject) => {\n"
+    "  fs.read(fd, buf, 0, buf.byteLength, null, (err, n) => err ? reject(err) : resolve(n));\n"
+    "});\n",
+  },
+  {
+    .name = "fs_read_file_async",
+    .deps = {"fs"},
+    .locals = {"path"},
+    .exported = true,
+    .is_fn = true,
+    .code = "const fs_read_file_async = (path) => fs.promises.readFile(path);\n",
+  },
+  {
+    .name = "fs_write_file_async",
+    .deps = {"fs"},
+    .locals = {"path", "data"},
+    .exported = true,
+    .is_fn = true,
+    .code = "const fs_write_file_async = (path, data) => fs.promises.writeFile(path, data).then(() => typeof data === 'string' ? Buffer.byteLength(data) : data.byteLength);\n",
+  },
+};
+
+// Work is split between a worker_threads pool and the calling thread, which blocks in Atomics.wait until the pool is done.
+// Workers run the program file itself, the epilogue sends them to wait for jobs instead of running main
+static JS_RuntimeFragment javascript_core_par_fragments[] = {
+  {
+    .name = "fs",
+    .code = "const fs = require('node:fs');\n",
+    .esm_code = "import * as fs from 'node:fs';\n",
+  },
+  {
+    .name = "os",
+    .code = "const os = require('node:os');\n",
+    .esm_code = "import * as os from 'node:os';\n",
+  },
+  {
+    .name = "worker_threads",
+    .code = "const worker_threads = require('node:worker_threads');\n",
+    .esm_code = "import * as worker_threads from 'node:worker_threads';\n",
+  },
+  {
+    .name = "par",
+    .deps = {"fs", "os", "worker_threads"},
+    .locals = {"par", "parWork", "parPool", "parShare", "parRun", "start", "end", "failure"},
+    .code =
+    "const par = { entry: null, fns: [], drain: null, globals: null, pool: null };\n"
+    // Chunks get claimed from a shared cursor, a share of what is left each time so the first ones are big
+    // and the last ones small enough to even out functions that take longer for some items than others
+    "const parWork = (job) => {\n"
+    "  const fn = par.fns[job.task];\n"
+    "  for (;;) {\n"
+    "    const start = Atomics.load(job.ctl, 0);\n"
+    "    if (start >= job.n) return;\n"
+    "    const end = Math.min(job.n, start + Math.ceil((job.n - start) / (2 * job.threads)));\n"
+    "    if (Atomics.compareExchange(job.ctl, 0, start, end) !== start) continue;\n"
+    "    if (job.output === null) {\n"
+    "      for (let i = start; i < end; ++i) fn(i);\n"
+    "      continue;\n"
+    "    }\n"
+    "    for (let i = start; i < end; ++i) {\n"
+    "      const value = fn(job.input[i]);\n"
+    "      if (typeof value !== 'number') throw new Error(`par_map: ${fn.name} has to return numbers, got ${value}`);\n"
+    "      job.output[i] = value;\n"
+    "    }\n"
+    "  }\n"
+    "};\n"
+    // As many threads as CPUs unless DWOC_PAR_THREADS says otherwise, the calling thread being one of them
+    "const parPool = () => {\n"
+    "  if (par.pool !== null) return par.pool;\n"
+    "  const env = Number(process.env.DWOC_PAR_THREADS);\n"
+    "  const threads = env > 0 ? env : os.availableParallelism ? os.availableParallelism() : os.cpus().length;\n"
+    "  par.pool = [];\n"
+    "  const globals = par.globals();\n"
+    "  for (let i = 1; i < threads; ++i) {\n"
+    "    const worker = new worker_threads.Worker(par.entry, { workerData: { dwocPar: true, globals: globals } });\n"
+    "    worker.unref();\n"
+    "    par.pool.push(worker);\n"
+    "  }\n"
+    "  return par.pool;\n"
+    "};\n"
+    // Numbers and typed arrays go to the workers through shared memory, anything else gets cloned
+    "const parShare = (items) => {\n"
+    "  if (ArrayBuffer.isView(items) && items.buffer instanceof SharedArrayBuffer) return items;\n"
+    "  let shared = null;\n"
+    "  if (ArrayBuffer.isView(items)) {\n"
+    "    shared = new (items instanceof Buffer ? Uint8Array : items.constructor)(new SharedArrayBuffer(items.byteLength));\n"
+    "  } else {\n"
+    "    for (const item of items) if (typeof item !== 'number') return items;\n"
+    "    shared = new Float64Array(new SharedArrayBuffer(items.length * 8));\n"
+    "  }\n"
+    "  shared.set(items);\n"
+    "  return shared;\n"
+    "};\n"
+    "const parRun = (fn, n, input, output) => {\n"
+    "  const task = par.fns.indexOf(fn);\n"
+    "  if (task === -1) throw new Error(`core:par: ${fn.name} was not compiled as a worker entry point`);\n"
+    "  const pool = parPool();\n"
+    "  const job = { task: task, n: n, input: input, output: output, threads: pool.length + 1, ctl: new Int32Array(new SharedArrayBuffer(12)) };\n"
+    "  for (const worker of pool) worker.postMessage(job);\n"
+    "  let failure = null;\n"
+    "  try { parWork(job); } catch (e) { failure = e; Atomics.store(job.ctl, 0, n); }\n"
+    "  for (;;) {\n"
+    "    const done = Atomics.load(job.ctl, 1);\n"
+    "    if (done === pool.length) break;\n"
+    "    Atomics.wait(job.ctl, 1, done);\n"
+    "  }\n"
+    "  if (failure !== null) throw failure;\n"
+    "  if (Atomics.load(job.ctl, 2) !== 0) throw new Error('core:par: a worker failed');\n"
+    "};\n",
+  },
+  // Globals of the program are evaluated once by the calling thread, workers start with their values instead of running
+  // the initializers again, which could read input or print
+  {
+    .name = "$parGlobal",
+    .deps = {"worker_threads"},
+    .locals = {"index", "init"},
+    .exported = true,
+    .is_fn = true,
+    .code =
+    "const $parGlobal = (index, init) => {\n"
+    "  if (worker_threads.isMainThread || !worker_threads.workerData || !worker_threads.workerData.dwocPar) return init();\n"
+    "  return worker_threads.workerData.globals[index];\n"
+    "};\n",
+  },
+  {
+    .name = "$parEntry",
+    .deps = {"par", "$parGlobal"},
+    .locals = {"file", "table"},
+    .exported = true,
+    .is_fn = true,
+    // Returns whether this thread is a worker of the pool, with the functions that can be sent to it.
+    // A worker drains what it printed before counting itself done, the calling thread goes on printing right after
+    .code =
+    "const $parEntry = (file, table, drain, globals) => {\n"
+    "  par.entry = file;\n"
+    "  par.fns = table;\n"
+    "  par.drain = drain;\n"
+    "  par.globals = globals;\n"
+    "  if (worker_threads.isMainThread || !worker_threads.workerData || !worker_threads.workerData.dwocPar) return false;\n"
+    "  worker_threads.parentPort.on('message', (job) => {\n"
+    "    try { parWork(job); }\n"
+    "    catch (e) {\n"
+    "      Atomics.store(job.ctl, 2, 1);\n"
+    "      Atomics.store(job.ctl, 0, job.n);\n"
+    "      fs.writeSync(2, `${e && e.stack || e}\\n`);\n"
+    "    } finally {\n"
+    "      if (par.drain !== null) par.drain();\n"
+    "      Atomics.add(job.ctl, 1, 1);\n"
+    "      Atomics.notify(job.ctl, 1);\n"
+    "    }\n"
+    "  });\n"
+    "  return true;\n"
+    "};\n",
+  },
+  {
+    .name = "par_map",
+    .deps = {"$parEntry"},
+    .locals = {"fn", "items", "workers", "results"},
+    .exported = true,
+    .is_fn = true,
+    // Results are numbers in a Float64Array, shared with the workers so they write them in place
+    .code =
+    "const par_map = (fn, items) => {\n"
+    "  if (!ArrayBuffer.isView(items) && !Array.isArray(items)) items = Array.from(items);\n"
+    "  const workers = parPool().length;\n"
+    "  const results = new Float64Array(workers > 0 ? new SharedArrayBuffer(items.length * 8) : items.length);\n"
+    "  parRun(fn, items.length, workers > 0 ? parShare(items) : items, results);\n"
+    "  return results;\n"
+    "};\n",
+  },
+  {
+    .name = "par_for",
+    .deps = {"$parEntry"},
+    .locals = {"count", "fn"},
+    .exported = true,
+    .is_fn = true,
+    // Calls fn(i) for every i from 0 up to count
+    .code = "const par_for = (count, fn) => { parRun(fn, count, null, null); };\n",
+  },
+};
+
+// Names of the functions handed to par_map and par_for, which get a worker entry point
+// They have to be top level functions, anything else can't be looked up again by a worker
+bool javascript_par_entries(AST_NodeList *module, AST_NodeList *list, StringViews *entries) {
+  nob_da_foreach(AST_Node, it, list) {
+    if (it->kind == AST_NK_FN_CALL) {
+      Nob_String_View name = it->as.fn_call.name;
+      size_t fn_arg = sv_eq_str(name, "par_map") ? 0 : 1;
+      if (sv_eq_str(name, "par_map") || sv_eq_str(name, "par_for")) {
+        if (it->as.fn_call.params.count != 2) {
+          comp_errorf(it->loc, SV_Fmt" takes 2 arguments but got %zu", SV_Arg(name), it->as.fn_call.params.count);
+          return false;
+        }
+        AST_Node *fn = optimizer_unwrap_expr(&it->as.fn_call.params.items[fn_arg]);
+        bool is_ident = fn->kind == AST_NK_TOKEN && fn->as.token.kind == TOK_IDENT;
+        if (!is_ident || optimizer_find_fn(module, fn->as.token.sv) == NULL) {
+          comp_errorf(fn->loc, "The function given to "SV_Fmt" has to be the name of a top level function so the workers can run it", SV_Arg(name));
+          return false;
+        }
+        if (!optimizer_svs_contain(entries, fn->as.token.sv)) nob_da_append(entries, fn->as.token.sv);
+      }
+    }
+    AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+    size_t lists_count = ast_node_child_lists(it, lists);
+    for (size_t i = 0; i < lists_count; ++i) {
+      if (!javascript_par_entries(module, lists[i], entries)) return false;
+    }
+  }
+  return true;
+}
+
+// Globals the workers get from the calling thread, the ones bound to a literal are as cheap to evaluate again
+bool javascript_is_par_global(AST_Node *node) {
+  if (node->kind != AST_NK_VAR_DECL) return false;
+  AST_NodeList *expr = &node->as.var_decl.expr;
+  if (expr->count != 1) return expr->count > 0;
+  AST_Node *value = optimizer_unwrap_expr(&expr->items[0]);
+  return !optimizer_is_literal(value) && !(value->kind == AST_NK_TOKEN && value->as.token.kind == TOK_STR);
+}
+
+bool javascript_check_core_par(AST_NodeList *module) {
+  StringViews entries = {0};
+  bool ok = javascript_par_entries(module, module, &entries);
+  safe_da_free(entries);
+  // Every worker would have a copy of its own, what one of them wrote nobody else would see
+  nob_da_foreach(AST_Node, it, module) {
+    if (it->kind != AST_NK_VAR_DECL || !it->as.var_decl.mutable) continue;
+    comp_errorf(it->loc, "Global `"SV_Fmt"` can't be mutable in a program using core:par, workers don't share globals", SV_Arg(it->as.var_decl.name));
+    ok = false;
+  }
+  return ok;
+}
+
+typedef struct {
+  // Name given to `use`
+  const char *name;
+  JS_RuntimeFragment *fragments;
+  size_t count;
+  // Validates how the program uses the library before its runtime gets emitted
+  bool (*check)(AST_NodeList *module);
+} JS_Library;
+
+static JS_Library javascript_libraries[] = {
+  { .name = "core:io", .fragments = javascript_core_io_fragments, .count = NOB_ARRAY_LEN(javascript_core_io_fragments) },
+  { .name = "core:fs", .fragments = javascript_core_fs_fragments, .count = NOB_ARRAY_LEN(javascript_core_fs_fragments) },
+  {
+    .name = "core:par",
+    .fragments = javascript_core_par_fragments,
+    .count = NOB_ARRAY_LEN(javascript_core_par_fragments),
+    .check = javascript_check_core_par,
+  },
+};
+
+JS_Library *javascript_find_library(Nob_String_View name) {
+  carray_foreach(JS_Library, it, javascript_libraries) {
+    if (sv_eq_str(name, it->name)) return it;
+  }
+  return NULL;
+}
+
+JS_RuntimeFragment *javascript_find_runtime_fragment(JS_RuntimeFragment *fragments, size_t count, const char *name) {
+  for (size_t i = 0; i < count; ++i) {
+    if (strcmp(fragments[i].name, name) == 0) return &fragments[i];
+  }
+  return NULL;
+}
+
+// Mark a fragment and everything it depends on as needed
+void javascript_mark_runtime_fragment(JS_RuntimeFragment *fragments, size_t count, bool *needed, size_t index) {
+  if (needed[index]) return;
+  needed[index] = true;
+  for (const char *const *dep = fragments[index].deps; *dep != NULL; ++dep) {
+    JS_RuntimeFragment *f = javascript_find_runtime_fragment(fragments, count, *dep);
+    if (f == NULL) NEVERf("Runtime fragment `%s` depends on unknown fragment `%s`", fragments[index].name, *dep);
+    javascript_mark_runtime_fragment(fragments, count, needed, f - fragments);
+  }
+}
+
+// The whole runtime as a module, the same for every program so it only gets parsed and cached once
+void javascript_esm_runtime(Nob_String_Builder *sb) {
+  nob_sb_append_cstr(sb, "// Generated by dwoc, shared by the programs compiled with --esm next to it\n");
+  // Libraries can define the same helper, like `fs`, it only gets declared by the first one
+  StringViews emitted = {0};
+  carray_foreach(JS_Library, lib, javascript_libraries) {
+    for (JS_RuntimeFragment *it = lib->fragments; it < lib->fragments + lib->count; ++it) {
+      if (optimizer_svs_contain(&emitted, SV(it->name))) continue;
+      nob_da_append(&emitted, SV(it->name));
+      const char *code = it->esm_code != NULL ? it->esm_code : it->code;
+      if (code != NULL) nob_sb_append_cstr(sb, code);
+    }
+  }
+  safe_da_free(emitted);
+  nob_sb_append_cstr(sb, "export {\n");
+  carray_foreach(JS_Library, lib, javascript_libraries) {
+    for (JS_RuntimeFragment *it = lib->fragments; it < lib->fragments + lib->count; ++it) {
+      if (it->exported) nob_sb_appendf(sb, "  %s,\n", it->name);
+    }
+  }
+  nob_sb_append_cstr(sb, "};\n");
+}
+
+bool javascript_write_esm_runtime(Context *ctx, const char *output_path) {
+  bool imports = false;
+  nob_da_foreach(Fn, it, &ctx->fns) imports = imports || javascript_find_library(it->library) != NULL;
+  nob_da_foreach(Var, it, &ctx->vars) imports = imports || javascript_find_library(it->library) != NULL;
+  if (!imports) return true;
+
+  Nob_String_Builder path = {0};
+  const char *name = nob_path_name(output_path);
+  nob_sb_append_buf(&path, output_path, name - output_path);
+  nob_sb_append_cstr(&path, JS_ESM_RUNTIME);
+  nob_sb_append_null(&path);
+  Nob_String_Builder runtime = {0};
+  javascript_esm_runtime(&runtime);
+  // Left untouched when it is already there so whatever cached it stays valid
+  Nob_String_Builder existing = {0};
+  bool ok = true;
+  bool current = nob_file_exists(path.items) == 1 && nob_read_entire_file(path.items, &existing)
+    && existing.count == runtime.count && memcmp(existing.items, runtime.items, runtime.count) == 0;
+  if (!current) ok = nob_write_entire_file(path.items, runtime.items, runtime.count);
+  nob_sb_free(existing);
+  nob_sb_free(runtime);
+  nob_sb_free(path);
+  return ok;
+}
+
+void javascript_import_library(Nob_String_Builder *sb, Context *ctx, JS_Library *lib) {
+  JS_RuntimeFragment *fragments = lib->fragments;
+  size_t fragments_count = lib->count;
+  Nob_String_View library = SV(lib->name);
+  bool needed[fragments_count];
+  memset(needed, 0, sizeof(needed));
+
+  StringViews refs = {0};
+  nob_da_foreach(AST_Node, it, &ctx->module) {
+    optimizer_collect_refs(it, &refs);
+    // The epilogue flushes whatever was left buffered once main returns
+    if (it->kind == AST_NK_FN_DECL && sv_eq_str(it->as.fn_decl.name, "main")) nob_da_append(&refs, SV("flush"));
+  }
+  // Workers of core:par drain their output at the end of every job
+  if (optimizer_svs_contain(&refs, SV("par_map")) || optimizer_svs_contain(&refs, SV("par_for"))) nob_da_append(&refs, SV("$drain"));
+  for (size_t i = 0; i < fragments_count; ++i) {
+    if (!fragments[i].exported) continue;
+    nob_da_foreach(Nob_String_View, ref, &refs) {
+      if (!sv_eq_str(*ref, fragments[i].name)) continue;
+      javascript_mark_runtime_fragment(fragments, fragments_count, needed, i);
+      break;
+    }
+  }
+  safe_da_free(refs);
+
+  // TODO: These variables should be defined before we reach compilation stage for the sake of type checking
+  for (size_t i = 0; i < fragments_count; ++i) {
+    if (!needed[i] || !fragments[i].exported) continue;
+    if (fragments[i].is_fn) {
+      Fn io_fn = {
+        .name = SV(fragments[i].name),
+        .library = library,
+      };
+      nob_da_append(&ctx->fns, io_fn);
+    } else {
+      Var io_var = {
+        .name = SV(fragments[i].name),
+        .immutable = true,
+        .library = library,
+      };
+      nob_da_append(&ctx->vars, io_var);
+    }
+  }
+
+  bool any_needed = false;
+  for (size_t i = 0; i < fragments_count; ++i) any_needed = any_needed || needed[i];
+  if (!any_needed) return;
+
+  if (ctx->opts.esm) {
+    // Bound lexically from the shared runtime module instead of looked up on globalThis
+    nob_sb_append_cstr(sb, "import { ");
+    bool first = true;
+    for (size_t i = 0; i < fragments_count; ++i) {
+      if (!needed[i] || !fragments[i].exported) continue;
+      if (!first) nob_sb_append_cstr(sb, ", ");
+      nob_sb_append_cstr(sb, fragments[i].name);
+      first = false;
+    }
+    nob_sb_append_cstr(sb, " } from \"./"JS_ESM_RUNTIME"\";\n");
+    return;
+  }
+
+  // Fragments are declared in dependency order so emitting them in table order is enough
+  size_t start = sb->count;
+  nob_sb_append_cstr(sb, "(function(){\n");
+  for (size_t i = 0; i < fragments_count; ++i) {
+    if (!needed[i] || fragments[i].code == NULL) continue;
+    nob_sb_append_cstr(sb, fragments[i].code);
+  }
+  for (size_t i = 0; i < fragments_count; ++i) {
+    if (!needed[i] || !fragments[i].exported) continue;
+    nob_sb_appendf(sb, "globalThis.%s = %s;\n", fragments[i].name, fragments[i].name);
+  }
+  nob_sb_append_cstr(sb, "})();\n");
+  if (!ctx->opts.minify) return;
+
+  // Everything the runtime declares is only seen through globalThis, so all of it can get a short name
+  StringViews declared = {0};
+  for (size_t i = 0; i < fragments_count; ++i) {
+    if (!needed[i]) continue;
+    nob_da_append(&declared, SV(fragments[i].name));
+    for (const char *const *local = fragments[i].locals; *local != NULL; ++local) {
+      if (!optimizer_svs_contain(&declared, SV(*local))) nob_da_append(&declared, SV(*local));
+    }
+  }
+  Optimizer_Indices uses = {0};
+  nob_da_foreach(Nob_String_View, it, &declared) nob_da_append(&uses, 0);
+  StringViews taken = {0};
+  for (size_t i = start; i < sb->count;) {
+    if (!javascript_is_ident_char(sb->items[i])) {
+      i += 1;
+      continue;
+    }
+    size_t word_start = i;
+    while (i < sb->count && javascript_is_ident_char(sb->items[i])) i += 1;
+    Nob_String_View word = nob_sv_from_parts(sb->items + word_start, i - word_start);
+    bool counted = false;
+    for (size_t j = 0; j < declared.count; ++j) {
+      if (!nob_sv_eq(declared.items[j], word)) continue;
+      uses.items[j] += 1;
+      counted = true;
+    }
+    if (!counted && !optimizer_svs_contain(&taken, word)) nob_da_append(&taken, word);
+  }
+  javascript_sort_by_uses(&declared, &uses);
+  Optimizer_Renames renames = {0};
+  size_t next = 0;
+  nob_da_foreach(Nob_String_View, it, &declared) {
+    nob_da_append(&renames.from, *it);
+    nob_da_append(&renames.to, javascript_next_short_name(&next, &taken));
+  }
+  javascript_minify(sb, start, &renames);
+  safe_da_free(declared);
+  safe_da_free(uses);
+  safe_da_free(taken);
+  safe_da_free(renames.from);
+  safe_da_free(renames.to);
+}
+
+typedef enum {
+  JS_VALUE_ANY,
+  JS_VALUE_NUMBER,
+  JS_VALUE_STRING,
+} JS_ValueKind;
+
+typedef struct {
+  Nob_String_View name;
+  JS_ValueKind kind;
+} JS_KnownVar;
+
+typedef struct {
+  JS_KnownVar *items;
+  size_t count;
+  size_t capacity;
+} JS_KnownVars;
+
+typedef struct {
+  AST_NodeList *module;
+  // Top level function being lowered
+  AST_Node *fn;
+  // Locals in scope at the statement being lowered, innermost last
+  JS_KnownVars known;
+  // Text of the constant writes since the last one that had to stay a call
+  Nob_String_Builder pending;
+  // Arguments that are only known at runtime, gathered into a single call to `runtime_fn`
+  AST_Node dynamic;
+  size_t lowered;
+} JS_WriteLowering;
+
+bool javascript_is_core_io_write(JS_WriteLowering *wl, AST_Node *node) {
+  if (node->kind != AST_NK_FN_CALL) return false;
+  Nob_String_View name = node->as.fn_call.name;
+  if (!sv_eq_str(name, "print") && !sv_eq_str(name, "println") && !sv_eq_str(name, "putchar") && !sv_eq_str(name, "putchars")) return false;
+  // A function of the module with the same name hides the library one
+  return optimizer_find_fn(wl->module, name) == NULL;
+}
+
+// Number an argument is known to be at compile time: literals and immutable globals bound to one
+bool javascript_constant_number(JS_WriteLowering *wl, AST_Node *node, double *out, bool locals, int depth) {
+  if (depth > 8) return false;
+  switch (node->kind) {
+  case AST_NK_EXPR:
+    return node->as.expr.count == 1 && javascript_constant_number(wl, &node->as.expr.items[0], out, locals, depth + 1);
+  case AST_NK_UNOP:
+    if (!sv_eq_str(node->as.op.op.sv, "-") || !javascript_constant_number(wl, &node->as.op.operands.items[0], out, locals, depth + 1)) return false;
+    *out = -*out;
+    return true;
+  case AST_NK_TOKEN:
+    if (node->as.token.kind == TOK_INT) {
+      *out = strtod(nob_temp_sv_to_cstr(node->as.token.sv), NULL);
+      return true;
+    }
+    if (node->as.token.kind != TOK_IDENT) return false;
+    // A local of the same name hides the global
+    if (locals) {
+      nob_da_foreach(JS_KnownVar, known, &wl->known) {
+        if (nob_sv_eq(known->name, node->as.token.sv)) return false;
+      }
+    }
+    nob_da_foreach(AST_Node, it, wl->module) {
+      if (it->kind != AST_NK_VAR_DECL || !nob_sv_eq(it->as.var_decl.name, node->as.token.sv)) continue;
+      if (it->as.var_decl.mutable || it->as.var_decl.expr.count != 1) return false;
+      return javascript_constant_number(wl, &it->as.var_decl.expr.items[0], out, false, depth + 1);
+    }
+    return false;
+  default:
+    return false;
+  }
+}
+
+// What an expression always evaluates to, `locals` resolves names through the scope being lowered before the globals
+JS_ValueKind javascript_value_kind(JS_WriteLowering *wl, AST_Node *node, bool locals, int depth) {
+  if (depth > 8) return JS_VALUE_ANY;
+  node = optimizer_unwrap_expr(node);
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    if (node->as.token.kind == TOK_INT) return JS_VALUE_NUMBER;
+    if (node->as.token.kind == TOK_STR) return JS_VALUE_STRING;
+    if (node->as.token.kind != TOK_IDENT) return JS_VALUE_ANY;
+    // Parameters, loop variables and nested functions are in the scope too, anything missing from it is a global
+    if (locals) {
+      for (size_t i = wl->known.count; i > 0; --i) {
+        if (nob_sv_eq(wl->known.items[i - 1].name, node->as.token.sv)) return wl->known.items[i - 1].kind;
+      }
+    }
+    nob_da_foreach(AST_Node, it, wl->module) {
+      if (it->kind != AST_NK_VAR_DECL || !nob_sv_eq(it->as.var_decl.name, node->as.token.sv)) continue;
+      if (it->as.var_decl.mutable || it->as.var_decl.expr.count != 1) return JS_VALUE_ANY;
+      return javascript_value_kind(wl, &it->as.var_decl.expr.items[0], false, depth + 1);
+    }
+    return JS_VALUE_ANY;
+  case AST_NK_UNOP:
+    return sv_eq_str(node->as.op.op.sv, "-") ? JS_VALUE_NUMBER : JS_VALUE_ANY;
+  case AST_NK_INDEX:
+    return javascript_is_number(node) ? JS_VALUE_NUMBER : JS_VALUE_ANY;
+  case AST_NK_BINOP: {
+    Nob_String_View op = node->as.op.op.sv;
+    if (sv_eq_str(op, "-") || sv_eq_str(op, "*") || sv_eq_str(op, "/") || sv_eq_str(op, "%")) return JS_VALUE_NUMBER;
+    if (!sv_eq_str(op, "+")) return JS_VALUE_ANY;
+    JS_ValueKind lhs = javascript_value_kind(wl, &node->as.op.operands.items[0], locals, depth + 1);
+    JS_ValueKind rhs = javascript_value_kind(wl, &node->as.op.operands.items[1], locals, depth + 1);
+    // `+` concatenates as soon as one side is a string
+    if (lhs == JS_VALUE_STRING || rhs == JS_VALUE_STRING) return JS_VALUE_STRING;
+    return lhs == JS_VALUE_NUMBER && rhs == JS_VALUE_NUMBER ? JS_VALUE_NUMBER : JS_VALUE_ANY;
+  }
+  default:
+    return JS_VALUE_ANY;
+  }
+}
+
+// Declarations of the name anywhere in the node, nested functions included
+size_t javascript_count_decls(AST_Node *node, Nob_String_View name) {
+  size_t count = 0;
+  switch (node->kind) {
+  case AST_NK_VAR_DECL:
+    count += nob_sv_eq(node->as.var_decl.name, name);
+    break;
+  case AST_NK_FOR:
+    count += nob_sv_eq(node->as.for_loop.name, name);
+    break;
+  case AST_NK_FN_DECL:
+    count += nob_sv_eq(node->as.fn_decl.name, name);
+    nob_da_foreach(AST_Node, param, &node->as.fn_decl.params) {
+      count += nob_sv_eq(param->as.token.sv, name);
+    }
+    break;
+  default:
+    break;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      count += javascript_count_decls(it, name);
+    }
+  }
+  return count;
+}
+
+// Whether every assignment to the variable in the node stores a value of its kind
+// The assignments can be anywhere in its scope so the names they read have to resolve the same from the declaration
+bool javascript_assigns_kind(JS_WriteLowering *wl, AST_Node *node, Nob_String_View name, JS_ValueKind kind) {
+  if (node->kind == AST_NK_ASSIGNMENT && nob_sv_eq(node->as.var_assign.name, name)) {
+    AST_NodeList *expr = &node->as.var_assign.expr;
+    if (expr->count != 1) return false;
+    StringViews refs = {0};
+    optimizer_collect_refs(&expr->items[0], &refs);
+    bool resolves = true;
+    nob_da_foreach(Nob_String_View, ref, &refs) {
+      if (nob_sv_eq(*ref, name)) continue;
+      size_t decls = javascript_count_decls(wl->fn, *ref);
+      bool in_scope = false;
+      nob_da_foreach(JS_KnownVar, known, &wl->known) in_scope = in_scope || nob_sv_eq(known->name, *ref);
+      if (decls > 1 || (decls == 1 && !in_scope)) resolves = false;
+    }
+    safe_da_free(refs);
+    if (!resolves || javascript_value_kind(wl, &expr->items[0], true, 0) != kind) return false;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (!javascript_assigns_kind(wl, it, name, kind)) return false;
+    }
+  }
+  return true;
+}
+
+void javascript_declare_known(JS_WriteLowering *wl, AST_Node *decl) {
+  AST_VarDeclAttr *var = &decl->as.var_decl;
+  JS_ValueKind kind = var->expr.count == 1 ? javascript_value_kind(wl, &var->expr.items[0], true, 0) : JS_VALUE_ANY;
+  // The variable keeps its kind while checking the assignments so `i = i + 1` counts as a number
+  nob_da_append(&wl->known, ((JS_KnownVar) { var->name, kind }));
+  if (var->mutable && kind != JS_VALUE_ANY && !javascript_assigns_kind(wl, wl->fn, var->name, kind)) {
+    nob_da_last(&wl->known).kind = JS_VALUE_ANY;
+  }
+}
+
+void javascript_declare_params(JS_WriteLowering *wl, AST_Node *fn) {
+  nob_da_foreach(AST_Node, param, &fn->as.fn_decl.params) {
+    nob_da_append(&wl->known, ((JS_KnownVar) { param->as.token.sv, JS_VALUE_ANY }));
+  }
 }
 
-bool javascript_compile_expr_at_depth(Nob_String_Builder *sb, AST_NodeList *expr, int depth) {
-  // nob_log(NOB_INFO, "Compiling expression...");
-  sb_add_indentation_level(sb, i, depth);
-  nob_da_foreach(AST_Node, node, expr) {
-    switch (node->kind) {
-    case AST_NK_TOKEN:
-      sb_append_sv(sb, node->as.token.sv);
-      break;
-    default:
-      comp_errorf(node->loc, "Unsupported %s in expression", ast_node_kind_name(node->kind));
-      comp_note(expr->items[0].loc, "Expression starts here");
-      return false;
+// Whether evaluating the argument later than the writes before it could be noticed
+bool javascript_has_effects(JS_WriteLowering *wl, AST_Node *node) {
+  if (node->kind == AST_NK_FN_CALL) {
+    AST_Node *callee = optimizer_find_fn(wl->module, node->as.fn_call.name);
+    if (callee == NULL || !optimizer_fn_is_pure(wl->module, callee, NULL)) return true;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (javascript_has_effects(wl, it)) return true;
     }
   }
+  return false;
+}
+
+// Calls whose arguments can be evaluated out of order with respect to the writes around them
+bool javascript_is_lowerable_write(JS_WriteLowering *wl, AST_Node *node) {
+  if (!javascript_is_core_io_write(wl, node)) return false;
+  nob_da_foreach(AST_Node, arg, &node->as.fn_call.params) {
+    if (javascript_has_effects(wl, arg)) return false;
+  }
   return true;
 }
 
-bool javascript_compile_var_declaration(Nob_String_Builder *sb, AST_Node node, int depth) {
-  // nob_log(NOB_INFO, "Compiling variable declaration...");
-  sb_add_indentation_level(sb, i, depth);
-  AST_VarDeclAttr decl = node.as.var_decl;
-  if (decl.mutable) {
-    nob_sb_append_cstr(sb, "let ");
-  } else {
-    nob_sb_append_cstr(sb, "const ");
+AST_Node javascript_string_node(Loc loc, Nob_String_View text) {
+  Nob_String_Builder literal = {0};
+  lexer_escape_string(&literal, text);
+  AST_Node node = {
+    .loc = loc,
+    .kind = AST_NK_TOKEN,
+  };
+  node.as.token.kind = TOK_STR;
+  node.as.token.sv = nob_sb_to_sv(literal);
+  return node;
+}
+
+// Turn the text gathered so far into one write
+void javascript_flush_pending_write(JS_WriteLowering *wl, AST_NodeList *out, Loc loc) {
+  if (wl->pending.count == 0) return;
+  AST_Node call = {
+    .loc = loc,
+    .kind = AST_NK_FN_CALL,
+  };
+  call.as.fn_call.name = SV("$write");
+  nob_da_append(&call.as.fn_call.params, javascript_string_node(loc, nob_sb_to_sv(wl->pending)));
+  nob_da_append(out, call);
+  wl->pending.count = 0;
+}
+
+void javascript_flush_dynamic_write(JS_WriteLowering *wl, AST_NodeList *out) {
+  if (wl->dynamic.as.fn_call.params.count == 0) return;
+  nob_da_append(out, wl->dynamic);
+  wl->dynamic.as.fn_call.params = (AST_NodeList) {0};
+}
+
+void javascript_push_dynamic_arg(JS_WriteLowering *wl, AST_NodeList *out, AST_Node *call, const char *runtime_fn, AST_Node *arg) {
+  // A putchar argument is a byte and a print argument is text, they can't share a call
+  if (!sv_eq_str(wl->dynamic.as.fn_call.name, runtime_fn)) javascript_flush_dynamic_write(wl, out);
+  if (wl->dynamic.as.fn_call.params.count == 0) {
+    javascript_flush_pending_write(wl, out, arg->loc);
+    wl->dynamic.loc = call->loc;
+    wl->dynamic.kind = AST_NK_FN_CALL;
+    wl->dynamic.as.fn_call.name = SV(runtime_fn);
   }
-  sb_append_sv(sb, decl.name);
-  if (decl.expr.count == 0) {
-    if (!decl.mutable) {
-      comp_error(node.loc, "Constant variables require to be set on declaration");
-      return false;
+  nob_da_append(&wl->dynamic.as.fn_call.params, ast_node_clone(*arg));
+}
+
+// Arguments of a known kind get a call of their own to the runtime function made for it
+void javascript_push_typed_write(JS_WriteLowering *wl, AST_NodeList *out, const char *runtime_fn, AST_Node *arg) {
+  javascript_flush_dynamic_write(wl, out);
+  javascript_flush_pending_write(wl, out, arg->loc);
+  AST_Node call = {
+    .loc = arg->loc,
+    .kind = AST_NK_FN_CALL,
+  };
+  call.as.fn_call.name = SV(runtime_fn);
+  nob_da_append(&call.as.fn_call.params, ast_node_clone(*arg));
+  nob_da_append(out, call);
+}
+
+void javascript_push_constant_text(JS_WriteLowering *wl, AST_NodeList *out, Nob_String_View text) {
+  javascript_flush_dynamic_write(wl, out);
+  sb_append_sv(&wl->pending, text);
+}
+
+// Split a core:io call into the text known at compile time and the runtime calls for the rest
+void javascript_lower_write(JS_WriteLowering *wl, AST_Node *call, AST_NodeList *out) {
+  Nob_String_View name = call->as.fn_call.name;
+  bool is_print = sv_eq_str(name, "print") || sv_eq_str(name, "println");
+  nob_da_foreach(AST_Node, arg, &call->as.fn_call.params) {
+    double number = 0;
+    bool is_number = javascript_constant_number(wl, arg, &number, true, 0);
+    if (is_print) {
+      if (arg->kind == AST_NK_TOKEN && arg->as.token.kind == TOK_STR) {
+        javascript_flush_dynamic_write(wl, out);
+        lexer_unescape_string(&wl->pending, arg->as.token.sv);
+        continue;
+      }
+      // Same text the template literal would give at runtime
+      if (is_number) {
+        javascript_flush_dynamic_write(wl, out);
+        sb_append_js_number(&wl->pending, number);
+        continue;
+      }
+      JS_ValueKind kind = javascript_value_kind(wl, arg, true, 0);
+      if (kind != JS_VALUE_ANY) {
+        javascript_push_typed_write(wl, out, kind == JS_VALUE_NUMBER ? "$writeNumber" : "$write", arg);
+        continue;
+      }
+      javascript_push_dynamic_arg(wl, out, call, "print", arg);
+      continue;
     }
-    nob_sb_append_cstr(sb, ";");
-    return true;
+    // Other bytes can be part of a multi byte sequence and have to be decoded along their neighbours at runtime
+    if (is_number && number >= 0 && number < 128) {
+      char byte = (char)number;
+      javascript_push_constant_text(wl, out, SVl(&byte, 1));
+      continue;
+    }
+    javascript_push_dynamic_arg(wl, out, call, "putchar", arg);
   }
-  nob_sb_append_cstr(sb, " = ");
-  if (!javascript_compile_expr_at_depth(sb, &decl.expr, 0)) return false;
-  nob_sb_append_cstr(sb, ";");
-  return true;
+  if (sv_eq_str(name, "println")) javascript_push_constant_text(wl, out, SV("\n"));
 }
 
-bool javascript_compile_fn_declaration(Nob_String_Builder *sb, AST_Node node, int depth) {
-  // nob_log(NOB_INFO, "Compiling function declaration...");
-  sb_add_indentation_level(sb, i, depth);
-  Vars local_vars = {0};
-  NOB_UNUSED(local_vars);
-  AST_FnDeclAttr decl = node.as.fn_decl;
-  nob_sb_append_cstr(sb, "function ");
-  sb_append_sv(sb, decl.name);
-  // TODO: Actually handle parameters from decl.params
-  nob_sb_append_cstr(sb, "() {\n");
-  nob_da_foreach(AST_Node, node, &decl.body) {
-    switch (node->kind) {
-    case AST_NK_TOKEN:
-      comp_warnf(node->loc, "Dangling atom %s with no operation or usage found", token_kind_name(node->as.token.kind));
-      sb_add_indentation_level(sb, i, depth+1);
-      sb_append_sv(sb, node->as.token.sv);
-      nob_sb_append_cstr(sb, ";");
-      break;
+void javascript_lower_writes_in_list(JS_WriteLowering *wl, AST_NodeList *list) {
+  AST_NodeList out = {0};
+  size_t scope = wl->known.count;
+  nob_da_foreach(AST_Node, it, list) {
+    if (javascript_is_lowerable_write(wl, it)) {
+      javascript_lower_write(wl, it, &out);
+      ast_node_children_free(it);
+      wl->lowered++;
+      continue;
+    }
 
-      // Molecules
-    case AST_NK_UNOP:
-    case AST_NK_BINOP:
-      TODOf("Implement compilation of %s molecule", ast_node_kind_name(node->kind));
+    javascript_flush_dynamic_write(wl, &out);
+    javascript_flush_pending_write(wl, &out, it->loc);
+    switch (it->kind) {
+    case AST_NK_BLOCK:
+      javascript_lower_writes_in_list(wl, &it->as.block);
       break;
-    case AST_NK_FN_PARAMS_DECL:
-      NEVERf("Molecule %s should not be found in function body", ast_node_kind_name(node->kind));
+    case AST_NK_IF:
+      javascript_lower_writes_in_list(wl, &it->as.if_stmt.then_body);
+      javascript_lower_writes_in_list(wl, &it->as.if_stmt.else_body);
       break;
-
-      // Compounds
-    case AST_NK_EXPR:
-      if (!javascript_compile_expr_at_depth(sb, &node->as.expr, depth + 1)) return false;
+    case AST_NK_WHILE:
+      javascript_lower_writes_in_list(wl, &it->as.while_loop.body);
       break;
+    case AST_NK_FOR: {
+      size_t body_scope = wl->known.count;
+      nob_da_append(&wl->known, ((JS_KnownVar) { it->as.for_loop.name, JS_VALUE_ANY }));
+      javascript_lower_writes_in_list(wl, &it->as.for_loop.body);
+      wl->known.count = body_scope;
+    } break;
+    case AST_NK_FN_DECL: {
+      nob_da_append(&wl->known, ((JS_KnownVar) { it->as.fn_decl.name, JS_VALUE_ANY }));
+      size_t body_scope = wl->known.count;
+      javascript_declare_params(wl, it);
+      javascript_lower_writes_in_list(wl, &it->as.fn_decl.body);
+      wl->known.count = body_scope;
+    } break;
     case AST_NK_VAR_DECL:
-      // TODO: Check if local variable is being re-declared
-      if (!javascript_compile_var_declaration(sb, *node, depth + 1)) return false;
+      javascript_declare_known(wl, it);
       break;
-    case AST_NK_FN_DECL:
-      comp_error(node->loc, "Closures are not supported, yet");
-      printf("    Function "SV_Fmt" should be moved outside\n", SV_Arg(node->as.fn_decl.name));
-      break;
-    case AST_NK_ASSIGNMENT:
-      sb_add_indentation_level(sb, i, depth+1);
-      sb_append_sv(sb, node->as.var_assign.name);
-      nob_sb_append_cstr(sb, " = ");
-      if (!javascript_compile_expr_at_depth(sb, &node->as.var_assign.expr, 0)) return false;
-      nob_sb_append_cstr(sb, ";");
+    default:
       break;
-    case AST_NK_FN_CALL:
-      sb_add_indentation_level(sb, i, depth+1);
-      sb_append_sv(sb, node->as.fn_call.name);
-      nob_sb_append_cstr(sb, "(");
-      if (node->as.fn_call.params.count > 0) {
-        AST_NodeList *fn_params = &node->as.fn_call.params;
-        if (fn_params->count > 0) {
-          nob_da_foreach(AST_Node, param, fn_params) {
-            size_t index = param - node->as.fn_call.params.items;
-            if (index > 0) nob_sb_append_cstr(sb, ", ");
-            switch (param->kind) {
-            case AST_NK_TOKEN:
-              sb_append_sv(sb, param->as.token.sv);
-              break;
-            case AST_NK_EXPR:
-              if (!javascript_compile_expr_at_depth(sb, &param->as.expr, 0)) return false;
-              break;
-            default:
-              comp_errorf(param->loc, "Unsupported %s in expression", ast_node_kind_name(param->kind));
-              comp_note(fn_params->items[0].loc, "Expression starts here");
-              return false;
-            }
-          }
-        }
+    }
+    nob_da_append(&out, *it);
+  }
+  javascript_flush_dynamic_write(wl, &out);
+  javascript_flush_pending_write(wl, &out, list->count > 0 ? nob_da_last(list).loc : (Loc) {0});
+  safe_da_free((*list));
+  *list = out;
+  wl->known.count = scope;
+}
+
+// Pre-encode the constant parts of print, println, putchar and putchars calls
+// Adjacent constant writes are merged into a single string written by one runtime call
+// Arguments known to be numbers or strings get a runtime call that doesn't check what they are
+// Returns the amount of calls that were lowered
+size_t javascript_lower_core_io_writes(AST_NodeList *module) {
+  bool imports_core_io = false;
+  nob_da_foreach(AST_Node, it, module) {
+    if (it->kind == AST_NK_IMPORT && sv_eq_str(it->as.import.name, "core:io")) imports_core_io = true;
+  }
+  if (!imports_core_io) return 0;
+  JS_WriteLowering wl = {
+    .module = module,
+  };
+  nob_da_foreach(AST_Node, it, module) {
+    if (it->kind != AST_NK_FN_DECL) continue;
+    wl.fn = it;
+    wl.known.count = 0;
+    javascript_declare_params(&wl, it);
+    javascript_lower_writes_in_list(&wl, &it->as.fn_decl.body);
+  }
+  safe_da_free(wl.pending);
+  safe_da_free(wl.known);
+  return wl.lowered;
+}
+
+// dwoc locals come into scope at their declaration while JavaScript ones take the whole block,
+// so a declaration hiding a name that is visible there gets a name of its own
+// Without it reads before the declaration hit the temporal dead zone and tail loops assign to the local instead of the parameter
+typedef struct {
+  // Names visible at the node being walked, globals first and innermost last
+  StringViews visible;
+  // Names every declaration in scope was given, the innermost one for a name is the last
+  Optimizer_Renames renames;
+  size_t fresh_id;
+  size_t renamed;
+} JS_Unshadower;
+
+Nob_String_View javascript_unshadow_lookup(JS_Unshadower *u, Nob_String_View name) {
+  for (size_t i = u->renames.from.count; i > 0; --i) {
+    if (nob_sv_eq(u->renames.from.items[i - 1], name)) return u->renames.to.items[i - 1];
+  }
+  return name;
+}
+
+void javascript_unshadow_declare(JS_Unshadower *u, Nob_String_View *name, bool can_rename) {
+  Nob_String_View original = *name;
+  if (can_rename && optimizer_svs_contain(&u->visible, original)) {
+    // `$` can't be part of a dwoc identifier and the inliner's names end in digits only
+    Nob_String_Builder sb = {0};
+    nob_sb_appendf(&sb, SV_Fmt"$s%zu", SV_Arg(original), ++u->fresh_id);
+    *name = nob_sb_to_sv(sb);
+    u->renamed++;
+  }
+  nob_da_append(&u->visible, original);
+  nob_da_append(&u->renames.from, original);
+  nob_da_append(&u->renames.to, *name);
+}
+
+void javascript_unshadow_node(JS_Unshadower *u, AST_Node *node);
+
+void javascript_unshadow_scope(JS_Unshadower *u, AST_NodeList *list) {
+  size_t visible = u->visible.count;
+  size_t renames = u->renames.from.count;
+  nob_da_foreach(AST_Node, it, list) {
+    javascript_unshadow_node(u, it);
+  }
+  u->visible.count = visible;
+  u->renames.from.count = renames;
+  u->renames.to.count = renames;
+}
+
+void javascript_unshadow_fn(JS_Unshadower *u, AST_Node *fn) {
+  size_t visible = u->visible.count;
+  size_t renames = u->renames.from.count;
+  // Parameters can hide outer names, they are bound before the body runs
+  nob_da_foreach(AST_Node, param, &fn->as.fn_decl.params) {
+    javascript_unshadow_declare(u, &param->as.token.sv, false);
+  }
+  javascript_unshadow_scope(u, &fn->as.fn_decl.body);
+  u->visible.count = visible;
+  u->renames.from.count = renames;
+  u->renames.to.count = renames;
+}
+
+void javascript_unshadow_node(JS_Unshadower *u, AST_Node *node) {
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    if (node->as.token.kind == TOK_IDENT) node->as.token.sv = javascript_unshadow_lookup(u, node->as.token.sv);
+    return;
+  case AST_NK_FN_CALL:
+    node->as.fn_call.name = javascript_unshadow_lookup(u, node->as.fn_call.name);
+    break;
+  case AST_NK_ASSIGNMENT:
+    node->as.var_assign.name = javascript_unshadow_lookup(u, node->as.var_assign.name);
+    break;
+  case AST_NK_VAR_DECL:
+    // The initializer still sees what the name meant before
+    javascript_unshadow_scope(u, &node->as.var_decl.expr);
+    javascript_unshadow_declare(u, &node->as.var_decl.name, true);
+    return;
+  case AST_NK_FOR: {
+    javascript_unshadow_scope(u, &node->as.for_loop.iter);
+    size_t visible = u->visible.count;
+    size_t renames = u->renames.from.count;
+    javascript_unshadow_declare(u, &node->as.for_loop.name, true);
+    javascript_unshadow_scope(u, &node->as.for_loop.body);
+    u->visible.count = visible;
+    u->renames.from.count = renames;
+    u->renames.to.count = renames;
+  } return;
+  case AST_NK_FN_DECL:
+    // Function declarations are initialized when their block starts so they keep their name
+    javascript_unshadow_declare(u, &node->as.fn_decl.name, false);
+    javascript_unshadow_fn(u, node);
+    return;
+  default:
+    break;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    javascript_unshadow_scope(u, lists[i]);
+  }
+}
+
+// Returns the amount of declarations that got renamed
+size_t javascript_unshadow_locals(AST_NodeList *module) {
+  JS_Unshadower u = {0};
+  nob_da_foreach(AST_Node, it, module) {
+    switch (it->kind) {
+    case AST_NK_FN_DECL: nob_da_append(&u.visible, it->as.fn_decl.name); break;
+    case AST_NK_VAR_DECL: nob_da_append(&u.visible, it->as.var_decl.name); break;
+    case AST_NK_STRUCT_DECL: nob_da_append(&u.visible, it->as.struct_decl.name); break;
+    default: break;
+    }
+  }
+  size_t globals = u.visible.count;
+  nob_da_foreach(AST_Node, it, module) {
+    if (it->kind != AST_NK_FN_DECL) continue;
+    u.visible.count = globals;
+    javascript_unshadow_fn(&u, it);
+  }
+  safe_da_free(u.visible);
+  safe_da_free(u.renames.from);
+  safe_da_free(u.renames.to);
+  return u.renamed;
+}
+
+size_t javascript_pass_unshadow_locals(Pass_Manager *pm) {
+  return javascript_unshadow_locals(pm->module);
+}
+
+size_t javascript_pass_lower_core_io_writes(Pass_Manager *pm) {
+  return javascript_lower_core_io_writes(pm->module);
+}
+
+// Arms that are all literals, `_` included, let the match be an array lookup
+bool javascript_match_is_table(AST_Node *match) {
+  Optimizer_Cases cases = {0};
+  AST_NodeList *fallback = NULL;
+  optimizer_match_cases(match, &cases, &fallback);
+  bool is_table = optimizer_cases_are_dense(&cases);
+  safe_da_free(cases);
+  nob_da_foreach(AST_Node, arm, &match->as.match.arms) {
+    AST_Node *value = optimizer_unwrap_expr(&arm->as.match_arm.value.items[0]);
+    bool is_literal = optimizer_is_literal(value) || (value->kind == AST_NK_TOKEN && value->as.token.kind == TOK_STR);
+    if (!is_literal) is_table = false;
+  }
+  return is_table;
+}
+
+void javascript_assign_match_tables(AST_Node *node, size_t *tables) {
+  if (node->kind == AST_NK_MATCH) {
+    node->as.match.table = javascript_match_is_table(node) ? ++*tables : 0;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      javascript_assign_match_tables(it, tables);
+    }
+  }
+}
+
+// Number the matches that get a lookup table, javascript_run_compilation emits the tables ahead of the module
+size_t javascript_pass_assign_match_tables(Pass_Manager *pm) {
+  size_t tables = 0;
+  nob_da_foreach(AST_Node, it, pm->module) {
+    javascript_assign_match_tables(it, &tables);
+  }
+  return tables;
+}
+
+bool javascript_compile_match_tables(Nob_String_Builder *sb, AST_Node *node) {
+  if (node->kind == AST_NK_MATCH && node->as.match.table != 0) {
+    Optimizer_Cases cases = {0};
+    AST_NodeList *fallback = NULL;
+    optimizer_match_cases(node, &cases, &fallback);
+    nob_sb_appendf(sb, "const $table%zu = [", node->as.match.table);
+    // Values without an arm of their own hold the `_` one
+    size_t next = 0;
+    for (double value = cases.items[0].value; value <= cases.items[cases.count - 1].value; ++value) {
+      if (value != cases.items[0].value) nob_sb_append_cstr(sb, ", ");
+      AST_NodeList *slot = fallback;
+      if (cases.items[next].value == value) slot = cases.items[next++].body;
+      if (slot == NULL) {
+        nob_sb_append_cstr(sb, "undefined");
+      } else if (!javascript_compile_expr_node(sb, &slot->items[0])) {
+        safe_da_free(cases);
+        return false;
       }
-      nob_sb_append_cstr(sb, ");");
-      break;
-    case AST_NK_EOF:
-      NEVER("End of File should never be part of function body");
-      break;
+    }
+    nob_sb_append_cstr(sb, "];\n");
+    safe_da_free(cases);
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (!javascript_compile_match_tables(sb, it)) return false;
+    }
+  }
+  return true;
+}
 
-    default:
-      TODOf("Implement missing AST Node kind ('%s') compilation", ast_node_kind_name(node->kind));
+typedef struct {
+  Nob_String_View name;
+  AST_Elem_Kind elem;
+  Nob_String_View soa;
+} JS_ArrayVar;
+
+// What every call of a top level function passes to one of its parameters
+typedef struct {
+  AST_Node *fn;
+  size_t index;
+  bool seen;
+  AST_Elem_Kind elem;
+  Nob_String_View soa;
+} JS_ParamKind;
+
+typedef struct {
+  JS_ParamKind *items;
+  size_t count;
+  size_t capacity;
+} JS_ParamKinds;
+
+typedef struct {
+  JS_ArrayVar *items;
+  size_t count;
+  size_t capacity;
+  AST_NodeList *module;
+  // Kinds the parameters have in this round and the ones the calls seen so far give them for the next
+  JS_ParamKinds params;
+  JS_ParamKinds next;
+  // Structs whose arrays got somewhere a struct of arrays can't go, and the ones kept as objects because of it
+  StringViews escaped;
+  StringViews demoted;
+  // Rounds didn't settle, every parameter is unknown and no struct becomes a struct of arrays
+  bool give_up;
+  // Variables from here on belong to the function being typed, the ones before are globals
+  size_t locals;
+  // Declarations of the current scope and assignments of the whole module
+  // A variable is only tracked when declared once and never assigned, shadowing included
+  StringViews declared;
+  StringViews assigned;
+} JS_ArrayTyper;
+
+void javascript_array_scan(JS_ArrayTyper *t, AST_Node *node, bool nested) {
+  switch (node->kind) {
+  case AST_NK_VAR_DECL:
+    nob_da_append(&t->declared, node->as.var_decl.name);
+    break;
+  case AST_NK_FOR:
+    nob_da_append(&t->declared, node->as.for_loop.name);
+    break;
+  case AST_NK_FN_DECL:
+    nob_da_append(&t->declared, node->as.fn_decl.name);
+    if (!nested) return;
+    nob_da_foreach(AST_Node, param, &node->as.fn_decl.params) {
+      nob_da_append(&t->declared, param->as.token.sv);
     }
-    nob_sb_append_cstr(sb, "\n");
+    break;
+  default:
+    break;
   }
-  nob_sb_append_cstr(sb, "}");
+  if (!nested) return;
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      javascript_array_scan(t, it, true);
+    }
+  }
+}
+
+// Names a top level function can't be told apart from, it's either used as a value or something else is called like it
+void javascript_array_scan_names(StringViews *names, AST_Node *node, bool top) {
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    if (node->as.token.kind == TOK_IDENT) nob_da_append(names, node->as.token.sv);
+    break;
+  case AST_NK_VAR_DECL:
+    nob_da_append(names, node->as.var_decl.name);
+    break;
+  case AST_NK_FOR:
+    nob_da_append(names, node->as.for_loop.name);
+    break;
+  case AST_NK_FN_DECL:
+    if (!top) nob_da_append(names, node->as.fn_decl.name);
+    nob_da_foreach(AST_Node, param, &node->as.fn_decl.params) {
+      nob_da_append(names, param->as.token.sv);
+    }
+    break;
+  default:
+    break;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      javascript_array_scan_names(names, it, false);
+    }
+  }
+}
+
+JS_ParamKind *javascript_param_kind(JS_ParamKinds *params, Nob_String_View fn, size_t index) {
+  nob_da_foreach(JS_ParamKind, it, params) {
+    if (it->index == index && nob_sv_eq(it->fn->as.fn_decl.name, fn)) return it;
+  }
+  return NULL;
+}
+
+// Arrays of numbers mix into wider numbers, a struct of arrays only goes with more of the same struct
+void javascript_param_kind_join(JS_ParamKind *param, AST_Elem_Kind elem, Nob_String_View soa) {
+  if (!param->seen) {
+    param->seen = true;
+    param->elem = elem;
+    param->soa = soa;
+    return;
+  }
+  if (param->elem == AST_ELEM_SOA || elem == AST_ELEM_SOA) {
+    if (param->elem == elem && nob_sv_eq(param->soa, soa)) return;
+    param->elem = AST_ELEM_ANY;
+  } else {
+    param->elem = javascript_elem_join(param->elem, elem);
+  }
+  param->soa = (Nob_String_View){0};
+}
+
+void javascript_array_scan_assignments(JS_ArrayTyper *t, AST_Node *node) {
+  if (node->kind == AST_NK_ASSIGNMENT) nob_da_append(&t->assigned, node->as.var_assign.name);
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      javascript_array_scan_assignments(t, it);
+    }
+  }
+}
+
+// Integers that fit in 32 bits, any other number is still an integer that a double holds exactly
+AST_Elem_Kind javascript_value_elem(AST_Node *node) {
+  double lo, hi;
+  if (javascript_expr_range(node, &lo, &hi) && lo >= INT32_MIN && hi <= INT32_MAX) return AST_ELEM_I32;
+  if (javascript_is_number(node)) return AST_ELEM_F64;
+  return AST_ELEM_ANY;
+}
+
+// Element kind of an expression evaluating to an array, soa gets the struct of the elements of a struct of arrays
+AST_Elem_Kind javascript_array_elem(JS_ArrayTyper *t, AST_Node *node, Nob_String_View *soa) {
+  *soa = (Nob_String_View){0};
+  node = optimizer_unwrap_expr(node);
+  switch (node->kind) {
+  case AST_NK_ARRAY:
+    *soa = node->as.array.soa;
+    return node->as.array.elem;
+  case AST_NK_INDEX:
+    if (!node->as.index.slice) return AST_ELEM_ANY;
+    *soa = node->as.index.soa;
+    return node->as.index.elem;
+  case AST_NK_TOKEN:
+    if (node->as.token.kind != TOK_IDENT) return AST_ELEM_ANY;
+    size_t from = 0, to = t->count;
+    // A local that isn't tracked still hides the global
+    if (optimizer_svs_contain(&t->declared, node->as.token.sv)) {
+      from = t->locals;
+    } else {
+      to = t->locals;
+    }
+    for (size_t i = from; i < to; ++i) {
+      if (!nob_sv_eq(t->items[i].name, node->as.token.sv)) continue;
+      *soa = t->items[i].soa;
+      return t->items[i].elem;
+    }
+    return AST_ELEM_ANY;
+  default:
+    return AST_ELEM_ANY;
+  }
+}
+
+// Fields the struct of arrays has of its own, a struct using them as field names keeps arrays of objects
+static const char *javascript_soa_members[] = { "length", "at", "slice" };
+
+bool javascript_struct_is_soa(AST_Node *decl) {
+  if (!optimizer_svs_contain(&decl->as.struct_decl.attrs, SV(ATTRIBUTE_SOA))) return false;
+  if (decl->as.struct_decl.fields.count == 0) return false;
+  nob_da_foreach(Nob_String_View, field, &decl->as.struct_decl.fields) {
+    carray_foreach(const char*, member, javascript_soa_members) {
+      if (sv_eq_str(*field, *member)) return false;
+    }
+  }
+  return true;
+}
+
+// Every element builds the same `@soa` struct out of numbers without calling anything
+// Fields get evaluated one after the other instead of element by element so nothing may notice the order
+bool javascript_array_is_soa(JS_ArrayTyper *t, AST_Array *array) {
+  if (t->give_up || array->items.count == 0) return false;
+  Nob_String_View name = {0};
+  nob_da_foreach(AST_Node, it, &array->items) {
+    AST_Node *value = optimizer_unwrap_expr(it);
+    if (value->kind != AST_NK_FN_CALL || !value->as.fn_call.constructs) return false;
+    if (name.count > 0 && !nob_sv_eq(name, value->as.fn_call.name)) return false;
+    name = value->as.fn_call.name;
+    nob_da_foreach(AST_Node, param, &value->as.fn_call.params) {
+      if (optimizer_contains_kind(param, AST_NK_FN_CALL)) return false;
+    }
+  }
+  if (optimizer_svs_contain(&t->demoted, name)) return false;
+  AST_Node *decl = ast_find_struct(t->module, name);
+  if (decl == NULL || !javascript_struct_is_soa(decl)) return false;
+  for (size_t i = 0; i < decl->as.struct_decl.fields.count; ++i) {
+    if (javascript_soa_column_elem(array, i) == AST_ELEM_ANY) return false;
+  }
+  array->soa = name;
   return true;
 }
 
-void javascript_import_core_io(Nob_String_Builder *sb, Context *ctx) {
-  static char *variable_names[] = {"stdin", "stdout", "stderr", "stdwarn"};
-  static char *fn_names[] = {"print", "println", "putchar", "flush"};
-  Nob_String_View library = SVl("core:io", 7);
-  size_t tmp_sp = nob_temp_save();
+bool javascript_array_var_is_tracked(JS_ArrayTyper *t, Nob_String_View name) {
+  return optimizer_svs_count(&t->declared, name) == 1 && !optimizer_svs_contain(&t->assigned, name);
+}
 
-  // TODO: These variables should be defined before we reach compilation stage for the sake of type checking
-  carray_foreach(char*, it, variable_names) {
-    char *name = *it;
-    Var io_var = {
-      .name = SV(name),
-      .immutable = true,
-      .library = library,
+// A struct of arrays may only reach code that knows its layout, anywhere else it would be read as an array of objects
+bool javascript_soa_stays(JS_ArrayTyper *t, AST_Node *parent, AST_Node *child, Nob_String_View soa) {
+  switch (parent->kind) {
+  case AST_NK_EXPR:
+    return true;
+  case AST_NK_FN_DECL:
+    return child < parent->as.fn_decl.body.items || child >= parent->as.fn_decl.body.items + parent->as.fn_decl.body.count;
+  case AST_NK_INDEX:
+    return child == parent->as.index.target.items;
+  case AST_NK_PIPELINE:
+    return child == parent->as.pipeline.source.items && parent->as.pipeline.stages.items[0].as.pipe_stage.kind != AST_PIPE_CALL;
+  case AST_NK_VAR_DECL:
+    return javascript_array_var_is_tracked(t, parent->as.var_decl.name);
+  case AST_NK_FN_CALL: {
+    if (parent->as.fn_call.constructs) return false;
+    JS_ParamKind *param = javascript_param_kind(&t->params, parent->as.fn_call.name, child - parent->as.fn_call.params.items);
+    return param != NULL && param->seen && param->elem == AST_ELEM_SOA && nob_sv_eq(param->soa, soa);
+  }
+  default:
+    return false;
+  }
+}
+
+// Children go first so an element read out of a typed array is known to be a number by the array holding it
+void javascript_type_arrays(JS_ArrayTyper *t, AST_Node *node, size_t *typed) {
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      javascript_type_arrays(t, it, typed);
+      Nob_String_View soa;
+      if (javascript_array_elem(t, it, &soa) == AST_ELEM_SOA && !javascript_soa_stays(t, node, it, soa)) {
+        nob_da_append(&t->escaped, soa);
+      }
+    }
+  }
+  switch (node->kind) {
+  case AST_NK_ARRAY: {
+    AST_Array *array = &node->as.array;
+    array->soa = (Nob_String_View){0};
+    array->elem = array->items.count == 0 ? AST_ELEM_ANY : AST_ELEM_I32;
+    nob_da_foreach(AST_Node, it, &array->items) {
+      array->elem = javascript_elem_join(array->elem, javascript_value_elem(it));
+    }
+    if (array->elem == AST_ELEM_ANY && javascript_array_is_soa(t, array)) array->elem = AST_ELEM_SOA;
+    if (array->elem != AST_ELEM_ANY) *typed += 1;
+  } return;
+  case AST_NK_INDEX:
+    node->as.index.elem = javascript_array_elem(t, &node->as.index.target.items[0], &node->as.index.soa);
+    return;
+  case AST_NK_PIPELINE: {
+    Nob_String_View soa;
+    if (javascript_array_elem(t, &node->as.pipeline.source.items[0], &soa) != AST_ELEM_SOA) soa = (Nob_String_View){0};
+    node->as.pipeline.soa = soa;
+  } return;
+  case AST_NK_FN_CALL: {
+    if (node->as.fn_call.constructs) return;
+    for (size_t i = 0; i < node->as.fn_call.params.count; ++i) {
+      JS_ParamKind *param = javascript_param_kind(&t->next, node->as.fn_call.name, i);
+      if (param == NULL) continue;
+      Nob_String_View soa;
+      AST_Elem_Kind elem = javascript_array_elem(t, &node->as.fn_call.params.items[i], &soa);
+      javascript_param_kind_join(param, elem, soa);
+    }
+  } return;
+  case AST_NK_VAR_DECL: {
+    Nob_String_View name = node->as.var_decl.name;
+    if (node->as.var_decl.expr.count != 1) return;
+    if (!javascript_array_var_is_tracked(t, name)) return;
+    JS_ArrayVar var = {
+      .name = name,
     };
-    nob_da_append(&ctx->vars, io_var);
+    var.elem = javascript_array_elem(t, &node->as.var_decl.expr.items[0], &var.soa);
+    if (var.elem != AST_ELEM_ANY) nob_da_append(t, var);
+  } return;
+  default:
+    return;
+  }
+}
+
+// Declarations of a top level function, its parameters included
+void javascript_array_scan_fn(JS_ArrayTyper *t, AST_Node *fn) {
+  nob_da_foreach(AST_Node, param, &fn->as.fn_decl.params) {
+    nob_da_append(&t->declared, param->as.token.sv);
   }
+  nob_da_foreach(AST_Node, stmt, &fn->as.fn_decl.body) {
+    javascript_array_scan(t, stmt, true);
+  }
+}
 
-  carray_foreach(char*, it, fn_names) {
-    char *name = *it;
-    Fn io_fn = {
-      .name = SV(name),
-      .library = library,
+size_t javascript_type_arrays_round(JS_ArrayTyper *t) {
+  t->count = 0;
+  t->escaped.count = 0;
+  t->next.count = 0;
+  nob_da_foreach(JS_ParamKind, param, &t->params) {
+    JS_ParamKind next = {
+      .fn = param->fn,
+      .index = param->index,
     };
-    nob_da_append(&ctx->fns, io_fn);
-  }
-
-  // Define base FDs (standard input/output/error)
-  nob_sb_append_cstr(sb,
-  "(function(){\n"
-  "const utf8Decoder = new TextDecoder();\n"
-  "const utf8Encoder = new TextEncoder();\n"
-  "const buffers = [];\n"
-  "const stdin = buffers.push(null)-1, stdout=buffers.push('')-1, stderr=buffers.push('')-1, stdwarn=buffers.push('')-1;\n"
-  "globalThis.stdin=stdin;globalThis.stdout=stdout;globalThis.stderr=stderr;globalThis.stdwarn=stdwarn;\n");
-
-  nob_sb_append_cstr(sb,
-  "const print = (...args) => {\n"
-  "  for (const arg of args) {\n"
-  "    if (arg == '\\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }\n"
-  "    if (typeof arg === 'string' && arg.includes('\\n')) {\n"
-  "      const idx = arg.lastIndexOf('\\n');\n"
-  "      const content = buffers[stdout] + arg.substring(0, idx);\n"
-  "      console.log(content);\n"
-  "      buffers[stdout] = arg.substring(idx+1);\n"
-  "      continue;\n"
-  "    }\n"
-  "    \n"
-  "    buffers[stdout] += `${arg}`;\n"
-  "  }\n"
-  "};globalThis.print = print;\n");
-  
-  nob_sb_append_cstr(sb,
-  "const println = (...args) => {\n"
-  "  for (const arg of args) {\n"
-  "    if (arg == '\\n') { console.log(buffers[stdout]); buffers[stdout] = ''; continue; }\n"
-  "    if (typeof arg === 'string' && arg.includes('\\n')) {\n"
-  "      const idx = arg.lastIndexOf('\\n');\n"
-  "      const content = buffers[stdout] + arg.substring(0, idx);\n"
-  "      console.log(content);\n"
-  "      buffers[stdout] = arg.substring(idx+1);\n"
-  "      continue;\n"
-  "    }\n"
-  "    \n"
-  "    buffers[stdout] += `${arg}`;\n"
-  "  }\n"
-  "  console.log(buffers[stdout]);\n"
-  "  buffers[stdout] = '';\n"
-  "};globalThis.println = println;\n");
-  
-  nob_sb_append_cstr(sb,
-  "const putchar = (...chars) => {\n"
-  "  if (chars.length == 0) { return; };\n"
-  "  if (chars.length == 1 && chars[0] === 10) { console.log(buffers[stdout]); buffers[stdout] = ''; return; }\n"
-  "  if (chars.length == 1) { buffers[stdout] += utf8Decoder.decode(new Uint8Array(chars)); return; }\n"
-  "  const subbuf = [];\n"
-  "  for (const ch of chars) {\n"
-  "    if (ch == 10) { console.log(buffers[stdout] + (subbuf.length == 0 ? '' : utf8Decoder.decode(new Uint8Array(subbuf)))); buffers[stdout] = ''; subbuf.length = 0; continue;  }\n"
-  "    subbuf.push(ch);\n"
-  "  }\n"
-  "  if (subbuf.length == 0) return;\n"
-  "  buffers[stdout] += utf8Decoder.decode(new Uint8Array(subbuf));\n"
-  "};globalThis.putchar = putchar;\n");
-
-  nob_sb_append_cstr(sb,
-  "const flush = () => {\n"
-  "  if (buffers[stdout]) console.log(buffers[stdout]);\n"
-  "  buffers[stdout] = '';\n"
-  "};globalThis.flush = flush;\n");
+    nob_da_append(&t->next, next);
+  }
+  size_t typed = 0;
+  nob_da_foreach(AST_Node, it, t->module) {
+    if (it->kind != AST_NK_FN_DECL) {
+      javascript_type_arrays(t, it, &typed);
+      continue;
+    }
+    StringViews globals = t->declared;
+    t->declared = (StringViews){0};
+    t->locals = t->count;
+    javascript_array_scan_fn(t, it);
+    nob_da_foreach(JS_ParamKind, param, &t->params) {
+      if (param->fn != it || !param->seen || param->elem == AST_ELEM_ANY) continue;
+      JS_ArrayVar var = {
+        .name = it->as.fn_decl.params.items[param->index].as.token.sv,
+        .elem = param->elem,
+        .soa = param->soa,
+      };
+      nob_da_append(t, var);
+    }
+    javascript_type_arrays(t, it, &typed);
+    safe_da_free(t->declared);
+    t->declared = globals;
+    t->count = t->locals;
+    t->locals = 0;
+  }
+  return typed;
+}
 
-  nob_sb_append_cstr(sb, "})();\n");
+#define JAVASCRIPT_TYPE_ARRAYS_ROUNDS 16
 
-  nob_temp_rewind(tmp_sp);
+// Give arrays of numbers a typed representation, returns how many array literals got one
+// Parameters of top level functions only called by name take the kind every call agrees on,
+// what a function receives changes what it passes on so rounds go on until nothing changes
+size_t javascript_pass_type_arrays(Pass_Manager *pm) {
+  JS_ArrayTyper t = {
+    .module = pm->module,
+  };
+  StringViews names = {0};
+  nob_da_foreach(AST_Node, it, pm->module) {
+    javascript_array_scan_assignments(&t, it);
+    javascript_array_scan(&t, it, false);
+    javascript_array_scan_names(&names, it, true);
+  }
+  nob_da_foreach(AST_Node, it, pm->module) {
+    if (it->kind != AST_NK_FN_DECL || optimizer_svs_contain(&names, it->as.fn_decl.name)) continue;
+    StringViews globals = t.declared;
+    t.declared = (StringViews){0};
+    javascript_array_scan_fn(&t, it);
+    for (size_t i = 0; i < it->as.fn_decl.params.count; ++i) {
+      if (!javascript_array_var_is_tracked(&t, it->as.fn_decl.params.items[i].as.token.sv)) continue;
+      JS_ParamKind param = {
+        .fn = it,
+        .index = i,
+      };
+      nob_da_append(&t.params, param);
+    }
+    safe_da_free(t.declared);
+    t.declared = globals;
+  }
+  safe_da_free(names);
+  size_t typed = 0;
+  for (size_t round = 0;; ++round) {
+    t.give_up = round == JAVASCRIPT_TYPE_ARRAYS_ROUNDS;
+    if (t.give_up) t.params.count = 0;
+    typed = javascript_type_arrays_round(&t);
+    if (t.give_up) break;
+    bool changed = false;
+    for (size_t i = 0; i < t.params.count; ++i) {
+      JS_ParamKind *param = &t.params.items[i], *next = &t.next.items[i];
+      if (param->seen != next->seen || param->elem != next->elem || !nob_sv_eq(param->soa, next->soa)) changed = true;
+      *param = *next;
+    }
+    if (changed) continue;
+    if (t.escaped.count == 0) break;
+    // Structs whose arrays escaped start over as objects, what the parameters held may not be true anymore
+    nob_da_foreach(Nob_String_View, it, &t.escaped) {
+      if (!optimizer_svs_contain(&t.demoted, *it)) nob_da_append(&t.demoted, *it);
+    }
+    nob_da_foreach(JS_ParamKind, it, &t.params) {
+      it->seen = false;
+    }
+  }
+  safe_da_free(t);
+  safe_da_free(t.declared);
+  safe_da_free(t.assigned);
+  safe_da_free(t.params);
+  safe_da_free(t.next);
+  safe_da_free(t.escaped);
+  safe_da_free(t.demoted);
+  return typed;
 }
 
-bool javascript_run_compilation(Nob_String_Builder *sb, Context *ctx) {
-  AST_Node node = {0};
-  while (true) {
-    node.kind = AST_NK_EOF;
-    if (!ast_chomp(&ctx->lex, &node)) {
-      nob_log(NOB_INFO, "Errored on ast node %s", ast_node_kind_name(node.kind));
-      return false;
+#define javascript_append_fields(sb, decl, fmt) \
+  nob_da_foreach(Nob_String_View, field, &(decl)->fields) nob_sb_appendf(sb, fmt, SV_Arg(*field), SV_Arg(*field))
+
+// Every field gets assigned in the constructor in declaration order so all instances share a single hidden class
+void javascript_compile_struct_declaration(Nob_String_Builder *sb, AST_Node *node) {
+  AST_StructDecl *decl = &node->as.struct_decl;
+  nob_sb_appendf(sb, "class "SV_Fmt" {\n", SV_Arg(decl->name));
+  nob_sb_append_cstr(sb, "  constructor(");
+  nob_da_foreach(Nob_String_View, field, &decl->fields) {
+    if (field != decl->fields.items) nob_sb_append_cstr(sb, ", ");
+    sb_append_sv(sb, (*field));
+  }
+  nob_sb_append_cstr(sb, ") {\n");
+  javascript_append_fields(sb, decl, "    this."SV_Fmt" = "SV_Fmt";\n");
+  nob_sb_append_cstr(sb, "  }\n}\n");
+  if (!optimizer_svs_contain(&decl->attrs, SV(ATTRIBUTE_SOA))) return;
+  if (!javascript_struct_is_soa(node)) {
+    comp_warnf(node->loc, "Arrays of `"SV_Fmt"` stay arrays of objects, a struct of arrays needs fields and can't have any named `length`, `at` or `slice`", SV_Arg(decl->name));
+    return;
+  }
+
+  // Arrays of the struct keep each field in a typed array of its own
+  nob_sb_appendf(sb, "class "SV_Fmt"$soa {\n", SV_Arg(decl->name));
+  nob_sb_append_cstr(sb, "  constructor(length");
+  nob_da_foreach(Nob_String_View, field, &decl->fields) {
+    nob_sb_appendf(sb, ", "SV_Fmt, SV_Arg(*field));
+  }
+  nob_sb_append_cstr(sb, ") {\n");
+  nob_sb_append_cstr(sb, "    this.length = length;\n");
+  javascript_append_fields(sb, decl, "    this."SV_Fmt" = "SV_Fmt";\n");
+  nob_sb_append_cstr(sb, "  }\n");
+  nob_sb_appendf(sb, "  at(i) {\n    return new "SV_Fmt"(", SV_Arg(decl->name));
+  nob_da_foreach(Nob_String_View, field, &decl->fields) {
+    if (field != decl->fields.items) nob_sb_append_cstr(sb, ", ");
+    nob_sb_appendf(sb, "this."SV_Fmt"[i]", SV_Arg(*field));
+  }
+  nob_sb_append_cstr(sb, ");\n  }\n");
+  Nob_String_View first = decl->fields.items[0];
+  nob_sb_append_cstr(sb, "  slice(start, end) {\n");
+  nob_sb_appendf(sb, "    const "SV_Fmt" = this."SV_Fmt".subarray(start, end);\n", SV_Arg(first), SV_Arg(first));
+  nob_sb_appendf(sb, "    return new "SV_Fmt"$soa("SV_Fmt".length", SV_Arg(decl->name), SV_Arg(first));
+  nob_da_foreach(Nob_String_View, field, &decl->fields) {
+    if (field == decl->fields.items) {
+      nob_sb_appendf(sb, ", "SV_Fmt, SV_Arg(*field));
+    } else {
+      nob_sb_appendf(sb, ", this."SV_Fmt".subarray(start, end)", SV_Arg(*field));
+    }
+  }
+  nob_sb_append_cstr(sb, ");\n  }\n}\n");
+}
+
+typedef enum {
+  JS_MANGLE_DECLARE,
+  JS_MANGLE_COUNT,
+  JS_MANGLE_RENAME,
+} JS_Mangle_Phase;
+
+// Short names for the locals of a top level function, nested functions included
+// Every local is renamed the same wherever it shows up, new names don't collide with any other so shadowing stays the same
+typedef struct {
+  JS_Mangle_Phase phase;
+  // Top level declarations and runtime names, kept as they are
+  StringViews *globals;
+  StringViews locals;
+  Optimizer_Indices uses;
+  // Every name mentioned that isn't a local
+  StringViews taken;
+  Optimizer_Renames renames;
+} JS_Mangler;
+
+void javascript_mangle_name(JS_Mangler *m, Nob_String_View *name, bool declares) {
+  switch (m->phase) {
+  case JS_MANGLE_DECLARE:
+    if (!declares || optimizer_svs_contain(&m->locals, *name) || optimizer_svs_contain(m->globals, *name)) return;
+    // Read by the loops pipelines compile to
+    if (sv_eq_str(*name, AST_PIPE_ITEM) || sv_eq_str(*name, AST_PIPE_ACC)) return;
+    nob_da_append(&m->locals, *name);
+    nob_da_append(&m->uses, 0);
+    return;
+  case JS_MANGLE_COUNT:
+    for (size_t i = 0; i < m->locals.count; ++i) {
+      if (!nob_sv_eq(m->locals.items[i], *name)) continue;
+      m->uses.items[i] += 1;
+      return;
+    }
+    if (!optimizer_svs_contain(&m->taken, *name)) nob_da_append(&m->taken, *name);
+    return;
+  case JS_MANGLE_RENAME:
+    *name = optimizer_rename_lookup(&m->renames, *name);
+    return;
+  }
+}
+
+void javascript_mangle_node(JS_Mangler *m, AST_Node *node) {
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    if (node->as.token.kind == TOK_IDENT) javascript_mangle_name(m, &node->as.token.sv, false);
+    return;
+  case AST_NK_VAR_DECL:
+    javascript_mangle_name(m, &node->as.var_decl.name, true);
+    break;
+  case AST_NK_ASSIGNMENT:
+    javascript_mangle_name(m, &node->as.var_assign.name, false);
+    break;
+  case AST_NK_FOR:
+    javascript_mangle_name(m, &node->as.for_loop.name, true);
+    break;
+  case AST_NK_FN_CALL:
+    javascript_mangle_name(m, &node->as.fn_call.name, false);
+    break;
+  case AST_NK_FN_DECL:
+    javascript_mangle_name(m, &node->as.fn_decl.name, true);
+    nob_da_foreach(AST_Node, param, &node->as.fn_decl.params) {
+      javascript_mangle_name(m, &param->as.token.sv, true);
+    }
+    nob_da_foreach(AST_Node, it, &node->as.fn_decl.body) {
+      javascript_mangle_node(m, it);
+    }
+    return;
+  default:
+    break;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      javascript_mangle_node(m, it);
+    }
+  }
+}
+
+// The top level function keeps its own name
+void javascript_mangle_fn(JS_Mangler *m, AST_Node *fn, JS_Mangle_Phase phase) {
+  m->phase = phase;
+  nob_da_foreach(AST_Node, param, &fn->as.fn_decl.params) {
+    javascript_mangle_name(m, &param->as.token.sv, true);
+  }
+  nob_da_foreach(AST_Node, it, &fn->as.fn_decl.body) {
+    javascript_mangle_node(m, it);
+  }
+}
+
+// Gives the locals of every function the shortest names available when minifying, top level names stay as they are
+size_t javascript_pass_mangle_locals(Pass_Manager *pm) {
+  if (!pm->opts->minify) return 0;
+  StringViews globals = {0};
+  nob_da_foreach(AST_Node, it, pm->module) {
+    switch (it->kind) {
+    case AST_NK_FN_DECL: nob_da_append(&globals, it->as.fn_decl.name); break;
+    case AST_NK_VAR_DECL: nob_da_append(&globals, it->as.var_decl.name); break;
+    case AST_NK_STRUCT_DECL: nob_da_append(&globals, it->as.struct_decl.name); break;
+    default: break;
+    }
+  }
+  carray_foreach(JS_RuntimeFragment, it, javascript_core_io_fragments) {
+    nob_da_append(&globals, SV(it->name));
+  }
+
+  size_t renamed = 0;
+  nob_da_foreach(AST_Node, it, pm->module) {
+    if (it->kind != AST_NK_FN_DECL) continue;
+    JS_Mangler m = {
+      .globals = &globals,
+    };
+    javascript_mangle_fn(&m, it, JS_MANGLE_DECLARE);
+    javascript_mangle_fn(&m, it, JS_MANGLE_COUNT);
+    nob_da_foreach(Nob_String_View, global, &globals) nob_da_append(&m.taken, *global);
+    javascript_sort_by_uses(&m.locals, &m.uses);
+    size_t next = 0;
+    nob_da_foreach(Nob_String_View, local, &m.locals) {
+      nob_da_append(&m.renames.from, *local);
+      nob_da_append(&m.renames.to, javascript_next_short_name(&next, &m.taken));
+      renamed += m.uses.items[local - m.locals.items];
+    }
+    javascript_mangle_fn(&m, it, JS_MANGLE_RENAME);
+    safe_da_free(m.locals);
+    safe_da_free(m.uses);
+    safe_da_free(m.taken);
+    safe_da_free(m.renames.from);
+    safe_da_free(m.renames.to);
+  }
+  safe_da_free(globals);
+  return renamed;
+}
+
+// Passes run over the module before emitting it, in order
+const Pass javascript_pipeline[] = {
+  { .name = "unshadow", .required = true, .run = javascript_pass_unshadow_locals },
+  { .name = "lambda-lift", .min_level = 0, .for_size = true, .run = pass_lift_lambdas },
+  { .name = "fold-constants", .min_level = 0, .for_size = true, .run = pass_fold_constants },
+  { .name = "inline", .min_level = 0, .for_size = false, .run = pass_inline_calls },
+  { .name = "cse", .min_level = 2, .for_size = true, .preserves = PASS_PRESERVES(PASS_ANALYSIS_PURITY), .run = pass_eliminate_common_subexprs },
+  { .name = "licm", .min_level = 2, .for_size = false, .preserves = PASS_PRESERVES(PASS_ANALYSIS_PURITY), .run = pass_hoist_loop_invariants },
+  {
+    .name = "lower-io-writes",
+    .min_level = 1,
+    .for_size = true,
+    // The statement lists get rebuilt so the tail call sites have to be found again
+    .preserves = PASS_PRESERVES(PASS_ANALYSIS_PURITY) | PASS_PRESERVES(PASS_ANALYSIS_MEMOIZE),
+    .run = javascript_pass_lower_core_io_writes,
+  },
+  { .name = "tree-shake", .min_level = 0, .for_size = true, .run = pass_tree_shake },
+  {
+    .name = "match-tables",
+    .min_level = 1,
+    .for_size = true,
+    // Only numbers the matches, nothing moves
+    .preserves = PASS_PRESERVES(PASS_ANALYSIS_PURITY) | PASS_PRESERVES(PASS_ANALYSIS_TAIL_CALLS) | PASS_PRESERVES(PASS_ANALYSIS_MEMOIZE) | PASS_PRESERVES(PASS_ANALYSIS_DISPATCH),
+    .run = javascript_pass_assign_match_tables,
+  },
+  {
+    .name = "typed-arrays",
+    .min_level = 0,
+    .for_size = true,
+    // Only picks how arrays are stored
+    .preserves = PASS_PRESERVES(PASS_ANALYSIS_PURITY) | PASS_PRESERVES(PASS_ANALYSIS_TAIL_CALLS) | PASS_PRESERVES(PASS_ANALYSIS_MEMOIZE) | PASS_PRESERVES(PASS_ANALYSIS_DISPATCH),
+    .run = javascript_pass_type_arrays,
+  },
+  {
+    // Runs last so the names the other passes made up get shortened too
+    .name = "mangle",
+    .min_level = 0,
+    .for_size = true,
+    // Chains of `if`s hold the name of the variable they compare
+    .preserves = PASS_PRESERVES(PASS_ANALYSIS_PURITY) | PASS_PRESERVES(PASS_ANALYSIS_TAIL_CALLS) | PASS_PRESERVES(PASS_ANALYSIS_MEMOIZE),
+    .run = javascript_pass_mangle_locals,
+  },
+};
+const size_t javascript_pipeline_count = NOB_ARRAY_LEN(javascript_pipeline);
+
+bool javascript_drain(Output_Sink *out, Nob_String_Builder *sb, Context *ctx) {
+  if (ctx->opts.minify) javascript_minify(sb, 0, NULL);
+  if (javascript_source_map != NULL && !javascript_map_item(javascript_source_map, sb)) return false;
+  return output_sink_drain(out, sb);
+}
+
+// Emits the module through a single builder that gets drained into the sink after every item, so it only grows as big as the largest one
+bool javascript_has_fn(Context *ctx, const char *name) {
+  nob_da_foreach(Fn, fn, &ctx->fns) {
+    if (sv_eq_str(fn->name, name)) return true;
+  }
+  return false;
+}
+
+bool javascript_compile_module_items(Output_Sink *out, Nob_String_Builder *sb, Context *ctx, Pass_Manager *pm) {
+  Optimizer_TailGroups *tail_groups = pass_manager_tail_groups(pm);
+
+  bool tables_emitted = false;
+  size_t par_globals = 0;
+  nob_da_foreach(AST_Node, it, &ctx->module) {
+    if (!javascript_drain(out, sb, ctx)) return false;
+    AST_Node node = *it;
+    if (!tables_emitted && node.kind != AST_NK_IMPORT) {
+      // After the runtime of the imports and before any code that might look them up
+      tables_emitted = true;
+      size_t start = sb->count;
+      // Classes aren't hoisted like functions are
+      nob_da_foreach(AST_Node, decl, &ctx->module) {
+        if (decl->kind == AST_NK_STRUCT_DECL) javascript_compile_struct_declaration(sb, decl);
+      }
+      nob_da_foreach(AST_Node, decl, &ctx->module) {
+        if (!javascript_compile_match_tables(sb, decl)) return false;
+      }
+      if (sb->count > start) nob_sb_append_cstr(sb, "\n");
     }
     switch (node.kind) {
     case AST_NK_EOF: return true;
 
     // Atoms
     case AST_NK_TOKEN:
-      comp_warnf(ctx->lex.loc, "Dangling atom %s at top level", ast_node_kind_name(node.kind));
+      comp_warnf(node.loc, "Dangling atom %s at top level", ast_node_kind_name(node.kind));
       break;
-    case AST_NK_IMPORT:
-      if (sv_eq_str(node.as.import.name, "core:io")) {
-        javascript_import_core_io(sb, ctx);
+    case AST_NK_IMPORT: {
+      JS_Library *lib = javascript_find_library(node.as.import.name);
+      if (lib != NULL) {
+        if (lib->check != NULL && !lib->check(&ctx->module)) return false;
+        javascript_import_library(sb, ctx, lib);
         break;
       }
       TODO("Implement imports in javascript declaration");
-      break;
+    } break;
 
       // Molecules
     case AST_NK_UNOP:
     case AST_NK_BINOP:
-      comp_warnf(ctx->lex.loc, "Dangling molecules %s at top level", ast_node_kind_name(node.kind));
+      comp_warnf(node.loc, "Dangling molecules %s at top level", ast_node_kind_name(node.kind));
       break;
     case AST_NK_FN_PARAMS_DECL:
-      comp_errorf(ctx->lex.loc, "Impossibly dangling molecules %s found", ast_node_kind_name(node.kind));
+      comp_errorf(node.loc, "Impossibly dangling molecules %s found", ast_node_kind_name(node.kind));
       HEREf("Impossible dangling %s found. Gotta debug lexing/parsing", ast_node_kind_name(node.kind));
       break;
 
@@ -286,25 +4315,84 @@ bool javascript_run_compilation(Nob_String_Builder *sb, Context *ctx) {
       break;
     case AST_NK_VAR_DECL:
       // TODO: Check if global variable is being re-declared
+      if (javascript_has_fn(ctx, "$parGlobal") && javascript_is_par_global(it)) {
+        javascript_map(sb, it);
+        nob_sb_appendf(sb, "const "SV_Fmt" = $parGlobal(%zu, () => ", SV_Arg(node.as.var_decl.name), par_globals++);
+        if (!javascript_compile_expr_at_depth(sb, &node.as.var_decl.expr, 0)) return false;
+        nob_sb_append_cstr(sb, ");");
+        break;
+      }
       if (!javascript_compile_var_declaration(sb, node, 0)) return false;
       break;
-    case AST_NK_FN_DECL:
-      if (!javascript_compile_fn_declaration(sb, node, 0)) {
+    case AST_NK_FN_DECL: {
+      JS_Function fn = {
+        .node = it,
+        .module = &ctx->module,
+        .tail_group = optimizer_tail_group_of(tail_groups, it - ctx->module.items),
+        .memoized = pass_manager_is_memoized(pm, it),
+        .pm = pm,
+      };
+      if (!javascript_compile_fn_declaration(sb, &fn, 0)) {
         return false;
       }
       if (sv_eq_str(node.as.fn_decl.name, "main")) {
         ctx->main_is_defined = true;
       }
-      break;
+    } break;
+    case AST_NK_STRUCT_DECL:
+      // Already emitted ahead of everything else
+      continue;
     default:
       TODOf("Implement missing AST Node kind ('%s') compilation", ast_node_kind_name(node.kind));
     }
     nob_sb_append_cstr(sb, "\n");
   }
+  return true;
+}
+
+bool javascript_run_compilation(Output_Sink *out, Context *ctx, Pass_Manager *pm) {
+  Nob_String_Builder item = {0};
+  bool ok = javascript_compile_module_items(out, &item, ctx, pm);
+  if (!javascript_drain(out, &item, ctx)) ok = false;
+  safe_da_free(item);
+  return ok;
 }
 
-void javascript_compilation_epilogue(Nob_String_Builder *sb, Context *ctx) {
-  if (ctx->main_is_defined) nob_sb_append_cstr(sb, "\n{ const r = main(); flush(); if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } }\n");
+void javascript_compilation_epilogue(Output_Sink *out, Context *ctx) {
+  if (!ctx->main_is_defined) return;
+  bool has_flush = javascript_has_fn(ctx, "flush");
+  bool has_par = javascript_has_fn(ctx, "$parEntry");
+  Nob_String_Builder sb = {0};
+  nob_sb_append_cstr(&sb, "\n");
+  if (has_par) {
+    // The workers of core:par load this same file and must not run main
+    StringViews entries = {0};
+    javascript_par_entries(&ctx->module, &ctx->module, &entries);
+    nob_sb_appendf(&sb, "if (!$parEntry(%s, [", ctx->opts.esm ? "new URL(import.meta.url)" : "__filename");
+    nob_da_foreach(Nob_String_View, it, &entries) {
+      if (it != entries.items) nob_sb_append_cstr(&sb, ", ");
+      sb_append_sv(&sb, (*it));
+    }
+    nob_sb_appendf(&sb, "], %s, () => [", javascript_has_fn(ctx, "$drain") ? "$drain" : "null");
+    bool first = true;
+    nob_da_foreach(AST_Node, it, &ctx->module) {
+      if (!javascript_is_par_global(it)) continue;
+      if (!first) nob_sb_append_cstr(&sb, ", ");
+      sb_append_sv(&sb, it->as.var_decl.name);
+      first = false;
+    }
+    nob_sb_append_cstr(&sb, "])) ");
+    safe_da_free(entries);
+  }
+  // An async main is done once its promise settles, only then is its output complete
+  AST_Node *main_fn = optimizer_find_fn(&ctx->module, SV("main"));
+  bool async = main_fn != NULL && main_fn->as.fn_decl.async;
+  nob_sb_append_cstr(&sb, async ? "main().then((r) => { " : "{ const r = main(); ");
+  if (has_flush) nob_sb_append_cstr(&sb, "flush(); ");
+  nob_sb_append_cstr(&sb, "if (typeof r === 'number') if (r != 0) { throw new Error(`Program exited with non-zero exit code: ${r}`); } ");
+  nob_sb_append_cstr(&sb, async ? "});\n" : "}\n");
+  javascript_drain(out, &sb, ctx);
+  nob_sb_free(sb);
 }
 
 #endif // DWOC_JS_IMPLEMENTATION
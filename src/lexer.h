@@ -9,6 +9,7 @@ typedef enum {
   TOK_IDENT,
   TOK_SYMBOL,
   TOK_INT,
+  TOK_STR, // Kept with its quotes and escapes as written in the source
 } TokenKind;
 
 typedef struct {
@@ -21,6 +22,9 @@ typedef struct {
   TokenKind kind;
 } Lexer;
 
+// Symbols that get lexed as a single token when they appear next to each other
+static const char *TWO_CHAR_OPERATORS[] = { "==", "!=", "<=", ">=", "&&", "||", "=>", "|>", ".." };
+
 typedef struct Token Token;
 
 struct Token {
@@ -41,6 +45,12 @@ bool lexer_next_token(Lexer *l);
 // Write the string representation of the passed in token
 void dump_token(Nob_String_Builder *sb, Token tok);
 
+// Append the text a string literal token stands for, with the quotes removed and the escapes resolved
+void lexer_unescape_string(Nob_String_Builder *sb, Nob_String_View literal);
+
+// Append a string literal token that unescapes back to the text
+void lexer_escape_string(Nob_String_Builder *sb, Nob_String_View text);
+
 // Move lexer ahead by one and store token data in a token
 #define next_token(l, tok) move_lexer_ahead_by(l, tok, 1)
 // Move lexer ahead by arbitrary amount and store last viewed token data in a token
@@ -93,6 +103,8 @@ const char *token_kind_name(TokenKind kind) {
     return "Symbol";
   case TOK_INT:
     return "Integer_Literal";
+  case TOK_STR:
+    return "String_Literal";
 
   default:
     return "<Unsupported-Token-Kind>";
@@ -167,11 +179,40 @@ bool lexer_next_token(Lexer *l) {
       l->at_point++;
       len++;
     }
+    // Strings, an unterminated one is left as an unknown token up to the end of the line
+  } else if (firstchar == '"') {
+    l->kind = TOK_UNKNOWN;
+    l->at_point++;
+    len++;
+    while (l->at_point < l->source_len && l->source[l->at_point] != '\n') {
+      char c = l->source[l->at_point];
+      l->at_point++;
+      len++;
+      if (c == '"') {
+        l->kind = TOK_STR;
+        break;
+      }
+      if (c == '\\' && l->at_point < l->source_len && l->source[l->at_point] != '\n') {
+        l->at_point++;
+        len++;
+      }
+    }
     // Symbols
   } else if (ispunct(firstchar)) {
     l->kind = TOK_SYMBOL;
     l->at_point++;
     len++;
+    // Operators made of two symbols are kept as a single token
+    if (l->at_point < l->source_len) {
+      char second = l->source[l->at_point];
+      carray_foreach(const char*, op, TWO_CHAR_OPERATORS) {
+        if ((*op)[0] == firstchar && (*op)[1] == second) {
+          l->at_point++;
+          len++;
+          break;
+        }
+      }
+    }
     // Everything else which is unknown
   } else {
     l->kind = TOK_UNKNOWN;
@@ -211,12 +252,50 @@ void dump_token(Nob_String_Builder *sb, Token tok) {
   case TOK_INT:
     nob_sb_appendf(sb, "Token::IntLit(%d)", tok.integer);
     break;
+  case TOK_STR:
+    nob_sb_appendf(sb, "Token::StrLit("SV_Fmt")", SV_Arg(tok.sv));
+    break;
   default:
     NOB_UNREACHABLE("dump_token: TokenKind match");
     break;
   }
 }
 
+void lexer_unescape_string(Nob_String_Builder *sb, Nob_String_View literal) {
+  for (size_t i = 1; i + 1 < literal.count; ++i) {
+    char c = literal.data[i];
+    if (c != '\\' || i + 2 >= literal.count) {
+      nob_da_append(sb, c);
+      continue;
+    }
+    c = literal.data[++i];
+    switch (c) {
+    case 'n': nob_da_append(sb, '\n'); break;
+    case 't': nob_da_append(sb, '\t'); break;
+    case 'r': nob_da_append(sb, '\r'); break;
+    case '0': nob_da_append(sb, '\0'); break;
+    default: nob_da_append(sb, c); break;
+    }
+  }
+}
+
+void lexer_escape_string(Nob_String_Builder *sb, Nob_String_View text) {
+  nob_da_append(sb, '"');
+  for (size_t i = 0; i < text.count; ++i) {
+    char c = text.data[i];
+    switch (c) {
+    case '\n': nob_sb_append_cstr(sb, "\\n"); break;
+    case '\t': nob_sb_append_cstr(sb, "\\t"); break;
+    case '\r': nob_sb_append_cstr(sb, "\\r"); break;
+    case '\0': nob_sb_append_cstr(sb, "\\0"); break;
+    case '"': nob_sb_append_cstr(sb, "\\\""); break;
+    case '\\': nob_sb_append_cstr(sb, "\\\\"); break;
+    default: nob_da_append(sb, c); break;
+    }
+  }
+  nob_da_append(sb, '"');
+}
+
 bool move_lexer_ahead_by(Lexer *l, Token *tok, int amount) {
   for (int i = 0; i < amount; ++i) {
     if (lexer_next_token(l)) {
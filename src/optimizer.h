@@ -0,0 +1,2862 @@
+#ifndef __DWOC_OPTIMIZER_H
+#define __DWOC_OPTIMIZER_H
+
+#include <limits.h>
+#include <math.h>
+
+#include "utils.h"
+#include "ast.h"
+#include "interpreter.h"
+
+#ifndef NOB_IMPLEMENTATION
+#  include "nob.h"
+#endif
+
+// Name under which a top level node is known to the rest of the module, empty if it declares nothing
+Nob_String_View optimizer_decl_name(AST_Node *node);
+
+// Push every identifier the node mentions (calls, variable reads and writes) onto refs
+void optimizer_collect_refs(AST_Node *node, StringViews *refs);
+
+// Drop every top level `fn` and `let` that can't be reached from `main`
+// Modules without a `main` are treated as libraries where every declaration is exported and nothing is dropped
+// Returns the amount of declarations that were removed
+size_t optimizer_tree_shake(AST_NodeList *module);
+
+// Default inlining budget for an optimization level
+size_t optimizer_inline_budget_for_level(int opt_level);
+
+// Amount of nodes in the subtree, used as the size metric of the inliner's cost model
+size_t optimizer_node_cost(AST_Node *node);
+
+// Find the top level function declaration with the given name
+AST_Node *optimizer_find_fn(AST_NodeList *module, Nob_String_View name);
+
+// Whether calling the function can end up calling it again
+bool optimizer_fn_is_recursive(AST_NodeList *module, AST_Node *fn);
+
+// Node an expression of a single node stands for, without the parentheses around it
+AST_Node *optimizer_unwrap_expr(AST_Node *node);
+
+// Replace call statements to small non-recursive functions by a block with the body of the function
+// Calls used as a value are replaced when the function is a single `return`, like `fn sq(x) { return x * x; }`
+// Returns the amount of calls that were inlined
+size_t optimizer_inline_calls(AST_NodeList *module, Options *opts);
+
+typedef struct {
+  AST_Node **items;
+  size_t count;
+  size_t capacity;
+} AST_NodePtrs;
+
+typedef struct {
+  size_t *items;
+  size_t count;
+  size_t capacity;
+} Optimizer_Indices;
+
+// Functions that tail call each other, a self recursive function makes up a group on its own
+typedef struct {
+  // Indices into the module of the functions in the group, in module order
+  Optimizer_Indices fns;
+  // `return f(...)` statements and trailing `f(...)` call statements that can jump to the start of a function of the group
+  AST_NodePtrs sites;
+} Optimizer_TailGroup;
+
+typedef struct {
+  Optimizer_TailGroup *items;
+  size_t count;
+  size_t capacity;
+} Optimizer_TailGroups;
+
+// Group the functions of the module into strongly connected components of their tail calls
+// Only components where at least one tail call stays inside of the component are stored
+void optimizer_find_tail_groups(AST_NodeList *module, Optimizer_TailGroups *groups);
+
+// Group the function at the module index is part of, NULL if it has no tail calls to eliminate
+Optimizer_TailGroup *optimizer_tail_group_of(Optimizer_TailGroups *groups, size_t fn_index);
+
+// Whether the result of the function only depends on its arguments
+// Pure functions do no I/O, don't touch mutable globals and only call other pure functions
+// When it isn't pure, offender is set to the first node found breaking that
+bool optimizer_fn_is_pure(AST_NodeList *module, AST_Node *fn, AST_Node **offender);
+// Same for evaluating an expression inside of a function that declares the locals
+bool optimizer_expr_is_pure(AST_NodeList *module, StringViews *locals, AST_Node *node);
+
+// Whether calls to the function should go through a compiler generated cache
+// Functions opt in with `@memo`, from -O2 pure functions calling themselves more than once are picked on their own
+// The cache is keyed by the arguments, so every call has to be proven to pass numbers only
+// -Os leaves the choice to `@memo` as the caching wrapper grows the output
+bool optimizer_should_memoize(AST_NodeList *module, AST_Node *fn, Options *opts);
+
+// Default step limit of compile time evaluation for an optimization level
+size_t optimizer_ctfe_steps_for_level(int opt_level);
+
+// Replace calls and operations whose operands are all known at compile time with the number they evaluate to
+// Immutable locals bound to a literal are replaced by the literal itself
+// Evaluation happens in a sandboxed interpreter, anything it can't run or that goes over the limits is left for the runtime
+// Returns the amount of expressions that were folded
+size_t optimizer_fold_constants(AST_NodeList *module, Options *opts);
+
+// Source like rendering of an expression, used by the optimization reports
+void optimizer_append_expr(Nob_String_Builder *sb, AST_Node *node);
+
+typedef enum {
+  OPTIMIZER_CALL_UNCHECKED = 0,
+  OPTIMIZER_CALL_IMPURE,
+  // Pure but it might never return, calling it earlier than the program would can change what gets printed before hanging
+  OPTIMIZER_CALL_PURE,
+  // Pure, not recursive and without loops, so it always returns
+  OPTIMIZER_CALL_TOTAL,
+} Optimizer_Call_Kind;
+
+// Classify calls to every function of the module, calls holds an entry per module index
+void optimizer_classify_calls(AST_NodeList *module, Optimizer_Call_Kind *calls);
+
+// Compute operations and pure calls repeated within a function body once, later occurrences read the stored value
+// Returns the amount of occurrences that were replaced
+size_t optimizer_eliminate_common_subexprs(AST_NodeList *module, Options *opts, Optimizer_Call_Kind *calls);
+
+// Compute operations and pure calls inside of a `while` loop whose operands the loop never changes once before the loop
+// Returns the amount of expressions that were hoisted
+size_t optimizer_hoist_loop_invariants(AST_NodeList *module, Options *opts, Optimizer_Call_Kind *calls);
+
+// Widest range of values a table indexed by them may cover
+#define OPTIMIZER_MAX_TABLE_SPAN 1024
+
+typedef struct {
+  double value;
+  // Statements that run when the subject holds the value, the value of the arm for a match
+  AST_NodeList *body;
+} Optimizer_Case;
+
+typedef struct {
+  Optimizer_Case *items;
+  size_t count;
+  size_t capacity;
+} Optimizer_Cases;
+
+// Insert keeping the cases sorted by value, a value that is already there keeps its first body as the later one is never reached
+void optimizer_cases_add(Optimizer_Cases *cases, double value, AST_NodeList *body);
+
+// Values close enough together for a table indexed by them: at least three and no more than twice as many slots as values
+bool optimizer_cases_are_dense(Optimizer_Cases *cases);
+
+// Enough cases for a jump table or a binary search to beat comparing against them one after another
+bool optimizer_cases_are_worth_dispatch(Optimizer_Cases *cases);
+
+// Cases of a match in order of their values, fallback is set to the value of the `_` arm or NULL without one
+void optimizer_match_cases(AST_Node *match, Optimizer_Cases *cases, AST_NodeList **fallback);
+
+// Chain of `if`s comparing the same variable against integer literals with `==`
+typedef struct {
+  // First statement of the chain in its statement list
+  AST_Node *head;
+  // Statements of the list it spans, consecutive `if`s without `else` whose bodies all return make up a single chain
+  size_t length;
+  Nob_String_View subject;
+  Optimizer_Cases cases;
+  // Body of the final `else`, NULL when there is none
+  AST_NodeList *fallback;
+} Optimizer_Dispatch;
+
+typedef struct {
+  Optimizer_Dispatch *items;
+  size_t count;
+  size_t capacity;
+} Optimizer_Dispatches;
+
+// Find the `if` chains of every function that are worth turning into a dispatch on the value
+void optimizer_find_dispatches(AST_NodeList *module, Optimizer_Dispatches *dispatches);
+
+// Chain starting at the statement, NULL if it doesn't start one
+Optimizer_Dispatch *optimizer_dispatch_at(Optimizer_Dispatches *dispatches, AST_Node *head);
+
+// Move nested functions to the top level when they don't escape and only read variables of the enclosing functions that never change
+// Those variables become extra parameters passed at every call, the nested functions that can't be moved stay closures
+// Returns the amount of functions that were lifted
+size_t optimizer_lift_lambdas(AST_NodeList *module);
+
+#endif // __DWOC_OPTIMIZER_H
+
+#ifdef DWOC_OPTIMIZER_IMPLEMENTATION
+
+Nob_String_View optimizer_decl_name(AST_Node *node) {
+  switch (node->kind) {
+  case AST_NK_FN_DECL:
+    return node->as.fn_decl.name;
+  case AST_NK_VAR_DECL:
+    return node->as.var_decl.name;
+  case AST_NK_STRUCT_DECL:
+    return node->as.struct_decl.name;
+  default:
+    return SVl(NULL, 0);
+  }
+}
+
+void optimizer_collect_refs_in_list(AST_NodeList *list, StringViews *refs) {
+  nob_da_foreach(AST_Node, it, list) {
+    optimizer_collect_refs(it, refs);
+  }
+}
+
+void optimizer_collect_refs(AST_Node *node, StringViews *refs) {
+  switch (node->kind) {
+  case AST_NK_EOF:
+  case AST_NK_IMPORT:
+  case AST_NK_STRUCT_DECL:
+    return;
+
+  case AST_NK_TOKEN:
+    if (node->as.token.kind == TOK_IDENT) nob_da_append(refs, node->as.token.sv);
+    return;
+
+  case AST_NK_FN_PARAMS_DECL:
+    return;
+
+  case AST_NK_UNOP:
+  case AST_NK_BINOP:
+    optimizer_collect_refs_in_list(&node->as.op.operands, refs);
+    return;
+  case AST_NK_EXPR:
+    optimizer_collect_refs_in_list(&node->as.expr, refs);
+    return;
+  case AST_NK_VAR_DECL:
+    optimizer_collect_refs_in_list(&node->as.var_decl.expr, refs);
+    return;
+  case AST_NK_ASSIGNMENT:
+    nob_da_append(refs, node->as.var_assign.name);
+    optimizer_collect_refs_in_list(&node->as.var_assign.expr, refs);
+    return;
+  case AST_NK_FN_DECL:
+    optimizer_collect_refs_in_list(&node->as.fn_decl.body, refs);
+    return;
+  case AST_NK_FN_CALL:
+    nob_da_append(refs, node->as.fn_call.name);
+    optimizer_collect_refs_in_list(&node->as.fn_call.params, refs);
+    return;
+  case AST_NK_BLOCK:
+    optimizer_collect_refs_in_list(&node->as.block, refs);
+    return;
+  case AST_NK_IF:
+    optimizer_collect_refs_in_list(&node->as.if_stmt.cond, refs);
+    optimizer_collect_refs_in_list(&node->as.if_stmt.then_body, refs);
+    optimizer_collect_refs_in_list(&node->as.if_stmt.else_body, refs);
+    return;
+  case AST_NK_WHILE:
+    optimizer_collect_refs_in_list(&node->as.while_loop.cond, refs);
+    optimizer_collect_refs_in_list(&node->as.while_loop.body, refs);
+    return;
+  case AST_NK_RETURN:
+    optimizer_collect_refs_in_list(&node->as.ret, refs);
+    return;
+  case AST_NK_YIELD:
+    optimizer_collect_refs_in_list(&node->as.yield, refs);
+    return;
+  case AST_NK_AWAIT:
+    optimizer_collect_refs_in_list(&node->as.awaited, refs);
+    return;
+  case AST_NK_FOR:
+    optimizer_collect_refs_in_list(&node->as.for_loop.iter, refs);
+    optimizer_collect_refs_in_list(&node->as.for_loop.body, refs);
+    return;
+  case AST_NK_MATCH:
+    optimizer_collect_refs_in_list(&node->as.match.subject, refs);
+    optimizer_collect_refs_in_list(&node->as.match.arms, refs);
+    return;
+  case AST_NK_MATCH_ARM:
+    optimizer_collect_refs_in_list(&node->as.match_arm.value, refs);
+    return;
+  case AST_NK_ARRAY:
+    optimizer_collect_refs_in_list(&node->as.array.items, refs);
+    optimizer_collect_refs_in_list(&node->as.array.length, refs);
+    return;
+  case AST_NK_INDEX:
+    optimizer_collect_refs_in_list(&node->as.index.target, refs);
+    optimizer_collect_refs_in_list(&node->as.index.start, refs);
+    optimizer_collect_refs_in_list(&node->as.index.end, refs);
+    return;
+  case AST_NK_FIELD:
+    optimizer_collect_refs_in_list(&node->as.field.target, refs);
+    return;
+  case AST_NK_PIPELINE:
+    optimizer_collect_refs_in_list(&node->as.pipeline.source, refs);
+    optimizer_collect_refs_in_list(&node->as.pipeline.stages, refs);
+    return;
+  case AST_NK_PIPE_STAGE:
+    optimizer_collect_refs_in_list(&node->as.pipe_stage.call, refs);
+    optimizer_collect_refs_in_list(&node->as.pipe_stage.init, refs);
+    return;
+  }
+  TODOf("optimizer_collect_refs: Collect references of %s", ast_node_kind_name(node->kind));
+}
+
+size_t optimizer_tree_shake(AST_NodeList *module) {
+  if (module->count == 0) return 0;
+
+  bool *reachable = NOB_REALLOC(NULL, module->count * sizeof(bool));
+  NOB_ASSERT(reachable != NULL && "Buy more RAM lol");
+  memset(reachable, 0, module->count * sizeof(bool));
+
+  // Work list of top level nodes whose references still have to be followed
+  struct {
+    size_t *items;
+    size_t count;
+    size_t capacity;
+  } pending = {0};
+
+  bool has_main = false;
+  for (size_t i = 0; i < module->count; ++i) {
+    AST_Node *node = &module->items[i];
+    if (node->kind == AST_NK_FN_DECL && sv_eq_str(node->as.fn_decl.name, "main")) {
+      has_main = true;
+      break;
+    }
+  }
+
+  for (size_t i = 0; i < module->count; ++i) {
+    AST_Node *node = &module->items[i];
+    Nob_String_View name = optimizer_decl_name(node);
+    // Imports and other non declarations always stay
+    bool is_root = name.count == 0 || !has_main || sv_eq_str(name, "main");
+    if (!is_root) continue;
+    reachable[i] = true;
+    nob_da_append(&pending, i);
+  }
+
+  StringViews refs = {0};
+  while (pending.count > 0) {
+    size_t index = da_pop(&pending);
+    refs.count = 0;
+    optimizer_collect_refs(&module->items[index], &refs);
+    nob_da_foreach(Nob_String_View, ref, &refs) {
+      // Every declaration sharing the name is kept, so a local shadowing a global only ever keeps more code alive
+      for (size_t i = 0; i < module->count; ++i) {
+        if (reachable[i]) continue;
+        if (!nob_sv_eq(optimizer_decl_name(&module->items[i]), *ref)) continue;
+        reachable[i] = true;
+        nob_da_append(&pending, i);
+      }
+    }
+  }
+
+  size_t kept = 0;
+  for (size_t i = 0; i < module->count; ++i) {
+    if (reachable[i]) {
+      module->items[kept++] = module->items[i];
+    } else {
+      ast_node_children_free(&module->items[i]);
+    }
+  }
+  size_t dropped = module->count - kept;
+  module->count = kept;
+
+  safe_da_free(refs);
+  safe_da_free(pending);
+  NOB_FREE(reachable);
+  return dropped;
+}
+
+size_t optimizer_inline_budget_for_level(int opt_level) {
+  switch (opt_level) {
+  case 0: return 0;
+  case 1: return 16;
+  default: return 48;
+  }
+}
+
+size_t optimizer_node_list_cost(AST_NodeList *list) {
+  size_t cost = 0;
+  nob_da_foreach(AST_Node, it, list) {
+    cost += optimizer_node_cost(it);
+  }
+  return cost;
+}
+
+size_t optimizer_node_cost(AST_Node *node) {
+  size_t cost = 1;
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    cost += optimizer_node_list_cost(lists[i]);
+  }
+  return cost;
+}
+
+bool optimizer_contains_kind(AST_Node *node, AST_Node_Kind kind) {
+  if (node->kind == kind) return true;
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (optimizer_contains_kind(it, kind)) return true;
+    }
+  }
+  return false;
+}
+
+AST_Node *optimizer_find_fn(AST_NodeList *module, Nob_String_View name) {
+  nob_da_foreach(AST_Node, it, module) {
+    if (it->kind == AST_NK_FN_DECL && nob_sv_eq(it->as.fn_decl.name, name)) return it;
+  }
+  return NULL;
+}
+
+bool optimizer_fn_reaches(AST_NodeList *module, AST_Node *from, Nob_String_View target, bool *visited) {
+  size_t index = from - module->items;
+  if (visited[index]) return false;
+  visited[index] = true;
+
+  bool found = false;
+  StringViews refs = {0};
+  optimizer_collect_refs(from, &refs);
+  nob_da_foreach(Nob_String_View, ref, &refs) {
+    if (nob_sv_eq(*ref, target)) {
+      found = true;
+      break;
+    }
+    AST_Node *callee = optimizer_find_fn(module, *ref);
+    if (callee != NULL && optimizer_fn_reaches(module, callee, target, visited)) {
+      found = true;
+      break;
+    }
+  }
+  safe_da_free(refs);
+  return found;
+}
+
+bool optimizer_fn_is_recursive(AST_NodeList *module, AST_Node *fn) {
+  bool *visited = NOB_REALLOC(NULL, module->count * sizeof(bool));
+  NOB_ASSERT(visited != NULL && "Buy more RAM lol");
+  memset(visited, 0, module->count * sizeof(bool));
+  bool result = optimizer_fn_reaches(module, fn, fn->as.fn_decl.name, visited);
+  NOB_FREE(visited);
+  return result;
+}
+
+// Names declared as parameters or variables anywhere inside of the node
+void optimizer_collect_locals(AST_Node *node, StringViews *locals) {
+  switch (node->kind) {
+  case AST_NK_FN_DECL:
+    nob_da_foreach(AST_Node, param, &node->as.fn_decl.params) {
+      nob_da_append(locals, param->as.token.sv);
+    }
+    nob_da_foreach(AST_Node, it, &node->as.fn_decl.body) {
+      optimizer_collect_locals(it, locals);
+    }
+    return;
+  case AST_NK_VAR_DECL:
+    nob_da_append(locals, node->as.var_decl.name);
+    return;
+  case AST_NK_BLOCK:
+    nob_da_foreach(AST_Node, it, &node->as.block) {
+      optimizer_collect_locals(it, locals);
+    }
+    return;
+  case AST_NK_IF:
+    nob_da_foreach(AST_Node, it, &node->as.if_stmt.then_body) {
+      optimizer_collect_locals(it, locals);
+    }
+    nob_da_foreach(AST_Node, it, &node->as.if_stmt.else_body) {
+      optimizer_collect_locals(it, locals);
+    }
+    return;
+  case AST_NK_WHILE:
+    nob_da_foreach(AST_Node, it, &node->as.while_loop.body) {
+      optimizer_collect_locals(it, locals);
+    }
+    return;
+  case AST_NK_FOR:
+    nob_da_append(locals, node->as.for_loop.name);
+    nob_da_foreach(AST_Node, it, &node->as.for_loop.body) {
+      optimizer_collect_locals(it, locals);
+    }
+    return;
+  default:
+    return;
+  }
+}
+
+bool optimizer_svs_contain(StringViews *svs, Nob_String_View sv) {
+  nob_da_foreach(Nob_String_View, it, svs) {
+    if (nob_sv_eq(*it, sv)) return true;
+  }
+  return false;
+}
+
+typedef struct {
+  StringViews from;
+  StringViews to;
+} Optimizer_Renames;
+
+Nob_String_View optimizer_rename_lookup(Optimizer_Renames *renames, Nob_String_View name) {
+  for (size_t i = 0; i < renames->from.count; ++i) {
+    if (nob_sv_eq(renames->from.items[i], name)) return renames->to.items[i];
+  }
+  return name;
+}
+
+void optimizer_rename_in_list(AST_NodeList *list, Optimizer_Renames *renames);
+
+void optimizer_rename(AST_Node *node, Optimizer_Renames *renames) {
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    if (node->as.token.kind == TOK_IDENT) node->as.token.sv = optimizer_rename_lookup(renames, node->as.token.sv);
+    return;
+  case AST_NK_VAR_DECL:
+    node->as.var_decl.name = optimizer_rename_lookup(renames, node->as.var_decl.name);
+    break;
+  case AST_NK_ASSIGNMENT:
+    node->as.var_assign.name = optimizer_rename_lookup(renames, node->as.var_assign.name);
+    break;
+  case AST_NK_FOR:
+    node->as.for_loop.name = optimizer_rename_lookup(renames, node->as.for_loop.name);
+    break;
+  case AST_NK_FN_DECL:
+    // Nested functions have their own scope
+    return;
+  default:
+    break;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    optimizer_rename_in_list(lists[i], renames);
+  }
+}
+
+void optimizer_rename_in_list(AST_NodeList *list, Optimizer_Renames *renames) {
+  nob_da_foreach(AST_Node, it, list) {
+    optimizer_rename(it, renames);
+  }
+}
+
+typedef struct {
+  AST_NodeList *module;
+  Options *opts;
+  // Names declared by the function being inlined into, the callee can't reference globals hidden by them
+  StringViews visible;
+  // The function being inlined into kept closures, calling one can change its locals halfway through an expression
+  bool has_closures;
+  size_t inlined;
+  size_t fresh_id;
+} Optimizer_Inliner;
+
+// `$` can't be part of a dwoc identifier so the generated names never clash with the user's
+Nob_String_View optimizer_fresh_name(Optimizer_Inliner *inl, Nob_String_View name) {
+  Nob_String_Builder sb = {0};
+  nob_sb_appendf(&sb, SV_Fmt"$%zu", SV_Arg(name), inl->fresh_id);
+  return nob_sb_to_sv(sb);
+}
+
+AST_Node *optimizer_unwrap_expr(AST_Node *node) {
+  while (node->kind == AST_NK_EXPR && node->as.expr.count == 1) node = &node->as.expr.items[0];
+  return node;
+}
+
+// Expression a function made of a single `return <expr>;` gives back, NULL for any other body
+AST_Node *optimizer_returned_expr(AST_Node *fn) {
+  AST_NodeList *body = &fn->as.fn_decl.body;
+  if (body->count != 1 || body->items[0].kind != AST_NK_RETURN || body->items[0].as.ret.count != 1) return NULL;
+  return optimizer_unwrap_expr(&body->items[0].as.ret.items[0]);
+}
+
+// Decide whether the call can be replaced with the callee body, returns the callee if so
+// Calls used as a value are replaced with the returned expression, so their callee has to be a single `return`
+AST_Node *optimizer_inline_candidate(Optimizer_Inliner *inl, AST_Node *call, AST_Node *caller, bool is_value, size_t *cost) {
+  AST_Node *callee = optimizer_find_fn(inl->module, call->as.fn_call.name);
+  if (callee == NULL || callee == caller) return NULL;
+  if (callee->as.fn_decl.params.count != call->as.fn_call.params.count) return NULL;
+  // Calling a generator only creates its iterator and an async function its promise, the body runs later
+  if (callee->as.fn_decl.generator || callee->as.fn_decl.async) return NULL;
+  *cost = optimizer_node_list_cost(&callee->as.fn_decl.body);
+  if (*cost > inl->opts->inline_budget) return NULL;
+  if (is_value) {
+    if (optimizer_returned_expr(callee) == NULL) return NULL;
+  } else if (optimizer_contains_kind(callee, AST_NK_RETURN)) {
+    // Returning from an inlined body would return from the caller instead
+    return NULL;
+  }
+  // Closures in the body would keep using the callee's variables by their names from before renaming
+  nob_da_foreach(AST_Node, it, &callee->as.fn_decl.body) {
+    if (optimizer_contains_kind(it, AST_NK_FN_DECL)) return NULL;
+  }
+  if (optimizer_fn_is_recursive(inl->module, callee)) return NULL;
+
+  StringViews locals = {0};
+  StringViews refs = {0};
+  optimizer_collect_locals(callee, &locals);
+  optimizer_collect_refs(callee, &refs);
+  bool captured = false;
+  nob_da_foreach(Nob_String_View, ref, &refs) {
+    if (optimizer_svs_contain(&locals, *ref)) continue;
+    if (optimizer_svs_contain(&inl->visible, *ref)) {
+      captured = true;
+      break;
+    }
+  }
+  safe_da_free(locals);
+  safe_da_free(refs);
+  return captured ? NULL : callee;
+}
+
+size_t optimizer_count_uses(AST_Node *node, Nob_String_View name) {
+  size_t count = node->kind == AST_NK_TOKEN && node->as.token.kind == TOK_IDENT && nob_sv_eq(node->as.token.sv, name) ? 1 : 0;
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      count += optimizer_count_uses(it, name);
+    }
+  }
+  return count;
+}
+
+// Put a copy of the matching value wherever the expression reads a parameter, all at once so an argument
+// mentioning another parameter's name doesn't get replaced again
+void optimizer_substitute_params(AST_Node *node, AST_NodeList *params, AST_NodeList *values) {
+  if (node->kind == AST_NK_TOKEN) {
+    if (node->as.token.kind != TOK_IDENT) return;
+    for (size_t i = 0; i < params->count; ++i) {
+      if (!nob_sv_eq(node->as.token.sv, params->items[i].as.token.sv)) continue;
+      *node = ast_node_clone(values->items[i]);
+      return;
+    }
+    return;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      optimizer_substitute_params(it, params, values);
+    }
+  }
+}
+
+// Values reading them anywhere inside of the inlined expression gives the same as reading them at the call
+// Locals can't change in the middle of an expression as assignments are statements, nor can immutable globals
+bool optimizer_is_stable_arg(Optimizer_Inliner *inl, AST_Node *arg) {
+  if (arg->kind != AST_NK_TOKEN) return false;
+  if (arg->as.token.kind == TOK_INT || arg->as.token.kind == TOK_STR) return true;
+  if (arg->as.token.kind != TOK_IDENT) return false;
+  if (optimizer_svs_contain(&inl->visible, arg->as.token.sv)) return !inl->has_closures;
+  nob_da_foreach(AST_Node, it, inl->module) {
+    if (it->kind == AST_NK_VAR_DECL && nob_sv_eq(it->as.var_decl.name, arg->as.token.sv)) return !it->as.var_decl.mutable;
+  }
+  return false;
+}
+
+// Arguments that give the same when evaluated before the statement, whatever the statement calls before reaching them
+bool optimizer_is_hoistable_arg(Optimizer_Inliner *inl, AST_Node *arg) {
+  switch (arg->kind) {
+  case AST_NK_TOKEN:
+    return optimizer_is_stable_arg(inl, arg);
+  case AST_NK_FN_CALL: {
+    AST_Node *callee = optimizer_find_fn(inl->module, arg->as.fn_call.name);
+    if (callee == NULL || !optimizer_fn_is_pure(inl->module, callee, NULL)) return false;
+  } break;
+  case AST_NK_EXPR:
+  case AST_NK_UNOP:
+  case AST_NK_BINOP:
+    break;
+  default:
+    return false;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(arg, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (!optimizer_is_hoistable_arg(inl, it)) return false;
+    }
+  }
+  return true;
+}
+
+bool optimizer_calls_any_param(AST_Node *node, AST_Node *fn) {
+  if (node->kind == AST_NK_FN_CALL) {
+    nob_da_foreach(AST_Node, param, &fn->as.fn_decl.params) {
+      if (nob_sv_eq(param->as.token.sv, node->as.fn_call.name)) return true;
+    }
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (optimizer_calls_any_param(it, fn)) return true;
+    }
+  }
+  return false;
+}
+
+// Replace a call used as a value with the expression its callee returns, arguments read more than once are bound
+// to temporaries declared before the statement when `hoist` allows evaluating them there
+// The arguments end up evaluated where the parameters are read, so unless they are locals or constants they
+// have to be pure and the expression must call nothing that could run in between
+bool optimizer_inline_value(Optimizer_Inliner *inl, AST_Node *caller, AST_Node *call, AST_NodeList *before, bool hoist) {
+  size_t cost = 0;
+  AST_Node *callee = optimizer_inline_candidate(inl, call, caller, true, &cost);
+  if (callee == NULL) return false;
+  AST_Node *returned = optimizer_returned_expr(callee);
+  // Substitution only replaces values, a call through a parameter would be left calling the parameter's name
+  if (optimizer_calls_any_param(returned, callee)) return false;
+  bool has_calls = optimizer_contains_kind(returned, AST_NK_FN_CALL);
+  AST_NodeList *params = &callee->as.fn_decl.params;
+  for (size_t i = 0; i < params->count; ++i) {
+    AST_Node *arg = optimizer_unwrap_expr(&call->as.fn_call.params.items[i]);
+    if (optimizer_is_stable_arg(inl, arg)) continue;
+    if (has_calls || !optimizer_expr_is_pure(inl->module, &inl->visible, arg)) return false;
+    if (optimizer_count_uses(returned, params->items[i].as.token.sv) <= 1) continue;
+    if (!hoist || !optimizer_is_hoistable_arg(inl, arg)) return false;
+  }
+
+  inl->fresh_id++;
+  AST_NodeList values = {0};
+  for (size_t i = 0; i < params->count; ++i) {
+    AST_Node *arg = optimizer_unwrap_expr(&call->as.fn_call.params.items[i]);
+    Nob_String_View param = params->items[i].as.token.sv;
+    if (optimizer_is_stable_arg(inl, arg) || optimizer_count_uses(returned, param) <= 1) {
+      nob_da_append(&values, *arg);
+      continue;
+    }
+    AST_Node binding = {
+      .loc = arg->loc,
+      .kind = AST_NK_VAR_DECL,
+    };
+    binding.as.var_decl.name = optimizer_fresh_name(inl, param);
+    nob_da_append(&binding.as.var_decl.expr, ast_node_clone(*arg));
+    nob_da_append(before, binding);
+    nob_da_append(&inl->visible, binding.as.var_decl.name);
+    AST_Node temp = {
+      .loc = arg->loc,
+      .kind = AST_NK_TOKEN,
+    };
+    temp.as.token.kind = TOK_IDENT;
+    temp.as.token.sv = binding.as.var_decl.name;
+    nob_da_append(&values, temp);
+  }
+  AST_Node value = ast_node_clone(*returned);
+  optimizer_substitute_params(&value, params, &values);
+  // The values only borrow the argument nodes, the clones made from them are what stays
+  safe_da_free(values);
+  if (inl->opts->report_inline) {
+    comp_notef(call->loc, "Inlined call to `"SV_Fmt"` (cost %zu, budget %zu)", SV_Arg(callee->as.fn_decl.name), cost, inl->opts->inline_budget);
+  }
+  inl->inlined++;
+  ast_node_children_free(call);
+  *call = value;
+  return true;
+}
+
+// Inline the calls used as values inside of an expression, innermost first
+// `hoist` turns false below anything that only evaluates some of the time
+void optimizer_inline_in_expr(Optimizer_Inliner *inl, AST_Node *caller, AST_Node *node, AST_NodeList *before, bool hoist, int depth) {
+  // Bounds the growth of chains of small functions calling each other
+  static const int max_depth = 4;
+  // A stage stays a call, the backend passes it the piped value
+  if (node->kind == AST_NK_PIPE_STAGE) return;
+  bool conditional = node->kind == AST_NK_MATCH || node->kind == AST_NK_PIPELINE ||
+    (node->kind == AST_NK_BINOP && (sv_eq_str(node->as.op.op.sv, "&&") || sv_eq_str(node->as.op.op.sv, "||")));
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      optimizer_inline_in_expr(inl, caller, it, before, hoist && !conditional, depth);
+    }
+  }
+  if (node->kind != AST_NK_FN_CALL || depth >= max_depth) return;
+  if (optimizer_inline_value(inl, caller, node, before, hoist)) {
+    optimizer_inline_in_expr(inl, caller, node, before, hoist, depth + 1);
+  }
+}
+
+void optimizer_inline_in_exprs(Optimizer_Inliner *inl, AST_Node *caller, AST_NodeList *exprs, AST_NodeList *before, bool hoist) {
+  nob_da_foreach(AST_Node, it, exprs) {
+    optimizer_inline_in_expr(inl, caller, it, before, hoist, 0);
+  }
+}
+
+void optimizer_inline_in_list(Optimizer_Inliner *inl, AST_Node *caller, AST_NodeList *list, int depth) {
+  // Bounds the growth of chains of small functions calling each other
+  static const int max_depth = 4;
+  AST_NodeList out = {0};
+  nob_da_foreach(AST_Node, it, list) {
+    // Temporaries of the calls inlined into the statement go right before it
+    switch (it->kind) {
+    case AST_NK_BLOCK:
+      optimizer_inline_in_list(inl, caller, &it->as.block, depth);
+      break;
+    case AST_NK_IF:
+      optimizer_inline_in_exprs(inl, caller, &it->as.if_stmt.cond, &out, true);
+      optimizer_inline_in_list(inl, caller, &it->as.if_stmt.then_body, depth);
+      optimizer_inline_in_list(inl, caller, &it->as.if_stmt.else_body, depth);
+      break;
+    case AST_NK_VAR_DECL:
+      optimizer_inline_in_exprs(inl, caller, &it->as.var_decl.expr, &out, true);
+      break;
+    case AST_NK_ASSIGNMENT:
+      optimizer_inline_in_exprs(inl, caller, &it->as.var_assign.expr, &out, true);
+      break;
+    case AST_NK_RETURN:
+      optimizer_inline_in_exprs(inl, caller, &it->as.ret, &out, true);
+      break;
+    case AST_NK_EXPR:
+      optimizer_inline_in_exprs(inl, caller, &it->as.expr, &out, true);
+      break;
+    case AST_NK_FN_CALL:
+      optimizer_inline_in_exprs(inl, caller, &it->as.fn_call.params, &out, true);
+      break;
+    case AST_NK_WHILE:
+      // The condition runs again every iteration, nothing can be bound before the loop
+      optimizer_inline_in_exprs(inl, caller, &it->as.while_loop.cond, &out, false);
+      optimizer_inline_in_list(inl, caller, &it->as.while_loop.body, depth);
+      break;
+    case AST_NK_FOR:
+      optimizer_inline_in_exprs(inl, caller, &it->as.for_loop.iter, &out, true);
+      optimizer_inline_in_list(inl, caller, &it->as.for_loop.body, depth);
+      break;
+    default:
+      break;
+    }
+    if (it->kind != AST_NK_FN_CALL || depth >= max_depth) {
+      nob_da_append(&out, *it);
+      continue;
+    }
+
+    size_t cost = 0;
+    AST_Node *callee = optimizer_inline_candidate(inl, it, caller, false, &cost);
+    if (callee == NULL) {
+      nob_da_append(&out, *it);
+      continue;
+    }
+
+    inl->fresh_id++;
+    Optimizer_Renames renames = {0};
+    StringViews locals = {0};
+    optimizer_collect_locals(callee, &locals);
+    nob_da_foreach(Nob_String_View, local, &locals) {
+      nob_da_append(&renames.from, *local);
+      nob_da_append(&renames.to, optimizer_fresh_name(inl, *local));
+    }
+
+    AST_Node block = {
+      .loc = it->loc,
+      .kind = AST_NK_BLOCK,
+    };
+    // Arguments get bound to the renamed parameters before the body runs
+    for (size_t i = 0; i < callee->as.fn_decl.params.count; ++i) {
+      AST_Node *arg = &it->as.fn_call.params.items[i];
+      AST_Node binding = {
+        .loc = arg->loc,
+        .kind = AST_NK_VAR_DECL,
+      };
+      binding.as.var_decl.name = optimizer_rename_lookup(&renames, callee->as.fn_decl.params.items[i].as.token.sv);
+      binding.as.var_decl.mutable = true;
+      if (arg->kind == AST_NK_EXPR) {
+        binding.as.var_decl.expr = ast_node_list_clone(arg->as.expr);
+      } else {
+        nob_da_append(&binding.as.var_decl.expr, ast_node_clone(*arg));
+      }
+      nob_da_append(&block.as.block, binding);
+    }
+    AST_NodeList body = ast_node_list_clone(callee->as.fn_decl.body);
+    optimizer_rename_in_list(&body, &renames);
+    nob_da_append_many(&block.as.block, body.items, body.count);
+    safe_da_free(body);
+    safe_da_free(locals);
+    safe_da_free(renames.from);
+    safe_da_free(renames.to);
+
+    if (inl->opts->report_inline) {
+      comp_notef(it->loc, "Inlined call to `"SV_Fmt"` (cost %zu, budget %zu)", SV_Arg(callee->as.fn_decl.name), cost, inl->opts->inline_budget);
+    }
+    inl->inlined++;
+    ast_node_children_free(it);
+    optimizer_inline_in_list(inl, caller, &block.as.block, depth + 1);
+    nob_da_append(&out, block);
+  }
+  safe_da_free((*list));
+  *list = out;
+}
+
+size_t optimizer_inline_calls(AST_NodeList *module, Options *opts) {
+  if (opts->inline_budget == 0) return 0;
+  Optimizer_Inliner inl = {
+    .module = module,
+    .opts = opts,
+  };
+  nob_da_foreach(AST_Node, it, module) {
+    if (it->kind != AST_NK_FN_DECL) continue;
+    inl.visible.count = 0;
+    optimizer_collect_locals(it, &inl.visible);
+    inl.has_closures = false;
+    nob_da_foreach(AST_Node, stmt, &it->as.fn_decl.body) {
+      if (optimizer_contains_kind(stmt, AST_NK_FN_DECL)) inl.has_closures = true;
+    }
+    optimizer_inline_in_list(&inl, it, &it->as.fn_decl.body, 0);
+  }
+  safe_da_free(inl.visible);
+  return inl.inlined;
+}
+
+bool optimizer_returns_value(AST_Node *node) {
+  if (node->kind == AST_NK_RETURN) return node->as.ret.count > 0;
+  if (node->kind == AST_NK_FN_DECL && node->as.fn_decl.body.count == 0) return false;
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (optimizer_returns_value(it)) return true;
+    }
+  }
+  return false;
+}
+
+// Statements whose call is in tail position, call statements only count when they are the last thing the function does
+void optimizer_collect_tail_sites(AST_NodeList *body, bool is_tail, AST_NodePtrs *sites) {
+  nob_da_foreach(AST_Node, it, body) {
+    bool stmt_is_tail = is_tail && it == body->items + body->count - 1;
+    switch (it->kind) {
+    case AST_NK_RETURN:
+      if (it->as.ret.count == 1 && it->as.ret.items[0].kind == AST_NK_FN_CALL) nob_da_append(sites, it);
+      break;
+    case AST_NK_FN_CALL:
+      if (stmt_is_tail) nob_da_append(sites, it);
+      break;
+    case AST_NK_BLOCK:
+      optimizer_collect_tail_sites(&it->as.block, stmt_is_tail, sites);
+      break;
+    case AST_NK_IF:
+      optimizer_collect_tail_sites(&it->as.if_stmt.then_body, stmt_is_tail, sites);
+      optimizer_collect_tail_sites(&it->as.if_stmt.else_body, stmt_is_tail, sites);
+      break;
+    case AST_NK_WHILE:
+      // The loop runs again after its last statement, only returns inside of it are in tail position
+      optimizer_collect_tail_sites(&it->as.while_loop.body, false, sites);
+      break;
+    case AST_NK_FOR:
+      optimizer_collect_tail_sites(&it->as.for_loop.body, false, sites);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+AST_Node *optimizer_tail_site_call(AST_Node *site) {
+  return site->kind == AST_NK_RETURN ? &site->as.ret.items[0] : site;
+}
+
+// Function of the module a tail call site can jump to, NULL when it has to stay a regular call
+AST_Node *optimizer_tail_site_target(AST_NodeList *module, AST_Node *site) {
+  AST_Node *call = optimizer_tail_site_call(site);
+  AST_Node *callee = optimizer_find_fn(module, call->as.fn_call.name);
+  if (callee == NULL || callee->as.fn_decl.params.count != call->as.fn_call.params.count) return NULL;
+  if (callee->as.fn_decl.generator || callee->as.fn_decl.async) return NULL;
+  // Jumping into a function that returns a value would make the trailing call statement return it as well
+  if (site->kind == AST_NK_FN_CALL && optimizer_returns_value(callee)) return NULL;
+  return callee;
+}
+
+typedef struct {
+  AST_NodeList *module;
+  Optimizer_TailGroups *groups;
+  // Per function tail call sites with a valid target
+  AST_NodePtrs *sites;
+  // Tarjan's bookkeeping
+  size_t *order;
+  size_t *low;
+  bool *on_stack;
+  Optimizer_Indices stack;
+  size_t next_order;
+} Optimizer_TailFinder;
+
+void optimizer_tail_connect(Optimizer_TailFinder *tf, size_t index) {
+  tf->next_order++;
+  tf->order[index] = tf->next_order;
+  tf->low[index] = tf->next_order;
+  nob_da_append(&tf->stack, index);
+  tf->on_stack[index] = true;
+
+  nob_da_foreach(AST_Node*, site, &tf->sites[index]) {
+    size_t target = optimizer_tail_site_target(tf->module, *site) - tf->module->items;
+    if (tf->order[target] == 0) {
+      optimizer_tail_connect(tf, target);
+      if (tf->low[target] < tf->low[index]) tf->low[index] = tf->low[target];
+    } else if (tf->on_stack[target] && tf->order[target] < tf->low[index]) {
+      tf->low[index] = tf->order[target];
+    }
+  }
+
+  if (tf->low[index] != tf->order[index]) return;
+  Optimizer_TailGroup group = {0};
+  while (true) {
+    size_t member = da_pop(&tf->stack);
+    tf->on_stack[member] = false;
+    nob_da_append(&group.fns, member);
+    if (member == index) break;
+  }
+  // Keep members in module order so the merged function is emitted where the first one was declared
+  for (size_t i = 1; i < group.fns.count; ++i) {
+    for (size_t j = i; j > 0 && group.fns.items[j - 1] > group.fns.items[j]; --j) {
+      size_t tmp = group.fns.items[j];
+      group.fns.items[j] = group.fns.items[j - 1];
+      group.fns.items[j - 1] = tmp;
+    }
+  }
+
+  nob_da_foreach(size_t, member, &group.fns) {
+    nob_da_foreach(AST_Node*, site, &tf->sites[*member]) {
+      size_t target = optimizer_tail_site_target(tf->module, *site) - tf->module->items;
+      bool in_group = false;
+      da_includes(&group.fns, target, &in_group);
+      if (in_group) nob_da_append(&group.sites, *site);
+    }
+  }
+  if (group.sites.count == 0) {
+    safe_da_free(group.fns);
+    return;
+  }
+  nob_da_append(tf->groups, group);
+}
+
+void optimizer_find_tail_groups(AST_NodeList *module, Optimizer_TailGroups *groups) {
+  if (module->count == 0) return;
+  Optimizer_TailFinder tf = {
+    .module = module,
+    .groups = groups,
+  };
+  tf.sites = NOB_REALLOC(NULL, module->count * sizeof(*tf.sites));
+  tf.order = NOB_REALLOC(NULL, module->count * sizeof(*tf.order));
+  tf.low = NOB_REALLOC(NULL, module->count * sizeof(*tf.low));
+  tf.on_stack = NOB_REALLOC(NULL, module->count * sizeof(*tf.on_stack));
+  NOB_ASSERT(tf.sites != NULL && tf.order != NULL && tf.low != NULL && tf.on_stack != NULL && "Buy more RAM lol");
+  memset(tf.sites, 0, module->count * sizeof(*tf.sites));
+  memset(tf.order, 0, module->count * sizeof(*tf.order));
+  memset(tf.low, 0, module->count * sizeof(*tf.low));
+  memset(tf.on_stack, 0, module->count * sizeof(*tf.on_stack));
+
+  for (size_t i = 0; i < module->count; ++i) {
+    AST_Node *fn = &module->items[i];
+    if (fn->kind != AST_NK_FN_DECL) continue;
+    // Closures created inside of the loop would see the parameters change under them
+    bool has_closure = false;
+    nob_da_foreach(AST_Node, it, &fn->as.fn_decl.body) {
+      if (optimizer_contains_kind(it, AST_NK_FN_DECL)) has_closure = true;
+    }
+    // Returning from a generator ends the iteration and from an async function settles its promise, neither can jump into another body
+    if (has_closure || fn->as.fn_decl.generator || fn->as.fn_decl.async) continue;
+    AST_NodePtrs all = {0};
+    optimizer_collect_tail_sites(&fn->as.fn_decl.body, true, &all);
+    nob_da_foreach(AST_Node*, site, &all) {
+      if (optimizer_tail_site_target(module, *site) != NULL) nob_da_append(&tf.sites[i], *site);
+    }
+    safe_da_free(all);
+  }
+  for (size_t i = 0; i < module->count; ++i) {
+    if (module->items[i].kind == AST_NK_FN_DECL && tf.order[i] == 0) optimizer_tail_connect(&tf, i);
+  }
+
+  for (size_t i = 0; i < module->count; ++i) safe_da_free(tf.sites[i]);
+  safe_da_free(tf.stack);
+  NOB_FREE(tf.sites);
+  NOB_FREE(tf.order);
+  NOB_FREE(tf.low);
+  NOB_FREE(tf.on_stack);
+}
+
+Optimizer_TailGroup *optimizer_tail_group_of(Optimizer_TailGroups *groups, size_t fn_index) {
+  nob_da_foreach(Optimizer_TailGroup, group, groups) {
+    bool included = false;
+    da_includes(&group->fns, fn_index, &included);
+    if (included) return group;
+  }
+  return NULL;
+}
+
+bool optimizer_fn_has_attr(AST_Node *fn, const char *attr) {
+  nob_da_foreach(Nob_String_View, it, &fn->as.fn_decl.attrs) {
+    if (sv_eq_str(*it, attr)) return true;
+  }
+  return false;
+}
+
+typedef struct {
+  Nob_String_View name;
+  // Function declaring the name, NULL for globals
+  AST_Node *fn;
+} Optimizer_Binding;
+
+typedef struct {
+  Optimizer_Binding *items;
+  size_t count;
+  size_t capacity;
+} Optimizer_Bindings;
+
+typedef struct {
+  AST_NodeList *module;
+  // Bindings being proven numeric, reaching one of them again assumes it is until proven otherwise
+  Optimizer_Bindings assumed;
+} Optimizer_Numeric;
+
+bool optimizer_binding_is_numeric(Optimizer_Numeric *n, AST_Node *fn, Nob_String_View name);
+
+// Integer literals and whatever arithmetic computes from them and from names only ever holding numbers
+bool optimizer_expr_is_numeric(Optimizer_Numeric *n, AST_Node *fn, AST_Node *node) {
+  switch (node->kind) {
+  case AST_NK_TOKEN: {
+    if (node->as.token.kind == TOK_INT) return true;
+    if (node->as.token.kind != TOK_IDENT) return false;
+    StringViews locals = {0};
+    if (fn != NULL) optimizer_collect_locals(fn, &locals);
+    bool is_local = optimizer_svs_contain(&locals, node->as.token.sv);
+    safe_da_free(locals);
+    return optimizer_binding_is_numeric(n, is_local ? fn : NULL, node->as.token.sv);
+  }
+  case AST_NK_EXPR:
+    return node->as.expr.count == 1 && optimizer_expr_is_numeric(n, fn, &node->as.expr.items[0]);
+  case AST_NK_UNOP:
+    return sv_eq_str(node->as.op.op.sv, "-") && optimizer_expr_is_numeric(n, fn, &node->as.op.operands.items[0]);
+  case AST_NK_BINOP: {
+    const char *arithmetic[] = { "+", "-", "*", "/", "%" };
+    bool is_arithmetic = false;
+    for (size_t i = 0; i < NOB_ARRAY_LEN(arithmetic); ++i) {
+      if (sv_eq_str(node->as.op.op.sv, arithmetic[i])) is_arithmetic = true;
+    }
+    if (!is_arithmetic) return false;
+    nob_da_foreach(AST_Node, it, &node->as.op.operands) {
+      if (!optimizer_expr_is_numeric(n, fn, it)) return false;
+    }
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+bool optimizer_value_is_numeric(Optimizer_Numeric *n, AST_Node *fn, AST_NodeList *expr) {
+  return expr->count == 1 && optimizer_expr_is_numeric(n, fn, &expr->items[0]);
+}
+
+// Every call made to the function passes a number as its index-th argument and the function is never used as a value
+bool optimizer_calls_pass_numeric(Optimizer_Numeric *n, AST_NodeList *list, AST_Node *enclosing, Nob_String_View name, size_t index, AST_Node **offender) {
+  nob_da_foreach(AST_Node, it, list) {
+    if (it->kind == AST_NK_FN_DECL) enclosing = it;
+    if (it->kind == AST_NK_TOKEN && it->as.token.kind == TOK_IDENT && nob_sv_eq(it->as.token.sv, name)) {
+      *offender = it;
+      return false;
+    }
+    if (it->kind == AST_NK_FN_CALL && nob_sv_eq(it->as.fn_call.name, name)) {
+      if (index >= it->as.fn_call.params.count) {
+        *offender = it;
+        return false;
+      }
+      AST_Node *arg = &it->as.fn_call.params.items[index];
+      if (!optimizer_expr_is_numeric(n, enclosing, arg)) {
+        *offender = arg;
+        return false;
+      }
+    }
+    AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+    size_t lists_count = ast_node_child_lists(it, lists);
+    for (size_t i = 0; i < lists_count; ++i) {
+      if (!optimizer_calls_pass_numeric(n, lists[i], enclosing, name, index, offender)) return false;
+    }
+  }
+  return true;
+}
+
+// Every declaration of and assignment to the name within the list stores a number
+bool optimizer_writes_are_numeric(Optimizer_Numeric *n, AST_Node *fn, AST_NodeList *list, Nob_String_View name) {
+  nob_da_foreach(AST_Node, it, list) {
+    if (it->kind == AST_NK_VAR_DECL && nob_sv_eq(it->as.var_decl.name, name)) {
+      if (!optimizer_value_is_numeric(n, fn, &it->as.var_decl.expr)) return false;
+    }
+    if (it->kind == AST_NK_ASSIGNMENT && nob_sv_eq(it->as.var_assign.name, name)) {
+      if (!optimizer_value_is_numeric(n, fn, &it->as.var_assign.expr)) return false;
+    }
+    // Elements given by an iterator can be anything
+    if (it->kind == AST_NK_FOR && nob_sv_eq(it->as.for_loop.name, name)) return false;
+    AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+    size_t lists_count = ast_node_child_lists(it, lists);
+    for (size_t i = 0; i < lists_count; ++i) {
+      if (!optimizer_writes_are_numeric(n, fn, lists[i], name)) return false;
+    }
+  }
+  return true;
+}
+
+// A global has to be immutable and initialized to a number, a parameter or a local has to only ever be given numbers
+bool optimizer_binding_is_numeric(Optimizer_Numeric *n, AST_Node *fn, Nob_String_View name) {
+  nob_da_foreach(Optimizer_Binding, it, &n->assumed) {
+    if (it->fn == fn && nob_sv_eq(it->name, name)) return true;
+  }
+  size_t assumed_count = n->assumed.count;
+  nob_da_append(&n->assumed, ((Optimizer_Binding) { .name = name, .fn = fn }));
+
+  bool numeric = false;
+  if (fn == NULL) {
+    nob_da_foreach(AST_Node, it, n->module) {
+      if (it->kind != AST_NK_VAR_DECL || !nob_sv_eq(it->as.var_decl.name, name)) continue;
+      numeric = !it->as.var_decl.mutable && optimizer_value_is_numeric(n, NULL, &it->as.var_decl.expr);
+      break;
+    }
+  } else {
+    numeric = true;
+    AST_NodeList *params = &fn->as.fn_decl.params;
+    for (size_t i = 0; numeric && i < params->count; ++i) {
+      if (!nob_sv_eq(params->items[i].as.token.sv, name)) continue;
+      AST_Node *offender = NULL;
+      numeric = optimizer_calls_pass_numeric(n, n->module, NULL, fn->as.fn_decl.name, i, &offender);
+    }
+    if (numeric) numeric = optimizer_writes_are_numeric(n, fn, &fn->as.fn_decl.body, name);
+  }
+
+  n->assumed.count = assumed_count;
+  return numeric;
+}
+
+bool optimizer_params_are_numeric(AST_NodeList *module, AST_Node *fn, AST_Node **offender) {
+  Optimizer_Numeric n = { .module = module };
+  bool numeric = true;
+  for (size_t i = 0; numeric && i < fn->as.fn_decl.params.count; ++i) {
+    nob_da_append(&n.assumed, ((Optimizer_Binding) { .name = fn->as.fn_decl.params.items[i].as.token.sv, .fn = fn }));
+    numeric = optimizer_calls_pass_numeric(&n, module, NULL, fn->as.fn_decl.name, i, offender);
+    if (numeric && !optimizer_writes_are_numeric(&n, fn, &fn->as.fn_decl.body, fn->as.fn_decl.params.items[i].as.token.sv)) {
+      *offender = fn;
+      numeric = false;
+    }
+    n.assumed.count = 0;
+  }
+  safe_da_free(n.assumed);
+  return numeric;
+}
+
+typedef struct {
+  AST_NodeList *module;
+  // Functions currently being checked, calls back into them are assumed pure until proven otherwise
+  bool *visiting;
+  // Names declared by the function being checked
+  StringViews locals;
+} Optimizer_Purity;
+
+bool optimizer_fn_is_pure_rec(Optimizer_Purity *p, AST_Node *fn, AST_Node **offender);
+
+bool optimizer_body_is_pure(Optimizer_Purity *p, AST_Node *node, AST_Node **offender) {
+  switch (node->kind) {
+  case AST_NK_TOKEN: {
+    if (node->as.token.kind != TOK_IDENT || optimizer_svs_contain(&p->locals, node->as.token.sv)) break;
+    // Reading a global is only fine while nobody can change it
+    nob_da_foreach(AST_Node, it, p->module) {
+      if (it->kind != AST_NK_VAR_DECL || !nob_sv_eq(it->as.var_decl.name, node->as.token.sv)) continue;
+      if (!it->as.var_decl.mutable) continue;
+      *offender = node;
+      return false;
+    }
+  } break;
+  case AST_NK_ASSIGNMENT:
+    if (!optimizer_svs_contain(&p->locals, node->as.var_assign.name)) {
+      *offender = node;
+      return false;
+    }
+    break;
+  case AST_NK_FN_CALL: {
+    // Library functions like the ones of core:io aren't declared in the module and are all effectful
+    AST_Node *callee = optimizer_find_fn(p->module, node->as.fn_call.name);
+    if (callee == NULL) {
+      *offender = node;
+      return false;
+    }
+    AST_Node *inner = NULL;
+    if (!optimizer_fn_is_pure_rec(p, callee, &inner)) {
+      *offender = node;
+      return false;
+    }
+  } break;
+  case AST_NK_AWAIT:
+    // Other code runs while it waits
+    *offender = node;
+    return false;
+  case AST_NK_FN_DECL:
+    return true;
+  default:
+    break;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (!optimizer_body_is_pure(p, it, offender)) return false;
+    }
+  }
+  return true;
+}
+
+bool optimizer_fn_is_pure_rec(Optimizer_Purity *p, AST_Node *fn, AST_Node **offender) {
+  // Every call gives a new iterator or promise, two calls with the same arguments can't share one
+  if (fn->as.fn_decl.generator || fn->as.fn_decl.async) {
+    *offender = fn;
+    return false;
+  }
+  size_t index = fn - p->module->items;
+  if (p->visiting[index]) return true;
+  p->visiting[index] = true;
+
+  StringViews outer = p->locals;
+  p->locals = (StringViews) {0};
+  optimizer_collect_locals(fn, &p->locals);
+  bool pure = true;
+  nob_da_foreach(AST_Node, it, &fn->as.fn_decl.body) {
+    if (!pure) break;
+    pure = optimizer_body_is_pure(p, it, offender);
+  }
+  safe_da_free(p->locals);
+  p->locals = outer;
+  return pure;
+}
+
+bool optimizer_fn_is_pure(AST_NodeList *module, AST_Node *fn, AST_Node **offender) {
+  Optimizer_Purity p = {
+    .module = module,
+  };
+  p.visiting = NOB_REALLOC(NULL, module->count * sizeof(bool));
+  NOB_ASSERT(p.visiting != NULL && "Buy more RAM lol");
+  memset(p.visiting, 0, module->count * sizeof(bool));
+  AST_Node *unused = NULL;
+  bool pure = optimizer_fn_is_pure_rec(&p, fn, offender == NULL ? &unused : offender);
+  NOB_FREE(p.visiting);
+  return pure;
+}
+
+bool optimizer_expr_is_pure(AST_NodeList *module, StringViews *locals, AST_Node *node) {
+  Optimizer_Purity p = {
+    .module = module,
+    .locals = *locals,
+  };
+  p.visiting = NOB_REALLOC(NULL, module->count * sizeof(bool));
+  NOB_ASSERT(p.visiting != NULL && "Buy more RAM lol");
+  memset(p.visiting, 0, module->count * sizeof(bool));
+  AST_Node *unused = NULL;
+  bool pure = optimizer_body_is_pure(&p, node, &unused);
+  NOB_FREE(p.visiting);
+  return pure;
+}
+
+size_t optimizer_count_calls_to(AST_Node *node, Nob_String_View name) {
+  size_t count = node->kind == AST_NK_FN_CALL && nob_sv_eq(node->as.fn_call.name, name) ? 1 : 0;
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      count += optimizer_count_calls_to(it, name);
+    }
+  }
+  return count;
+}
+
+bool optimizer_should_memoize(AST_NodeList *module, AST_Node *fn, Options *opts) {
+  bool requested = optimizer_fn_has_attr(fn, ATTRIBUTE_MEMO);
+  if (!requested) {
+    // Only functions that branch into themselves several times have overlapping subproblems worth caching
+    if (opts->opt_level < 2 || opts->optimize_size) return false;
+    if (optimizer_count_calls_to(fn, fn->as.fn_decl.name) < 2) return false;
+    if (!optimizer_returns_value(fn)) return false;
+  }
+  AST_Node *offender = NULL;
+  if (!optimizer_fn_is_pure(module, fn, &offender)) {
+    if (requested) {
+      comp_warnf(fn->loc, "Ignoring `@memo` on `"SV_Fmt"` as it is not pure", SV_Arg(fn->as.fn_decl.name));
+      comp_note(offender->loc, "Purity is broken here");
+    }
+    return false;
+  }
+  if (!optimizer_params_are_numeric(module, fn, &offender)) {
+    if (requested) {
+      comp_warnf(fn->loc, "Ignoring `@memo` on `"SV_Fmt"` as it isn't only given numbers", SV_Arg(fn->as.fn_decl.name));
+      comp_note(offender->loc, "Argument that can't be proven to be a number");
+    }
+    return false;
+  }
+  return true;
+}
+
+size_t optimizer_ctfe_steps_for_level(int opt_level) {
+  switch (opt_level) {
+  case 0: return 0;
+  case 1: return 1000000;
+  default: return 10000000;
+  }
+}
+
+typedef struct {
+  AST_NodeList *module;
+  Interpreter in;
+  // Names declared by the function being folded, they hide globals of the same name
+  StringViews locals;
+  // Variables in scope at the current statement with the literal they are bound to, NULL when it isn't known
+  StringViews scope_names;
+  AST_NodePtrs scope_values;
+  size_t folded;
+} Optimizer_Folder;
+
+// Literal as the parser would produce it, negative numbers become a negation of their absolute value
+AST_Node optimizer_number_literal(Loc loc, double value) {
+  Nob_String_Builder sb = {0};
+  sb_append_js_number(&sb, fabs(value));
+  AST_Node literal = {
+    .loc = loc,
+    .kind = AST_NK_TOKEN,
+  };
+  literal.as.token.kind = TOK_INT;
+  literal.as.token.sv = nob_sb_to_sv(sb);
+  literal.as.token.integer = fabs(value) <= INT_MAX ? (int)fabs(value) : 0;
+  if (!signbit(value)) return literal;
+
+  AST_Node negation = {
+    .loc = loc,
+    .kind = AST_NK_UNOP,
+  };
+  negation.as.op.op.kind = TOK_SYMBOL;
+  negation.as.op.op.sv = SV("-");
+  nob_da_append(&negation.as.op.operands, literal);
+  return negation;
+}
+
+bool optimizer_is_literal(AST_Node *node) {
+  if (node->kind == AST_NK_TOKEN) return node->as.token.kind == TOK_INT;
+  return node->kind == AST_NK_UNOP && sv_eq_str(node->as.op.op.sv, "-") && optimizer_is_literal(&node->as.op.operands.items[0]);
+}
+
+bool optimizer_is_constant(Optimizer_Folder *f, AST_Node *node) {
+  if (optimizer_is_literal(node)) return true;
+  if (node->kind == AST_NK_EXPR) return node->as.expr.count == 1 && optimizer_is_constant(f, &node->as.expr.items[0]);
+  if (node->kind != AST_NK_TOKEN || node->as.token.kind != TOK_IDENT) return false;
+  if (optimizer_svs_contain(&f->locals, node->as.token.sv)) return false;
+  nob_da_foreach(AST_Node, it, f->module) {
+    if (it->kind == AST_NK_VAR_DECL && nob_sv_eq(it->as.var_decl.name, node->as.token.sv)) return !it->as.var_decl.mutable;
+  }
+  return false;
+}
+
+void optimizer_fold_expr(Optimizer_Folder *f, AST_Node *node);
+void optimizer_fold_match(Optimizer_Folder *f, AST_Node *node);
+
+void optimizer_fold_expr_list(Optimizer_Folder *f, AST_NodeList *list) {
+  nob_da_foreach(AST_Node, it, list) {
+    optimizer_fold_expr(f, it);
+  }
+}
+
+void optimizer_fold_scope_push(Optimizer_Folder *f, Nob_String_View name, AST_Node *value) {
+  nob_da_append(&f->scope_names, name);
+  nob_da_append(&f->scope_values, value);
+}
+
+void optimizer_fold_scope_restore(Optimizer_Folder *f, size_t count) {
+  f->scope_names.count = count;
+  f->scope_values.count = count;
+}
+
+AST_Node *optimizer_fold_scope_lookup(Optimizer_Folder *f, Nob_String_View name) {
+  for (size_t i = f->scope_names.count; i > 0; --i) {
+    if (nob_sv_eq(f->scope_names.items[i - 1], name)) return f->scope_values.items[i - 1];
+  }
+  return NULL;
+}
+
+// A match on a known value is replaced by the arm it takes
+void optimizer_fold_match(Optimizer_Folder *f, AST_Node *node) {
+  AST_Match *match = &node->as.match;
+  optimizer_fold_expr_list(f, &match->subject);
+  nob_da_foreach(AST_Node, arm, &match->arms) {
+    optimizer_fold_expr_list(f, &arm->as.match_arm.value);
+  }
+  Interpreter_Value subject = {0};
+  if (!optimizer_is_constant(f, &match->subject.items[0])) return;
+  if (!interpreter_eval(&f->in, &match->subject.items[0], &subject) || subject.kind != INTERPRETER_VK_NUMBER) return;
+
+  AST_Node *taken = NULL;
+  nob_da_foreach(AST_Node, arm, &match->arms) {
+    if (arm->as.match_arm.patterns.count == 0 && taken == NULL) taken = arm;
+    nob_da_foreach(AST_Node, pattern, &arm->as.match_arm.patterns) {
+      if (ast_int_literal_value(pattern) == subject.number) {
+        taken = arm;
+        goto found;
+      }
+    }
+  }
+found:
+  // Without a `_` arm the value is undefined, which has no literal to be replaced by
+  if (taken == NULL) return;
+  AST_Node value = taken->as.match_arm.value.items[0];
+  taken->as.match_arm.value.count = 0;
+  ast_node_children_free(node);
+  *node = value;
+  f->folded++;
+}
+
+void optimizer_fold_expr(Optimizer_Folder *f, AST_Node *node) {
+  AST_NodeList *operands = NULL;
+  switch (node->kind) {
+  case AST_NK_TOKEN: {
+    // Immutable locals bound to a literal get replaced by it
+    if (node->as.token.kind != TOK_IDENT) return;
+    AST_Node *value = optimizer_fold_scope_lookup(f, node->as.token.sv);
+    if (value == NULL) return;
+    Loc loc = node->loc;
+    *node = ast_node_clone(*value);
+    node->loc = loc;
+    f->folded++;
+  } return;
+  case AST_NK_UNOP:
+  case AST_NK_BINOP:
+    operands = &node->as.op.operands;
+    break;
+  case AST_NK_FN_CALL:
+    operands = &node->as.fn_call.params;
+    break;
+  case AST_NK_AWAIT:
+    optimizer_fold_expr_list(f, &node->as.awaited);
+    return;
+  case AST_NK_EXPR:
+    optimizer_fold_expr_list(f, &node->as.expr);
+    return;
+  case AST_NK_MATCH:
+    optimizer_fold_match(f, node);
+    return;
+  case AST_NK_ARRAY:
+    optimizer_fold_expr_list(f, &node->as.array.items);
+    optimizer_fold_expr_list(f, &node->as.array.length);
+    return;
+  case AST_NK_INDEX:
+    optimizer_fold_expr_list(f, &node->as.index.target);
+    optimizer_fold_expr_list(f, &node->as.index.start);
+    optimizer_fold_expr_list(f, &node->as.index.end);
+    return;
+  case AST_NK_FIELD:
+    optimizer_fold_expr_list(f, &node->as.field.target);
+    return;
+  case AST_NK_PIPELINE:
+    // The calls of the stages read the element so only their other arguments can be folded
+    optimizer_fold_expr_list(f, &node->as.pipeline.source);
+    nob_da_foreach(AST_Node, stage, &node->as.pipeline.stages) {
+      optimizer_fold_expr_list(f, &stage->as.pipe_stage.call.items[0].as.fn_call.params);
+      optimizer_fold_expr_list(f, &stage->as.pipe_stage.init);
+    }
+    return;
+  default:
+    return;
+  }
+  // Operands first so a call only gets evaluated once its arguments are known
+  optimizer_fold_expr_list(f, operands);
+  if (optimizer_is_literal(node)) return;
+  nob_da_foreach(AST_Node, it, operands) {
+    if (!optimizer_is_constant(f, it)) return;
+  }
+
+  Interpreter_Value value = {0};
+  if (!interpreter_eval(&f->in, node, &value)) return;
+  // Booleans and undefined print differently from numbers, and numbers this big would print in exponent notation
+  if (value.kind != INTERPRETER_VK_NUMBER || !isfinite(value.number) || fabs(value.number) >= 1e21) return;
+  ast_node_children_free(node);
+  *node = optimizer_number_literal(node->loc, value.number);
+  f->folded++;
+}
+
+void optimizer_fold_statements(Optimizer_Folder *f, AST_NodeList *list) {
+  nob_da_foreach(AST_Node, it, list) {
+    switch (it->kind) {
+    case AST_NK_VAR_DECL: {
+      optimizer_fold_expr_list(f, &it->as.var_decl.expr);
+      AST_NodeList *expr = &it->as.var_decl.expr;
+      bool is_constant = !it->as.var_decl.mutable && expr->count == 1 && optimizer_is_literal(&expr->items[0]);
+      optimizer_fold_scope_push(f, it->as.var_decl.name, is_constant ? &expr->items[0] : NULL);
+    } break;
+    case AST_NK_ASSIGNMENT:
+      optimizer_fold_expr_list(f, &it->as.var_assign.expr);
+      break;
+    case AST_NK_RETURN:
+      optimizer_fold_expr_list(f, &it->as.ret);
+      break;
+    case AST_NK_EXPR:
+      optimizer_fold_expr_list(f, &it->as.expr);
+      break;
+    case AST_NK_FN_CALL:
+      // The call statement itself stays, a lone literal statement would do nothing
+      optimizer_fold_expr_list(f, &it->as.fn_call.params);
+      break;
+    case AST_NK_BLOCK: {
+      size_t scope = f->scope_names.count;
+      optimizer_fold_statements(f, &it->as.block);
+      optimizer_fold_scope_restore(f, scope);
+    } break;
+    case AST_NK_IF: {
+      size_t scope = f->scope_names.count;
+      optimizer_fold_expr_list(f, &it->as.if_stmt.cond);
+      optimizer_fold_statements(f, &it->as.if_stmt.then_body);
+      optimizer_fold_scope_restore(f, scope);
+      optimizer_fold_statements(f, &it->as.if_stmt.else_body);
+      optimizer_fold_scope_restore(f, scope);
+    } break;
+    case AST_NK_WHILE: {
+      size_t scope = f->scope_names.count;
+      optimizer_fold_expr_list(f, &it->as.while_loop.cond);
+      optimizer_fold_statements(f, &it->as.while_loop.body);
+      optimizer_fold_scope_restore(f, scope);
+    } break;
+    case AST_NK_YIELD:
+      optimizer_fold_expr_list(f, &it->as.yield);
+      break;
+    case AST_NK_FOR: {
+      size_t scope = f->scope_names.count;
+      optimizer_fold_expr_list(f, &it->as.for_loop.iter);
+      optimizer_fold_scope_push(f, it->as.for_loop.name, NULL);
+      optimizer_fold_statements(f, &it->as.for_loop.body);
+      optimizer_fold_scope_restore(f, scope);
+    } break;
+    default:
+      break;
+    }
+  }
+}
+
+size_t optimizer_fold_constants(AST_NodeList *module, Options *opts) {
+  if (opts->ctfe_steps == 0) return 0;
+  Optimizer_Folder f = {
+    .module = module,
+    .in = {
+      .module = module,
+      .limits = {
+        .max_steps = opts->ctfe_steps,
+        .max_depth = 1000,
+        .max_slots = 1 << 20,
+      },
+    },
+  };
+  nob_da_foreach(AST_Node, it, module) {
+    f.locals.count = 0;
+    if (it->kind == AST_NK_VAR_DECL) {
+      optimizer_fold_expr_list(&f, &it->as.var_decl.expr);
+    } else if (it->kind == AST_NK_FN_DECL) {
+      optimizer_collect_locals(it, &f.locals);
+      nob_da_foreach(AST_Node, param, &it->as.fn_decl.params) {
+        optimizer_fold_scope_push(&f, param->as.token.sv, NULL);
+      }
+      optimizer_fold_statements(&f, &it->as.fn_decl.body);
+      optimizer_fold_scope_restore(&f, 0);
+    }
+  }
+  interpreter_free(&f.in);
+  safe_da_free(f.locals);
+  safe_da_free(f.scope_names);
+  safe_da_free(f.scope_values);
+  return f.folded;
+}
+
+void optimizer_append_operand(Nob_String_Builder *sb, AST_Node *operand, int precedence, bool is_rhs) {
+  bool wrap = false;
+  if (operand->kind == AST_NK_BINOP) {
+    int operand_precedence = ast_binop_precedence(operand->as.op.op.sv);
+    wrap = operand_precedence < precedence || (is_rhs && operand_precedence == precedence);
+  }
+  if (wrap) nob_sb_append_cstr(sb, "(");
+  optimizer_append_expr(sb, operand);
+  if (wrap) nob_sb_append_cstr(sb, ")");
+}
+
+void optimizer_append_expr(Nob_String_Builder *sb, AST_Node *node) {
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    sb_append_sv(sb, node->as.token.sv);
+    return;
+  case AST_NK_EXPR:
+    nob_da_foreach(AST_Node, it, &node->as.expr) {
+      optimizer_append_expr(sb, it);
+    }
+    return;
+  case AST_NK_FN_CALL:
+    sb_append_sv(sb, node->as.fn_call.name);
+    nob_sb_append_cstr(sb, "(");
+    nob_da_foreach(AST_Node, it, &node->as.fn_call.params) {
+      if (it != node->as.fn_call.params.items) nob_sb_append_cstr(sb, ", ");
+      optimizer_append_expr(sb, it);
+    }
+    nob_sb_append_cstr(sb, ")");
+    return;
+  case AST_NK_UNOP:
+    sb_append_sv(sb, node->as.op.op.sv);
+    optimizer_append_operand(sb, &node->as.op.operands.items[0], INT_MAX, false);
+    return;
+  case AST_NK_BINOP: {
+    int precedence = ast_binop_precedence(node->as.op.op.sv);
+    optimizer_append_operand(sb, &node->as.op.operands.items[0], precedence, false);
+    nob_sb_appendf(sb, " "SV_Fmt" ", SV_Arg(node->as.op.op.sv));
+    optimizer_append_operand(sb, &node->as.op.operands.items[1], precedence, true);
+  } return;
+  case AST_NK_MATCH:
+    nob_sb_append_cstr(sb, "match (");
+    optimizer_append_expr(sb, &node->as.match.subject.items[0]);
+    nob_sb_append_cstr(sb, ") { ");
+    nob_da_foreach(AST_Node, arm, &node->as.match.arms) {
+      if (arm != node->as.match.arms.items) nob_sb_append_cstr(sb, ", ");
+      nob_da_foreach(AST_Node, pattern, &arm->as.match_arm.patterns) {
+        if (pattern != arm->as.match_arm.patterns.items) nob_sb_append_cstr(sb, " | ");
+        optimizer_append_expr(sb, pattern);
+      }
+      if (arm->as.match_arm.patterns.count == 0) nob_sb_append_cstr(sb, "_");
+      nob_sb_append_cstr(sb, " => ");
+      optimizer_append_expr(sb, &arm->as.match_arm.value.items[0]);
+    }
+    nob_sb_append_cstr(sb, " }");
+    return;
+  case AST_NK_ARRAY:
+    nob_sb_append_cstr(sb, "[");
+    nob_da_foreach(AST_Node, it, &node->as.array.items) {
+      if (it != node->as.array.items.items) nob_sb_append_cstr(sb, ", ");
+      optimizer_append_expr(sb, it);
+    }
+    if (node->as.array.length.count > 0) {
+      nob_sb_append_cstr(sb, "; ");
+      optimizer_append_expr(sb, &node->as.array.length.items[0]);
+    }
+    nob_sb_append_cstr(sb, "]");
+    return;
+  case AST_NK_INDEX:
+    optimizer_append_expr(sb, &node->as.index.target.items[0]);
+    nob_sb_append_cstr(sb, "[");
+    if (node->as.index.start.count > 0) optimizer_append_expr(sb, &node->as.index.start.items[0]);
+    if (node->as.index.slice) nob_sb_append_cstr(sb, "..");
+    if (node->as.index.end.count > 0) optimizer_append_expr(sb, &node->as.index.end.items[0]);
+    nob_sb_append_cstr(sb, "]");
+    return;
+  case AST_NK_FIELD:
+    optimizer_append_expr(sb, &node->as.field.target.items[0]);
+    nob_sb_appendf(sb, "."SV_Fmt, SV_Arg(node->as.field.name));
+    return;
+  case AST_NK_PIPELINE:
+    optimizer_append_expr(sb, &node->as.pipeline.source.items[0]);
+    nob_da_foreach(AST_Node, stage, &node->as.pipeline.stages) {
+      nob_sb_append_cstr(sb, " |> ");
+      optimizer_append_expr(sb, &stage->as.pipe_stage.call.items[0]);
+    }
+    return;
+  default:
+    nob_sb_appendf(sb, "<%s>", ast_node_kind_name(node->kind));
+    return;
+  }
+}
+
+uint64_t optimizer_hash_sv(uint64_t hash, Nob_String_View sv) {
+  for (size_t i = 0; i < sv.count; ++i) {
+    hash ^= (unsigned char)sv.data[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// FNV-1a over the shape of the expression, equal expressions hash the same
+uint64_t optimizer_expr_hash(uint64_t hash, AST_Node *node) {
+  node = optimizer_unwrap_expr(node);
+  hash ^= node->kind;
+  hash *= 1099511628211ULL;
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    return optimizer_hash_sv(hash, node->as.token.sv);
+  case AST_NK_UNOP:
+  case AST_NK_BINOP:
+    hash = optimizer_hash_sv(hash, node->as.op.op.sv);
+    break;
+  case AST_NK_FN_CALL:
+    hash = optimizer_hash_sv(hash, node->as.fn_call.name);
+    break;
+  default:
+    break;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      hash = optimizer_expr_hash(hash, it);
+    }
+  }
+  return hash;
+}
+
+bool optimizer_expr_eq(AST_Node *a, AST_Node *b) {
+  a = optimizer_unwrap_expr(a);
+  b = optimizer_unwrap_expr(b);
+  if (a->kind != b->kind) return false;
+  switch (a->kind) {
+  case AST_NK_TOKEN:
+    return a->as.token.kind == b->as.token.kind && nob_sv_eq(a->as.token.sv, b->as.token.sv);
+  case AST_NK_UNOP:
+  case AST_NK_BINOP:
+    if (!nob_sv_eq(a->as.op.op.sv, b->as.op.op.sv)) return false;
+    break;
+  case AST_NK_FN_CALL:
+    if (!nob_sv_eq(a->as.fn_call.name, b->as.fn_call.name)) return false;
+    break;
+  case AST_NK_EXPR:
+    break;
+  default:
+    return false;
+  }
+  AST_NodeList *a_lists[AST_MAX_CHILD_LISTS];
+  AST_NodeList *b_lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(a, a_lists);
+  if (ast_node_child_lists(b, b_lists) != lists_count) return false;
+  for (size_t i = 0; i < lists_count; ++i) {
+    if (a_lists[i]->count != b_lists[i]->count) return false;
+    for (size_t j = 0; j < a_lists[i]->count; ++j) {
+      if (!optimizer_expr_eq(&a_lists[i]->items[j], &b_lists[i]->items[j])) return false;
+    }
+  }
+  return true;
+}
+
+// Whether the expression reads any of the variables
+bool optimizer_expr_reads_any(AST_Node *node, StringViews *names) {
+  if (node->kind == AST_NK_TOKEN) return node->as.token.kind == TOK_IDENT && optimizer_svs_contain(names, node->as.token.sv);
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (optimizer_expr_reads_any(it, names)) return true;
+    }
+  }
+  return false;
+}
+
+// Names of every variable the node assigns to or declares
+void optimizer_collect_writes(AST_Node *node, StringViews *writes) {
+  if (node->kind == AST_NK_ASSIGNMENT) nob_da_append(writes, node->as.var_assign.name);
+  if (node->kind == AST_NK_VAR_DECL) nob_da_append(writes, node->as.var_decl.name);
+  if (node->kind == AST_NK_FOR) nob_da_append(writes, node->as.for_loop.name);
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      optimizer_collect_writes(it, writes);
+    }
+  }
+}
+
+void optimizer_insert_node(AST_NodeList *list, size_t index, AST_Node node) {
+  nob_da_append(list, node);
+  memmove(&list->items[index + 1], &list->items[index], (list->count - index - 1) * sizeof(AST_Node));
+  list->items[index] = node;
+}
+
+AST_Node optimizer_ident(Loc loc, Nob_String_View name) {
+  AST_Node ident = {
+    .loc = loc,
+    .kind = AST_NK_TOKEN,
+  };
+  ident.as.token.kind = TOK_IDENT;
+  ident.as.token.sv = name;
+  return ident;
+}
+
+typedef struct {
+  AST_NodeList *module;
+  Options *opts;
+  // Names declared by the function being optimized
+  StringViews locals;
+  // Per module index, what is known about calling the function there
+  Optimizer_Call_Kind *calls;
+  size_t fresh_id;
+  size_t moved;
+} Optimizer_Motion;
+
+// Nested functions can write to the variables of the enclosing one behind the optimizer's back
+bool optimizer_motion_can_optimize(AST_Node *fn) {
+  nob_da_foreach(AST_Node, it, &fn->as.fn_decl.body) {
+    if (optimizer_contains_kind(it, AST_NK_FN_DECL)) return false;
+  }
+  return true;
+}
+
+Optimizer_Call_Kind optimizer_call_kind(AST_NodeList *module, Optimizer_Call_Kind *calls, AST_Node *fn) {
+  Optimizer_Call_Kind *kind = &calls[fn - module->items];
+  if (*kind != OPTIMIZER_CALL_UNCHECKED) return *kind;
+  if (!optimizer_fn_is_pure(module, fn, NULL)) {
+    *kind = OPTIMIZER_CALL_IMPURE;
+    return *kind;
+  }
+  *kind = OPTIMIZER_CALL_PURE;
+  if (optimizer_fn_is_recursive(module, fn) || optimizer_contains_kind(fn, AST_NK_WHILE)) return *kind;
+  StringViews refs = {0};
+  optimizer_collect_refs(fn, &refs);
+  bool total = true;
+  nob_da_foreach(Nob_String_View, ref, &refs) {
+    AST_Node *callee = optimizer_find_fn(module, *ref);
+    if (callee != NULL && optimizer_call_kind(module, calls, callee) != OPTIMIZER_CALL_TOTAL) {
+      total = false;
+      break;
+    }
+  }
+  safe_da_free(refs);
+  if (total) *kind = OPTIMIZER_CALL_TOTAL;
+  return *kind;
+}
+
+void optimizer_classify_calls(AST_NodeList *module, Optimizer_Call_Kind *calls) {
+  memset(calls, 0, module->count * sizeof(Optimizer_Call_Kind));
+  nob_da_foreach(AST_Node, it, module) {
+    if (it->kind == AST_NK_FN_DECL) optimizer_call_kind(module, calls, it);
+  }
+}
+
+// Whether the expression computes the same value wherever it is evaluated as long as the variables it reads hold the same values
+// Clears total when it calls a function that might not return
+bool optimizer_motion_is_movable(Optimizer_Motion *m, AST_Node *node, bool *total) {
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    if (node->as.token.kind == TOK_INT) return true;
+    if (node->as.token.kind != TOK_IDENT) return false;
+    if (optimizer_svs_contain(&m->locals, node->as.token.sv)) return true;
+    nob_da_foreach(AST_Node, it, m->module) {
+      if (it->kind == AST_NK_VAR_DECL && nob_sv_eq(it->as.var_decl.name, node->as.token.sv)) return !it->as.var_decl.mutable;
+    }
+    return false;
+  case AST_NK_FN_CALL: {
+    AST_Node *callee = optimizer_find_fn(m->module, node->as.fn_call.name);
+    if (callee == NULL) return false;
+    Optimizer_Call_Kind kind = m->calls[callee - m->module->items];
+    if (kind == OPTIMIZER_CALL_IMPURE) return false;
+    if (kind == OPTIMIZER_CALL_PURE) *total = false;
+    nob_da_foreach(AST_Node, it, &node->as.fn_call.params) {
+      if (!optimizer_motion_is_movable(m, it, total)) return false;
+    }
+    return true;
+  }
+  case AST_NK_UNOP:
+  case AST_NK_BINOP:
+    nob_da_foreach(AST_Node, it, &node->as.op.operands) {
+      if (!optimizer_motion_is_movable(m, it, total)) return false;
+    }
+    return true;
+  case AST_NK_EXPR:
+    nob_da_foreach(AST_Node, it, &node->as.expr) {
+      if (!optimizer_motion_is_movable(m, it, total)) return false;
+    }
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Expressions worth storing in a variable: calls, and operations on more than a single value
+bool optimizer_motion_is_candidate(Optimizer_Motion *m, AST_Node *node, bool *total) {
+  if (node->kind != AST_NK_FN_CALL && node->kind != AST_NK_BINOP && node->kind != AST_NK_UNOP) return false;
+  if (node->kind != AST_NK_FN_CALL && optimizer_node_cost(node) < 3) return false;
+  *total = true;
+  return optimizer_motion_is_movable(m, node, total);
+}
+
+Nob_String_View optimizer_motion_fresh_name(Optimizer_Motion *m, const char *prefix) {
+  m->fresh_id++;
+  Nob_String_Builder sb = {0};
+  nob_sb_appendf(&sb, "$%s%zu", prefix, m->fresh_id);
+  return nob_sb_to_sv(sb);
+}
+
+bool optimizer_is_short_circuit(AST_Node *node) {
+  return node->kind == AST_NK_BINOP && (sv_eq_str(node->as.op.op.sv, "&&") || sv_eq_str(node->as.op.op.sv, "||"));
+}
+
+typedef struct {
+  uint64_t hash;
+  // First occurrence, the one that ends up computing the value
+  AST_Node *def;
+  // Statement the first occurrence is part of
+  AST_NodeList *list;
+  size_t index;
+  // Variable already holding the value when the first occurrence is all a declaration stores, empty otherwise
+  Nob_String_View name;
+  // Set once the walk leaves the statement list of the first occurrence or something it reads gets written to
+  bool dead;
+  AST_NodePtrs uses;
+} Optimizer_CSE_Entry;
+
+typedef struct {
+  Optimizer_Motion *m;
+  struct {
+    Optimizer_CSE_Entry *items;
+    size_t count;
+    size_t capacity;
+  } entries;
+} Optimizer_CSE;
+
+// Forget the values that depend on the variable, the declaration of it if any keeps the value it just stored
+void optimizer_cse_kill(Optimizer_CSE *cse, Nob_String_View name, AST_Node *decl) {
+  StringViews names = {0};
+  nob_da_append(&names, name);
+  nob_da_foreach(Optimizer_CSE_Entry, it, &cse->entries) {
+    if (it->dead) continue;
+    bool is_decl = &it->list->items[it->index] == decl;
+    if ((nob_sv_eq(it->name, name) && !is_decl) || optimizer_expr_reads_any(it->def, &names)) it->dead = true;
+  }
+  safe_da_free(names);
+}
+
+void optimizer_cse_visit_list(Optimizer_CSE *cse, AST_NodeList *exprs, bool can_define, AST_NodeList *list, size_t index);
+
+void optimizer_cse_visit(Optimizer_CSE *cse, AST_Node *node, bool can_define, AST_NodeList *list, size_t index) {
+  bool total = true;
+  if (optimizer_motion_is_candidate(cse->m, node, &total)) {
+    uint64_t hash = optimizer_expr_hash(14695981039346656037ULL, node);
+    nob_da_foreach(Optimizer_CSE_Entry, it, &cse->entries) {
+      if (it->dead || it->hash != hash || !optimizer_expr_eq(it->def, node)) continue;
+      nob_da_append(&it->uses, node);
+      return;
+    }
+    if (can_define) {
+      Optimizer_CSE_Entry entry = {
+        .hash = hash,
+        .def = node,
+        .list = list,
+        .index = index,
+      };
+      AST_Node *stmt = &list->items[index];
+      if (stmt->kind == AST_NK_VAR_DECL && stmt->as.var_decl.expr.count == 1 && optimizer_unwrap_expr(&stmt->as.var_decl.expr.items[0]) == node) {
+        entry.name = stmt->as.var_decl.name;
+      }
+      nob_da_append(&cse->entries, entry);
+    }
+  }
+  switch (node->kind) {
+  case AST_NK_EXPR:
+    nob_da_foreach(AST_Node, it, &node->as.expr) {
+      optimizer_cse_visit(cse, it, can_define, list, index);
+    }
+    return;
+  case AST_NK_UNOP:
+  case AST_NK_BINOP:
+    optimizer_cse_visit(cse, &node->as.op.operands.items[0], can_define, list, index);
+    if (node->as.op.operands.count > 1) {
+      // The right hand side of `&&` and `||` doesn't always run
+      optimizer_cse_visit(cse, &node->as.op.operands.items[1], can_define && !optimizer_is_short_circuit(node), list, index);
+    }
+    return;
+  case AST_NK_FN_CALL:
+    nob_da_foreach(AST_Node, it, &node->as.fn_call.params) {
+      optimizer_cse_visit(cse, it, can_define, list, index);
+    }
+    return;
+  case AST_NK_ARRAY:
+    optimizer_cse_visit_list(cse, &node->as.array.items, can_define, list, index);
+    optimizer_cse_visit_list(cse, &node->as.array.length, can_define, list, index);
+    return;
+  case AST_NK_INDEX:
+    optimizer_cse_visit_list(cse, &node->as.index.target, can_define, list, index);
+    optimizer_cse_visit_list(cse, &node->as.index.start, can_define, list, index);
+    optimizer_cse_visit_list(cse, &node->as.index.end, can_define, list, index);
+    return;
+  case AST_NK_FIELD:
+    optimizer_cse_visit_list(cse, &node->as.field.target, can_define, list, index);
+    return;
+  case AST_NK_PIPELINE:
+    // The stages run once per element, possibly never
+    optimizer_cse_visit_list(cse, &node->as.pipeline.source, can_define, list, index);
+    return;
+  case AST_NK_MATCH:
+    optimizer_cse_visit_list(cse, &node->as.match.subject, can_define, list, index);
+    // Only one of the arms runs
+    nob_da_foreach(AST_Node, arm, &node->as.match.arms) {
+      optimizer_cse_visit_list(cse, &arm->as.match_arm.value, false, list, index);
+    }
+    return;
+  default:
+    return;
+  }
+}
+
+void optimizer_cse_visit_list(Optimizer_CSE *cse, AST_NodeList *exprs, bool can_define, AST_NodeList *list, size_t index) {
+  nob_da_foreach(AST_Node, it, exprs) {
+    optimizer_cse_visit(cse, it, can_define, list, index);
+  }
+}
+
+void optimizer_cse_walk(Optimizer_CSE *cse, AST_NodeList *list) {
+  size_t scope = cse->entries.count;
+  for (size_t i = 0; i < list->count; ++i) {
+    AST_Node *it = &list->items[i];
+    switch (it->kind) {
+    case AST_NK_VAR_DECL:
+      optimizer_cse_visit_list(cse, &it->as.var_decl.expr, true, list, i);
+      // The new variable hides whatever the name referred to before
+      optimizer_cse_kill(cse, it->as.var_decl.name, it);
+      break;
+    case AST_NK_ASSIGNMENT:
+      optimizer_cse_visit_list(cse, &it->as.var_assign.expr, true, list, i);
+      optimizer_cse_kill(cse, it->as.var_assign.name, NULL);
+      break;
+    case AST_NK_RETURN:
+      optimizer_cse_visit_list(cse, &it->as.ret, true, list, i);
+      break;
+    case AST_NK_YIELD:
+      optimizer_cse_visit_list(cse, &it->as.yield, true, list, i);
+      break;
+    case AST_NK_EXPR:
+      optimizer_cse_visit_list(cse, &it->as.expr, true, list, i);
+      break;
+    case AST_NK_FN_CALL:
+      optimizer_cse_visit_list(cse, &it->as.fn_call.params, true, list, i);
+      break;
+    case AST_NK_BLOCK:
+      optimizer_cse_walk(cse, &it->as.block);
+      break;
+    case AST_NK_IF:
+      optimizer_cse_visit_list(cse, &it->as.if_stmt.cond, true, list, i);
+      optimizer_cse_walk(cse, &it->as.if_stmt.then_body);
+      optimizer_cse_walk(cse, &it->as.if_stmt.else_body);
+      break;
+    case AST_NK_WHILE: {
+      // Anything written inside of the loop might already differ at the start of the next iteration
+      StringViews writes = {0};
+      optimizer_collect_writes(it, &writes);
+      nob_da_foreach(Nob_String_View, name, &writes) {
+        optimizer_cse_kill(cse, *name, NULL);
+      }
+      safe_da_free(writes);
+      optimizer_cse_visit_list(cse, &it->as.while_loop.cond, false, list, i);
+      optimizer_cse_walk(cse, &it->as.while_loop.body);
+    } break;
+    case AST_NK_FOR: {
+      // What gets iterated is computed once before the loop, the body runs again like a while's does
+      optimizer_cse_visit_list(cse, &it->as.for_loop.iter, true, list, i);
+      StringViews writes = {0};
+      optimizer_collect_writes(it, &writes);
+      nob_da_foreach(Nob_String_View, name, &writes) {
+        optimizer_cse_kill(cse, *name, NULL);
+      }
+      safe_da_free(writes);
+      optimizer_cse_walk(cse, &it->as.for_loop.body);
+    } break;
+    default:
+      break;
+    }
+  }
+  for (size_t i = scope; i < cse->entries.count; ++i) {
+    cse->entries.items[i].dead = true;
+  }
+}
+
+void optimizer_cse_reset(Optimizer_CSE *cse) {
+  nob_da_foreach(Optimizer_CSE_Entry, it, &cse->entries) {
+    safe_da_free(it->uses);
+  }
+  cse->entries.count = 0;
+}
+
+// Replace the occurrences of the most expensive repeated expression, returns false when there is none left
+bool optimizer_cse_step(Optimizer_CSE *cse, AST_Node *fn) {
+  optimizer_cse_reset(cse);
+  optimizer_cse_walk(cse, &fn->as.fn_decl.body);
+
+  Optimizer_CSE_Entry *best = NULL;
+  size_t best_cost = 0;
+  nob_da_foreach(Optimizer_CSE_Entry, it, &cse->entries) {
+    if (it->uses.count == 0) continue;
+    size_t cost = optimizer_node_cost(it->def);
+    if (cost <= best_cost) continue;
+    best = it;
+    best_cost = cost;
+  }
+  if (best == NULL) return false;
+
+  Nob_String_View name = best->name;
+  if (name.count == 0) {
+    name = optimizer_motion_fresh_name(cse->m, "cse");
+    nob_da_append(&cse->m->locals, name);
+  }
+  if (cse->m->opts->report_hoist) {
+    Nob_String_Builder sb = {0};
+    optimizer_append_expr(&sb, best->def);
+    comp_notef(best->def->loc, "Computing `"SV_Fmt"` once as `"SV_Fmt"`, reused %zu more time%s",
+               (int)sb.count, sb.items, SV_Arg(name), best->uses.count, best->uses.count == 1 ? "" : "s");
+    nob_sb_free(sb);
+  }
+  nob_da_foreach(AST_Node *, use, &best->uses) {
+    Loc loc = (*use)->loc;
+    ast_node_children_free(*use);
+    **use = optimizer_ident(loc, name);
+  }
+  cse->m->moved += best->uses.count;
+  if (best->name.count > 0) return true;
+
+  AST_Node decl = {
+    .loc = best->def->loc,
+    .kind = AST_NK_VAR_DECL,
+  };
+  decl.as.var_decl.name = name;
+  decl.as.var_decl.mutable = false;
+  nob_da_append(&decl.as.var_decl.expr, *best->def);
+  *best->def = optimizer_ident(decl.loc, name);
+  optimizer_insert_node(best->list, best->index, decl);
+  return true;
+}
+
+size_t optimizer_eliminate_common_subexprs(AST_NodeList *module, Options *opts, Optimizer_Call_Kind *calls) {
+  Optimizer_Motion m = {
+    .module = module,
+    .opts = opts,
+    .calls = calls,
+  };
+  Optimizer_CSE cse = {
+    .m = &m,
+  };
+  nob_da_foreach(AST_Node, it, module) {
+    if (it->kind != AST_NK_FN_DECL || !optimizer_motion_can_optimize(it)) continue;
+    m.locals.count = 0;
+    optimizer_collect_locals(it, &m.locals);
+    // Every step takes at least one operation out of the body so this ends
+    while (optimizer_cse_step(&cse, it)) {}
+  }
+  optimizer_cse_reset(&cse);
+  safe_da_free(cse.entries);
+  safe_da_free(m.locals);
+  return m.moved;
+}
+
+typedef struct {
+  Optimizer_Motion *m;
+  // Variables written somewhere inside of the loop
+  StringViews varying;
+  // Declarations of the hoisted values, they go right before the loop
+  AST_NodeList decls;
+} Optimizer_LICM;
+
+void optimizer_licm_visit(Optimizer_LICM *h, AST_Node *node, bool runs_first) {
+  bool total = true;
+  if (optimizer_motion_is_candidate(h->m, node, &total) && !optimizer_expr_reads_any(node, &h->varying) && (total || runs_first)) {
+    Nob_String_View name = {0};
+    nob_da_foreach(AST_Node, it, &h->decls) {
+      if (optimizer_expr_eq(&it->as.var_decl.expr.items[0], node)) {
+        name = it->as.var_decl.name;
+        break;
+      }
+    }
+    if (name.count == 0) {
+      name = optimizer_motion_fresh_name(h->m, "licm");
+      nob_da_append(&h->m->locals, name);
+      if (h->m->opts->report_hoist) {
+        Nob_String_Builder sb = {0};
+        optimizer_append_expr(&sb, node);
+        comp_notef(node->loc, "Hoisted `"SV_Fmt"` out of the loop as `"SV_Fmt"`", (int)sb.count, sb.items, SV_Arg(name));
+        nob_sb_free(sb);
+      }
+      AST_Node decl = {
+        .loc = node->loc,
+        .kind = AST_NK_VAR_DECL,
+      };
+      decl.as.var_decl.name = name;
+      decl.as.var_decl.mutable = false;
+      nob_da_append(&decl.as.var_decl.expr, *node);
+      nob_da_append(&h->decls, decl);
+    } else {
+      ast_node_children_free(node);
+    }
+    *node = optimizer_ident(node->loc, name);
+    h->m->moved++;
+    return;
+  }
+  switch (node->kind) {
+  case AST_NK_EXPR:
+    nob_da_foreach(AST_Node, it, &node->as.expr) {
+      optimizer_licm_visit(h, it, runs_first);
+    }
+    return;
+  case AST_NK_UNOP:
+  case AST_NK_BINOP:
+    optimizer_licm_visit(h, &node->as.op.operands.items[0], runs_first);
+    if (node->as.op.operands.count > 1) {
+      optimizer_licm_visit(h, &node->as.op.operands.items[1], runs_first && !optimizer_is_short_circuit(node));
+    }
+    return;
+  case AST_NK_FN_CALL:
+    nob_da_foreach(AST_Node, it, &node->as.fn_call.params) {
+      optimizer_licm_visit(h, it, runs_first);
+    }
+    return;
+  case AST_NK_ARRAY:
+    nob_da_foreach(AST_Node, it, &node->as.array.items) {
+      optimizer_licm_visit(h, it, runs_first);
+    }
+    nob_da_foreach(AST_Node, it, &node->as.array.length) {
+      optimizer_licm_visit(h, it, runs_first);
+    }
+    return;
+  case AST_NK_INDEX:
+    optimizer_licm_visit(h, &node->as.index.target.items[0], runs_first);
+    nob_da_foreach(AST_Node, it, &node->as.index.start) {
+      optimizer_licm_visit(h, it, runs_first);
+    }
+    nob_da_foreach(AST_Node, it, &node->as.index.end) {
+      optimizer_licm_visit(h, it, runs_first);
+    }
+    return;
+  case AST_NK_FIELD:
+    optimizer_licm_visit(h, &node->as.field.target.items[0], runs_first);
+    return;
+  case AST_NK_PIPELINE:
+    optimizer_licm_visit(h, &node->as.pipeline.source.items[0], runs_first);
+    return;
+  case AST_NK_MATCH:
+    optimizer_licm_visit(h, &node->as.match.subject.items[0], runs_first);
+    nob_da_foreach(AST_Node, arm, &node->as.match.arms) {
+      optimizer_licm_visit(h, &arm->as.match_arm.value.items[0], false);
+    }
+    return;
+  default:
+    return;
+  }
+}
+
+// Values an inner loop hoisted that don't change in the outer loop either
+bool optimizer_licm_is_invariant_decl(Optimizer_LICM *h, AST_Node *node) {
+  if (node->kind != AST_NK_VAR_DECL || node->as.var_decl.mutable) return false;
+  if (!nob_sv_starts_with(node->as.var_decl.name, SV("$licm")) || node->as.var_decl.expr.count != 1) return false;
+  bool total = true;
+  AST_Node *expr = &node->as.var_decl.expr.items[0];
+  return optimizer_motion_is_movable(h->m, expr, &total) && total && !optimizer_expr_reads_any(expr, &h->varying);
+}
+
+void optimizer_licm_visit_statements(Optimizer_LICM *h, AST_NodeList *list) {
+  for (size_t i = 0; i < list->count; ++i) {
+    AST_Node *it = &list->items[i];
+    if (optimizer_licm_is_invariant_decl(h, it)) {
+      // The whole declaration moves so it isn't left behind as a copy of another variable
+      if (h->m->opts->report_hoist) {
+        comp_notef(it->loc, "Hoisted `"SV_Fmt"` out of the enclosing loop too", SV_Arg(it->as.var_decl.name));
+      }
+      nob_da_foreach(Nob_String_View, name, &h->varying) {
+        if (nob_sv_eq(*name, it->as.var_decl.name)) *name = SV("");
+      }
+      nob_da_append(&h->decls, *it);
+      memmove(it, it + 1, (list->count - i - 1) * sizeof(AST_Node));
+      list->count--;
+      i--;
+      continue;
+    }
+    AST_NodeList *exprs = NULL;
+    switch (it->kind) {
+    case AST_NK_VAR_DECL: exprs = &it->as.var_decl.expr; break;
+    case AST_NK_ASSIGNMENT: exprs = &it->as.var_assign.expr; break;
+    case AST_NK_RETURN: exprs = &it->as.ret; break;
+    case AST_NK_YIELD: exprs = &it->as.yield; break;
+    case AST_NK_EXPR: exprs = &it->as.expr; break;
+    case AST_NK_FN_CALL: exprs = &it->as.fn_call.params; break;
+    case AST_NK_BLOCK:
+      optimizer_licm_visit_statements(h, &it->as.block);
+      break;
+    case AST_NK_FOR:
+      exprs = &it->as.for_loop.iter;
+      optimizer_licm_visit_statements(h, &it->as.for_loop.body);
+      break;
+    case AST_NK_IF:
+      exprs = &it->as.if_stmt.cond;
+      optimizer_licm_visit_statements(h, &it->as.if_stmt.then_body);
+      optimizer_licm_visit_statements(h, &it->as.if_stmt.else_body);
+      break;
+    case AST_NK_WHILE:
+      exprs = &it->as.while_loop.cond;
+      optimizer_licm_visit_statements(h, &it->as.while_loop.body);
+      break;
+    default:
+      break;
+    }
+    if (exprs == NULL) continue;
+    // Only operations that can't fail or hang get computed ahead of the statements before them in the loop
+    nob_da_foreach(AST_Node, expr, exprs) {
+      optimizer_licm_visit(h, expr, false);
+    }
+  }
+}
+
+void optimizer_licm_walk(Optimizer_Motion *m, AST_NodeList *list) {
+  for (size_t i = 0; i < list->count; ++i) {
+    AST_Node *it = &list->items[i];
+    // Inner loops first, what they hoist might be invariant for the outer loop too
+    AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+    size_t lists_count = ast_node_child_lists(it, lists);
+    for (size_t j = 0; j < lists_count; ++j) {
+      optimizer_licm_walk(m, lists[j]);
+    }
+    if (it->kind != AST_NK_WHILE) continue;
+
+    Optimizer_LICM h = {
+      .m = m,
+    };
+    optimizer_collect_writes(it, &h.varying);
+    // The condition runs before anything else in the loop, even calls that might not return can be moved out of it
+    nob_da_foreach(AST_Node, expr, &it->as.while_loop.cond) {
+      optimizer_licm_visit(&h, expr, true);
+    }
+    optimizer_licm_visit_statements(&h, &it->as.while_loop.body);
+    for (size_t j = 0; j < h.decls.count; ++j) {
+      optimizer_insert_node(list, i + j, h.decls.items[j]);
+    }
+    i += h.decls.count;
+    safe_da_free(h.varying);
+    safe_da_free(h.decls);
+  }
+}
+
+size_t optimizer_hoist_loop_invariants(AST_NodeList *module, Options *opts, Optimizer_Call_Kind *calls) {
+  Optimizer_Motion m = {
+    .module = module,
+    .opts = opts,
+    .calls = calls,
+  };
+  nob_da_foreach(AST_Node, it, module) {
+    if (it->kind != AST_NK_FN_DECL || !optimizer_motion_can_optimize(it)) continue;
+    m.locals.count = 0;
+    optimizer_collect_locals(it, &m.locals);
+    optimizer_licm_walk(&m, &it->as.fn_decl.body);
+  }
+  safe_da_free(m.locals);
+  return m.moved;
+}
+
+void optimizer_cases_add(Optimizer_Cases *cases, double value, AST_NodeList *body) {
+  size_t index = 0;
+  while (index < cases->count && cases->items[index].value < value) index++;
+  if (index < cases->count && cases->items[index].value == value) return;
+  Optimizer_Case it = {
+    .value = value,
+    .body = body,
+  };
+  nob_da_append(cases, it);
+  memmove(&cases->items[index + 1], &cases->items[index], (cases->count - index - 1) * sizeof(Optimizer_Case));
+  cases->items[index] = it;
+}
+
+bool optimizer_cases_are_dense(Optimizer_Cases *cases) {
+  if (cases->count < 3) return false;
+  double span = cases->items[cases->count - 1].value - cases->items[0].value + 1;
+  return span <= 2*cases->count && span <= OPTIMIZER_MAX_TABLE_SPAN;
+}
+
+bool optimizer_cases_are_worth_dispatch(Optimizer_Cases *cases) {
+  return optimizer_cases_are_dense(cases) || cases->count >= 4;
+}
+
+void optimizer_match_cases(AST_Node *match, Optimizer_Cases *cases, AST_NodeList **fallback) {
+  *fallback = NULL;
+  nob_da_foreach(AST_Node, arm, &match->as.match.arms) {
+    if (arm->as.match_arm.patterns.count == 0) *fallback = &arm->as.match_arm.value;
+    nob_da_foreach(AST_Node, pattern, &arm->as.match_arm.patterns) {
+      optimizer_cases_add(cases, ast_int_literal_value(pattern), &arm->as.match_arm.value);
+    }
+  }
+}
+
+// Values the condition compares the subject against, `x == 1`, `1 == x` and `||` of those
+bool optimizer_dispatch_values(AST_Node *cond, Nob_String_View *subject, AST_NodeList *body, Optimizer_Cases *cases) {
+  cond = optimizer_unwrap_expr(cond);
+  if (cond->kind != AST_NK_BINOP) return false;
+  AST_Node *lhs = optimizer_unwrap_expr(&cond->as.op.operands.items[0]);
+  AST_Node *rhs = optimizer_unwrap_expr(&cond->as.op.operands.items[1]);
+  if (sv_eq_str(cond->as.op.op.sv, "||")) {
+    return optimizer_dispatch_values(lhs, subject, body, cases) && optimizer_dispatch_values(rhs, subject, body, cases);
+  }
+  if (!sv_eq_str(cond->as.op.op.sv, "==")) return false;
+  if (optimizer_is_literal(lhs)) {
+    AST_Node *tmp = lhs;
+    lhs = rhs;
+    rhs = tmp;
+  }
+  if (lhs->kind != AST_NK_TOKEN || lhs->as.token.kind != TOK_IDENT || !optimizer_is_literal(rhs)) return false;
+  if (subject->count == 0) *subject = lhs->as.token.sv;
+  if (!nob_sv_eq(*subject, lhs->as.token.sv)) return false;
+  optimizer_cases_add(cases, ast_int_literal_value(rhs), body);
+  return true;
+}
+
+// Add the values of the condition to the cases, they are left as they were when it isn't a comparison of the subject
+bool optimizer_dispatch_try_values(AST_Node *cond, Nob_String_View *subject, AST_NodeList *body, Optimizer_Cases *cases) {
+  Optimizer_Cases attempt = {0};
+  nob_da_append_many(&attempt, cases->items, cases->count);
+  Nob_String_View name = *subject;
+  if (!optimizer_dispatch_values(cond, &name, body, &attempt)) {
+    safe_da_free(attempt);
+    return false;
+  }
+  safe_da_free((*cases));
+  *cases = attempt;
+  *subject = name;
+  return true;
+}
+
+bool optimizer_body_returns(AST_NodeList *body) {
+  return body->count > 0 && body->items[body->count - 1].kind == AST_NK_RETURN;
+}
+
+// Recognize the chain starting at the statement, on failure the dispatch is left empty
+bool optimizer_dispatch_chain(AST_NodeList *list, size_t index, Optimizer_Dispatch *d) {
+  AST_Node *head = &list->items[index];
+  d->head = head;
+  if (head->kind != AST_NK_IF) return false;
+  if (head->as.if_stmt.else_body.count > 0) {
+    // `if (x == 1) { ... } else if (x == 2) { ... } else { ... }`, an `if` on something else becomes part of the fallback
+    d->length = 1;
+    AST_Node *it = head;
+    while (optimizer_dispatch_try_values(&it->as.if_stmt.cond.items[0], &d->subject, &it->as.if_stmt.then_body, &d->cases)) {
+      AST_NodeList *else_body = &it->as.if_stmt.else_body;
+      d->fallback = else_body->count > 0 ? else_body : NULL;
+      if (else_body->count != 1 || else_body->items[0].kind != AST_NK_IF) break;
+      it = &else_body->items[0];
+    }
+  } else {
+    // Consecutive `if (x == 1) return ...;` where what follows them is the fallback
+    while (index + d->length < list->count) {
+      AST_Node *it = &list->items[index + d->length];
+      if (it->kind != AST_NK_IF || it->as.if_stmt.else_body.count > 0 || !optimizer_body_returns(&it->as.if_stmt.then_body)) break;
+      if (!optimizer_dispatch_try_values(&it->as.if_stmt.cond.items[0], &d->subject, &it->as.if_stmt.then_body, &d->cases)) break;
+      d->length++;
+    }
+  }
+  if (d->length > 0 && optimizer_cases_are_worth_dispatch(&d->cases)) return true;
+  safe_da_free(d->cases);
+  return false;
+}
+
+void optimizer_find_dispatches_in_list(AST_NodeList *list, Optimizer_Dispatches *dispatches) {
+  for (size_t i = 0; i < list->count; ++i) {
+    Optimizer_Dispatch d = {0};
+    if (optimizer_dispatch_chain(list, i, &d)) {
+      nob_da_append(dispatches, d);
+      // Bodies and the fallback can hold chains of their own
+      nob_da_foreach(Optimizer_Case, it, &d.cases) {
+        bool seen = false;
+        for (Optimizer_Case *prev = d.cases.items; prev < it; ++prev) {
+          if (prev->body == it->body) seen = true;
+        }
+        if (!seen) optimizer_find_dispatches_in_list(it->body, dispatches);
+      }
+      if (d.fallback != NULL) optimizer_find_dispatches_in_list(d.fallback, dispatches);
+      i += d.length - 1;
+      continue;
+    }
+    AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+    size_t lists_count = ast_node_child_lists(&list->items[i], lists);
+    for (size_t j = 0; j < lists_count; ++j) {
+      optimizer_find_dispatches_in_list(lists[j], dispatches);
+    }
+  }
+}
+
+void optimizer_find_dispatches(AST_NodeList *module, Optimizer_Dispatches *dispatches) {
+  nob_da_foreach(AST_Node, it, module) {
+    if (it->kind == AST_NK_FN_DECL) optimizer_find_dispatches_in_list(&it->as.fn_decl.body, dispatches);
+  }
+}
+
+Optimizer_Dispatch *optimizer_dispatch_at(Optimizer_Dispatches *dispatches, AST_Node *head) {
+  nob_da_foreach(Optimizer_Dispatch, it, dispatches) {
+    if (it->head == head) return it;
+  }
+  return NULL;
+}
+
+typedef struct {
+  AST_Node *node;
+  // Index of the function it is nested in, SIZE_MAX for the top level one
+  size_t parent;
+  // Parameters, variables and functions declared right inside of it
+  StringViews bound;
+  // Names it or the functions nested in it use that the enclosing functions declare
+  StringViews free;
+  // Extra parameters once lifted
+  StringViews captures;
+  bool lift;
+  Nob_String_View lifted_name;
+} Optimizer_Lambda;
+
+typedef struct {
+  Optimizer_Lambda *items;
+  size_t count;
+  size_t capacity;
+} Optimizer_Lambdas;
+
+typedef struct {
+  // The top level function is the first one
+  Optimizer_Lambdas lambdas;
+  // Every declaration inside of the top level function, a name shows up once per declaration
+  StringViews declared;
+  StringViews assigned;
+  // Identifiers used as values, a function showing up here escapes
+  StringViews values;
+} Optimizer_Lifter;
+
+size_t optimizer_svs_count(StringViews *svs, Nob_String_View sv) {
+  size_t count = 0;
+  nob_da_foreach(Nob_String_View, it, svs) {
+    if (nob_sv_eq(*it, sv)) count++;
+  }
+  return count;
+}
+
+size_t optimizer_lift_scan(Optimizer_Lifter *lf, AST_Node *fn, size_t parent);
+
+void optimizer_lift_scan_node(Optimizer_Lifter *lf, size_t index, AST_Node *node) {
+  switch (node->kind) {
+  case AST_NK_TOKEN:
+    if (node->as.token.kind != TOK_IDENT) return;
+    nob_da_append(&lf->lambdas.items[index].free, node->as.token.sv);
+    nob_da_append(&lf->values, node->as.token.sv);
+    return;
+  case AST_NK_VAR_DECL:
+    nob_da_append(&lf->lambdas.items[index].bound, node->as.var_decl.name);
+    nob_da_append(&lf->declared, node->as.var_decl.name);
+    break;
+  case AST_NK_ASSIGNMENT:
+    nob_da_append(&lf->lambdas.items[index].free, node->as.var_assign.name);
+    nob_da_append(&lf->assigned, node->as.var_assign.name);
+    break;
+  case AST_NK_FOR:
+    nob_da_append(&lf->lambdas.items[index].bound, node->as.for_loop.name);
+    nob_da_append(&lf->declared, node->as.for_loop.name);
+    break;
+  case AST_NK_FN_CALL:
+    nob_da_append(&lf->lambdas.items[index].free, node->as.fn_call.name);
+    break;
+  case AST_NK_FN_DECL: {
+    nob_da_append(&lf->lambdas.items[index].bound, node->as.fn_decl.name);
+    nob_da_append(&lf->declared, node->as.fn_decl.name);
+    size_t inner = optimizer_lift_scan(lf, node, index);
+    // Scanning can grow the array, only hold onto indices
+    nob_da_foreach(Nob_String_View, it, &lf->lambdas.items[inner].free) {
+      nob_da_append(&lf->lambdas.items[index].free, *it);
+    }
+  } return;
+  default:
+    break;
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      optimizer_lift_scan_node(lf, index, it);
+    }
+  }
+}
+
+// Variables are treated as living in the whole function like the inliner does, not only in their block
+size_t optimizer_lift_scan(Optimizer_Lifter *lf, AST_Node *fn, size_t parent) {
+  size_t index = lf->lambdas.count;
+  Optimizer_Lambda lambda = {
+    .node = fn,
+    .parent = parent,
+  };
+  nob_da_append(&lf->lambdas, lambda);
+  nob_da_foreach(AST_Node, param, &fn->as.fn_decl.params) {
+    nob_da_append(&lf->lambdas.items[index].bound, param->as.token.sv);
+    nob_da_append(&lf->declared, param->as.token.sv);
+  }
+  nob_da_foreach(AST_Node, it, &fn->as.fn_decl.body) {
+    optimizer_lift_scan_node(lf, index, it);
+  }
+
+  Optimizer_Lambda *self = &lf->lambdas.items[index];
+  size_t kept = 0;
+  nob_da_foreach(Nob_String_View, it, &self->free) {
+    if (optimizer_svs_contain(&self->bound, *it)) continue;
+    bool seen = false;
+    for (size_t i = 0; i < kept && !seen; ++i) seen = nob_sv_eq(self->free.items[i], *it);
+    if (!seen) self->free.items[kept++] = *it;
+  }
+  self->free.count = kept;
+  return index;
+}
+
+// Whether one of the functions around the lambda declares the name, anything else is a global
+bool optimizer_lift_is_enclosing(Optimizer_Lifter *lf, size_t index, Nob_String_View name) {
+  for (size_t at = lf->lambdas.items[index].parent; at != SIZE_MAX; at = lf->lambdas.items[at].parent) {
+    if (optimizer_svs_contain(&lf->lambdas.items[at].bound, name)) return true;
+  }
+  return false;
+}
+
+Optimizer_Lambda *optimizer_lift_find(Optimizer_Lifter *lf, Nob_String_View name) {
+  for (size_t i = 1; i < lf->lambdas.count; ++i) {
+    Optimizer_Lambda *it = &lf->lambdas.items[i];
+    if (it->lift && nob_sv_eq(it->node->as.fn_decl.name, name)) return it;
+  }
+  return NULL;
+}
+
+// Calls passing another amount of arguments would put the captured values in the wrong parameters
+bool optimizer_lift_calls_match_arity(AST_Node *node, Nob_String_View name, size_t arity) {
+  if (node->kind == AST_NK_FN_CALL && nob_sv_eq(node->as.fn_call.name, name) && node->as.fn_call.params.count != arity) return false;
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      if (!optimizer_lift_calls_match_arity(it, name, arity)) return false;
+    }
+  }
+  return true;
+}
+
+// Passing a variable along only reads the same value the closure would when nothing assigns to it
+// Names declared more than once could resolve to another variable at the call site
+bool optimizer_lift_can_lift(Optimizer_Lifter *lf, Optimizer_Lambda *lambda) {
+  Nob_String_View name = lambda->node->as.fn_decl.name;
+  if (optimizer_svs_count(&lf->declared, name) != 1 || optimizer_svs_contain(&lf->values, name)) return false;
+  if (!optimizer_lift_calls_match_arity(lf->lambdas.items[0].node, name, lambda->node->as.fn_decl.params.count)) return false;
+  nob_da_foreach(Nob_String_View, it, &lambda->free) {
+    if (optimizer_svs_count(&lf->declared, *it) != 1 || optimizer_svs_contain(&lf->assigned, *it)) return false;
+  }
+  return true;
+}
+
+void optimizer_lift_rewrite_calls(Optimizer_Lifter *lf, AST_Node *node) {
+  if (node->kind == AST_NK_FN_CALL) {
+    Optimizer_Lambda *callee = optimizer_lift_find(lf, node->as.fn_call.name);
+    if (callee != NULL) {
+      node->as.fn_call.name = callee->lifted_name;
+      nob_da_foreach(Nob_String_View, it, &callee->captures) {
+        nob_da_append(&node->as.fn_call.params, optimizer_ident(node->loc, *it));
+      }
+    }
+  }
+  AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+  size_t lists_count = ast_node_child_lists(node, lists);
+  for (size_t i = 0; i < lists_count; ++i) {
+    nob_da_foreach(AST_Node, it, lists[i]) {
+      optimizer_lift_rewrite_calls(lf, it);
+    }
+  }
+}
+
+// Move the lifted functions out of the list, innermost first
+void optimizer_lift_extract(Optimizer_Lifter *lf, AST_NodeList *list, AST_NodeList *lifted) {
+  size_t kept = 0;
+  nob_da_foreach(AST_Node, it, list) {
+    AST_NodeList *lists[AST_MAX_CHILD_LISTS];
+    size_t lists_count = ast_node_child_lists(it, lists);
+    for (size_t i = 0; i < lists_count; ++i) {
+      optimizer_lift_extract(lf, lists[i], lifted);
+    }
+    bool moves = false;
+    if (it->kind == AST_NK_FN_DECL) {
+      for (size_t i = 1; i < lf->lambdas.count && !moves; ++i) {
+        moves = lf->lambdas.items[i].lift && nob_sv_eq(lf->lambdas.items[i].lifted_name, it->as.fn_decl.name);
+      }
+    }
+    if (moves) {
+      nob_da_append(lifted, *it);
+    } else {
+      list->items[kept++] = *it;
+    }
+  }
+  list->count = kept;
+}
+
+void optimizer_lift_free(Optimizer_Lifter *lf) {
+  nob_da_foreach(Optimizer_Lambda, it, &lf->lambdas) {
+    safe_da_free(it->bound);
+    safe_da_free(it->free);
+    safe_da_free(it->captures);
+  }
+  safe_da_free(lf->lambdas);
+  safe_da_free(lf->declared);
+  safe_da_free(lf->assigned);
+  safe_da_free(lf->values);
+}
+
+// Lift the functions nested in a top level one into lifted
+void optimizer_lift_lambdas_of(AST_Node *root, AST_NodeList *lifted) {
+  Optimizer_Lifter lf = {0};
+  optimizer_lift_scan(&lf, root, SIZE_MAX);
+
+  for (size_t i = 1; i < lf.lambdas.count; ++i) {
+    Optimizer_Lambda *it = &lf.lambdas.items[i];
+    size_t kept = 0;
+    nob_da_foreach(Nob_String_View, name, &it->free) {
+      if (optimizer_lift_is_enclosing(&lf, i, *name)) it->free.items[kept++] = *name;
+    }
+    it->free.count = kept;
+    it->lift = optimizer_lift_can_lift(&lf, it);
+  }
+
+  // Calling a lifted function means passing what it captures, so those get captured by the caller as well
+  for (size_t i = 1; i < lf.lambdas.count; ++i) {
+    Optimizer_Lambda *it = &lf.lambdas.items[i];
+    if (!it->lift) continue;
+    nob_da_foreach(Nob_String_View, name, &it->free) {
+      if (optimizer_lift_find(&lf, *name) == NULL) nob_da_append(&it->captures, *name);
+    }
+  }
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = 1; i < lf.lambdas.count; ++i) {
+      Optimizer_Lambda *it = &lf.lambdas.items[i];
+      if (!it->lift) continue;
+      nob_da_foreach(Nob_String_View, name, &it->free) {
+        Optimizer_Lambda *callee = optimizer_lift_find(&lf, *name);
+        if (callee == NULL) continue;
+        nob_da_foreach(Nob_String_View, capture, &callee->captures) {
+          if (optimizer_svs_contain(&it->captures, *capture) || optimizer_svs_contain(&it->bound, *capture)) continue;
+          nob_da_append(&it->captures, *capture);
+          changed = true;
+        }
+      }
+    }
+  }
+
+  bool any = false;
+  for (size_t i = 1; i < lf.lambdas.count; ++i) {
+    Optimizer_Lambda *it = &lf.lambdas.items[i];
+    if (!it->lift) continue;
+    any = true;
+    Nob_String_Builder sb = {0};
+    nob_sb_appendf(&sb, SV_Fmt"$"SV_Fmt, SV_Arg(root->as.fn_decl.name), SV_Arg(it->node->as.fn_decl.name));
+    it->lifted_name = nob_sb_to_sv(sb);
+  }
+  if (any) {
+    nob_da_foreach(AST_Node, it, &root->as.fn_decl.body) {
+      optimizer_lift_rewrite_calls(&lf, it);
+    }
+    // Declarations last as the calls are found by the original names
+    for (size_t i = 1; i < lf.lambdas.count; ++i) {
+      Optimizer_Lambda *it = &lf.lambdas.items[i];
+      if (!it->lift) continue;
+      it->node->as.fn_decl.name = it->lifted_name;
+      nob_da_foreach(Nob_String_View, capture, &it->captures) {
+        nob_da_append(&it->node->as.fn_decl.params, optimizer_ident(it->node->loc, *capture));
+      }
+    }
+    optimizer_lift_extract(&lf, &root->as.fn_decl.body, lifted);
+  }
+  optimizer_lift_free(&lf);
+}
+
+size_t optimizer_lift_lambdas(AST_NodeList *module) {
+  size_t count = 0;
+  AST_NodeList lifted = {0};
+  for (size_t i = 0; i < module->count; ++i) {
+    AST_Node *it = &module->items[i];
+    if (it->kind != AST_NK_FN_DECL) continue;
+    bool has_nested = false;
+    nob_da_foreach(AST_Node, stmt, &it->as.fn_decl.body) {
+      if (optimizer_contains_kind(stmt, AST_NK_FN_DECL)) has_nested = true;
+    }
+    if (!has_nested) continue;
+    lifted.count = 0;
+    optimizer_lift_lambdas_of(it, &lifted);
+    // Right before the function they came from, the loop carries on after it
+    for (size_t j = 0; j < lifted.count; ++j) {
+      optimizer_insert_node(module, i + j, lifted.items[j]);
+    }
+    i += lifted.count;
+    count += lifted.count;
+  }
+  safe_da_free(lifted);
+  return count;
+}
+
+#endif // DWOC_OPTIMIZER_IMPLEMENTATION
@@ -0,0 +1,343 @@
+#ifndef __DWOC_PASSES_H
+#define __DWOC_PASSES_H
+
+#include <time.h>
+
+#include "utils.h"
+#include "ast.h"
+#include "optimizer.h"
+
+#ifndef NOB_IMPLEMENTATION
+#  include "nob.h"
+#endif
+
+// Facts about the module computed on demand and cached until a pass changes what they depend on
+typedef enum {
+  // Optimizer_Call_Kind of every function, what calls CSE and LICM are allowed to move
+  PASS_ANALYSIS_PURITY,
+  // Groups of functions whose tail calls the backend turns into loops
+  PASS_ANALYSIS_TAIL_CALLS,
+  // Functions whose calls go through a cache
+  PASS_ANALYSIS_MEMOIZE,
+  // Chains of `if`s on the value of a variable the backend can jump through
+  PASS_ANALYSIS_DISPATCH,
+  COUNT_PASS_ANALYSES,
+} Pass_Analysis;
+
+#define PASS_PRESERVES(analysis) (1u << (analysis))
+
+typedef struct Pass_Manager Pass_Manager;
+
+typedef struct {
+  const char *name;
+  // Lowest -O level the pass runs at
+  int min_level;
+  // Whether -Os runs it, passes that trade size for speed don't
+  bool for_size;
+  // Needed for the output to be correct, it runs at every level and --disable-pass refuses to skip it
+  bool required;
+  // Analyses the pass keeps valid, every other one gets computed again the next time it is asked for
+  unsigned preserves;
+  // Returns the amount of nodes it changed
+  size_t (*run)(Pass_Manager *pm);
+} Pass;
+
+typedef struct {
+  const char *name;
+  double seconds;
+  size_t changed;
+  // How many times it ran, analyses run again after being invalidated
+  size_t runs;
+  // Requests served from the cache, always 0 for passes
+  size_t hits;
+  bool disabled;
+} Pass_Stat;
+
+typedef struct {
+  Pass_Stat *items;
+  size_t count;
+  size_t capacity;
+} Pass_Stats;
+
+struct Pass_Manager {
+  AST_NodeList *module;
+  Options *opts;
+  bool valid[COUNT_PASS_ANALYSES];
+  // Results of the analyses, only meaningful while valid
+  Optimizer_Call_Kind *purity;
+  Optimizer_TailGroups tail_groups;
+  bool *memoized;
+  Optimizer_Dispatches dispatches;
+  Pass_Stats pass_stats;
+  Pass_Stat analysis_stats[COUNT_PASS_ANALYSES];
+};
+
+void pass_manager_init(Pass_Manager *pm, AST_NodeList *module, Options *opts);
+void pass_manager_free(Pass_Manager *pm);
+
+// Whether the name is a pass of the pipeline or an analysis, used to validate what gets disabled
+bool pass_manager_knows(const Pass *pipeline, size_t pipeline_count, const char *name);
+// Whether the name is a pass of the pipeline that can't be disabled
+bool pass_manager_is_required(const Pass *pipeline, size_t pipeline_count, const char *name);
+
+// Run every pass of the pipeline that is enabled for the options in order
+void pass_manager_run(Pass_Manager *pm, const Pass *pipeline, size_t pipeline_count);
+
+// Whether the analysis runs with the current options, backends skip the lowerings that depend on it when it doesn't
+bool pass_manager_analysis_enabled(Pass_Manager *pm, Pass_Analysis analysis);
+
+// Analysis results, computed the first time they are asked for after being invalidated
+Optimizer_Call_Kind *pass_manager_purity(Pass_Manager *pm);
+Optimizer_TailGroups *pass_manager_tail_groups(Pass_Manager *pm);
+bool pass_manager_is_memoized(Pass_Manager *pm, AST_Node *fn);
+Optimizer_Dispatch *pass_manager_dispatch_at(Pass_Manager *pm, AST_Node *head);
+
+// Print how long every pass and analysis took, what passes changed and how often analyses were reused
+void pass_manager_print_stats(Pass_Manager *pm);
+
+// Wrappers of the optimizer transforms so backends can put them in their pipelines
+size_t pass_lift_lambdas(Pass_Manager *pm);
+size_t pass_fold_constants(Pass_Manager *pm);
+size_t pass_inline_calls(Pass_Manager *pm);
+size_t pass_eliminate_common_subexprs(Pass_Manager *pm);
+size_t pass_hoist_loop_invariants(Pass_Manager *pm);
+size_t pass_tree_shake(Pass_Manager *pm);
+
+#endif // __DWOC_PASSES_H
+
+#ifdef DWOC_PASSES_IMPLEMENTATION
+
+typedef struct {
+  const char *name;
+  int min_level;
+  bool for_size;
+} Pass_Analysis_Info;
+
+static const Pass_Analysis_Info pass_analyses[COUNT_PASS_ANALYSES] = {
+  [PASS_ANALYSIS_PURITY] = { .name = "purity", .min_level = 0, .for_size = true },
+  [PASS_ANALYSIS_TAIL_CALLS] = { .name = "tail-calls", .min_level = 1, .for_size = true },
+  [PASS_ANALYSIS_MEMOIZE] = { .name = "memoize", .min_level = 0, .for_size = true },
+  [PASS_ANALYSIS_DISPATCH] = { .name = "dispatch", .min_level = 1, .for_size = true },
+};
+
+double pass_manager_now(void) {
+#ifdef _WIN32
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+void pass_manager_init(Pass_Manager *pm, AST_NodeList *module, Options *opts) {
+  memset(pm, 0, sizeof(*pm));
+  pm->module = module;
+  pm->opts = opts;
+  for (size_t i = 0; i < COUNT_PASS_ANALYSES; ++i) {
+    pm->analysis_stats[i].name = pass_analyses[i].name;
+  }
+}
+
+void pass_manager_free_tail_groups(Optimizer_TailGroups *groups) {
+  nob_da_foreach(Optimizer_TailGroup, it, groups) {
+    safe_da_free(it->fns);
+    safe_da_free(it->sites);
+  }
+  groups->count = 0;
+}
+
+void pass_manager_free_dispatches(Optimizer_Dispatches *dispatches) {
+  nob_da_foreach(Optimizer_Dispatch, it, dispatches) {
+    safe_da_free(it->cases);
+  }
+  dispatches->count = 0;
+}
+
+void pass_manager_free(Pass_Manager *pm) {
+  NOB_FREE(pm->purity);
+  NOB_FREE(pm->memoized);
+  pass_manager_free_tail_groups(&pm->tail_groups);
+  safe_da_free(pm->tail_groups);
+  pass_manager_free_dispatches(&pm->dispatches);
+  safe_da_free(pm->dispatches);
+  safe_da_free(pm->pass_stats);
+}
+
+bool pass_manager_is_disabled(Pass_Manager *pm, const char *name) {
+  nob_da_foreach(const char *, it, &pm->opts->disabled_passes) {
+    if (strcmp(*it, name) == 0) return true;
+  }
+  return false;
+}
+
+bool pass_manager_is_enabled(Pass_Manager *pm, const char *name, int min_level, bool for_size) {
+  if (pass_manager_is_disabled(pm, name)) return false;
+  if (pm->opts->optimize_size) return for_size;
+  return pm->opts->opt_level >= min_level;
+}
+
+bool pass_manager_knows(const Pass *pipeline, size_t pipeline_count, const char *name) {
+  for (size_t i = 0; i < pipeline_count; ++i) {
+    if (strcmp(pipeline[i].name, name) == 0) return true;
+  }
+  for (size_t i = 0; i < COUNT_PASS_ANALYSES; ++i) {
+    if (strcmp(pass_analyses[i].name, name) == 0) return true;
+  }
+  return false;
+}
+
+bool pass_manager_is_required(const Pass *pipeline, size_t pipeline_count, const char *name) {
+  for (size_t i = 0; i < pipeline_count; ++i) {
+    if (strcmp(pipeline[i].name, name) == 0) return pipeline[i].required;
+  }
+  return false;
+}
+
+void pass_manager_run(Pass_Manager *pm, const Pass *pipeline, size_t pipeline_count) {
+  for (size_t i = 0; i < pipeline_count; ++i) {
+    const Pass *pass = &pipeline[i];
+    Pass_Stat stat = {
+      .name = pass->name,
+      .disabled = !pass->required && !pass_manager_is_enabled(pm, pass->name, pass->min_level, pass->for_size),
+    };
+    if (!stat.disabled) {
+      double start = pass_manager_now();
+      stat.changed = pass->run(pm);
+      stat.seconds = pass_manager_now() - start;
+      stat.runs = 1;
+      // Even a pass that changed nothing may have moved nodes around, results holding pointers into the module are stale
+      for (size_t a = 0; a < COUNT_PASS_ANALYSES; ++a) {
+        if ((pass->preserves & PASS_PRESERVES(a)) == 0) pm->valid[a] = false;
+      }
+    }
+    nob_da_append(&pm->pass_stats, stat);
+  }
+}
+
+// Whether the cached result can be handed out, otherwise the caller computes it and marks it valid
+bool pass_manager_analysis_cached(Pass_Manager *pm, Pass_Analysis analysis) {
+  if (!pm->valid[analysis]) return false;
+  pm->analysis_stats[analysis].hits++;
+  return true;
+}
+
+bool pass_manager_analysis_enabled(Pass_Manager *pm, Pass_Analysis analysis) {
+  const Pass_Analysis_Info *info = &pass_analyses[analysis];
+  bool enabled = pass_manager_is_enabled(pm, info->name, info->min_level, info->for_size);
+  pm->analysis_stats[analysis].disabled = !enabled;
+  return enabled;
+}
+
+void pass_manager_analysis_done(Pass_Manager *pm, Pass_Analysis analysis, double start) {
+  pm->valid[analysis] = true;
+  pm->analysis_stats[analysis].seconds += pass_manager_now() - start;
+  pm->analysis_stats[analysis].runs++;
+}
+
+Optimizer_Call_Kind *pass_manager_purity(Pass_Manager *pm) {
+  if (pass_manager_analysis_cached(pm, PASS_ANALYSIS_PURITY)) return pm->purity;
+  double start = pass_manager_now();
+  pm->purity = NOB_REALLOC(pm->purity, (pm->module->count + 1) * sizeof(Optimizer_Call_Kind));
+  NOB_ASSERT(pm->purity != NULL && "Buy more RAM lol");
+  if (pass_manager_analysis_enabled(pm, PASS_ANALYSIS_PURITY)) {
+    optimizer_classify_calls(pm->module, pm->purity);
+  } else {
+    // Without purity nothing can be moved across other calls
+    for (size_t i = 0; i < pm->module->count; ++i) pm->purity[i] = OPTIMIZER_CALL_IMPURE;
+  }
+  pass_manager_analysis_done(pm, PASS_ANALYSIS_PURITY, start);
+  return pm->purity;
+}
+
+Optimizer_TailGroups *pass_manager_tail_groups(Pass_Manager *pm) {
+  if (pass_manager_analysis_cached(pm, PASS_ANALYSIS_TAIL_CALLS)) return &pm->tail_groups;
+  double start = pass_manager_now();
+  pass_manager_free_tail_groups(&pm->tail_groups);
+  if (pass_manager_analysis_enabled(pm, PASS_ANALYSIS_TAIL_CALLS)) {
+    optimizer_find_tail_groups(pm->module, &pm->tail_groups);
+  }
+  pass_manager_analysis_done(pm, PASS_ANALYSIS_TAIL_CALLS, start);
+  return &pm->tail_groups;
+}
+
+bool pass_manager_is_memoized(Pass_Manager *pm, AST_Node *fn) {
+  if (!pass_manager_analysis_cached(pm, PASS_ANALYSIS_MEMOIZE)) {
+    double start = pass_manager_now();
+    pm->memoized = NOB_REALLOC(pm->memoized, (pm->module->count + 1) * sizeof(bool));
+    NOB_ASSERT(pm->memoized != NULL && "Buy more RAM lol");
+    memset(pm->memoized, 0, (pm->module->count + 1) * sizeof(bool));
+    if (pass_manager_analysis_enabled(pm, PASS_ANALYSIS_MEMOIZE)) {
+      nob_da_foreach(AST_Node, it, pm->module) {
+        if (it->kind != AST_NK_FN_DECL) continue;
+        pm->memoized[it - pm->module->items] = optimizer_should_memoize(pm->module, it, pm->opts);
+      }
+    }
+    pass_manager_analysis_done(pm, PASS_ANALYSIS_MEMOIZE, start);
+  }
+  return pm->memoized[fn - pm->module->items];
+}
+
+Optimizer_Dispatch *pass_manager_dispatch_at(Pass_Manager *pm, AST_Node *head) {
+  if (!pass_manager_analysis_cached(pm, PASS_ANALYSIS_DISPATCH)) {
+    double start = pass_manager_now();
+    pass_manager_free_dispatches(&pm->dispatches);
+    if (pass_manager_analysis_enabled(pm, PASS_ANALYSIS_DISPATCH)) {
+      optimizer_find_dispatches(pm->module, &pm->dispatches);
+    }
+    pass_manager_analysis_done(pm, PASS_ANALYSIS_DISPATCH, start);
+  }
+  return optimizer_dispatch_at(&pm->dispatches, head);
+}
+
+void pass_manager_print_stat(const char *kind, Pass_Stat *stat) {
+  if (stat->disabled) {
+    printf("  %-8s %-16s %10s\n", kind, stat->name, "disabled");
+  } else if (stat->runs == 0) {
+    printf("  %-8s %-16s %10s\n", kind, stat->name, "unused");
+  } else if (strcmp(kind, "pass") == 0) {
+    printf("  %-8s %-16s %8.3fms  %zu nodes changed\n", kind, stat->name, stat->seconds * 1000.0, stat->changed);
+  } else {
+    printf("  %-8s %-16s %8.3fms  computed %zu time%s, %zu cache hit%s\n", kind, stat->name, stat->seconds * 1000.0,
+           stat->runs, stat->runs == 1 ? "" : "s", stat->hits, stat->hits == 1 ? "" : "s");
+  }
+}
+
+void pass_manager_print_stats(Pass_Manager *pm) {
+  printf("Pass stats:\n");
+  nob_da_foreach(Pass_Stat, it, &pm->pass_stats) {
+    pass_manager_print_stat("pass", it);
+  }
+  for (size_t i = 0; i < COUNT_PASS_ANALYSES; ++i) {
+    pass_manager_print_stat("analysis", &pm->analysis_stats[i]);
+  }
+}
+
+size_t pass_lift_lambdas(Pass_Manager *pm) {
+  return optimizer_lift_lambdas(pm->module);
+}
+
+size_t pass_fold_constants(Pass_Manager *pm) {
+  return optimizer_fold_constants(pm->module, pm->opts);
+}
+
+size_t pass_inline_calls(Pass_Manager *pm) {
+  return optimizer_inline_calls(pm->module, pm->opts);
+}
+
+size_t pass_eliminate_common_subexprs(Pass_Manager *pm) {
+  return optimizer_eliminate_common_subexprs(pm->module, pm->opts, pass_manager_purity(pm));
+}
+
+size_t pass_hoist_loop_invariants(Pass_Manager *pm) {
+  return optimizer_hoist_loop_invariants(pm->module, pm->opts, pass_manager_purity(pm));
+}
+
+size_t pass_tree_shake(Pass_Manager *pm) {
+  return optimizer_tree_shake(pm->module);
+}
+
+#endif // DWOC_PASSES_IMPLEMENTATION
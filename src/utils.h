@@ -1,6 +1,8 @@
 #ifndef __DWOC_UTILS_H
 #define __DWOC_UTILS_H
 
+#include <math.h>
+
 #ifndef NOB_IMPLEMENTATION
 #include "nob.h"
 #endif
@@ -14,6 +16,39 @@ typedef enum {
   OT_IR,
 } OutputTarget;
 
+typedef struct {
+  const char **items;
+  size_t count;
+  size_t capacity;
+} Cstrs;
+
+typedef struct {
+  // Optimization level selected with -O<n>, -Os counts as -O2 with the passes that grow the output left out
+  int opt_level;
+  bool optimize_size;
+  // Max cost of a function body for its calls to be inlined, 0 disables inlining
+  size_t inline_budget;
+  // Print a note for every call that got inlined
+  bool report_inline;
+  // Max steps the compile time interpreter can take to fold a single expression, 0 disables folding
+  size_t ctfe_steps;
+  // Print a note for every expression common subexpression elimination or loop invariant code motion moved
+  bool report_hoist;
+  // Print the time every pass and analysis took and how many nodes each pass changed
+  bool pass_stats;
+  // Names of the passes and analyses to skip, for bisecting
+  Cstrs disabled_passes;
+  // Emit generators as JavaScript `function*` instead of state machines, smaller but slower to step through
+  bool native_generators;
+  // Emit JavaScript without formatting and with the shortest names available for locals and the runtime
+  bool minify;
+  // Write a source map next to the JavaScript, with the url the JavaScript also gets a comment pointing at it
+  bool source_map;
+  bool source_map_url;
+  // Emit an ES module importing the runtime from a shared file instead of embedding it
+  bool esm;
+} Options;
+
 typedef struct {
   Nob_String_View *items;
   size_t count;
@@ -78,6 +113,33 @@ bool sv_eq_buf(Nob_String_View sv, const char *buf, size_t buf_len);
 
 #define sb_append_sv(sb, sv) nob_sb_append_buf(sb, sv.data, sv.count)
 
+// Same text JavaScript's Number#toString gives, the fewest digits that read back as the same double
+void sb_append_js_number(Nob_String_Builder *sb, double value);
+
+#define OUTPUT_SINK_CAPACITY (64*1024)
+
+// Output file behind a fixed size buffer, emitters hand it one top level item at a time so memory doesn't grow with the output
+typedef struct {
+  FILE *file;
+  const char *path;
+  // Bytes that already reached the file
+  size_t written;
+  size_t count;
+  char items[OUTPUT_SINK_CAPACITY];
+} Output_Sink;
+
+bool output_sink_open(Output_Sink *out, const char *path);
+// Writes bigger than the buffer skip it and go out straight from where they are
+bool output_sink_write(Output_Sink *out, const char *data, size_t size);
+#define output_sink_write_sv(out, sv) output_sink_write(out, (sv).data, (sv).count)
+#define output_sink_write_cstr(out, cstr) output_sink_write(out, cstr, strlen(cstr))
+// Moves what got built into the sink, leaving the builder empty for the next item
+bool output_sink_drain(Output_Sink *out, Nob_String_Builder *sb);
+bool output_sink_flush(Output_Sink *out);
+bool output_sink_close(Output_Sink *out);
+// Closes and deletes the file, a failed compilation leaves no half written output behind
+void output_sink_discard(Output_Sink *out);
+
 // Made my own todo cause abort kinda seems a bit odd in my machine sometimes
 #define TODO(message) (fprintf(stderr, "%s:%d: [TODO] %s\n", __FILE__, __LINE__, message), exit(1))
 #define TODOf(fmt, ...) (fprintf(stderr, "%s:%d: [TODO] "fmt"\n", __FILE__, __LINE__, __VA_ARGS__), exit(1))
@@ -128,5 +190,120 @@ bool sv_eq_buf(Nob_String_View sv, const char *buf, size_t buf_len) {
   return strncmp(sv.data, buf, buf_len) == 0;
 }
 
+void sb_append_js_number(Nob_String_Builder *sb, double value) {
+  if (isnan(value)) {
+    nob_sb_append_cstr(sb, "NaN");
+    return;
+  }
+  // -0 prints as 0
+  if (value < 0) {
+    nob_da_append(sb, '-');
+    value = -value;
+  }
+  if (isinf(value)) {
+    nob_sb_append_cstr(sb, "Infinity");
+    return;
+  }
+  if (value == 0) {
+    nob_da_append(sb, '0');
+    return;
+  }
+
+  char buf[32];
+  int precision = 1;
+  for (; precision < 17; ++precision) {
+    snprintf(buf, sizeof(buf), "%.*e", precision - 1, value);
+    if (strtod(buf, NULL) == value) break;
+  }
+  snprintf(buf, sizeof(buf), "%.*e", precision - 1, value);
+  char digits[20];
+  int count = 0;
+  char *it = buf;
+  for (; *it != 'e'; ++it) {
+    if (*it != '.') digits[count++] = *it;
+  }
+  while (count > 1 && digits[count - 1] == '0') count--;
+  // Digits are read as 0.ddd times 10^point
+  int point = atoi(it + 1) + 1;
+
+  if (count <= point && point <= 21) {
+    nob_sb_append_buf(sb, digits, count);
+    for (int i = count; i < point; ++i) nob_da_append(sb, '0');
+  } else if (0 < point && point <= 21) {
+    nob_sb_append_buf(sb, digits, point);
+    nob_da_append(sb, '.');
+    nob_sb_append_buf(sb, digits + point, count - point);
+  } else if (-6 < point && point <= 0) {
+    nob_sb_append_cstr(sb, "0.");
+    for (int i = point; i < 0; ++i) nob_da_append(sb, '0');
+    nob_sb_append_buf(sb, digits, count);
+  } else {
+    nob_da_append(sb, digits[0]);
+    if (count > 1) {
+      nob_da_append(sb, '.');
+      nob_sb_append_buf(sb, digits + 1, count - 1);
+    }
+    nob_sb_appendf(sb, "e%c%d", point > 0 ? '+' : '-', abs(point - 1));
+  }
+}
+
+bool output_sink_open(Output_Sink *out, const char *path) {
+  out->path = path;
+  out->written = 0;
+  out->count = 0;
+  out->file = fopen(path, "wb");
+  if (out->file == NULL) {
+    nob_log(NOB_ERROR, "Could not open file %s for writing: %s", path, strerror(errno));
+    return false;
+  }
+  // The sink is the only buffer between the emitters and the file
+  setvbuf(out->file, NULL, _IONBF, 0);
+  return true;
+}
+
+bool output_sink_put(Output_Sink *out, const char *data, size_t size) {
+  if (size == 0) return true;
+  if (fwrite(data, 1, size, out->file) != size) {
+    nob_log(NOB_ERROR, "Could not write into file %s: %s", out->path, strerror(errno));
+    return false;
+  }
+  out->written += size;
+  return true;
+}
+
+bool output_sink_flush(Output_Sink *out) {
+  bool ok = output_sink_put(out, out->items, out->count);
+  out->count = 0;
+  return ok;
+}
+
+bool output_sink_write(Output_Sink *out, const char *data, size_t size) {
+  if (out->count + size > OUTPUT_SINK_CAPACITY && !output_sink_flush(out)) return false;
+  if (size >= OUTPUT_SINK_CAPACITY) return output_sink_put(out, data, size);
+  memcpy(out->items + out->count, data, size);
+  out->count += size;
+  return true;
+}
+
+bool output_sink_drain(Output_Sink *out, Nob_String_Builder *sb) {
+  bool ok = output_sink_write(out, sb->items, sb->count);
+  sb->count = 0;
+  return ok;
+}
+
+bool output_sink_close(Output_Sink *out) {
+  bool ok = output_sink_flush(out);
+  if (fclose(out->file) != 0) ok = false;
+  out->file = NULL;
+  return ok;
+}
+
+void output_sink_discard(Output_Sink *out) {
+  if (out->file == NULL) return;
+  fclose(out->file);
+  out->file = NULL;
+  remove(out->path);
+}
+
 #endif // DWOC_UTILS_IMPLEMENTATION
 